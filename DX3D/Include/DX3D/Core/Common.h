@@ -2,6 +2,9 @@
 #include <DX3D/Core/Core.h>
 #include <DX3D/Core/Logger.h>
 #include <DX3D/Math/Rect.h>
+#include <DX3D/Graphics/BufferTypes.h>
+#include <DX3D/Graphics/VertexEncodingTypes.h>
+#include <functional>
 
 namespace dx3d
 {
@@ -25,6 +28,7 @@ namespace dx3d
     struct GraphicsEngineDesc
     {
         BaseDesc base;
+        bool logStatistics{};       // the caches', backend's and renderer's counters at Info level when destroyed
     };
 
     struct GraphicsDeviceDesc
@@ -65,9 +69,107 @@ namespace dx3d
         const ShaderBinary& ps;
     };
 
+    struct GeometryArenaDesc
+    {
+        BaseDesc base;
+        GraphicsBackend& backend;
+        ui32 vertexStride{};            // bytes between the x y z r g b a float vertices handed to the arena
+        VertexEncoding encoding{};      // how they are stored on the GPU, the buffer stride follows from it
+        PositionBounds bounds{};        // box Snorm16x4 positions are normalized into, anything outside is clamped
+        ui32 initialVertexCapacity{ 1024 };
+        ui32 initialIndexCapacity{ 4096 };
+    };
+
+    struct DynamicUploadRingDesc
+    {
+        BaseDesc base;
+        GraphicsBackend& backend;
+        ui32 byteCapacity{ 4 * 1024 * 1024 };
+        BufferType type{ BufferType::Vertex };  // what the ring's buffers are bound as
+    };
+
+    struct ConstantBufferRingDesc
+    {
+        BaseDesc base;
+        GraphicsBackend& backend;
+        ui32 byteCapacity{ 1024 * 1024 };       // of the per-frame ring, grows when a frame needs more
+        ui32 initialBlockCapacity{ 64 };        // retained blocks, grows as well
+    };
+
+    struct ShapeSystemDesc
+    {
+        BaseDesc base;
+        GraphicsBackend& backend;
+        GeometryArena& arena;               // the meshes live in it
+        DynamicUploadRing* uploadRing{};    // per-frame instances go through it when set
+    };
+
+    // one shape of a bulk add call, same meaning and defaults as the single add calls (r < 0 keeps the default colors)
+    struct TriangleDesc
+    {
+        f32 posX{}, posY{};
+        f32 size{ 1.0f };
+        f32 r{ -1.0f }, g{ -1.0f }, b{ -1.0f }, a{ 1.0f };
+    };
+
+    struct RectangleDesc
+    {
+        f32 posX{}, posY{};
+        f32 width{ 1.0f }, height{ 1.0f };
+        f32 r{ -1.0f }, g{ -1.0f }, b{ -1.0f }, a{ 1.0f };
+    };
+
+    struct CubeDesc
+    {
+        f32 posX{}, posY{}, posZ{};
+        f32 size{ 1.0f };
+        f32 r{ -1.0f }, g{ -1.0f }, b{ -1.0f }, a{ 1.0f };
+    };
+
+    struct SceneRendererDesc
+    {
+        BaseDesc base;
+        GraphicsBackend& backend;
+        ThreadPool* threadPool{};   // fills bulk adds and records parallel command lists when set
+        // arena vertices as fp16 positions + 8 bit colors, 12 bytes instead of 28
+        VertexEncoding vertexEncoding{ PositionEncoding::Half4, ColorEncoding::Unorm8x4 };
+        // a command list gets at least this many draws, a deferred list costs more than recording a few draws saves
+        ui32 minDrawsPerCommandList{ 256 };
+    };
+
+    enum class FramePacing
+    {
+        Sleep = 0,  // sleeps through most of a wait and yields the last bit, least CPU for a steady frame time
+        Yield,      // gives the core away between checks of the clock
+        Spin        // busy-waits, a full core for the tightest timing
+    };
+
+    struct FrameSchedulerDesc
+    {
+        BaseDesc base;
+        d64 simulationStep = 1.0 / 60.0;    // seconds of simulated time per fixed step
+        ui32 maxStepsPerFrame = 8;          // catch-up limit after a stall, a longer backlog is dropped
+        d64 frameRateCap = 0.0;             // frames per second, 0 = uncapped
+        FramePacing pacing = FramePacing::Sleep;
+        // seconds on a monotonic clock, steady_clock since creation when empty; tests drive the scheduler with a
+        // clock of their own, which has to keep moving while a frame cap is waited out
+        std::function<d64()> clock{};
+    };
+
     struct GameDesc
     {
         Rect windowSize{ 1280,720 };
         Logger::LogLevel logLevel = Logger::LogLevel::Error;
+        // log lines are written by a background thread, off the frame; off by default, since the lines
+        // still queued when the process dies are lost and those are the ones a crash report needs
+        bool asyncLogging = false;
+        bool logStatistics = false;  // the engine's and the frame scheduler's counters at Info level on shutdown
+        bool enableProfiler = false;
+        const char* profilerTracePath = "ProfilerTrace.json"; // written on shutdown when profiling
+        d64 frameRateCap = 60.0;            // 0 = render as fast as possible
+        FramePacing framePacing = FramePacing::Sleep;
+        d64 simulationStep = 1.0 / 60.0;
+        ui32 maxSimulationStepsPerFrame = 8;    // catch-up limit after a stall, see FrameSchedulerDesc
+        bool simulationThread = false;      // run onFixedUpdate on its own thread instead of before each frame
     };
 }
\ No newline at end of file
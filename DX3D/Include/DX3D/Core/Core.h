@@ -11,6 +11,10 @@ namespace dx3d {
 	class GraphicsDevice;
 
 	class Logger;
+	class ThreadPool;
+	class EntityStore;
+	class SceneGraph;
+	class FrameScheduler;
 	class SwapChain;
 	class Display;
 
@@ -18,9 +22,22 @@ namespace dx3d {
 
 	class ShaderBinary;
 	class GraphicsPipelineState;
+	class GeometryArena;
+	class DynamicUploadRing;
+	class ConstantBufferRing;
+	class GraphicsBackend;
+	class D3D11GraphicsBackend;
+	class GraphicsCommandList;
+	class RenderQueue;
+	class SceneRenderer;
+	class ImmutableBufferCache;
+	class PipelineCache;
+	class ShaderCache;
 
 	using i32 = int;
+	using ui16 = unsigned short;
 	using ui32 = unsigned int;
+	using ui64 = unsigned long long;
 	using f32 = float;
 	using d64 = double;
 
@@ -29,4 +46,8 @@ namespace dx3d {
 
 	using ShaderBinaryPtr = std::shared_ptr<ShaderBinary>;
 	using GraphicsPipelineStatePtr = std::shared_ptr<GraphicsPipelineState>;
+
+	template <typename Tag> struct GenerationalHandle;
+	using Entity = GenerationalHandle<struct EntityTag>;
+	using SceneNode = GenerationalHandle<struct SceneNodeTag>;
 }
@@ -0,0 +1,331 @@
+#pragma once
+#include <DX3D/Core/SlotMap.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace dx3d
+{
+	// one bit per component id, see EntityStore::getMask
+	using ComponentMask = ui64;
+
+	class EntityChunk;
+
+	/*
+	* Archetype based entity/component store.
+	* Entities with the same components and the same group share an archetype, which packs them into fixed
+	* size chunks: inside a chunk every component is one contiguous array (structure of arrays), so a system
+	* reading two components of ten thousand entities streams through two dense arrays per chunk instead of
+	* hopping between objects. The group is a value shared by a whole chunk (the renderer keys it on the
+	* mesh), which keeps it out of the rows and makes each chunk one batch of the same thing.
+	* Removing an entity moves the archetype's last one into its place, so every chunk but the last is full.
+	* Components have to be trivially copyable, rows move between chunks with memcpy, and new rows start
+	* out as T{}. Handles are generational like SlotMap's and the slot behind one stays put while the
+	* entity lives, so side structures (a BVH, ...) can key on it even though its row moves.
+	* Every write access stamps the chunk with a new store version; systems remember the version they
+	* last processed and skip the chunks nothing was written to since.
+	* Not thread safe, except that forEachChunk with a thread pool hands each chunk to one worker.
+	*/
+	class EntityStore final
+	{
+	public:
+		static constexpr ui32 ChunkBytes = 16 * 1024;
+		static constexpr ui32 MaxComponents = 64;
+
+		EntityStore() = default;
+		EntityStore(const EntityStore&) = delete;
+		EntityStore& operator=(const EntityStore&) = delete;
+
+		// process-wide id of a component type, assigned on first use
+		template <typename T>
+		static ui32 getComponentId()
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Components are moved between chunks with memcpy");
+			static const ui32 id = registerComponent(sizeof(T), alignof(T), &DefaultValue<T>);
+			return id;
+		}
+
+		template <typename... T>
+		static ComponentMask getMask()
+		{
+			return ((ComponentMask{ 1 } << getComponentId<T>()) | ... | ComponentMask{});
+		}
+
+		// count entities with the components in mask, written to outEntities (when given) in row order.
+		// initialize(chunk, firstRow, rowCount, firstIndex) runs once per chunk range the new rows landed in,
+		// on the thread pool when there is one, and is where their components get their values
+		template <typename Initialize>
+		void create(ComponentMask mask, ui32 group, size_t count, Entity* outEntities, const Initialize& initialize,
+			ThreadPool* threadPool = nullptr);
+		void create(ComponentMask mask, ui32 group, size_t count, Entity* outEntities = nullptr);
+		Entity create(ComponentMask mask, ui32 group = 0);
+
+		// false for null or stale handles
+		bool destroy(Entity entity);
+		void clear();
+		bool contains(Entity entity) const noexcept;
+
+		// nullptr for stale handles and entities without a T; the non-const one marks the chunk as written
+		template <typename T> T* get(Entity entity);
+		template <typename T> const T* get(Entity entity) const;
+		template <typename T> bool has(Entity entity) const noexcept;
+
+		// structural changes move the entity to another archetype, components both have keep their values
+		template <typename T> void add(Entity entity, const T& value = {});
+		template <typename T> void remove(Entity entity);
+		void setComponents(Entity entity, ComponentMask mask);
+		void setGroup(Entity entity, ui32 group);
+
+		ComponentMask getComponents(Entity entity) const;
+		ui32 getGroup(Entity entity) const;
+		// slots are below getSlotCapacity() and reused after destroy
+		static ui32 getSlot(Entity entity) noexcept { return entity.id - 1; }
+		ui32 getSlotCapacity() const noexcept { return static_cast<ui32>(m_slots.size()); }
+
+		// fn(EntityChunk&) for every non-empty chunk whose archetype has all components in required,
+		// in archetype creation order; with a thread pool the chunks run in parallel
+		template <typename Function>
+		void forEachChunk(ComponentMask required, const Function& fn, ThreadPool* threadPool = nullptr);
+		// same, limited to one group
+		template <typename Function>
+		void forEachChunk(ComponentMask required, ui32 group, const Function& fn);
+
+		size_t size() const noexcept { return m_entityCount; }
+		size_t getChunkCount() const noexcept;
+		// bumped by every write access and structural change
+		ui64 getVersion() const noexcept { return m_version; }
+		// bumped when entities are created, destroyed or change archetype, for side structures that sweep stale entries
+		ui64 getStructureVersion() const noexcept { return m_structureVersion; }
+
+	private:
+		friend class EntityChunk;
+
+		struct Chunk
+		{
+			alignas(64) unsigned char bytes[ChunkBytes];
+			ui32 count{};
+			ui64 version{};
+		};
+
+		struct Archetype
+		{
+			ComponentMask mask{};
+			ui32 group{};
+			ui32 capacity{};                        // rows per chunk
+			ui32 offsets[MaxComponents]{};          // byte offset of every component's array, entities sit at 0
+			std::vector<ui32> components{};         // ids in mask, ascending
+			std::vector<std::unique_ptr<Chunk>> chunks{};
+			size_t size{};
+		};
+
+		struct Slot
+		{
+			ui32 archetype{};
+			ui32 chunk{};
+			ui32 row{};
+			ui32 generation{};
+		};
+
+		struct ArchetypeKey
+		{
+			ComponentMask mask{};
+			ui32 group{};
+			bool operator==(const ArchetypeKey&) const = default;
+		};
+
+		struct ArchetypeKeyHash
+		{
+			size_t operator()(const ArchetypeKey& key) const noexcept
+			{
+				return std::hash<ComponentMask>{}(key.mask ^ (static_cast<ComponentMask>(key.group) * 0x9E3779B97F4A7C15ull));
+			}
+		};
+
+		struct ComponentInfo
+		{
+			ui32 size{};
+			ui32 alignment{};
+			const void* defaultValue{};
+		};
+
+		// rows of one chunk a task works on
+		struct Range
+		{
+			ui32 archetype{};
+			Chunk* chunk{};
+			ui32 firstRow{};
+			ui32 rowCount{};
+			size_t firstIndex{};
+		};
+
+		template <typename T>
+		static inline const T DefaultValue{};
+
+		static ui32 registerComponent(size_t size, size_t alignment, const void* defaultValue);
+		static ComponentInfo& getComponentInfo(ui32 id) noexcept;
+
+		ui32 getArchetype(ComponentMask mask, ui32 group);
+		// appends count default rows, handles included, and returns the chunk ranges they ended up in
+		void appendRows(ui32 archetype, size_t count, Entity* outEntities, std::vector<Range>& outRanges);
+		void removeRow(ui32 archetype, ui32 chunk, ui32 row);
+		void moveEntity(Entity entity, ComponentMask mask, ui32 group);
+		const Slot& getLiveSlot(Entity entity) const;
+		void* getComponent(const Slot& slot, ui32 id) const noexcept;
+		// task once per range, on the thread pool when there is one and more than one range
+		void runRanges(const std::vector<Range>& ranges, const std::function<void(EntityChunk&, const Range&)>& task,
+			ThreadPool* threadPool);
+
+	private:
+		std::vector<Archetype> m_archetypes{};
+		std::unordered_map<ArchetypeKey, ui32, ArchetypeKeyHash> m_archetypeLookup{};
+		std::vector<Slot> m_slots{};
+		std::vector<ui32> m_freeSlots{};
+		size_t m_entityCount{};
+		ui64 m_version{ 1 };
+		ui64 m_structureVersion{ 1 };
+	};
+
+	// a view of one chunk while it is being iterated: row i of every array belongs to getEntities()[i]
+	class EntityChunk final
+	{
+	public:
+		ui32 size() const noexcept { return m_chunk->count; }
+		ui32 getGroup() const noexcept { return m_archetype->group; }
+		ComponentMask getComponents() const noexcept { return m_archetype->mask; }
+		// the store version of the last write to the chunk
+		ui64 getVersion() const noexcept { return m_chunk->version; }
+		const Entity* getEntities() const noexcept { return reinterpret_cast<const Entity*>(m_chunk->bytes); }
+
+		// the array of T, nullptr when the archetype has none; write marks the chunk as changed
+		template <typename T>
+		T* write() noexcept
+		{
+			const auto id = EntityStore::getComponentId<T>();
+			if (!(m_archetype->mask & (ComponentMask{ 1 } << id))) return nullptr;
+			m_chunk->version = m_writeVersion;
+			return reinterpret_cast<T*>(m_chunk->bytes + m_archetype->offsets[id]);
+		}
+
+		template <typename T>
+		const T* read() const noexcept
+		{
+			const auto id = EntityStore::getComponentId<T>();
+			if (!(m_archetype->mask & (ComponentMask{ 1 } << id))) return nullptr;
+			return reinterpret_cast<const T*>(m_chunk->bytes + m_archetype->offsets[id]);
+		}
+
+	private:
+		friend class EntityStore;
+
+		EntityChunk(const EntityStore::Archetype& archetype, EntityStore::Chunk& chunk, ui64 writeVersion) noexcept :
+			m_archetype(&archetype), m_chunk(&chunk), m_writeVersion(writeVersion)
+		{
+		}
+
+	private:
+		const EntityStore::Archetype* m_archetype{};
+		EntityStore::Chunk* m_chunk{};
+		ui64 m_writeVersion{};
+	};
+
+	template <typename Initialize>
+	void EntityStore::create(ComponentMask mask, ui32 group, size_t count, Entity* outEntities, const Initialize& initialize,
+		ThreadPool* threadPool)
+	{
+		if (!count) return;
+
+		const auto archetype = getArchetype(mask, group);
+		std::vector<Range> ranges;
+		appendRows(archetype, count, outEntities, ranges);
+		runRanges(ranges, [&](EntityChunk& chunk, const Range& range)
+			{
+				initialize(chunk, range.firstRow, range.rowCount, range.firstIndex);
+			}, threadPool);
+	}
+
+	template <typename T>
+	T* EntityStore::get(Entity entity)
+	{
+		if (!contains(entity)) return nullptr;
+		const auto& slot = m_slots[getSlot(entity)];
+		auto* component = static_cast<T*>(getComponent(slot, getComponentId<T>()));
+		if (component)
+			m_archetypes[slot.archetype].chunks[slot.chunk]->version = ++m_version;
+		return component;
+	}
+
+	template <typename T>
+	const T* EntityStore::get(Entity entity) const
+	{
+		if (!contains(entity)) return nullptr;
+		return static_cast<const T*>(getComponent(m_slots[getSlot(entity)], getComponentId<T>()));
+	}
+
+	template <typename T>
+	bool EntityStore::has(Entity entity) const noexcept
+	{
+		return contains(entity) && (m_archetypes[m_slots[getSlot(entity)].archetype].mask & getMask<T>());
+	}
+
+	template <typename T>
+	void EntityStore::add(Entity entity, const T& value)
+	{
+		const auto& slot = getLiveSlot(entity);
+		moveEntity(entity, m_archetypes[slot.archetype].mask | getMask<T>(), m_archetypes[slot.archetype].group);
+		*get<T>(entity) = value;
+	}
+
+	template <typename T>
+	void EntityStore::remove(Entity entity)
+	{
+		const auto& slot = getLiveSlot(entity);
+		moveEntity(entity, m_archetypes[slot.archetype].mask & ~getMask<T>(), m_archetypes[slot.archetype].group);
+	}
+
+	template <typename Function>
+	void EntityStore::forEachChunk(ComponentMask required, const Function& fn, ThreadPool* threadPool)
+	{
+		const auto writeVersion = ++m_version;
+		if (!threadPool)
+		{
+			for (auto& archetype : m_archetypes)
+			{
+				if ((archetype.mask & required) != required) continue;
+				for (auto& chunk : archetype.chunks)
+				{
+					EntityChunk view{ archetype, *chunk, writeVersion };
+					fn(view);
+				}
+			}
+			return;
+		}
+
+		// one task per chunk of everything that matches
+		std::vector<Range> ranges;
+		for (ui32 i = 0; i < m_archetypes.size(); i++)
+		{
+			if ((m_archetypes[i].mask & required) != required) continue;
+			for (auto& chunk : m_archetypes[i].chunks)
+				ranges.push_back({ i, chunk.get(), 0, chunk->count });
+		}
+		runRanges(ranges, [&](EntityChunk& chunk, const Range&) { fn(chunk); }, threadPool);
+	}
+
+	template <typename Function>
+	void EntityStore::forEachChunk(ComponentMask required, ui32 group, const Function& fn)
+	{
+		const auto writeVersion = ++m_version;
+		for (auto& archetype : m_archetypes)
+		{
+			if (archetype.group != group || (archetype.mask & required) != required) continue;
+			for (auto& chunk : archetype.chunks)
+			{
+				EntityChunk view{ archetype, *chunk, writeVersion };
+				fn(view);
+			}
+		}
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <DX3D/Core/Base.h>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <thread>
+
+namespace dx3d
+{
+	// what beginFrame decided for the frame about to be rendered
+	struct FrameTiming
+	{
+		ui64 frameIndex{};
+		d64 time{};                 // scheduler clock at the start of the frame, in seconds
+		d64 frameSeconds{};         // since the previous frame started
+		ui32 simulationSteps{};     // fixed steps to run before rendering, always 0 with a simulation thread
+		d64 firstStepTime{};        // scheduler clock the first of them was due at, step i at + i * simulation step
+		f32 interpolation{};        // [0, 1] from the last completed step towards the next one
+	};
+
+	struct FrameSchedulerStats
+	{
+		ui64 frames{};
+		ui64 simulationSteps{};
+		ui64 droppedSteps{};        // simulated time given up after stalls, in steps
+		d64 idleSeconds{};          // spent waiting by the render thread for the frame cap
+	};
+
+	// a fixed step's state and the one before it, published by the simulation and interpolated by the renderer
+	template <typename State>
+	struct SimulationSnapshot
+	{
+		State previous{};
+		State current{};
+		ui64 tick{};
+		d64 time{};                 // scheduler clock when current was completed, see FrameScheduler::getInterpolation
+	};
+
+	/*
+	* Fixed-timestep simulation with frame pacing (the accumulator loop from "Fix Your Timestep!").
+	* Inline, beginFrame returns how many fixed steps are due and how far to interpolate past the last one.
+	* With startSimulationThread the steps run on their own thread at the fixed rate instead, publishing
+	* SimulationSnapshots (through a TripleBuffer) that the render thread interpolates; rendering is then
+	* one step behind the simulation.
+	* Both threads wait with the configured pacing: Sleep sleeps in 1 ms slices while the remaining time is
+	* above the measured oversleep (mean + deviation, which adapts to the OS timer granularity) and yields
+	* the rest, so a 60 Hz cap costs almost no CPU and still lands within a fraction of a millisecond.
+	*/
+	class FrameScheduler final : public Base
+	{
+	public:
+		// called for every fixed step with its length in seconds, its index and the scheduler clock it was due at,
+		// which is what a SimulationSnapshot published from it should carry as its time
+		using SimulationFunction = std::function<void(d64 step, ui64 tick, d64 stepTime)>;
+
+		explicit FrameScheduler(const FrameSchedulerDesc& desc);
+		virtual ~FrameScheduler() override;
+
+		// render thread, once per frame: waits out the frame cap, then accounts for the elapsed time.
+		// Rethrows what the simulation thread threw, after stopping it.
+		FrameTiming beginFrame();
+
+		void startSimulationThread(SimulationFunction simulate);
+		// waits for the step in progress, beginFrame goes back to returning the steps
+		void stopSimulationThread();
+		bool isSimulationThreaded() const noexcept;
+
+		// seconds since the scheduler was created, or the clock of the description
+		d64 now() const noexcept;
+		// how far the renderer is past the step completed at stepTime, for interpolating a snapshot
+		f32 getInterpolation(d64 stepTime) const noexcept;
+
+		d64 getSimulationStep() const noexcept;
+		void setFrameRateCap(d64 framesPerSecond) noexcept;
+		FrameSchedulerStats getStats() const noexcept;
+
+	private:
+		// running oversleep statistics of one waiting thread
+		struct SleepEstimate
+		{
+			d64 estimate{ 0.005 };
+			d64 mean{ 0.005 };
+			d64 m2{};
+			ui64 count{ 1 };
+		};
+
+		// returns the seconds spent waiting
+		d64 waitUntil(d64 deadline, SleepEstimate& sleepEstimate) const;
+		void simulationLoop(SimulationFunction simulate);
+
+	private:
+		const d64 m_simulationStep{};
+		const ui32 m_maxStepsPerFrame{};
+		const FramePacing m_pacing{};
+		const std::chrono::steady_clock::time_point m_start{};
+		const std::function<d64()> m_clock{};
+
+		d64 m_framePeriod{};
+		d64 m_nextFrameTime{};
+		d64 m_lastFrameTime{};
+		d64 m_accumulator{};
+		ui64 m_frameIndex{};
+		SleepEstimate m_frameSleep{};
+		FrameSchedulerStats m_stats{};
+
+		std::thread m_simulationThread{};
+		std::atomic<bool> m_stopSimulation{};
+		std::atomic<ui64> m_threadSteps{};
+		std::atomic<ui64> m_threadDroppedSteps{};
+		std::atomic<d64> m_lastStepTime{};
+		std::exception_ptr m_simulationError{};     // written by the simulation thread before it exits
+		std::atomic<bool> m_simulationFailed{};
+	};
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <cstddef>
+
+namespace dx3d
+{
+	namespace Hash
+	{
+		constexpr ui64 FnvOffsetBasis = 14695981039346656037ull;
+		constexpr ui64 FnvPrime = 1099511628211ull;
+
+		// 64-bit FNV-1a, used to key content-addressed caches
+		inline ui64 HashBytes(const void* data, size_t size, ui64 seed = FnvOffsetBasis) noexcept
+		{
+			auto bytes = static_cast<const unsigned char*>(data);
+			ui64 hash = seed;
+			for (size_t i = 0; i < size; i++)
+			{
+				hash ^= bytes[i];
+				hash *= FnvPrime;
+			}
+			return hash;
+		}
+
+		template <typename T>
+		inline ui64 HashValue(const T& value, ui64 seed = FnvOffsetBasis) noexcept
+		{
+			return HashBytes(&value, sizeof(T), seed);
+		}
+
+		inline ui64 Combine(ui64 seed, ui64 value) noexcept
+		{
+			return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include <DX3D/Core/Logger.h>
+#include <fstream>
+#include <string>
+
+namespace dx3d
+{
+    /*
+    * Destination of formatted log lines.
+    * A logger calls its sinks from one thread at a time: the writer thread when asynchronous,
+    * otherwise the logging thread under the logger's lock. Sinks need no locking of their own
+    * unless they are shared between loggers.
+    */
+    class LogSink
+    {
+    public:
+        virtual ~LogSink() = default;
+
+        // line is the formatted record including its trailing newline, not null terminated
+        virtual void write(Logger::LogLevel level, const char* line, std::size_t length) = 0;
+        virtual void flush() {}
+    };
+
+    // std::clog, what the logger always wrote to
+    class ConsoleLogSink final : public LogSink
+    {
+    public:
+        virtual void write(Logger::LogLevel level, const char* line, std::size_t length) override;
+        virtual void flush() override;
+    };
+
+    class FileLogSink final : public LogSink
+    {
+    public:
+        explicit FileLogSink(const std::string& path, bool append = false);
+
+        bool isOpen() const noexcept;
+
+        virtual void write(Logger::LogLevel level, const char* line, std::size_t length) override;
+        virtual void flush() override;
+
+    private:
+        std::ofstream m_file;
+    };
+}
@@ -1,7 +1,13 @@
 #pragma once
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace dx3d
 {
+    class LogSink;
+
     class Logger final
     {
     public:
@@ -12,10 +18,39 @@ namespace dx3d
             Info
         };
 
+        // what an asynchronous logger does when its queue is full
+        enum class OverflowPolicy
+        {
+            Block = 0,  // wait for the writer thread to make room
+            Drop        // drop (and count) info and warnings, errors still wait
+        };
+
+        struct LoggerDesc
+        {
+            LogLevel logLevel = LogLevel::Error;
+            bool async = false;                                 // format and write on a background thread
+            std::size_t queueCapacity = 4096;                   // records, rounded up to a power of two
+            OverflowPolicy overflowPolicy = OverflowPolicy::Drop;
+            std::vector<std::shared_ptr<LogSink>> sinks{};      // empty = console
+        };
+
+        // longest message an asynchronous record keeps, longer ones are truncated
+        static constexpr std::size_t MaxRecordMessageLength = 240;
+
         explicit Logger(LogLevel logLevel = LogLevel::Error);
+        explicit Logger(const LoggerDesc& desc);
         ~Logger();
 
+        // checked by DX3DLog before the message is built
+        bool isEnabled(LogLevel level) const noexcept { return level <= m_logLevel; }
+
         void log(LogLevel level, const char* message);
+        // blocks until everything logged so far reached the sinks
+        void flush();
+        // records an asynchronous logger threw away because its queue was full
+        unsigned long long getDroppedCount() const noexcept;
+
+        static const char* GetLogLevelName(LogLevel level) noexcept;
 
     protected:
         Logger(const Logger&) = delete;
@@ -23,16 +58,27 @@ namespace dx3d
         Logger& operator = (const Logger&) = delete;
         Logger& operator=(Logger&&) = delete;
 
+    private:
+        struct AsyncQueue;
+
+        void write(LogLevel level, const char* message, std::size_t length);
+
     private:
         LogLevel m_logLevel = LogLevel::Error;
+        std::vector<std::shared_ptr<LogSink>> m_sinks{};
+        std::mutex m_sinkMutex{};                   // synchronous mode only, the writer thread owns the sinks otherwise
+        std::unique_ptr<AsyncQueue> m_async{};
     };
 }
 
 #define DX3DLog(logger, type, message)\
-logger.log((type), message)
+do {\
+auto& dx3dLogger = (logger);\
+if (dx3dLogger.isEnabled(type)) dx3dLogger.log((type), message);\
+} while (0)
 
 #define DX3DLogThrow(logger, exception, type, message)\
 {\
 DX3DLog(logger,type,message);\
 throw exception(message);\
-}
\ No newline at end of file
+}
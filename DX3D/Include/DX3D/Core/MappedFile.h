@@ -0,0 +1,39 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <cstddef>
+#include <filesystem>
+
+namespace dx3d
+{
+	/*
+	* Read-only view of a whole file through the OS file mapping, nothing is read or copied up front:
+	* pages come in from the file cache when they are first touched. The view stays valid while the
+	* MappedFile is open, the mapping keeps the file alive even if other handles to it are closed.
+	* The mapping itself lives in the platform sources (Win32/Win32MappedFile.cpp, Posix/PosixMappedFile.cpp for the tests).
+	*/
+	class MappedFile final
+	{
+	public:
+		MappedFile() = default;
+		// check isOpen() afterwards
+		explicit MappedFile(const std::filesystem::path& path);
+		~MappedFile();
+
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		// closes the current view first, false for missing and empty files (there is nothing to map)
+		bool open(const std::filesystem::path& path);
+		void close() noexcept;
+
+		bool isOpen() const noexcept { return m_data != nullptr; }
+		const unsigned char* data() const noexcept { return m_data; }
+		size_t size() const noexcept { return m_size; }
+
+	private:
+		const unsigned char* m_data{};
+		size_t m_size{};
+	};
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dx3d
+{
+	struct ProfilerFrameStats
+	{
+		ui64 frameCount{};  // frames in the sampled window
+		d64 minMs{};
+		d64 avgMs{};
+		d64 p99Ms{};
+		d64 maxMs{};
+	};
+
+	/*
+	* CPU profiler: scoped zones are written into a ring buffer owned by the recording thread,
+	* so recording never takes a lock. Only the newest events of each thread are kept.
+	* While disabled a zone costs one relaxed atomic load; define DX3D_DISABLE_PROFILER to compile them out.
+	* Zone names are stored by pointer and must outlive the profiler (string literals).
+	*/
+	class Profiler final
+	{
+	public:
+		struct Event
+		{
+			const char* name{};
+			ui64 startNs{};
+			ui64 endNs{};
+		};
+
+		class ScopedZone
+		{
+		public:
+			explicit ScopedZone(const char* name) noexcept;
+			~ScopedZone();
+
+			ScopedZone(const ScopedZone&) = delete;
+			ScopedZone& operator=(const ScopedZone&) = delete;
+
+		private:
+			const char* m_name{};
+			ui64 m_startNs{};  // 0 = profiler was disabled when the zone was entered
+		};
+
+		static constexpr size_t EventsPerThread = 1 << 16;
+		static constexpr size_t FrameHistorySize = 4096;
+
+		static Profiler& get() noexcept;
+		static ui64 now() noexcept;
+
+		void setEnabled(bool enabled) noexcept;
+		bool isEnabled() const noexcept;
+
+		// names the calling thread in the exported trace; while disabled only the name is kept, the thread's
+		// event ring is allocated by its first recorded event
+		void setThreadName(const char* name);
+		// drops the event if the thread's ring cannot be allocated
+		void record(const char* name, ui64 startNs, ui64 endNs) noexcept;
+
+		// call once per frame on the frame boundary, the time between two marks is one frame
+		void markFrame() noexcept;
+		ProfilerFrameStats getFrameStats() const;
+
+		// Chrome trace-event JSON (chrome://tracing, Perfetto); best called between frames
+		bool exportChromeTrace(const std::filesystem::path& path) const;
+		void reset();
+
+	private:
+		struct ThreadBuffer
+		{
+			ui32 threadId{};
+			std::string name{};
+			std::vector<Event> events{};
+			std::atomic<ui64> written{};
+		};
+
+		Profiler();
+		ThreadBuffer& getThreadBuffer();
+
+	private:
+		std::atomic<bool> m_enabled{};
+		const ui64 m_epochNs{};
+
+		mutable std::mutex m_threadsMutex{};
+		std::vector<std::unique_ptr<ThreadBuffer>> m_threads{};
+
+		mutable std::mutex m_framesMutex{};
+		std::vector<d64> m_frameTimesMs{};
+		size_t m_frameCursor{};
+		ui64 m_lastFrameNs{};
+	};
+}
+
+#define DX3DProfileConcatInner(a, b) a##b
+#define DX3DProfileConcat(a, b) DX3DProfileConcatInner(a, b)
+
+#ifndef DX3D_DISABLE_PROFILER
+#define DX3DProfileZone(name)\
+	dx3d::Profiler::ScopedZone DX3DProfileConcat(dx3dProfileZone, __LINE__)(name)
+#define DX3DProfileFrame()\
+	dx3d::Profiler::get().markFrame()
+#else
+#define DX3DProfileZone(name)
+#define DX3DProfileFrame()
+#endif
@@ -0,0 +1,116 @@
+#pragma once
+#include <DX3D/Core/SlotMap.h>
+#include <DX3D/Math/Mat4.h>
+#include <vector>
+
+namespace dx3d
+{
+	struct SceneGraphStats
+	{
+		ui32 nodes{};
+		ui32 recomputed{};      // world matrices the last update() computed
+		ui32 levels{};          // depth of the deepest node + 1
+		bool sorted{};          // the last update() had to restore the breadth-first order first
+		bool parallel{};        // and split at least one level over the thread pool
+	};
+
+	/*
+	* Transform hierarchy: every node has a local matrix relative to its parent and a world matrix,
+	* world = local * parent world (row vectors, the child's transform applies first).
+	* The nodes live in flat arrays sorted breadth first, so every level is one contiguous range and every
+	* parent sits before its children; update() is then a single pass over the arrays, no recursion.
+	* Changing a local matrix only flags the node; update() recomputes the flagged nodes and everything
+	* below them and nothing else. The flag travels down through the pass itself: a node is recomputed
+	* when it was flagged or its parent was recomputed in the same pass.
+	* Nodes in one level do not depend on each other, so levels with a lot to recompute are split over
+	* the thread pool.
+	* Adding nodes deep in the tree, reparenting and removing move nodes around in the arrays, which is
+	* O(nodes); adds and reparents only mark the order stale and the next update() restores it once.
+	* A node can carry an Entity, which the graph never touches; SceneRenderer writes the world matrices
+	* of the recomputed nodes into their shapes.
+	*/
+	class SceneGraph final
+	{
+	public:
+		// a level expected to recompute fewer nodes than this stays on the calling thread
+		static constexpr ui32 ParallelThreshold = 2048;
+
+		// a null parent makes a root
+		SceneNode createNode(SceneNode parent = {}, const Mat4& local = Mat4::identity(), Entity entity = {});
+		// removes the node and everything below it
+		void removeNode(SceneNode node);
+		void clear();
+		bool contains(SceneNode node) const noexcept;
+
+		// throws for a parent inside the node's own subtree
+		void setParent(SceneNode node, SceneNode parent);
+		SceneNode getParent(SceneNode node) const;
+
+		void setLocal(SceneNode node, const Mat4& local);
+		const Mat4& getLocal(SceneNode node) const;
+		// as of the last update()
+		const Mat4& getWorld(SceneNode node) const;
+
+		void setEntity(SceneNode node, Entity entity);
+		Entity getEntity(SceneNode node) const;
+
+		// brings the world matrices of all flagged nodes and their subtrees up to date
+		void update(ThreadPool* threadPool = nullptr);
+		const SceneGraphStats& getStats() const noexcept;
+
+		// fn(entity, world) for every node with an entity whose world matrix the last update() changed
+		template <typename Function>
+		void forEachRecomputed(const Function& fn) const
+		{
+			if (!m_stats.recomputed) return;
+			for (size_t i = 0; i < m_worlds.size(); i++)
+			{
+				if (m_recomputedAt[i] == m_updateIndex && m_entities[i])
+					fn(m_entities[i], m_worlds[i]);
+			}
+		}
+
+		size_t size() const noexcept { return m_worlds.size(); }
+
+	private:
+		static constexpr ui32 NoParent = ~0u;
+		// nodes of one level a task recomputes
+		static constexpr ui32 BlockSize = 512;
+
+		struct Slot
+		{
+			ui32 index{};
+			ui32 generation{};
+		};
+
+		ui32 getIndex(SceneNode node) const;
+		void markDirty(ui32 index) noexcept;
+		// rebuilds the arrays in breadth-first order from the parent links, O(nodes)
+		void sortBreadthFirst();
+		// recomputes the flagged nodes and their descendants among [first, last), returns how many
+		ui32 updateRange(ui32 first, ui32 last) noexcept;
+		// moves node i of every array to newIndex[i], dropping the ones mapped to NoParent
+		void permute(const std::vector<ui32>& newIndex, ui32 newSize);
+
+	private:
+		// by index, breadth-first order
+		std::vector<Mat4> m_locals{};
+		std::vector<Mat4> m_worlds{};
+		std::vector<ui32> m_parents{};              // index of the parent, NoParent for roots
+		std::vector<ui32> m_depths{};
+		std::vector<unsigned char> m_dirty{};       // local changed since the last update
+		std::vector<ui64> m_recomputedAt{};         // m_updateIndex of the update that last computed the world
+		std::vector<Entity> m_entities{};
+		std::vector<ui32> m_indexSlots{};           // slot of the node at an index
+
+		std::vector<Slot> m_slots{};
+		std::vector<ui32> m_freeSlots{};
+		std::vector<ui32> m_levelStarts{};          // index of the first node of every level, plus the end
+		ui32 m_dirtyCount{};
+		ui32 m_firstDirtyLevel{ ~0u };              // shallowest and deepest flagged node, while the order is not stale
+		ui32 m_lastDirtyLevel{};
+		ui64 m_updateIndex{ 1 };
+		bool m_orderStale{};
+		SceneGraphStats m_stats{};
+	};
+}
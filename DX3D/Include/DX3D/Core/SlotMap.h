@@ -0,0 +1,132 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <utility>
+#include <vector>
+
+namespace dx3d
+{
+	// slot + generation, goes stale once its element is removed even if the slot is reused later
+	template <typename Tag>
+	struct GenerationalHandle
+	{
+		ui32 id{};              // slot + 1, 0 = null
+		ui32 generation{};
+		explicit operator bool() const noexcept { return id != 0; }
+		bool operator==(const GenerationalHandle&) const = default;
+	};
+
+	/*
+	* Elements packed in one dense array, handed out as generational handles.
+	* A handle points at a slot, the slot points into the dense array; removing an element moves the
+	* last one into its place, so insert, remove and lookup are O(1) and the dense array never has gaps.
+	* Dense indices change on removal, only handles are stable.
+	*/
+	template <typename T, typename Handle>
+	class SlotMap final
+	{
+	public:
+		Handle insert(T value)
+		{
+			ui32 slot{};
+			if (m_freeSlots.empty())
+			{
+				slot = static_cast<ui32>(m_slots.size());
+				m_slots.push_back({});
+			}
+			else
+			{
+				slot = m_freeSlots.back();
+				m_freeSlots.pop_back();
+			}
+
+			m_slots[slot].denseIndex = static_cast<ui32>(m_dense.size());
+			m_dense.push_back(std::move(value));
+			m_denseSlots.push_back(slot);
+			return { slot + 1, m_slots[slot].generation };
+		}
+
+		// false for null or stale handles
+		bool remove(Handle handle)
+		{
+			if (!contains(handle)) return false;
+
+			const auto slot = handle.id - 1;
+			const auto index = m_slots[slot].denseIndex;
+			const auto last = static_cast<ui32>(m_dense.size() - 1);
+			if (index != last)
+			{
+				m_dense[index] = std::move(m_dense[last]);
+				m_denseSlots[index] = m_denseSlots[last];
+				m_slots[m_denseSlots[index]].denseIndex = index;
+			}
+			m_dense.pop_back();
+			m_denseSlots.pop_back();
+
+			m_slots[slot].generation++;
+			m_freeSlots.push_back(slot);
+			return true;
+		}
+
+		void clear()
+		{
+			for (const auto slot : m_denseSlots)
+			{
+				m_slots[slot].generation++;
+				m_freeSlots.push_back(slot);
+			}
+			m_dense.clear();
+			m_denseSlots.clear();
+		}
+
+		void reserve(size_t capacity)
+		{
+			m_dense.reserve(capacity);
+			m_denseSlots.reserve(capacity);
+		}
+
+		bool contains(Handle handle) const noexcept
+		{
+			return handle.id && handle.id <= m_slots.size() && m_slots[handle.id - 1].generation == handle.generation;
+		}
+
+		// nullptr for null or stale handles
+		T* get(Handle handle) noexcept { return contains(handle) ? &m_dense[m_slots[handle.id - 1].denseIndex] : nullptr; }
+		const T* get(Handle handle) const noexcept { return contains(handle) ? &m_dense[m_slots[handle.id - 1].denseIndex] : nullptr; }
+
+		// where the element sits in the dense array right now, the handle has to be valid
+		ui32 getDenseIndex(Handle handle) const noexcept { return m_slots[handle.id - 1].denseIndex; }
+		// slots stay put for the element's lifetime, so side structures (a BVH, ...) can key on them
+		static ui32 getSlot(Handle handle) noexcept { return handle.id - 1; }
+		ui32 getSlotDenseIndex(ui32 slot) const noexcept { return m_slots[slot].denseIndex; }
+		Handle getHandle(size_t denseIndex) const noexcept
+		{
+			const auto slot = m_denseSlots[denseIndex];
+			return { slot + 1, m_slots[slot].generation };
+		}
+
+		size_t size() const noexcept { return m_dense.size(); }
+		bool empty() const noexcept { return m_dense.empty(); }
+
+		T* data() noexcept { return m_dense.data(); }
+		const T* data() const noexcept { return m_dense.data(); }
+		T& operator[](size_t denseIndex) noexcept { return m_dense[denseIndex]; }
+		const T& operator[](size_t denseIndex) const noexcept { return m_dense[denseIndex]; }
+
+		auto begin() noexcept { return m_dense.begin(); }
+		auto end() noexcept { return m_dense.end(); }
+		auto begin() const noexcept { return m_dense.begin(); }
+		auto end() const noexcept { return m_dense.end(); }
+
+	private:
+		struct Slot
+		{
+			ui32 denseIndex{};
+			ui32 generation{};
+		};
+
+		std::vector<T> m_dense{};
+		std::vector<ui32> m_denseSlots{};       // slot of every dense element, to fix up the moved one on removal
+		std::vector<Slot> m_slots{};
+		std::vector<ui32> m_freeSlots{};
+	};
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <DX3D/Core/Base.h>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dx3d
+{
+	struct ThreadPoolDesc
+	{
+		BaseDesc base;
+		ui32 workerCount{ ~0u };   // ~0u = one per hardware thread, minus the calling thread
+	};
+
+	/*
+	* Fixed set of worker threads for fork/join work.
+	* parallelFor hands out indices to the workers and the calling thread and returns once all of them ran.
+	* Nested calls (from inside a task) run serially on the calling thread instead of deadlocking.
+	* The first exception thrown by a task is rethrown on the caller after the batch finished.
+	*/
+	class ThreadPool final : public Base
+	{
+	public:
+		explicit ThreadPool(const ThreadPoolDesc& desc);
+		virtual ~ThreadPool() override;
+
+		// workers + the calling thread
+		ui32 getThreadCount() const noexcept;
+
+		void parallelFor(ui32 count, const std::function<void(ui32 index)>& task);
+
+	private:
+		void workerLoop(ui32 workerIndex);
+		void runTasks();
+
+	private:
+		std::vector<std::thread> m_workers{};
+
+		std::mutex m_submitMutex{};
+		std::mutex m_mutex{};
+		std::condition_variable m_wake{};
+		std::condition_variable m_done{};
+
+		const std::function<void(ui32)>* m_task{};
+		ui32 m_count{};
+		std::atomic<ui32> m_next{};
+		ui32 m_completed{};
+		ui32 m_active{};
+		ui64 m_generation{};
+		bool m_stopping{};
+		std::exception_ptr m_error{};
+	};
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <atomic>
+
+namespace dx3d
+{
+	/*
+	* Lock-free hand-off of the newest value from one writer thread to one reader thread.
+	* The writer fills getWriteBuffer() and publishes it, the reader picks up whatever was published last;
+	* neither side ever waits for the other and a slow reader simply skips values. The three buffers rotate
+	* through the writer, the shared middle slot and the reader, the dirty bit on the middle slot marks a
+	* value the reader has not taken yet.
+	* The write buffer is not cleared on publish, it holds an older value the writer has to overwrite.
+	*/
+	template <typename T>
+	class TripleBuffer final
+	{
+	public:
+		TripleBuffer() = default;
+		TripleBuffer(const TripleBuffer&) = delete;
+		TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+		// writer thread
+		T& getWriteBuffer() noexcept { return m_buffers[m_write]; }
+		void publish() noexcept
+		{
+			m_write = m_middle.exchange(m_write | DirtyBit, std::memory_order_acq_rel) & IndexMask;
+		}
+
+		// reader thread, true when a newer value was taken
+		bool update() noexcept
+		{
+			if (!(m_middle.load(std::memory_order_relaxed) & DirtyBit)) return false;
+			m_read = m_middle.exchange(m_read, std::memory_order_acq_rel) & IndexMask;
+			return true;
+		}
+		const T& read() const noexcept { return m_buffers[m_read]; }
+
+	private:
+		static constexpr ui32 DirtyBit = 4;
+		static constexpr ui32 IndexMask = 3;
+
+		T m_buffers[3]{};
+		ui32 m_write{ 0 };
+		std::atomic<ui32> m_middle{ 1 };
+		ui32 m_read{ 2 };
+	};
+}
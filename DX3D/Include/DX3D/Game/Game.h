@@ -1,6 +1,8 @@
 #pragma once
 #include <DX3D/Core/Base.h>
 #include <DX3D/Core/Core.h>
+#include <DX3D/Core/FrameScheduler.h>
+#include <string>
 
 namespace dx3d {
 	class Game : public Base
@@ -11,6 +13,16 @@ namespace dx3d {
 
 		virtual void run() final;
 
+	protected:
+		// one fixed simulation step, on the simulation thread when GameDesc::simulationThread is set: share state
+		// with onFrame through a TripleBuffer of SimulationSnapshots then, never through the graphics engine
+		virtual void onFixedUpdate(d64 /*step*/, ui64 /*tick*/, d64 /*stepTime*/) {}
+		// render thread, after the frame's fixed steps and before it is drawn
+		virtual void onFrame(const FrameTiming& /*timing*/) {}
+
+		GraphicsEngine& getGraphicsEngine() noexcept;
+		FrameScheduler& getFrameScheduler() noexcept;
+
 	private:
 		void onInternalUpdate();
 
@@ -18,7 +30,12 @@ namespace dx3d {
 		std::unique_ptr<Logger> m_loggerPtr{};
 		std::unique_ptr<GraphicsEngine> m_graphicsEngine{};
 		std::unique_ptr<Display> m_display{};
+		std::unique_ptr<FrameScheduler> m_frameScheduler{};
+		bool m_simulationThread{};
+		bool m_logStatistics{};
+		ui64 m_simulationTick{};
 		bool m_isRunning{ true };
+		std::string m_profilerTracePath{};
 	};
 
 }
@@ -0,0 +1,12 @@
+#pragma once
+
+namespace dx3d
+{
+	// what a backend buffer is bound as
+	enum class BufferType
+	{
+		Vertex = 0,
+		Index,      // always 32-bit indices
+		Constant
+	};
+}
@@ -1,8 +1,13 @@
 #pragma once
 
-#include <DX3D/Graphics/GraphicsResource.h>
-#include <DX3D/Graphics/Shader.h>
-#include <memory>
+#include <DX3D/Core/Base.h>
+#include <DX3D/Graphics/GraphicsTypes.h>
+#include <DX3D/Graphics/VertexEncoding.h>
+#include <DX3D/Graphics/MeshOptimizer.h>
+#include <DX3D/Graphics/MeshSimplifier.h>
+#include <DX3D/Math/Aabb.h>
+#include <DX3D/Math/Mat4.h>
+#include <filesystem>
 #include <vector>
 
 namespace dx3d
@@ -13,25 +18,75 @@ namespace dx3d
         float r, g, b, a; // Color
     };
 
-    class Mesh : public GraphicsResource
+    // what level selection did over a frame, SceneRenderer resets it in update()
+    struct MeshLodStats
+    {
+        ui64 trianglesDrawn{};
+        ui64 trianglesSaved{};                      // full-detail triangles that coarser levels left out
+        ui32 levelDraws[MaxMeshLodLevels]{};        // draws per level
+    };
+
+    // the camera and screen a Mesh picks its level of detail for
+    struct MeshLodContext
+    {
+        Mat4 viewProjection{};
+        f32 viewportHeight{ 720.0f };               // pixels
+        f32 pixelError{ 1.0f };                     // a level is fine while its error covers at most this many pixels
+        f32 hysteresis{ 0.25f };                    // going coarser needs (1 - hysteresis) * pixelError, so levels do not flicker at the threshold
+        MeshLodStats stats{};
+    };
+
+    class Mesh : public Base
     {
     public:
-        Mesh(const GraphicsResourceDesc& gDesc);
-        virtual ~Mesh() = default;
+        // packed encodings shrink the vertex buffer, Snorm16x4 positions are normalized to each mesh's own bounds
+        Mesh(const BaseDesc& desc, GraphicsBackend& backend, const VertexEncoding& encoding = {});
+        virtual ~Mesh() override;
+
+        // replaces the geometry with a MeshFile, whose encoding and optimized buffers are used as stored
+        void loadFromFile(const std::filesystem::path& path);
+        // replaces the geometry with an OBJ or binary glTF model (MeshImporter), parsed on the thread pool if there is one
+        void importFromFile(const std::filesystem::path& path, ThreadPool* threadPool = nullptr);
 
-        void render(ID3D11DeviceContext& context);
+        // world goes into the ring as this draw's object constants, so call it between the ring's begin() and end(),
+        // which SceneRenderer::submitMesh does; the camera is whatever the queue's frame constants hold
+        // with a lod context the level is picked by screen size (selectLod) and counted in its stats, without one
+        // the full mesh is drawn; lodLevel is the drawn instance's level from its last submit and gets the new one,
+        // one mesh drawn in several places needs one per place or the hysteresis is measured from the wrong level
+        void submit(RenderQueue& queue, ConstantBufferRing& constants, const Mat4& world = Mat4::identity(),
+            MeshLodContext* lod = nullptr, ui32* lodLevel = nullptr) const;
+        // the coarsest level whose error projects to at most the context's pixel error, 0 is the full mesh;
+        // current is the level drawn before, the hysteresis is measured from it
+        ui32 selectLod(const Mat4& world, const MeshLodContext& lod, ui32 current) const noexcept;
+        // level 0 is the full mesh, every level is a range of the one index buffer
+        const std::vector<MeshLodLevel>& getLodLevels() const noexcept;
+        // what welding and reordering did to the last initializeBuffers() input or the loaded file's source
+        const MeshOptimizerStats& getOptimizerStats() const noexcept;
 
     protected:
+        // vertices are a triangle list, welded into an indexed mesh and reordered by MeshOptimizer::Optimize
         void initializeBuffers(const std::vector<Vertex>& vertices);
+        // an indexed triangle list, e.g. from an importer
+        void initializeBuffers(const std::vector<Vertex>& vertices, const std::vector<ui32>& indices);
         void initializeShaders();
+        void releaseBuffers();
+        // encodes and uploads what MeshOptimizer produced, m_optimizerStats describes it; the index buffer
+        // gets the level of detail chain MeshSimplifier builds from it
+        void uploadOptimized(const std::vector<unsigned char>& vertices, const std::vector<ui32>& indices);
 
     protected:
-        Microsoft::WRL::ComPtr<ID3D11Buffer> m_vertexBuffer;
-        Microsoft::WRL::ComPtr<ID3D11InputLayout> m_inputLayout;
-        std::unique_ptr<Shader> m_vertexShader;
-        std::unique_ptr<Shader> m_pixelShader;
-        UINT m_stride;
-        UINT m_offset;
-        UINT m_vertexCount;
+        GraphicsBackend& m_backend;
+        BufferHandle m_vertexBuffer;                    // shared through the backend's immutable buffer cache
+        BufferHandle m_indexBuffer;                     // same
+        PipelineHandle m_pipeline;                      // shared through the backend's pipeline cache
+        VertexEncoding m_encoding;
+        PositionBounds m_bounds;
+        ui32 m_stride;
+        ui32 m_offset;
+        ui32 m_vertexCount;
+        ui32 m_indexCount;                              // of all levels
+        MeshOptimizerStats m_optimizerStats;
+        std::vector<MeshLodLevel> m_lods;
+        Aabb m_localBounds;                             // untransformed positions, for the projected size
     };
 } 
\ No newline at end of file
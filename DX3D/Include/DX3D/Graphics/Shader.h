@@ -1,5 +1,6 @@
 #pragma once
 #include <DX3D/Graphics/GraphicsResource.h>
+#include <DX3D/Graphics/ShaderCache.h>
 #include <string>
 #include <vector>
 
@@ -20,21 +21,24 @@ namespace dx3d
             Type type;
             std::string entryPoint;
             std::string target;
+            std::vector<ShaderMacro> defines{};
         };
 
         explicit Shader(const ShaderDesc& desc);
         ~Shader();
 
-        bool compile(const std::string& source);
+        bool compile(const std::string& source, const char* sourceName = nullptr);
+        bool compile(const char* source, size_t sourceSize, const char* sourceName = nullptr);
+        // the source is compiled straight out of the mapped file, it is never copied into a string
         bool loadFromFile(const std::string& filename);
         
         ID3D11VertexShader* getVertexShader() const { return m_vertexShader.Get(); }
         ID3D11PixelShader* getPixelShader() const { return m_pixelShader.Get(); }
-        const std::vector<BYTE>& getByteCode() const { return m_byteCode; }
+        const ShaderBytecode& getByteCode() const;
 
     private:
         ShaderDesc m_desc;
-        std::vector<BYTE> m_byteCode;
+        ShaderBytecodePtr m_byteCode;                   // shared with every other Shader built from the same source
         Microsoft::WRL::ComPtr<ID3D11VertexShader> m_vertexShader;
         Microsoft::WRL::ComPtr<ID3D11PixelShader> m_pixelShader;
     };
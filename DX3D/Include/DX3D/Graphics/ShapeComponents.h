@@ -0,0 +1,37 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <DX3D/Math/Aabb.h>
+#include <DX3D/Math/Mat4.h>
+#include <DX3D/Math/Vec4.h>
+
+namespace dx3d
+{
+	// the meshes SceneRenderer registers up front, an entity's group in the EntityStore says which one it is drawn as
+	enum class ShapeMesh : ui32
+	{
+		Triangle = 0,
+		Rectangle,
+		Cube
+	};
+
+	/*
+	* What ShapeSystem draws: every entity with all three components is one instance of its group's mesh.
+	* Transform and color are separate arrays in the chunks and go to the GPU as two instance streams,
+	* so a chunk's instances are two memcpys.
+	*/
+	struct TransformComponent
+	{
+		Mat4 world{};           // applied to the mesh's vertices, the first instance stream
+	};
+
+	struct ColorComponent
+	{
+		Vec4 color{ -1.0f, -1.0f, -1.0f, 1.0f };    // the second stream, r < 0 keeps the mesh's vertex colors and only takes the alpha
+	};
+
+	// the mesh's box through the transform, maintained by ShapeSystem::update for culling
+	struct BoundsComponent
+	{
+		Aabb world{};
+	};
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <DX3D/Math/Vec3.h>
+#include <cstddef>
+
+namespace dx3d
+{
+	enum class PositionEncoding
+	{
+		Float3 = 0,     // 12 bytes, as authored
+		Half4,          // 8 bytes, fp16 xyz + w = 1, decoded by the input assembler
+		Snorm16x4       // 8 bytes, 16 bit normalized inside the position bounds, decoded in the vertex shader
+	};
+
+	enum class ColorEncoding
+	{
+		Float4 = 0,     // 16 bytes, as authored
+		Unorm8x4        // 4 bytes, decoded by the input assembler
+	};
+
+	// how the x y z r g b a float vertices (Vertex, ...) are stored on the GPU
+	struct VertexEncoding
+	{
+		PositionEncoding position{ PositionEncoding::Float3 };
+		ColorEncoding color{ ColorEncoding::Float4 };
+
+		ui32 getPositionSize() const noexcept;
+		ui32 getStride() const noexcept;
+		bool isPacked() const noexcept { return position != PositionEncoding::Float3 || color != ColorEncoding::Float4; }
+		bool operator==(const VertexEncoding&) const = default;
+	};
+
+	// box the Snorm16x4 positions are normalized into, position = decoded * extent + center
+	struct PositionBounds
+	{
+		Vec3 center{};
+		Vec3 extent{ 1.0f, 1.0f, 1.0f };
+
+		// tightest box around the positions of count x y z ... vertices, vertexStride bytes apart
+		static PositionBounds FromVertices(const void* vertices, size_t vertexStride, size_t count) noexcept;
+	};
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <DX3D/Math/Vec3.h>
+#include <DX3D/Math/Mat4.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace dx3d
+{
+	// axis aligned box, empty() is inverted (min > max) so the first grow() or merge() snaps it onto something
+	class Aabb
+	{
+	public:
+		Aabb() = default;
+		Aabb(const Vec3& low, const Vec3& high) : min{ low }, max{ high } {}
+
+		static Aabb empty() noexcept
+		{
+			constexpr auto inf = std::numeric_limits<f32>::infinity();
+			return { { inf, inf, inf }, { -inf, -inf, -inf } };
+		}
+
+		// box around count positions pointStride bytes apart, x y z first like in the vertex structs
+		static Aabb fromPoints(const void* points, size_t pointStride, size_t count) noexcept
+		{
+			auto box = empty();
+			for (size_t i = 0; i < count; i++)
+			{
+				Vec3 p;
+				std::memcpy(&p, static_cast<const unsigned char*>(points) + i * pointStride, sizeof(p));
+				box.grow(p);
+			}
+			return box;
+		}
+
+		bool isEmpty() const noexcept { return min.x > max.x || min.y > max.y || min.z > max.z; }
+
+		void grow(const Vec3& p) noexcept
+		{
+			min = { std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z) };
+			max = { std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z) };
+		}
+
+		void merge(const Aabb& b) noexcept
+		{
+			min = { std::min(min.x, b.min.x), std::min(min.y, b.min.y), std::min(min.z, b.min.z) };
+			max = { std::max(max.x, b.max.x), std::max(max.y, b.max.y), std::max(max.z, b.max.z) };
+		}
+
+		Vec3 center() const noexcept { return (min + max) * 0.5f; }
+		Vec3 extent() const noexcept { return (max - min) * 0.5f; }
+
+		// the build and refit heuristics only compare these, so the factor 2 is left out
+		f32 halfSurfaceArea() const noexcept
+		{
+			if (isEmpty()) return 0.0f;
+			const auto d = max - min;
+			return d.x * d.y + d.y * d.z + d.z * d.x;
+		}
+
+		// box around the transformed box (Arvo): the new extent is the old one through |M|
+		Aabb transformed(const Mat4& matrix) const noexcept
+		{
+			const auto c = center(), e = extent();
+			const auto& m = matrix.m;
+			f32 newCenter[3], newExtent[3];
+			for (ui32 column = 0; column < 3; column++)
+			{
+				newCenter[column] = c.x * m[0][column] + c.y * m[1][column] + c.z * m[2][column] + m[3][column];
+				newExtent[column] = e.x * std::fabs(m[0][column]) + e.y * std::fabs(m[1][column]) + e.z * std::fabs(m[2][column]);
+			}
+			return {
+				{ newCenter[0] - newExtent[0], newCenter[1] - newExtent[1], newCenter[2] - newExtent[2] },
+				{ newCenter[0] + newExtent[0], newCenter[1] + newExtent[1], newCenter[2] + newExtent[2] }
+			};
+		}
+
+	public:
+		Vec3 min{};
+		Vec3 max{};
+	};
+}
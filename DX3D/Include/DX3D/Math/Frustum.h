@@ -0,0 +1,132 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <DX3D/Math/Simd.h>
+#include <DX3D/Math/Vec4.h>
+#include <DX3D/Math/Mat4.h>
+#include <DX3D/Math/Aabb.h>
+#include <cmath>
+
+namespace dx3d
+{
+	// four boxes as structure of arrays, the layout Frustum::classify4 tests in one go
+	struct alignas(16) Aabb4
+	{
+		f32 minX[4], minY[4], minZ[4];
+		f32 maxX[4], maxY[4], maxZ[4];
+
+		void set(ui32 lane, const Aabb& box) noexcept
+		{
+			minX[lane] = box.min.x; minY[lane] = box.min.y; minZ[lane] = box.min.z;
+			maxX[lane] = box.max.x; maxY[lane] = box.max.y; maxZ[lane] = box.max.z;
+		}
+
+		Aabb get(ui32 lane) const noexcept
+		{
+			return { { minX[lane], minY[lane], minZ[lane] }, { maxX[lane], maxY[lane], maxZ[lane] } };
+		}
+	};
+
+	/*
+	* Six inward facing planes (a x + b y + c z + d >= 0 inside), extracted from a row-vector view-projection
+	* with Direct3D's 0..w depth range. Boxes are tested against the corner farthest along each plane normal
+	* (outside when even that one is behind a plane) and the nearest one (fully inside when it is in front of all).
+	*/
+	class Frustum
+	{
+	public:
+		static constexpr ui32 PlaneCount = 6;
+
+		static Frustum fromMatrix(const Mat4& viewProjection) noexcept
+		{
+			// clip = v * M, so clip.x is v dotted with column 0 and so on
+			const auto& m = viewProjection.m;
+			auto column = [&m](ui32 c) { return Vec4{ m[0][c], m[1][c], m[2][c], m[3][c] }; };
+			const auto x = column(0), y = column(1), z = column(2), w = column(3);
+
+			Frustum frustum{};
+			frustum.planes[0] = w + x;    // left
+			frustum.planes[1] = w - x;    // right
+			frustum.planes[2] = w + y;    // bottom
+			frustum.planes[3] = w - y;    // top
+			frustum.planes[4] = z;        // near
+			frustum.planes[5] = w - z;    // far
+			for (auto& plane : frustum.planes)
+			{
+				const auto length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+				if (length > 0.0f) plane = plane * (1.0f / length);
+			}
+			return frustum;
+		}
+
+		// positions that already are clip space (w = 1): -1..1 in x and y, 0..1 in z
+		static Frustum clipVolume() noexcept { return fromMatrix(Mat4::identity()); }
+
+		bool intersects(const Aabb& box) const noexcept
+		{
+			for (const auto& plane : planes)
+			{
+				const auto px = plane.x > 0.0f ? box.max.x : box.min.x;
+				const auto py = plane.y > 0.0f ? box.max.y : box.min.y;
+				const auto pz = plane.z > 0.0f ? box.max.z : box.min.z;
+				if (plane.x * px + plane.y * py + plane.z * pz + plane.w < 0.0f)
+					return false;
+			}
+			return true;
+		}
+
+		// bit i = box i touches the frustum, bit i + 4 = box i is completely inside it
+		ui32 classify4(const Aabb4& boxes) const noexcept
+		{
+#if DX3D_SIMD_SSE
+			const __m128 minX = _mm_load_ps(boxes.minX), minY = _mm_load_ps(boxes.minY), minZ = _mm_load_ps(boxes.minZ);
+			const __m128 maxX = _mm_load_ps(boxes.maxX), maxY = _mm_load_ps(boxes.maxY), maxZ = _mm_load_ps(boxes.maxZ);
+			const __m128 zero = _mm_setzero_ps();
+
+			__m128 outside = zero;
+			__m128 partial = zero;
+			for (const auto& plane : planes)
+			{
+				// which corner is farthest along the normal is the same for all four boxes
+				const __m128 a = _mm_set1_ps(plane.x), b = _mm_set1_ps(plane.y), c = _mm_set1_ps(plane.z), d = _mm_set1_ps(plane.w);
+				const bool px = plane.x > 0.0f, py = plane.y > 0.0f, pz = plane.z > 0.0f;
+
+				const __m128 farthest = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(a, px ? maxX : minX), _mm_mul_ps(b, py ? maxY : minY)),
+					_mm_add_ps(_mm_mul_ps(c, pz ? maxZ : minZ), d));
+				const __m128 nearest = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(a, px ? minX : maxX), _mm_mul_ps(b, py ? minY : maxY)),
+					_mm_add_ps(_mm_mul_ps(c, pz ? minZ : maxZ), d));
+
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(farthest, zero));
+				partial = _mm_or_ps(partial, _mm_cmplt_ps(nearest, zero));
+			}
+
+			const auto outsideMask = static_cast<ui32>(_mm_movemask_ps(outside));
+			const auto partialMask = static_cast<ui32>(_mm_movemask_ps(partial));
+			return (~outsideMask & 0xf) | ((~(outsideMask | partialMask) & 0xf) << 4);
+#else
+			ui32 result{};
+			for (ui32 lane = 0; lane < 4; lane++)
+			{
+				bool outside = false, partial = false;
+				for (const auto& plane : planes)
+				{
+					const bool px = plane.x > 0.0f, py = plane.y > 0.0f, pz = plane.z > 0.0f;
+					const auto farthest = plane.x * (px ? boxes.maxX : boxes.minX)[lane] + plane.y * (py ? boxes.maxY : boxes.minY)[lane] +
+						plane.z * (pz ? boxes.maxZ : boxes.minZ)[lane] + plane.w;
+					const auto nearest = plane.x * (px ? boxes.minX : boxes.maxX)[lane] + plane.y * (py ? boxes.minY : boxes.maxY)[lane] +
+						plane.z * (pz ? boxes.minZ : boxes.maxZ)[lane] + plane.w;
+					outside |= farthest < 0.0f;
+					partial |= nearest < 0.0f;
+				}
+				if (!outside) result |= 1u << lane;
+				if (!outside && !partial) result |= 1u << (lane + 4);
+			}
+			return result;
+#endif
+		}
+
+	public:
+		Vec4 planes[PlaneCount]{};
+	};
+}
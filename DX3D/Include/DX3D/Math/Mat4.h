@@ -0,0 +1,206 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <DX3D/Math/Simd.h>
+#include <DX3D/Math/Vec3.h>
+#include <DX3D/Math/Vec4.h>
+#include <cmath>
+
+namespace dx3d
+{
+	/*
+	* Row-major 4x4 matrix for row vectors (v * M), translation in the last row: the same layout and
+	* convention as TransformComponent::world and mul(float4(position, 1), world) in the shaders.
+	* a * b applies a first, then b. The projection and view helpers are left-handed, like Direct3D's.
+	*/
+	class Mat4
+	{
+	public:
+		Mat4() = default;
+		Mat4(f32 m00, f32 m01, f32 m02, f32 m03,
+			f32 m10, f32 m11, f32 m12, f32 m13,
+			f32 m20, f32 m21, f32 m22, f32 m23,
+			f32 m30, f32 m31, f32 m32, f32 m33) :
+			m{ { m00, m01, m02, m03 }, { m10, m11, m12, m13 }, { m20, m21, m22, m23 }, { m30, m31, m32, m33 } }
+		{
+		}
+
+		static Mat4 identity() noexcept { return {}; }
+
+		static Mat4 translation(const Vec3& t) noexcept
+		{
+			Mat4 result;
+			result.m[3][0] = t.x;
+			result.m[3][1] = t.y;
+			result.m[3][2] = t.z;
+			return result;
+		}
+
+		static Mat4 scale(const Vec3& s) noexcept
+		{
+			Mat4 result;
+			result.m[0][0] = s.x;
+			result.m[1][1] = s.y;
+			result.m[2][2] = s.z;
+			return result;
+		}
+
+		static Mat4 scale(f32 s) noexcept { return scale({ s, s, s }); }
+
+		static Mat4 rotationX(f32 radians) noexcept
+		{
+			const auto s = std::sin(radians), c = std::cos(radians);
+			return { 1, 0, 0, 0,   0, c, s, 0,   0, -s, c, 0,   0, 0, 0, 1 };
+		}
+
+		static Mat4 rotationY(f32 radians) noexcept
+		{
+			const auto s = std::sin(radians), c = std::cos(radians);
+			return { c, 0, -s, 0,   0, 1, 0, 0,   s, 0, c, 0,   0, 0, 0, 1 };
+		}
+
+		static Mat4 rotationZ(f32 radians) noexcept
+		{
+			const auto s = std::sin(radians), c = std::cos(radians);
+			return { c, s, 0, 0,   -s, c, 0, 0,   0, 0, 1, 0,   0, 0, 0, 1 };
+		}
+
+		static Mat4 lookAtLH(const Vec3& eye, const Vec3& target, const Vec3& up) noexcept
+		{
+			const auto zAxis = (target - eye).normalized();
+			const auto xAxis = up.cross(zAxis).normalized();
+			const auto yAxis = zAxis.cross(xAxis);
+			return {
+				xAxis.x, yAxis.x, zAxis.x, 0,
+				xAxis.y, yAxis.y, zAxis.y, 0,
+				xAxis.z, yAxis.z, zAxis.z, 0,
+				-xAxis.dot(eye), -yAxis.dot(eye), -zAxis.dot(eye), 1
+			};
+		}
+
+		// depth maps [nearZ, farZ] to [0, 1]
+		static Mat4 perspectiveFovLH(f32 fovY, f32 aspectRatio, f32 nearZ, f32 farZ) noexcept
+		{
+			const auto height = 1.0f / std::tan(fovY * 0.5f);
+			const auto width = height / aspectRatio;
+			const auto range = farZ / (farZ - nearZ);
+			return { width, 0, 0, 0,   0, height, 0, 0,   0, 0, range, 1,   0, 0, -range * nearZ, 0 };
+		}
+
+		static Mat4 orthographicLH(f32 width, f32 height, f32 nearZ, f32 farZ) noexcept
+		{
+			const auto range = 1.0f / (farZ - nearZ);
+			return { 2.0f / width, 0, 0, 0,   0, 2.0f / height, 0, 0,   0, 0, range, 0,   0, 0, -range * nearZ, 1 };
+		}
+
+		Mat4 operator*(const Mat4& b) const noexcept
+		{
+			Mat4 result;
+#if DX3D_SIMD_SSE
+			const auto b0 = _mm_loadu_ps(b.m[0]), b1 = _mm_loadu_ps(b.m[1]);
+			const auto b2 = _mm_loadu_ps(b.m[2]), b3 = _mm_loadu_ps(b.m[3]);
+			for (ui32 row = 0; row < 4; row++)
+			{
+				auto r = _mm_mul_ps(_mm_set1_ps(m[row][0]), b0);
+				r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m[row][1]), b1));
+				r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m[row][2]), b2));
+				r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m[row][3]), b3));
+				_mm_storeu_ps(result.m[row], r);
+			}
+#else
+			for (ui32 row = 0; row < 4; row++)
+				for (ui32 column = 0; column < 4; column++)
+					result.m[row][column] = m[row][0] * b.m[0][column] + m[row][1] * b.m[1][column] +
+						m[row][2] * b.m[2][column] + m[row][3] * b.m[3][column];
+#endif
+			return result;
+		}
+
+		Mat4& operator*=(const Mat4& b) noexcept { return *this = *this * b; }
+
+		bool operator==(const Mat4&) const = default;
+
+		Mat4 transposed() const noexcept
+		{
+#if DX3D_SIMD_SSE
+			auto r0 = _mm_loadu_ps(m[0]), r1 = _mm_loadu_ps(m[1]);
+			auto r2 = _mm_loadu_ps(m[2]), r3 = _mm_loadu_ps(m[3]);
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			Mat4 result;
+			_mm_storeu_ps(result.m[0], r0);
+			_mm_storeu_ps(result.m[1], r1);
+			_mm_storeu_ps(result.m[2], r2);
+			_mm_storeu_ps(result.m[3], r3);
+			return result;
+#else
+			return {
+				m[0][0], m[1][0], m[2][0], m[3][0],
+				m[0][1], m[1][1], m[2][1], m[3][1],
+				m[0][2], m[1][2], m[2][2], m[3][2],
+				m[0][3], m[1][3], m[2][3], m[3][3]
+			};
+#endif
+		}
+
+		// general inverse through the cofactors, a singular matrix gives the identity
+		Mat4 inverted() const noexcept
+		{
+			const auto* a = &m[0][0];
+			f32 inv[16];
+			inv[0] = a[5] * a[10] * a[15] - a[5] * a[11] * a[14] - a[9] * a[6] * a[15] + a[9] * a[7] * a[14] + a[13] * a[6] * a[11] - a[13] * a[7] * a[10];
+			inv[4] = -a[4] * a[10] * a[15] + a[4] * a[11] * a[14] + a[8] * a[6] * a[15] - a[8] * a[7] * a[14] - a[12] * a[6] * a[11] + a[12] * a[7] * a[10];
+			inv[8] = a[4] * a[9] * a[15] - a[4] * a[11] * a[13] - a[8] * a[5] * a[15] + a[8] * a[7] * a[13] + a[12] * a[5] * a[11] - a[12] * a[7] * a[9];
+			inv[12] = -a[4] * a[9] * a[14] + a[4] * a[10] * a[13] + a[8] * a[5] * a[14] - a[8] * a[6] * a[13] - a[12] * a[5] * a[10] + a[12] * a[6] * a[9];
+			inv[1] = -a[1] * a[10] * a[15] + a[1] * a[11] * a[14] + a[9] * a[2] * a[15] - a[9] * a[3] * a[14] - a[13] * a[2] * a[11] + a[13] * a[3] * a[10];
+			inv[5] = a[0] * a[10] * a[15] - a[0] * a[11] * a[14] - a[8] * a[2] * a[15] + a[8] * a[3] * a[14] + a[12] * a[2] * a[11] - a[12] * a[3] * a[10];
+			inv[9] = -a[0] * a[9] * a[15] + a[0] * a[11] * a[13] + a[8] * a[1] * a[15] - a[8] * a[3] * a[13] - a[12] * a[1] * a[11] + a[12] * a[3] * a[9];
+			inv[13] = a[0] * a[9] * a[14] - a[0] * a[10] * a[13] - a[8] * a[1] * a[14] + a[8] * a[2] * a[13] + a[12] * a[1] * a[10] - a[12] * a[2] * a[9];
+			inv[2] = a[1] * a[6] * a[15] - a[1] * a[7] * a[14] - a[5] * a[2] * a[15] + a[5] * a[3] * a[14] + a[13] * a[2] * a[7] - a[13] * a[3] * a[6];
+			inv[6] = -a[0] * a[6] * a[15] + a[0] * a[7] * a[14] + a[4] * a[2] * a[15] - a[4] * a[3] * a[14] - a[12] * a[2] * a[7] + a[12] * a[3] * a[6];
+			inv[10] = a[0] * a[5] * a[15] - a[0] * a[7] * a[13] - a[4] * a[1] * a[15] + a[4] * a[3] * a[13] + a[12] * a[1] * a[7] - a[12] * a[3] * a[5];
+			inv[14] = -a[0] * a[5] * a[14] + a[0] * a[6] * a[13] + a[4] * a[1] * a[14] - a[4] * a[2] * a[13] - a[12] * a[1] * a[6] + a[12] * a[2] * a[5];
+			inv[3] = -a[1] * a[6] * a[11] + a[1] * a[7] * a[10] + a[5] * a[2] * a[11] - a[5] * a[3] * a[10] - a[9] * a[2] * a[7] + a[9] * a[3] * a[6];
+			inv[7] = a[0] * a[6] * a[11] - a[0] * a[7] * a[10] - a[4] * a[2] * a[11] + a[4] * a[3] * a[10] + a[8] * a[2] * a[7] - a[8] * a[3] * a[6];
+			inv[11] = -a[0] * a[5] * a[11] + a[0] * a[7] * a[9] + a[4] * a[1] * a[11] - a[4] * a[3] * a[9] - a[8] * a[1] * a[7] + a[8] * a[3] * a[5];
+			inv[15] = a[0] * a[5] * a[10] - a[0] * a[6] * a[9] - a[4] * a[1] * a[10] + a[4] * a[2] * a[9] + a[8] * a[1] * a[6] - a[8] * a[2] * a[5];
+
+			const auto determinant = a[0] * inv[0] + a[1] * inv[4] + a[2] * inv[8] + a[3] * inv[12];
+			if (determinant == 0.0f) return {};
+
+			const auto scale = 1.0f / determinant;
+			Mat4 result;
+			for (ui32 i = 0; i < 16; i++)
+				(&result.m[0][0])[i] = inv[i] * scale;
+			return result;
+		}
+
+		Vec4 row(ui32 index) const noexcept { return { m[index][0], m[index][1], m[index][2], m[index][3] }; }
+
+		Vec4 transform(const Vec4& v) const noexcept
+		{
+#if DX3D_SIMD_SSE
+			auto r = _mm_mul_ps(_mm_set1_ps(v.x), _mm_loadu_ps(m[0]));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v.y), _mm_loadu_ps(m[1])));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v.z), _mm_loadu_ps(m[2])));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v.w), _mm_loadu_ps(m[3])));
+			return Vec4::store(r);
+#else
+			return {
+				v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0] + v.w * m[3][0],
+				v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1] + v.w * m[3][1],
+				v.x * m[0][2] + v.y * m[1][2] + v.z * m[2][2] + v.w * m[3][2],
+				v.x * m[0][3] + v.y * m[1][3] + v.z * m[2][3] + v.w * m[3][3]
+			};
+#endif
+		}
+
+		// w = 1, affine: the result is not divided by w
+		Vec3 transformPoint(const Vec3& p) const noexcept { return transform(Vec4{ p, 1.0f }).xyz(); }
+		// w = 0, translation is ignored
+		Vec3 transformDirection(const Vec3& d) const noexcept { return transform(Vec4{ d, 0.0f }).xyz(); }
+
+	public:
+		f32 m[4][4]{ { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } };
+	};
+
+	static_assert(sizeof(Mat4) == 16 * sizeof(f32), "Mat4 must stay layout compatible with float4x4 instance data");
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <DX3D/Math/Simd.h>
+#include <DX3D/Math/Vec3.h>
+#include <DX3D/Math/Vec4.h>
+#include <DX3D/Math/Mat4.h>
+#include <cmath>
+
+namespace dx3d
+{
+	/*
+	* Rotation quaternion (x, y, z = vector part, w = scalar part).
+	* a * b rotates by a first, then by b, matching Mat4 (toMat4(a * b) == toMat4(a) * toMat4(b)).
+	*/
+	class Quat
+	{
+	public:
+		Quat() = default;
+		Quat(f32 x, f32 y, f32 z, f32 w) : x(x), y(y), z(z), w(w) {}
+
+		static Quat identity() noexcept { return {}; }
+
+		// axis does not need to be normalized
+		static Quat fromAxisAngle(const Vec3& axis, f32 radians) noexcept
+		{
+			const auto v = axis.normalized() * std::sin(radians * 0.5f);
+			return { v.x, v.y, v.z, std::cos(radians * 0.5f) };
+		}
+
+		// shortest path, t in [0, 1]
+		static Quat slerp(const Quat& a, const Quat& b, f32 t) noexcept
+		{
+			auto cosTheta = a.asVec4().dot(b.asVec4());
+			auto end = b.asVec4();
+			if (cosTheta < 0.0f)
+			{
+				cosTheta = -cosTheta;
+				end = -end;
+			}
+
+			f32 wa = 1.0f - t, wb = t;
+			// nearly parallel: the lerp is exact enough and avoids dividing by sin(theta) ~ 0
+			if (cosTheta < 0.9995f)
+			{
+				const auto theta = std::acos(cosTheta);
+				const auto invSin = 1.0f / std::sin(theta);
+				wa = std::sin((1.0f - t) * theta) * invSin;
+				wb = std::sin(t * theta) * invSin;
+			}
+			return fromVec4((a.asVec4() * wa + end * wb).normalized());
+		}
+
+		Quat operator*(const Quat& q) const noexcept
+		{
+			// Hamilton product q (x) this, so that this rotation is applied first
+			const auto& a = q;
+			const auto& b = *this;
+#if DX3D_SIMD_SSE
+			const auto vb = b.asVec4().load();
+			auto r = _mm_mul_ps(_mm_set1_ps(a.w), vb);
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a.x),
+				_mm_mul_ps(_mm_shuffle_ps(vb, vb, _MM_SHUFFLE(0, 1, 2, 3)), _mm_setr_ps(1, -1, 1, -1))));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a.y),
+				_mm_mul_ps(_mm_shuffle_ps(vb, vb, _MM_SHUFFLE(1, 0, 3, 2)), _mm_setr_ps(1, 1, -1, -1))));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a.z),
+				_mm_mul_ps(_mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 3, 0, 1)), _mm_setr_ps(-1, 1, 1, -1))));
+			return fromVec4(Vec4::store(r));
+#else
+			return {
+				a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+				a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+				a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+				a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+			};
+#endif
+		}
+
+		Quat& operator*=(const Quat& b) noexcept { return *this = *this * b; }
+
+		bool operator==(const Quat&) const = default;
+
+		Quat conjugate() const noexcept { return { -x, -y, -z, w }; }
+		Quat normalized() const noexcept { return fromVec4(asVec4().normalized()); }
+
+		Vec3 rotate(const Vec3& v) const noexcept
+		{
+			// v + 2w(q x v) + 2 q x (q x v)
+			const Vec3 q{ x, y, z };
+			const auto t = q.cross(v) * 2.0f;
+			return v + t * w + q.cross(t);
+		}
+
+		Mat4 toMat4() const noexcept
+		{
+			const auto xx = x * x, yy = y * y, zz = z * z;
+			const auto xy = x * y, xz = x * z, yz = y * z;
+			const auto wx = w * x, wy = w * y, wz = w * z;
+			return {
+				1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy), 0,
+				2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx), 0,
+				2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy), 0,
+				0, 0, 0, 1
+			};
+		}
+
+		Vec4 asVec4() const noexcept { return { x, y, z, w }; }
+		static Quat fromVec4(const Vec4& v) noexcept { return { v.x, v.y, v.z, v.w }; }
+
+	public:
+		f32 x{}, y{}, z{}, w{ 1.0f };
+	};
+}
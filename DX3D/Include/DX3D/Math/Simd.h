@@ -0,0 +1,14 @@
+#pragma once
+
+/*
+* Instruction sets the math library is compiled for.
+* SSE2 is part of every x64 target; the AVX kernels are used when the compiler targets AVX (/arch:AVX, -mavx).
+* Define DX3D_DISABLE_SIMD to force the scalar code paths everywhere.
+*/
+#if !defined(DX3D_DISABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define DX3D_SIMD_SSE 1
+#if defined(__AVX__)
+#define DX3D_SIMD_AVX 1
+#endif
+#include <immintrin.h>
+#endif
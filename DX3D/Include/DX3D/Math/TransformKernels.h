@@ -0,0 +1,42 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <DX3D/Math/Vec3.h>
+#include <DX3D/Math/Vec4.h>
+#include <DX3D/Math/Mat4.h>
+#include <cstddef>
+
+namespace dx3d
+{
+	/*
+	* Batch kernels over arrays of positions and matrices (AVX: 8 points per step, SSE: 4, scalar otherwise).
+	* results may be the same array as the input (in place), other overlaps are not supported.
+	* The strided overloads read and write the first three floats of each element, so they work directly
+	* on arrays of vertex structs (Vertex, ...), whose position comes first.
+	*/
+	namespace TransformKernels
+	{
+		// w = 1, affine (no divide by w)
+		void TransformPoints(const Mat4& matrix, const Vec3* points, Vec3* results, size_t count) noexcept;
+		void TransformPoints(const Mat4& matrix, const void* points, size_t pointStride,
+			void* results, size_t resultStride, size_t count) noexcept;
+
+		// w = 0, translation is ignored
+		void TransformDirections(const Mat4& matrix, const Vec3* directions, Vec3* results, size_t count) noexcept;
+
+		void TransformVectors(const Mat4& matrix, const Vec4* vectors, Vec4* results, size_t count) noexcept;
+
+		// results[i] = matrices[i] * matrix
+		void MultiplyMatrices(const Mat4* matrices, const Mat4& matrix, Mat4* results, size_t count) noexcept;
+
+		// plain loops with the same signatures, the reference the SIMD paths are measured and checked against
+		namespace Scalar
+		{
+			void TransformPoints(const Mat4& matrix, const Vec3* points, Vec3* results, size_t count) noexcept;
+			void TransformPoints(const Mat4& matrix, const void* points, size_t pointStride,
+				void* results, size_t resultStride, size_t count) noexcept;
+			void TransformDirections(const Mat4& matrix, const Vec3* directions, Vec3* results, size_t count) noexcept;
+			void TransformVectors(const Mat4& matrix, const Vec4* vectors, Vec4* results, size_t count) noexcept;
+			void MultiplyMatrices(const Mat4* matrices, const Mat4& matrix, Mat4* results, size_t count) noexcept;
+		}
+	}
+}
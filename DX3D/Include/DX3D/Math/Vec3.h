@@ -0,0 +1,47 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <cmath>
+
+namespace dx3d
+{
+	/*
+	* Three packed floats, the same layout as the position at the start of the vertex structs.
+	* Single Vec3 operations stay scalar (a 12 byte value gains nothing from a round trip through a register),
+	* arrays of them go through the batch kernels in TransformKernels.h.
+	*/
+	class Vec3
+	{
+	public:
+		Vec3() = default;
+		Vec3(f32 x, f32 y, f32 z) : x(x), y(y), z(z) {}
+
+		Vec3 operator+(const Vec3& v) const noexcept { return { x + v.x, y + v.y, z + v.z }; }
+		Vec3 operator-(const Vec3& v) const noexcept { return { x - v.x, y - v.y, z - v.z }; }
+		Vec3 operator*(const Vec3& v) const noexcept { return { x * v.x, y * v.y, z * v.z }; }
+		Vec3 operator*(f32 s) const noexcept { return { x * s, y * s, z * s }; }
+		Vec3 operator/(f32 s) const noexcept { return *this * (1.0f / s); }
+		Vec3 operator-() const noexcept { return { -x, -y, -z }; }
+
+		Vec3& operator+=(const Vec3& v) noexcept { return *this = *this + v; }
+		Vec3& operator-=(const Vec3& v) noexcept { return *this = *this - v; }
+		Vec3& operator*=(f32 s) noexcept { return *this = *this * s; }
+
+		bool operator==(const Vec3&) const = default;
+
+		f32 dot(const Vec3& v) const noexcept { return x * v.x + y * v.y + z * v.z; }
+		Vec3 cross(const Vec3& v) const noexcept { return { y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x }; }
+		f32 lengthSquared() const noexcept { return dot(*this); }
+		f32 length() const noexcept { return std::sqrt(lengthSquared()); }
+		// zero stays zero
+		Vec3 normalized() const noexcept
+		{
+			const auto len = length();
+			return len > 0.0f ? *this / len : Vec3{};
+		}
+
+	public:
+		f32 x{}, y{}, z{};
+	};
+
+	static_assert(sizeof(Vec3) == 3 * sizeof(f32), "Vec3 must stay layout compatible with vertex positions");
+}
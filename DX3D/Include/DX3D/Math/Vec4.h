@@ -1,5 +1,8 @@
 #pragma once
 #include <DX3D/Core/Core.h>
+#include <DX3D/Math/Simd.h>
+#include <DX3D/Math/Vec3.h>
+#include <cmath>
 
 namespace dx3d
 {
@@ -8,7 +11,89 @@ namespace dx3d
 	public:
 		Vec4() = default;
 		Vec4(f32 x, f32 y, f32 z, f32 w) : x(x), y(y), z(z), w(w) {}
+		Vec4(const Vec3& v, f32 w) : x(v.x), y(v.y), z(v.z), w(w) {}
+
+#if DX3D_SIMD_SSE
+		// unaligned, Vec4 keeps the 4 byte alignment of the float4s in the vertex and instance structs
+		__m128 load() const noexcept { return _mm_loadu_ps(&x); }
+		static Vec4 store(__m128 v) noexcept
+		{
+			Vec4 result;
+			_mm_storeu_ps(&result.x, v);
+			return result;
+		}
+#endif
+
+		Vec4 operator+(const Vec4& v) const noexcept
+		{
+#if DX3D_SIMD_SSE
+			return store(_mm_add_ps(load(), v.load()));
+#else
+			return { x + v.x, y + v.y, z + v.z, w + v.w };
+#endif
+		}
+
+		Vec4 operator-(const Vec4& v) const noexcept
+		{
+#if DX3D_SIMD_SSE
+			return store(_mm_sub_ps(load(), v.load()));
+#else
+			return { x - v.x, y - v.y, z - v.z, w - v.w };
+#endif
+		}
+
+		Vec4 operator*(const Vec4& v) const noexcept
+		{
+#if DX3D_SIMD_SSE
+			return store(_mm_mul_ps(load(), v.load()));
+#else
+			return { x * v.x, y * v.y, z * v.z, w * v.w };
+#endif
+		}
+
+		Vec4 operator*(f32 s) const noexcept
+		{
+#if DX3D_SIMD_SSE
+			return store(_mm_mul_ps(load(), _mm_set1_ps(s)));
+#else
+			return { x * s, y * s, z * s, w * s };
+#endif
+		}
+
+		Vec4 operator/(f32 s) const noexcept { return *this * (1.0f / s); }
+		Vec4 operator-() const noexcept { return { -x, -y, -z, -w }; }
+
+		Vec4& operator+=(const Vec4& v) noexcept { return *this = *this + v; }
+		Vec4& operator-=(const Vec4& v) noexcept { return *this = *this - v; }
+		Vec4& operator*=(f32 s) noexcept { return *this = *this * s; }
+
+		bool operator==(const Vec4&) const = default;
+
+		f32 dot(const Vec4& v) const noexcept
+		{
+#if DX3D_SIMD_SSE
+			const auto product = _mm_mul_ps(load(), v.load());
+			const auto pairs = _mm_add_ps(product, _mm_movehl_ps(product, product));
+			return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+#else
+			return x * v.x + y * v.y + z * v.z + w * v.w;
+#endif
+		}
+
+		f32 lengthSquared() const noexcept { return dot(*this); }
+		f32 length() const noexcept { return std::sqrt(lengthSquared()); }
+		// zero stays zero
+		Vec4 normalized() const noexcept
+		{
+			const auto len = length();
+			return len > 0.0f ? *this / len : Vec4{};
+		}
+
+		Vec3 xyz() const noexcept { return { x, y, z }; }
+
 	public:
 		f32 x{}, y{}, z{}, w{};
 	};
-}
\ No newline at end of file
+
+	static_assert(sizeof(Vec4) == 4 * sizeof(f32), "Vec4 must stay layout compatible with float4 vertex attributes");
+}
@@ -0,0 +1,330 @@
+#include <DX3D/Core/EntityStore.h>
+#include <DX3D/Core/ThreadPool.h>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+	std::mutex ComponentRegistryMutex{};
+	dx3d::ui32 ComponentCount{};
+
+	size_t AlignUp(size_t value, size_t alignment) noexcept
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+}
+
+dx3d::ui32 dx3d::EntityStore::registerComponent(size_t size, size_t alignment, const void* defaultValue)
+{
+	std::lock_guard lock(ComponentRegistryMutex);
+	if (ComponentCount == MaxComponents)
+		throw std::invalid_argument("EntityStore supports at most 64 component types");
+
+	getComponentInfo(ComponentCount) = { static_cast<ui32>(size), static_cast<ui32>(alignment), defaultValue };
+	return ComponentCount++;
+}
+
+dx3d::EntityStore::ComponentInfo& dx3d::EntityStore::getComponentInfo(ui32 id) noexcept
+{
+	static ComponentInfo infos[MaxComponents]{};
+	return infos[id];
+}
+
+void dx3d::EntityStore::create(ComponentMask mask, ui32 group, size_t count, Entity* outEntities)
+{
+	if (!count) return;
+
+	std::vector<Range> ranges;
+	appendRows(getArchetype(mask, group), count, outEntities, ranges);
+}
+
+dx3d::Entity dx3d::EntityStore::create(ComponentMask mask, ui32 group)
+{
+	Entity entity{};
+	create(mask, group, 1, &entity);
+	return entity;
+}
+
+bool dx3d::EntityStore::destroy(Entity entity)
+{
+	if (!contains(entity)) return false;
+
+	auto& slot = m_slots[getSlot(entity)];
+	removeRow(slot.archetype, slot.chunk, slot.row);
+
+	slot.generation++;
+	m_freeSlots.push_back(getSlot(entity));
+	m_entityCount--;
+	return true;
+}
+
+void dx3d::EntityStore::clear()
+{
+	for (auto& archetype : m_archetypes)
+	{
+		for (const auto& chunk : archetype.chunks)
+		{
+			const auto* entities = reinterpret_cast<const Entity*>(chunk->bytes);
+			for (ui32 row = 0; row < chunk->count; row++)
+			{
+				m_slots[getSlot(entities[row])].generation++;
+				m_freeSlots.push_back(getSlot(entities[row]));
+			}
+		}
+		archetype.chunks.clear();
+		archetype.size = 0;
+	}
+	m_entityCount = 0;
+	m_version++;
+	m_structureVersion++;
+}
+
+bool dx3d::EntityStore::contains(Entity entity) const noexcept
+{
+	return entity.id && entity.id <= m_slots.size() && m_slots[entity.id - 1].generation == entity.generation;
+}
+
+void dx3d::EntityStore::setComponents(Entity entity, ComponentMask mask)
+{
+	moveEntity(entity, mask, m_archetypes[getLiveSlot(entity).archetype].group);
+}
+
+void dx3d::EntityStore::setGroup(Entity entity, ui32 group)
+{
+	moveEntity(entity, m_archetypes[getLiveSlot(entity).archetype].mask, group);
+}
+
+dx3d::ComponentMask dx3d::EntityStore::getComponents(Entity entity) const
+{
+	return m_archetypes[getLiveSlot(entity).archetype].mask;
+}
+
+dx3d::ui32 dx3d::EntityStore::getGroup(Entity entity) const
+{
+	return m_archetypes[getLiveSlot(entity).archetype].group;
+}
+
+size_t dx3d::EntityStore::getChunkCount() const noexcept
+{
+	size_t count = 0;
+	for (const auto& archetype : m_archetypes)
+		count += archetype.chunks.size();
+	return count;
+}
+
+dx3d::ui32 dx3d::EntityStore::getArchetype(ComponentMask mask, ui32 group)
+{
+	const auto found = m_archetypeLookup.find({ mask, group });
+	if (found != m_archetypeLookup.end())
+		return found->second;
+
+	Archetype archetype{};
+	archetype.mask = mask;
+	archetype.group = group;
+	for (auto bits = mask; bits; bits &= bits - 1)
+		archetype.components.push_back(static_cast<ui32>(std::countr_zero(bits)));
+
+	// the handles first, then one array per component, each 16 byte aligned for SIMD loads
+	auto layout = [&](ui32 capacity)
+		{
+			size_t offset = AlignUp(sizeof(Entity) * capacity, 16);
+			for (const auto id : archetype.components)
+			{
+				const auto& info = getComponentInfo(id);
+				offset = AlignUp(offset, std::max<size_t>(info.alignment, 16));
+				archetype.offsets[id] = static_cast<ui32>(offset);
+				offset += static_cast<size_t>(info.size) * capacity;
+			}
+			return offset;
+		};
+
+	size_t rowSize = sizeof(Entity);
+	for (const auto id : archetype.components)
+	{
+		if (getComponentInfo(id).alignment > 64)
+			throw std::invalid_argument("EntityStore components can be aligned to at most 64 bytes");
+		rowSize += getComponentInfo(id).size;
+	}
+	if (rowSize > ChunkBytes / 4)
+		throw std::invalid_argument("EntityStore components of one entity have to fit a quarter chunk");
+
+	// the most rows that still fit once the arrays are padded to their alignment
+	archetype.capacity = static_cast<ui32>(ChunkBytes / rowSize);
+	while (layout(archetype.capacity) > ChunkBytes)
+		archetype.capacity--;
+
+	const auto index = static_cast<ui32>(m_archetypes.size());
+	m_archetypes.push_back(std::move(archetype));
+	m_archetypeLookup.emplace(ArchetypeKey{ mask, group }, index);
+	return index;
+}
+
+void dx3d::EntityStore::appendRows(ui32 archetypeIndex, size_t count, Entity* outEntities, std::vector<Range>& outRanges)
+{
+	auto& archetype = m_archetypes[archetypeIndex];
+	const auto version = ++m_version;
+	m_structureVersion++;
+
+	size_t created = 0;
+	while (created < count)
+	{
+		if (archetype.chunks.empty() || archetype.chunks.back()->count == archetype.capacity)
+			archetype.chunks.push_back(std::make_unique<Chunk>());
+
+		const auto chunkIndex = static_cast<ui32>(archetype.chunks.size() - 1);
+		auto& chunk = *archetype.chunks.back();
+		const auto firstRow = chunk.count;
+		const auto rowCount = static_cast<ui32>(std::min<size_t>(count - created, archetype.capacity - firstRow));
+
+		auto* entities = reinterpret_cast<Entity*>(chunk.bytes);
+		for (ui32 row = firstRow; row < firstRow + rowCount; row++)
+		{
+			ui32 slot{};
+			if (m_freeSlots.empty())
+			{
+				slot = static_cast<ui32>(m_slots.size());
+				m_slots.push_back({});
+			}
+			else
+			{
+				slot = m_freeSlots.back();
+				m_freeSlots.pop_back();
+			}
+
+			auto& target = m_slots[slot];
+			target.archetype = archetypeIndex;
+			target.chunk = chunkIndex;
+			target.row = row;
+			entities[row] = { slot + 1, target.generation };
+			if (outEntities)
+				outEntities[created + row - firstRow] = entities[row];
+		}
+
+		for (const auto id : archetype.components)
+		{
+			const auto& info = getComponentInfo(id);
+			auto* array = chunk.bytes + archetype.offsets[id];
+			for (ui32 row = firstRow; row < firstRow + rowCount; row++)
+				std::memcpy(array + static_cast<size_t>(row) * info.size, info.defaultValue, info.size);
+		}
+
+		chunk.count += rowCount;
+		chunk.version = version;
+		outRanges.push_back({ archetypeIndex, &chunk, firstRow, rowCount, created });
+		created += rowCount;
+	}
+
+	archetype.size += count;
+	m_entityCount += count;
+}
+
+void dx3d::EntityStore::removeRow(ui32 archetypeIndex, ui32 chunkIndex, ui32 row)
+{
+	auto& archetype = m_archetypes[archetypeIndex];
+	auto& chunk = *archetype.chunks[chunkIndex];
+	auto& lastChunk = *archetype.chunks.back();
+	const auto lastRow = lastChunk.count - 1;
+	const auto version = ++m_version;
+	m_structureVersion++;
+
+	// the archetype's last row fills the hole, which keeps every chunk but the last one full
+	if (&chunk != &lastChunk || row != lastRow)
+	{
+		auto* entities = reinterpret_cast<Entity*>(chunk.bytes);
+		const auto moved = reinterpret_cast<const Entity*>(lastChunk.bytes)[lastRow];
+		entities[row] = moved;
+		for (const auto id : archetype.components)
+		{
+			const auto size = getComponentInfo(id).size;
+			std::memcpy(chunk.bytes + archetype.offsets[id] + static_cast<size_t>(row) * size,
+				lastChunk.bytes + archetype.offsets[id] + static_cast<size_t>(lastRow) * size, size);
+		}
+
+		auto& movedSlot = m_slots[getSlot(moved)];
+		movedSlot.chunk = chunkIndex;
+		movedSlot.row = row;
+	}
+
+	chunk.version = version;
+	lastChunk.version = version;
+	if (!--lastChunk.count)
+		archetype.chunks.pop_back();
+	archetype.size--;
+}
+
+void dx3d::EntityStore::moveEntity(Entity entity, ComponentMask mask, ui32 group)
+{
+	const auto source = getLiveSlot(entity);
+	const auto& sourceArchetype = m_archetypes[source.archetype];
+	if (sourceArchetype.mask == mask && sourceArchetype.group == group)
+		return;
+
+	const auto target = getArchetype(mask, group);
+	std::vector<Range> ranges;
+	Entity moved{};
+	appendRows(target, 1, &moved, ranges);
+
+	// the new row got a slot of its own, it takes over the entity's slot instead and copies what both archetypes have
+	const auto& movedSlot = m_slots[getSlot(moved)];
+	const auto targetChunkIndex = movedSlot.chunk;
+	const auto targetRow = movedSlot.row;
+	auto* targetChunk = m_archetypes[target].chunks[targetChunkIndex].get();
+	const auto* sourceChunk = m_archetypes[source.archetype].chunks[source.chunk].get();
+	for (const auto id : m_archetypes[target].components)
+	{
+		if (!(m_archetypes[source.archetype].mask & (ComponentMask{ 1 } << id))) continue;
+		const auto size = getComponentInfo(id).size;
+		std::memcpy(targetChunk->bytes + m_archetypes[target].offsets[id] + static_cast<size_t>(targetRow) * size,
+			sourceChunk->bytes + m_archetypes[source.archetype].offsets[id] + static_cast<size_t>(source.row) * size, size);
+	}
+	reinterpret_cast<Entity*>(targetChunk->bytes)[targetRow] = entity;
+
+	m_slots[getSlot(moved)].generation++;
+	m_freeSlots.push_back(getSlot(moved));
+	m_entityCount--;
+
+	removeRow(source.archetype, source.chunk, source.row);
+	auto& slot = m_slots[getSlot(entity)];
+	slot.archetype = target;
+	slot.chunk = targetChunkIndex;
+	slot.row = targetRow;
+}
+
+const dx3d::EntityStore::Slot& dx3d::EntityStore::getLiveSlot(Entity entity) const
+{
+	if (!contains(entity))
+		throw std::invalid_argument("Entity handle is stale or null");
+	return m_slots[getSlot(entity)];
+}
+
+void* dx3d::EntityStore::getComponent(const Slot& slot, ui32 id) const noexcept
+{
+	const auto& archetype = m_archetypes[slot.archetype];
+	if (!(archetype.mask & (ComponentMask{ 1 } << id))) return nullptr;
+	return archetype.chunks[slot.chunk]->bytes + archetype.offsets[id] + static_cast<size_t>(slot.row) * getComponentInfo(id).size;
+}
+
+void dx3d::EntityStore::runRanges(const std::vector<Range>& ranges, const std::function<void(EntityChunk&, const Range&)>& task,
+	ThreadPool* threadPool)
+{
+	const auto writeVersion = m_version;
+	auto runRange = [&](ui32 index)
+		{
+			const auto& range = ranges[index];
+			EntityChunk view{ m_archetypes[range.archetype], *range.chunk, writeVersion };
+			task(view, range);
+		};
+
+	if (threadPool && ranges.size() > 1)
+	{
+		threadPool->parallelFor(static_cast<ui32>(ranges.size()), runRange);
+	}
+	else
+	{
+		for (ui32 i = 0; i < ranges.size(); i++)
+			runRange(i);
+	}
+}
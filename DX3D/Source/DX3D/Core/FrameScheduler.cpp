@@ -0,0 +1,208 @@
+#include <DX3D/Core/FrameScheduler.h>
+#include <DX3D/Core/Profiler.h>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+dx3d::FrameScheduler::FrameScheduler(const FrameSchedulerDesc& desc) :
+	Base(desc.base),
+	m_simulationStep(desc.simulationStep),
+	m_maxStepsPerFrame(desc.maxStepsPerFrame),
+	m_pacing(desc.pacing),
+	m_start(std::chrono::steady_clock::now()),
+	m_clock(desc.clock)
+{
+	if (!(desc.simulationStep > 0.0)) DX3DLogThrowInvalidArg("The simulation step has to be positive.");
+	if (!desc.maxStepsPerFrame) DX3DLogThrowInvalidArg("At least one simulation step per frame has to be allowed.");
+	setFrameRateCap(desc.frameRateCap);
+	// the first frame measures from here, whatever the clock started at
+	m_lastFrameTime = now();
+}
+
+dx3d::FrameScheduler::~FrameScheduler()
+{
+	stopSimulationThread();
+}
+
+dx3d::FrameTiming dx3d::FrameScheduler::beginFrame()
+{
+	DX3DProfileZone("FrameScheduler::beginFrame");
+
+	if (m_simulationFailed.load(std::memory_order_acquire))
+	{
+		stopSimulationThread();
+		m_simulationFailed = false;
+		std::rethrow_exception(std::exchange(m_simulationError, nullptr));
+	}
+
+	if (m_framePeriod > 0.0 && m_nextFrameTime > now())
+		m_stats.idleSeconds += waitUntil(m_nextFrameTime, m_frameSleep);
+
+	const auto time = now();
+	if (m_framePeriod > 0.0)
+	{
+		// keep the phase while on time, start over after falling behind by a whole frame instead of rushing frames out
+		m_nextFrameTime += m_framePeriod;
+		if (m_nextFrameTime < time) m_nextFrameTime = time + m_framePeriod;
+	}
+
+	FrameTiming timing{};
+	timing.frameIndex = m_frameIndex++;
+	timing.time = time;
+	timing.frameSeconds = time - m_lastFrameTime;
+	m_lastFrameTime = time;
+	m_stats.frames++;
+
+	if (isSimulationThreaded())
+	{
+		timing.interpolation = getInterpolation(m_lastStepTime.load(std::memory_order_acquire));
+		return timing;
+	}
+
+	m_accumulator += timing.frameSeconds;
+	auto due = static_cast<ui64>(m_accumulator / m_simulationStep);
+	if (due > m_maxStepsPerFrame)
+	{
+		// after a stall (a breakpoint, a dragged window) catching up on everything would stall again
+		m_stats.droppedSteps += due - m_maxStepsPerFrame;
+		m_accumulator -= static_cast<d64>(due - m_maxStepsPerFrame) * m_simulationStep;
+		due = m_maxStepsPerFrame;
+	}
+	m_accumulator -= static_cast<d64>(due) * m_simulationStep;
+	m_stats.simulationSteps += due;
+
+	timing.simulationSteps = static_cast<ui32>(due);
+	// the steps end where the accumulator is left, which is what getInterpolation measures from
+	timing.firstStepTime = time - m_accumulator - static_cast<d64>(due) * m_simulationStep + m_simulationStep;
+	timing.interpolation = static_cast<f32>(std::clamp(m_accumulator / m_simulationStep, 0.0, 1.0));
+	return timing;
+}
+
+void dx3d::FrameScheduler::startSimulationThread(SimulationFunction simulate)
+{
+	if (!simulate) DX3DLogThrowInvalidArg("No simulation function provided.");
+	if (isSimulationThreaded()) DX3DLogThrowError("The simulation thread is already running.");
+
+	m_stopSimulation = false;
+	m_lastStepTime = now();
+	m_simulationThread = std::thread(&FrameScheduler::simulationLoop, this, std::move(simulate));
+}
+
+void dx3d::FrameScheduler::stopSimulationThread()
+{
+	if (!m_simulationThread.joinable()) return;
+	m_stopSimulation = true;
+	m_simulationThread.join();
+	// the inline accumulator starts from here, not from the frame the thread was started in
+	m_accumulator = 0.0;
+}
+
+bool dx3d::FrameScheduler::isSimulationThreaded() const noexcept
+{
+	return m_simulationThread.joinable();
+}
+
+dx3d::d64 dx3d::FrameScheduler::now() const noexcept
+{
+	if (m_clock) return m_clock();
+	return std::chrono::duration<d64>(std::chrono::steady_clock::now() - m_start).count();
+}
+
+dx3d::f32 dx3d::FrameScheduler::getInterpolation(d64 stepTime) const noexcept
+{
+	return static_cast<f32>(std::clamp((now() - stepTime) / m_simulationStep, 0.0, 1.0));
+}
+
+dx3d::d64 dx3d::FrameScheduler::getSimulationStep() const noexcept
+{
+	return m_simulationStep;
+}
+
+void dx3d::FrameScheduler::setFrameRateCap(d64 framesPerSecond) noexcept
+{
+	m_framePeriod = framesPerSecond > 0.0 ? 1.0 / framesPerSecond : 0.0;
+	m_nextFrameTime = now();
+}
+
+dx3d::FrameSchedulerStats dx3d::FrameScheduler::getStats() const noexcept
+{
+	auto stats = m_stats;
+	stats.simulationSteps += m_threadSteps.load(std::memory_order_relaxed);
+	stats.droppedSteps += m_threadDroppedSteps.load(std::memory_order_relaxed);
+	return stats;
+}
+
+dx3d::d64 dx3d::FrameScheduler::waitUntil(d64 deadline, SleepEstimate& sleepEstimate) const
+{
+	DX3DProfileZone("FrameScheduler::wait");
+	const auto start = now();
+	auto time = start;
+
+	if (m_pacing == FramePacing::Sleep)
+	{
+		// a sleep can overshoot by the timer granularity, so only sleep while even a bad overshoot still fits
+		while (deadline - time > sleepEstimate.estimate)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			const auto after = now();
+			const auto observed = after - time;
+			time = after;
+
+			// Welford's running mean and variance of how long a 1 ms sleep really takes
+			sleepEstimate.count++;
+			const auto delta = observed - sleepEstimate.mean;
+			sleepEstimate.mean += delta / static_cast<d64>(sleepEstimate.count);
+			sleepEstimate.m2 += delta * (observed - sleepEstimate.mean);
+			sleepEstimate.estimate = sleepEstimate.mean + std::sqrt(sleepEstimate.m2 / static_cast<d64>(sleepEstimate.count - 1));
+		}
+	}
+
+	while (time < deadline)
+	{
+		if (m_pacing != FramePacing::Spin) std::this_thread::yield();
+		time = now();
+	}
+	return time - start;
+}
+
+void dx3d::FrameScheduler::simulationLoop(SimulationFunction simulate)
+{
+	Profiler::get().setThreadName("Simulation");
+	SleepEstimate sleepEstimate{};
+	auto next = now();
+	ui64 tick = 0;
+
+	try
+	{
+		while (!m_stopSimulation.load(std::memory_order_acquire))
+		{
+			const auto time = now();
+			if (time < next)
+			{
+				// at most one step long, so stopping never waits for more than that
+				waitUntil(next, sleepEstimate);
+				continue;
+			}
+
+			const auto behind = static_cast<ui64>((time - next) / m_simulationStep);
+			if (behind > m_maxStepsPerFrame)
+			{
+				m_threadDroppedSteps.fetch_add(behind - m_maxStepsPerFrame, std::memory_order_relaxed);
+				next += static_cast<d64>(behind - m_maxStepsPerFrame) * m_simulationStep;
+			}
+
+			{
+				DX3DProfileZone("FrameScheduler::simulate");
+				simulate(m_simulationStep, tick++, next);
+			}
+			m_lastStepTime.store(next, std::memory_order_release);
+			m_threadSteps.fetch_add(1, std::memory_order_relaxed);
+			next += m_simulationStep;
+		}
+	}
+	catch (...)
+	{
+		m_simulationError = std::current_exception();
+		m_simulationFailed.store(true, std::memory_order_release);
+	}
+}
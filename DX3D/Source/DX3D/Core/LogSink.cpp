@@ -0,0 +1,32 @@
+#include <DX3D/Core/LogSink.h>
+#include <iostream>
+
+void dx3d::ConsoleLogSink::write(Logger::LogLevel, const char* line, std::size_t length)
+{
+    std::clog.write(line, static_cast<std::streamsize>(length));
+}
+
+void dx3d::ConsoleLogSink::flush()
+{
+    std::clog.flush();
+}
+
+dx3d::FileLogSink::FileLogSink(const std::string& path, bool append) :
+    m_file(path, std::ios::binary | (append ? std::ios::app : std::ios::trunc))
+{
+}
+
+bool dx3d::FileLogSink::isOpen() const noexcept
+{
+    return m_file.is_open();
+}
+
+void dx3d::FileLogSink::write(Logger::LogLevel, const char* line, std::size_t length)
+{
+    if (m_file) m_file.write(line, static_cast<std::streamsize>(length));
+}
+
+void dx3d::FileLogSink::flush()
+{
+    if (m_file) m_file.flush();
+}
@@ -1,28 +1,266 @@
 #include <DX3D/Core/Logger.h>
-#include <iostream>
+#include <DX3D/Core/LogSink.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
 
-dx3d::Logger::Logger(LogLevel logLevel) : m_logLevel(logLevel)
+namespace
 {
-    std::clog << "S.A.Cao | C++ 3D Game Thingy" << "\n";
-    std::clog << "-----------------------------" << "\n";
+    constexpr const char* LoggerBanner =
+        "S.A.Cao | C++ 3D Game Thingy\n"
+        "-----------------------------\n";
+
+    // "[DX3D Warning]: " + message + "\n"
+    std::string formatLine(dx3d::Logger::LogLevel level, const char* message, std::size_t length)
+    {
+        std::string line{};
+        line.reserve(length + 18);
+        line += "[DX3D ";
+        line += dx3d::Logger::GetLogLevelName(level);
+        line += "]: ";
+        line.append(message, length);
+        line += '\n';
+        return line;
+    }
+}
+
+/*
+* Bounded multi-producer / single-consumer ring of fixed-size records (Vyukov's bounded queue).
+* Every cell carries a sequence number: a producer claims position p by CAS on enqueuePos once the
+* cell's sequence equals p, copies the message and publishes it with sequence p + 1. The writer thread
+* consumes p when it sees p + 1 and hands the cell back to the producers with p + capacity.
+* Producers never lock or allocate; formatting and sink I/O only happen on the writer thread.
+*/
+struct dx3d::Logger::AsyncQueue
+{
+    struct Record
+    {
+        LogLevel level{};
+        std::uint32_t length{};
+        char message[MaxRecordMessageLength]{};
+    };
+
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence{};
+        Record record{};
+    };
+
+    explicit AsyncQueue(std::size_t capacity) : cells(std::make_unique<Cell[]>(capacity)), mask(capacity - 1)
+    {
+        for (std::size_t i = 0; i < capacity; i++)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    bool tryPush(LogLevel level, const char* message, std::size_t length) noexcept
+    {
+        auto pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell{};
+        while (true)
+        {
+            cell = &cells[pos & mask];
+            const auto sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0) return false;
+            else pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+
+        cell->record.level = level;
+        cell->record.length = static_cast<std::uint32_t>(length);
+        std::memcpy(cell->record.message, message, length);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // writer thread only
+    const Record* peek() const noexcept
+    {
+        const auto& cell = cells[dequeuePos & mask];
+        return cell.sequence.load(std::memory_order_acquire) == dequeuePos + 1 ? &cell.record : nullptr;
+    }
+
+    // writer thread only, after peek returned a record
+    void pop() noexcept
+    {
+        cells[dequeuePos & mask].sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+        dequeuePos++;
+    }
+
+    void wakeWriter() noexcept
+    {
+        signal.fetch_add(1, std::memory_order_release);
+        signal.notify_one();
+    }
+
+    std::unique_ptr<Cell[]> cells;
+    const std::size_t mask;
+    Logger::OverflowPolicy overflowPolicy{};
+
+    alignas(64) std::atomic<std::size_t> enqueuePos{};
+    alignas(64) std::size_t dequeuePos{};
+    std::atomic<std::size_t> writtenPos{};          // records before this position reached the sinks
+    std::atomic<std::uint32_t> signal{};            // bumped by producers to wake the writer
+    std::atomic<unsigned long long> dropped{};
+    std::atomic<bool> stopping{};
+    std::thread writer{};
+};
+
+dx3d::Logger::Logger(LogLevel logLevel) : Logger(LoggerDesc{ logLevel })
+{
+}
+
+dx3d::Logger::Logger(const LoggerDesc& desc) : m_logLevel(desc.logLevel), m_sinks(desc.sinks)
+{
+    if (m_sinks.empty()) m_sinks.push_back(std::make_shared<ConsoleLogSink>());
+
+    for (auto& sink : m_sinks)
+        sink->write(LogLevel::Info, LoggerBanner, std::strlen(LoggerBanner));
+
+    if (!desc.async) return;
+
+    std::size_t capacity = 2;
+    while (capacity < desc.queueCapacity) capacity <<= 1;
+
+    m_async = std::make_unique<AsyncQueue>(capacity);
+    m_async->overflowPolicy = desc.overflowPolicy;
+    m_async->writer = std::thread([this]()
+        {
+            auto& queue = *m_async;
+            unsigned long long reportedDrops{};
+            while (true)
+            {
+                const auto signal = queue.signal.load(std::memory_order_acquire);
+
+                auto written = false;
+                while (const auto* record = queue.peek())
+                {
+                    write(record->level, record->message, record->length);
+                    queue.pop();
+                    written = true;
+                }
+
+                const auto dropped = queue.dropped.load(std::memory_order_relaxed);
+                if (dropped != reportedDrops)
+                {
+                    const auto message = std::to_string(dropped - reportedDrops) + " log messages dropped, the queue was full.";
+                    write(LogLevel::Warning, message.c_str(), message.size());
+                    reportedDrops = dropped;
+                    written = true;
+                }
+
+                if (written)
+                {
+                    for (auto& sink : m_sinks)
+                        sink->flush();
+                    queue.writtenPos.store(queue.dequeuePos, std::memory_order_release);
+                    queue.writtenPos.notify_all();
+                    continue;
+                }
+
+                // only stop once the queue is drained
+                if (queue.stopping.load(std::memory_order_acquire)) return;
+                queue.signal.wait(signal, std::memory_order_acquire);
+            }
+        });
 }
 
 dx3d::Logger::~Logger()
 {
+    if (m_async)
+    {
+        m_async->stopping.store(true, std::memory_order_release);
+        m_async->wakeWriter();
+        m_async->writer.join();
+    }
+    else
+    {
+        for (auto& sink : m_sinks)
+            sink->flush();
+    }
 }
 
 void dx3d::Logger::log(LogLevel level, const char* message)
 {
-    auto logLevelToString = [](LogLevel level) {
-        switch (level)
+    if (level > m_logLevel) return;
+    if (!message) message = "";
+
+    if (!m_async)
+    {
+        const auto length = std::strlen(message);
+        std::lock_guard lock(m_sinkMutex);
+        write(level, message, length);
+        return;
+    }
+
+    auto& queue = *m_async;
+    const auto length = static_cast<std::size_t>(std::find(message, message + MaxRecordMessageLength, '\0') - message);
+    const auto wait = level == LogLevel::Error || queue.overflowPolicy == OverflowPolicy::Block;
+    while (!queue.tryPush(level, message, length))
+    {
+        if (!wait)
         {
-        case LogLevel::Info: return "Info";
-        case LogLevel::Warning: return "Warning";
-        case LogLevel::Error: return "Error";
-        default: return "Unknown";
+            queue.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
         }
-        };
+        queue.wakeWriter();
+        std::this_thread::yield();
+    }
+    queue.wakeWriter();
 
-    if (level > m_logLevel) return;
-    std::clog << "[DX3D " << logLevelToString(level) << "]: " << message << "\n";
-}
\ No newline at end of file
+    // errors usually end in an exception or a crash, so they are on the sinks before log returns
+    if (level == LogLevel::Error) flush();
+}
+
+void dx3d::Logger::flush()
+{
+    if (!m_async)
+    {
+        std::lock_guard lock(m_sinkMutex);
+        for (auto& sink : m_sinks)
+            sink->flush();
+        return;
+    }
+
+    // the writer thread itself never waits on itself
+    if (std::this_thread::get_id() == m_async->writer.get_id()) return;
+
+    auto& queue = *m_async;
+    const auto target = queue.enqueuePos.load(std::memory_order_acquire);
+    queue.wakeWriter();
+    auto written = queue.writtenPos.load(std::memory_order_acquire);
+    while (written < target)
+    {
+        queue.writtenPos.wait(written, std::memory_order_acquire);
+        written = queue.writtenPos.load(std::memory_order_acquire);
+    }
+}
+
+unsigned long long dx3d::Logger::getDroppedCount() const noexcept
+{
+    return m_async ? m_async->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+const char* dx3d::Logger::GetLogLevelName(LogLevel level) noexcept
+{
+    switch (level)
+    {
+    case LogLevel::Info: return "Info";
+    case LogLevel::Warning: return "Warning";
+    case LogLevel::Error: return "Error";
+    default: return "Unknown";
+    }
+}
+
+void dx3d::Logger::write(LogLevel level, const char* message, std::size_t length)
+{
+    const auto line = formatLine(level, message, length);
+    for (auto& sink : m_sinks)
+        sink->write(level, line.data(), line.size());
+}
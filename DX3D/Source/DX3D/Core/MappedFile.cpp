@@ -0,0 +1,29 @@
+#include <DX3D/Core/MappedFile.h>
+#include <utility>
+
+dx3d::MappedFile::MappedFile(const std::filesystem::path& path)
+{
+	open(path);
+}
+
+dx3d::MappedFile::~MappedFile()
+{
+	close();
+}
+
+dx3d::MappedFile::MappedFile(MappedFile&& other) noexcept :
+	m_data(std::exchange(other.m_data, nullptr)),
+	m_size(std::exchange(other.m_size, 0))
+{
+}
+
+dx3d::MappedFile& dx3d::MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		close();
+		m_data = std::exchange(other.m_data, nullptr);
+		m_size = std::exchange(other.m_size, 0);
+	}
+	return *this;
+}
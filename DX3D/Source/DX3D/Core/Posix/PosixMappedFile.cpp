@@ -0,0 +1,38 @@
+#include <DX3D/Core/MappedFile.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool dx3d::MappedFile::open(const std::filesystem::path& path)
+{
+	close();
+
+	const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (file < 0) return false;
+
+	struct stat status{};
+	if (fstat(file, &status) != 0 || status.st_size <= 0 ||
+		static_cast<ui64>(status.st_size) > static_cast<ui64>(SIZE_MAX))
+	{
+		::close(file);
+		return false;
+	}
+
+	// the mapping keeps its own reference to the file, the descriptor is not needed once it exists
+	const auto size = static_cast<size_t>(status.st_size);
+	auto view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+	::close(file);
+	if (view == MAP_FAILED) return false;
+
+	m_data = static_cast<const unsigned char*>(view);
+	m_size = size;
+	return true;
+}
+
+void dx3d::MappedFile::close() noexcept
+{
+	if (m_data) munmap(const_cast<unsigned char*>(m_data), m_size);
+	m_data = nullptr;
+	m_size = 0;
+}
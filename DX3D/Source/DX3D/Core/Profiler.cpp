@@ -0,0 +1,210 @@
+#include <DX3D/Core/Profiler.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace
+{
+	thread_local void* t_threadBuffer{};
+	thread_local std::string t_threadName{};   // given before the thread had a buffer
+
+	void WriteJsonString(std::ofstream& file, const char* text)
+	{
+		file << '"';
+		for (auto c = text ? text : ""; *c; c++)
+		{
+			if (*c == '"' || *c == '\\') file << '\\' << *c;
+			else if (static_cast<unsigned char>(*c) < 0x20) file << ' ';
+			else file << *c;
+		}
+		file << '"';
+	}
+}
+
+dx3d::Profiler::ScopedZone::ScopedZone(const char* name) noexcept : m_name(name)
+{
+	if (Profiler::get().isEnabled())
+		m_startNs = Profiler::now();
+}
+
+dx3d::Profiler::ScopedZone::~ScopedZone()
+{
+	if (m_startNs)
+		Profiler::get().record(m_name, m_startNs, Profiler::now());
+}
+
+dx3d::Profiler::Profiler() : m_epochNs(now())
+{
+}
+
+dx3d::Profiler& dx3d::Profiler::get() noexcept
+{
+	static Profiler profiler{};
+	return profiler;
+}
+
+dx3d::ui64 dx3d::Profiler::now() noexcept
+{
+	return static_cast<ui64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void dx3d::Profiler::setEnabled(bool enabled) noexcept
+{
+	m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool dx3d::Profiler::isEnabled() const noexcept
+{
+	return m_enabled.load(std::memory_order_relaxed);
+}
+
+void dx3d::Profiler::setThreadName(const char* name)
+{
+	// a thread only gets its event ring once it records, until then the name waits for it
+	if (!t_threadBuffer && !isEnabled())
+	{
+		t_threadName = name ? name : "";
+		return;
+	}
+
+	auto& buffer = getThreadBuffer();
+	std::lock_guard lock(m_threadsMutex);
+	buffer.name = name ? name : "";
+}
+
+void dx3d::Profiler::record(const char* name, ui64 startNs, ui64 endNs) noexcept
+{
+	auto* buffer = static_cast<ThreadBuffer*>(t_threadBuffer);
+	if (!buffer)
+	{
+		// the thread's first event allocates its ring; zones end in destructors, so without memory the event is dropped
+		try
+		{
+			buffer = &getThreadBuffer();
+		}
+		catch (...)
+		{
+			return;
+		}
+	}
+
+	// only the owning thread writes its buffer, the counter is published for the exporter
+	const auto index = buffer->written.load(std::memory_order_relaxed);
+	buffer->events[index % EventsPerThread] = { name, startNs, endNs };
+	buffer->written.store(index + 1, std::memory_order_release);
+}
+
+void dx3d::Profiler::markFrame() noexcept
+{
+	if (!isEnabled()) return;
+
+	const auto frameEnd = now();
+	std::lock_guard lock(m_framesMutex);
+	if (m_lastFrameNs)
+	{
+		record("Frame", m_lastFrameNs, frameEnd);
+
+		const auto frameMs = static_cast<d64>(frameEnd - m_lastFrameNs) / 1.0e6;
+		if (m_frameTimesMs.size() < FrameHistorySize) m_frameTimesMs.push_back(frameMs);
+		else m_frameTimesMs[m_frameCursor] = frameMs;
+		m_frameCursor = (m_frameCursor + 1) % FrameHistorySize;
+	}
+	m_lastFrameNs = frameEnd;
+}
+
+dx3d::ProfilerFrameStats dx3d::Profiler::getFrameStats() const
+{
+	std::vector<d64> frames{};
+	{
+		std::lock_guard lock(m_framesMutex);
+		frames = m_frameTimesMs;
+	}
+	if (frames.empty()) return {};
+
+	ProfilerFrameStats stats{};
+	stats.frameCount = frames.size();
+	stats.minMs = *std::min_element(frames.begin(), frames.end());
+	stats.maxMs = *std::max_element(frames.begin(), frames.end());
+	d64 total{};
+	for (auto frame : frames) total += frame;
+	stats.avgMs = total / static_cast<d64>(frames.size());
+
+	// nearest-rank percentile
+	const auto rank = (frames.size() * 99 + 99) / 100 - 1;
+	std::nth_element(frames.begin(), frames.begin() + rank, frames.end());
+	stats.p99Ms = frames[rank];
+	return stats;
+}
+
+bool dx3d::Profiler::exportChromeTrace(const std::filesystem::path& path) const
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (!file) return false;
+
+	char number[64]{};
+	bool first = true;
+	auto separator = [&]() { if (!first) file << ",\n"; first = false; };
+
+	file << "{\"traceEvents\":[\n";
+	std::lock_guard lock(m_threadsMutex);
+	for (const auto& thread : m_threads)
+	{
+		if (!thread->name.empty())
+		{
+			separator();
+			file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->threadId << ",\"args\":{\"name\":";
+			WriteJsonString(file, thread->name.c_str());
+			file << "}}";
+		}
+
+		const auto written = thread->written.load(std::memory_order_acquire);
+		const auto count = std::min<ui64>(written, EventsPerThread);
+		for (auto i = written - count; i < written; i++)
+		{
+			const auto& event = thread->events[i % EventsPerThread];
+			const auto start = event.startNs > m_epochNs ? event.startNs - m_epochNs : 0;
+
+			separator();
+			file << "{\"name\":";
+			WriteJsonString(file, event.name);
+			std::snprintf(number, sizeof(number), "%.3f", static_cast<d64>(start) / 1000.0);
+			file << ",\"ph\":\"X\",\"ts\":" << number;
+			std::snprintf(number, sizeof(number), "%.3f", static_cast<d64>(event.endNs - event.startNs) / 1000.0);
+			file << ",\"dur\":" << number << ",\"pid\":1,\"tid\":" << thread->threadId << "}";
+		}
+	}
+	file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return static_cast<bool>(file);
+}
+
+void dx3d::Profiler::reset()
+{
+	{
+		std::lock_guard lock(m_threadsMutex);
+		for (auto& thread : m_threads)
+			thread->written.store(0, std::memory_order_release);
+	}
+	std::lock_guard lock(m_framesMutex);
+	m_frameTimesMs.clear();
+	m_frameCursor = 0;
+	m_lastFrameNs = 0;
+}
+
+dx3d::Profiler::ThreadBuffer& dx3d::Profiler::getThreadBuffer()
+{
+	if (t_threadBuffer) return *static_cast<ThreadBuffer*>(t_threadBuffer);
+
+	// first event on this thread, buffers are kept until exit so the trace still has them
+	auto buffer = std::make_unique<ThreadBuffer>();
+	buffer->events.resize(EventsPerThread);
+
+	std::lock_guard lock(m_threadsMutex);
+	buffer->threadId = static_cast<ui32>(m_threads.size() + 1);
+	buffer->name = std::move(t_threadName);
+	t_threadBuffer = buffer.get();
+	m_threads.push_back(std::move(buffer));
+	return *m_threads.back();
+}
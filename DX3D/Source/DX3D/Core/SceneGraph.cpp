@@ -0,0 +1,360 @@
+#include <DX3D/Core/SceneGraph.h>
+#include <DX3D/Core/ThreadPool.h>
+#include <DX3D/Core/Profiler.h>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <type_traits>
+
+dx3d::SceneNode dx3d::SceneGraph::createNode(SceneNode parent, const Mat4& local, Entity entity)
+{
+	const auto parentIndex = parent ? getIndex(parent) : NoParent;
+	const auto depth = parent ? m_depths[parentIndex] + 1 : 0;
+
+	ui32 slot{};
+	if (m_freeSlots.empty())
+	{
+		slot = static_cast<ui32>(m_slots.size());
+		m_slots.push_back({});
+	}
+	else
+	{
+		slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+
+	// appended at the end, which is still breadth first as long as it lands in the last level or opens a new one
+	const auto index = static_cast<ui32>(m_worlds.size());
+	m_slots[slot].index = index;
+	m_locals.push_back(local);
+	m_worlds.push_back(local);
+	m_parents.push_back(parentIndex);
+	m_depths.push_back(depth);
+	m_dirty.push_back(0);
+	m_recomputedAt.push_back(0);
+	m_entities.push_back(entity);
+	m_indexSlots.push_back(slot);
+	markDirty(index);
+
+	if (!m_orderStale)
+	{
+		const auto levelCount = m_levelStarts.empty() ? 0 : static_cast<ui32>(m_levelStarts.size()) - 1;
+		if (m_levelStarts.empty())
+			m_levelStarts = { 0, 1 };
+		else if (depth + 1 == levelCount)
+			m_levelStarts.back()++;
+		else if (depth == levelCount)
+			m_levelStarts.push_back(index + 1);
+		else
+			m_orderStale = true;
+	}
+
+	return { slot + 1, m_slots[slot].generation };
+}
+
+void dx3d::SceneGraph::removeNode(SceneNode node)
+{
+	if (m_orderStale)
+		sortBreadthFirst();
+
+	// descendants come after the node and after their parents, one pass from the node finds them all
+	const auto target = getIndex(node);
+	const auto count = static_cast<ui32>(m_worlds.size());
+	std::vector<ui32> newIndex(count);
+	std::vector<unsigned char> removed(count, 0);
+	ui32 kept = 0;
+	for (ui32 i = 0; i < count; i++)
+	{
+		const auto parent = m_parents[i];
+		if (i == target || (i > target && parent != NoParent && removed[parent]))
+		{
+			removed[i] = 1;
+			newIndex[i] = NoParent;
+
+			auto& slot = m_slots[m_indexSlots[i]];
+			slot.generation++;
+			m_freeSlots.push_back(m_indexSlots[i]);
+			m_dirtyCount -= m_dirty[i];
+			continue;
+		}
+		newIndex[i] = kept++;
+	}
+
+	// dropping nodes keeps the order, only the levels have to be counted again
+	permute(newIndex, kept);
+	m_levelStarts.clear();
+	for (ui32 i = 0; i < kept; i++)
+	{
+		if (m_depths[i] == m_levelStarts.size())
+			m_levelStarts.push_back(i);
+	}
+	m_levelStarts.push_back(kept);
+}
+
+void dx3d::SceneGraph::clear()
+{
+	for (const auto slot : m_indexSlots)
+	{
+		m_slots[slot].generation++;
+		m_freeSlots.push_back(slot);
+	}
+
+	m_locals.clear();
+	m_worlds.clear();
+	m_parents.clear();
+	m_depths.clear();
+	m_dirty.clear();
+	m_recomputedAt.clear();
+	m_entities.clear();
+	m_indexSlots.clear();
+	m_levelStarts.clear();
+	m_dirtyCount = 0;
+	m_firstDirtyLevel = ~0u;
+	m_lastDirtyLevel = 0;
+	m_orderStale = false;
+}
+
+bool dx3d::SceneGraph::contains(SceneNode node) const noexcept
+{
+	return node.id && node.id <= m_slots.size() && m_slots[node.id - 1].generation == node.generation;
+}
+
+void dx3d::SceneGraph::setParent(SceneNode node, SceneNode parent)
+{
+	const auto index = getIndex(node);
+	const auto parentIndex = parent ? getIndex(parent) : NoParent;
+	if (m_parents[index] == parentIndex)
+		return;
+
+	for (auto ancestor = parentIndex; ancestor != NoParent; ancestor = m_parents[ancestor])
+	{
+		if (ancestor == index)
+			throw std::invalid_argument("A scene node cannot be parented to itself or one of its descendants");
+	}
+
+	// the subtree changes depth, the next update() sorts it into its new levels
+	m_parents[index] = parentIndex;
+	markDirty(index);
+	m_orderStale = true;
+}
+
+dx3d::SceneNode dx3d::SceneGraph::getParent(SceneNode node) const
+{
+	const auto parent = m_parents[getIndex(node)];
+	if (parent == NoParent)
+		return {};
+	const auto slot = m_indexSlots[parent];
+	return { slot + 1, m_slots[slot].generation };
+}
+
+void dx3d::SceneGraph::setLocal(SceneNode node, const Mat4& local)
+{
+	const auto index = getIndex(node);
+	m_locals[index] = local;
+	markDirty(index);
+}
+
+const dx3d::Mat4& dx3d::SceneGraph::getLocal(SceneNode node) const
+{
+	return m_locals[getIndex(node)];
+}
+
+const dx3d::Mat4& dx3d::SceneGraph::getWorld(SceneNode node) const
+{
+	return m_worlds[getIndex(node)];
+}
+
+void dx3d::SceneGraph::setEntity(SceneNode node, Entity entity)
+{
+	m_entities[getIndex(node)] = entity;
+}
+
+dx3d::Entity dx3d::SceneGraph::getEntity(SceneNode node) const
+{
+	return m_entities[getIndex(node)];
+}
+
+void dx3d::SceneGraph::update(ThreadPool* threadPool)
+{
+	DX3DProfileZone("SceneGraph::update");
+
+	// a new index every update, so the nodes stamped by the previous one no longer count as recomputed
+	m_updateIndex++;
+	m_stats = {};
+	m_stats.nodes = static_cast<ui32>(m_worlds.size());
+	m_stats.sorted = m_orderStale;
+	if (m_orderStale)
+	{
+		// the depths the flags were recorded at may have changed
+		sortBreadthFirst();
+		m_firstDirtyLevel = 0;
+		m_lastDirtyLevel = ~0u;
+	}
+	m_stats.levels = m_levelStarts.empty() ? 0 : static_cast<ui32>(m_levelStarts.size()) - 1;
+	if (!m_dirtyCount)
+		return;
+
+	// level by level: a level only reads the worlds of the one above, which is complete by then.
+	// Nothing above the first flagged level changes, and below the last one only children of recomputed nodes do
+	const bool canSplit = threadPool && threadPool->getThreadCount() > 1;
+	ui32 recomputed = 0;
+	ui32 previousRecomputed = 0;
+	for (auto level = m_firstDirtyLevel; level < m_stats.levels; level++)
+	{
+		const auto first = m_levelStarts[level];
+		const auto last = m_levelStarts[level + 1];
+
+		// the work expected here: the flagged nodes plus the children of what the level above recomputed,
+		// at that level's average fan-out
+		size_t expected = m_dirtyCount;
+		if (level > 0 && previousRecomputed)
+			expected += static_cast<size_t>(previousRecomputed) * (last - first) / (first - m_levelStarts[level - 1]);
+
+		ui32 levelRecomputed = 0;
+		if (!canSplit || last - first <= BlockSize || expected < ParallelThreshold)
+		{
+			levelRecomputed = updateRange(first, last);
+		}
+		else
+		{
+			std::atomic<ui32> blocksRecomputed{};
+			threadPool->parallelFor((last - first + BlockSize - 1) / BlockSize, [&](ui32 block)
+				{
+					const auto blockFirst = first + block * BlockSize;
+					blocksRecomputed += updateRange(blockFirst, std::min(blockFirst + BlockSize, last));
+				});
+			levelRecomputed = blocksRecomputed;
+			m_stats.parallel = true;
+		}
+
+		recomputed += levelRecomputed;
+		previousRecomputed = levelRecomputed;
+		if (!levelRecomputed && level >= m_lastDirtyLevel)
+			break;
+	}
+
+	m_stats.recomputed = recomputed;
+	m_dirtyCount = 0;
+	m_firstDirtyLevel = ~0u;
+	m_lastDirtyLevel = 0;
+}
+
+const dx3d::SceneGraphStats& dx3d::SceneGraph::getStats() const noexcept
+{
+	return m_stats;
+}
+
+void dx3d::SceneGraph::markDirty(ui32 index) noexcept
+{
+	if (m_dirty[index])
+		return;
+
+	m_dirty[index] = 1;
+	m_dirtyCount++;
+	m_firstDirtyLevel = std::min(m_firstDirtyLevel, m_depths[index]);
+	m_lastDirtyLevel = std::max(m_lastDirtyLevel, m_depths[index]);
+}
+
+dx3d::ui32 dx3d::SceneGraph::getIndex(SceneNode node) const
+{
+	if (!contains(node))
+		throw std::invalid_argument("SceneNode handle is stale or null");
+	return m_slots[node.id - 1].index;
+}
+
+void dx3d::SceneGraph::sortBreadthFirst()
+{
+	const auto count = static_cast<ui32>(m_worlds.size());
+
+	// children grouped by parent (counting sort), the roots keep their relative order
+	std::vector<ui32> childStarts(count + 1, 0);
+	for (ui32 i = 0; i < count; i++)
+	{
+		if (m_parents[i] != NoParent)
+			childStarts[m_parents[i] + 1]++;
+	}
+	for (ui32 i = 0; i < count; i++)
+		childStarts[i + 1] += childStarts[i];
+
+	std::vector<ui32> children(childStarts[count]);
+	std::vector<ui32> cursor(childStarts.begin(), childStarts.end() - 1);
+	std::vector<ui32> order;
+	order.reserve(count);
+	for (ui32 i = 0; i < count; i++)
+	{
+		if (m_parents[i] == NoParent)
+			order.push_back(i);
+		else
+			children[cursor[m_parents[i]]++] = i;
+	}
+
+	// the order vector is its own queue: every node visited appends its children
+	m_levelStarts.clear();
+	std::vector<ui32> depths(count);
+	for (ui32 head = 0; head < order.size(); head++)
+	{
+		const auto node = order[head];
+		depths[node] = m_parents[node] == NoParent ? 0 : depths[m_parents[node]] + 1;
+		if (depths[node] == m_levelStarts.size())
+			m_levelStarts.push_back(head);
+		for (auto child = childStarts[node]; child < childStarts[node + 1]; child++)
+			order.push_back(children[child]);
+	}
+	m_levelStarts.push_back(count);
+	m_depths = std::move(depths);
+
+	std::vector<ui32> newIndex(count);
+	for (ui32 i = 0; i < count; i++)
+		newIndex[order[i]] = i;
+	permute(newIndex, count);
+	m_orderStale = false;
+}
+
+dx3d::ui32 dx3d::SceneGraph::updateRange(ui32 first, ui32 last) noexcept
+{
+	ui32 count = 0;
+	for (auto i = first; i < last; i++)
+	{
+		const auto parent = m_parents[i];
+		const bool parentRecomputed = parent != NoParent && m_recomputedAt[parent] == m_updateIndex;
+		if (!m_dirty[i] && !parentRecomputed)
+			continue;
+
+		m_worlds[i] = parent == NoParent ? m_locals[i] : m_locals[i] * m_worlds[parent];
+		m_dirty[i] = 0;
+		m_recomputedAt[i] = m_updateIndex;
+		count++;
+	}
+	return count;
+}
+
+void dx3d::SceneGraph::permute(const std::vector<ui32>& newIndex, ui32 newSize)
+{
+	auto apply = [&](auto& values)
+		{
+			std::remove_reference_t<decltype(values)> moved(newSize);
+			for (size_t i = 0; i < values.size(); i++)
+			{
+				if (newIndex[i] != NoParent)
+					moved[newIndex[i]] = values[i];
+			}
+			values = std::move(moved);
+		};
+
+	for (size_t i = 0; i < m_parents.size(); i++)
+	{
+		if (newIndex[i] == NoParent) continue;
+		if (m_parents[i] != NoParent)
+			m_parents[i] = newIndex[m_parents[i]];
+		m_slots[m_indexSlots[i]].index = newIndex[i];
+	}
+
+	apply(m_locals);
+	apply(m_worlds);
+	apply(m_parents);
+	apply(m_depths);
+	apply(m_dirty);
+	apply(m_recomputedAt);
+	apply(m_entities);
+	apply(m_indexSlots);
+}
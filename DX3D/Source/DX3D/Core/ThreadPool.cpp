@@ -0,0 +1,119 @@
+#include <DX3D/Core/ThreadPool.h>
+#include <DX3D/Core/Profiler.h>
+#include <string>
+
+namespace
+{
+	thread_local bool t_insideThreadPool{};
+}
+
+dx3d::ThreadPool::ThreadPool(const ThreadPoolDesc& desc) : Base(desc.base)
+{
+	auto workerCount = desc.workerCount;
+	if (workerCount == ~0u)
+	{
+		const auto hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+
+	m_workers.reserve(workerCount);
+	for (ui32 i = 0; i < workerCount; i++)
+		m_workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+dx3d::ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard lock(m_mutex);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+	for (auto& worker : m_workers)
+		worker.join();
+}
+
+dx3d::ui32 dx3d::ThreadPool::getThreadCount() const noexcept
+{
+	return static_cast<ui32>(m_workers.size()) + 1;
+}
+
+void dx3d::ThreadPool::parallelFor(ui32 count, const std::function<void(ui32 index)>& task)
+{
+	if (!count) return;
+	if (m_workers.empty() || count == 1 || t_insideThreadPool)
+	{
+		for (ui32 i = 0; i < count; i++)
+			task(i);
+		return;
+	}
+
+	std::lock_guard submit(m_submitMutex);
+	{
+		std::lock_guard lock(m_mutex);
+		m_task = &task;
+		m_count = count;
+		m_next.store(0, std::memory_order_relaxed);
+		m_completed = 0;
+		m_error = nullptr;
+		m_generation++;
+	}
+	m_wake.notify_all();
+
+	t_insideThreadPool = true;
+	runTasks();
+	t_insideThreadPool = false;
+
+	std::exception_ptr error{};
+	{
+		// workers still inside runTasks hold on to m_task, so the batch is only over once they left
+		std::unique_lock lock(m_mutex);
+		m_done.wait(lock, [this]() { return m_completed == m_count && !m_active; });
+		m_task = nullptr;
+		error = m_error;
+		m_error = nullptr;
+	}
+	if (error) std::rethrow_exception(error);
+}
+
+void dx3d::ThreadPool::workerLoop(ui32 workerIndex)
+{
+	t_insideThreadPool = true;
+	Profiler::get().setThreadName(("Worker " + std::to_string(workerIndex)).c_str());
+
+	ui64 seenGeneration{};
+	std::unique_lock lock(m_mutex);
+	while (true)
+	{
+		m_wake.wait(lock, [&]() { return m_stopping || (m_task && m_generation != seenGeneration); });
+		if (m_stopping) return;
+
+		seenGeneration = m_generation;
+		m_active++;
+		lock.unlock();
+		runTasks();
+		lock.lock();
+		if (!--m_active) m_done.notify_all();
+	}
+}
+
+void dx3d::ThreadPool::runTasks()
+{
+	while (true)
+	{
+		const auto index = m_next.fetch_add(1, std::memory_order_relaxed);
+		if (index >= m_count) return;
+
+		try
+		{
+			(*m_task)(index);
+		}
+		catch (...)
+		{
+			std::lock_guard lock(m_mutex);
+			if (!m_error) m_error = std::current_exception();
+		}
+
+		std::lock_guard lock(m_mutex);
+		if (++m_completed == m_count) m_done.notify_all();
+	}
+}
@@ -0,0 +1,39 @@
+#include <DX3D/Core/MappedFile.h>
+#include <Windows.h>
+
+bool dx3d::MappedFile::open(const std::filesystem::path& path)
+{
+	close();
+
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0 ||
+		static_cast<ui64>(size.QuadPart) > static_cast<ui64>(SIZE_MAX))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!mapping) return false;
+
+	// the view holds its own reference to the mapping, neither handle is needed once it exists
+	auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!view) return false;
+
+	m_data = static_cast<const unsigned char*>(view);
+	m_size = static_cast<size_t>(size.QuadPart);
+	return true;
+}
+
+void dx3d::MappedFile::close() noexcept
+{
+	if (m_data) UnmapViewOfFile(m_data);
+	m_data = nullptr;
+	m_size = 0;
+}
@@ -2,14 +2,26 @@
 #include <DX3D/Window/Window.h>
 #include <DX3D/Graphics/GraphicsEngine.h>
 #include <DX3D/Core/Logger.h>
+#include <DX3D/Core/Profiler.h>
 #include <DX3D/Game/Display.h>
 
 dx3d::Game::Game(const GameDesc& desc) :
-    Base({ *std::make_unique<Logger>(desc.logLevel).release() }),
-    m_loggerPtr(&m_logger)
+    Base({ *std::make_unique<Logger>(Logger::LoggerDesc{ desc.logLevel, desc.asyncLogging }).release() }),
+    m_loggerPtr(&m_logger),
+    m_simulationThread(desc.simulationThread),
+    m_logStatistics(desc.logStatistics)
 {
-    m_graphicsEngine = std::make_unique<GraphicsEngine>(GraphicsEngineDesc{ m_logger });
+    if (desc.enableProfiler)
+    {
+        Profiler::get().setEnabled(true);
+        Profiler::get().setThreadName("Main");
+        m_profilerTracePath = desc.profilerTracePath ? desc.profilerTracePath : "";
+    }
+
+    m_graphicsEngine = std::make_unique<GraphicsEngine>(GraphicsEngineDesc{ {m_logger}, desc.logStatistics });
     m_display = std::make_unique<Display>(DisplayDesc{ {m_logger,desc.windowSize},m_graphicsEngine->getGraphicsDevice() });
+    m_frameScheduler = std::make_unique<FrameScheduler>(FrameSchedulerDesc{ {m_logger}, desc.simulationStep,
+        desc.maxSimulationStepsPerFrame, desc.frameRateCap, desc.framePacing });
 
     DX3DLogInfo("Game initialized.");
 }
@@ -17,9 +29,50 @@ dx3d::Game::Game(const GameDesc& desc) :
 dx3d::Game::~Game()
 {
     DX3DLogInfo("Game is shutting down...");
+    m_frameScheduler->stopSimulationThread();
+
+    if (m_logStatistics)
+    {
+        const auto schedulerStats = m_frameScheduler->getStats();
+        DX3DLogInfo(("Frame scheduler: " + std::to_string(schedulerStats.frames) + " frames, " +
+            std::to_string(schedulerStats.simulationSteps) + " simulation steps (" +
+            std::to_string(schedulerStats.droppedSteps) + " dropped), " +
+            std::to_string(schedulerStats.idleSeconds) + " s idle.").c_str());
+    }
+
+    auto& profiler = Profiler::get();
+    if (profiler.isEnabled())
+    {
+        const auto stats = profiler.getFrameStats();
+        DX3DLogInfo(("Frame time over " + std::to_string(stats.frameCount) + " frames: min " +
+            std::to_string(stats.minMs) + " ms, avg " + std::to_string(stats.avgMs) + " ms, p99 " +
+            std::to_string(stats.p99Ms) + " ms, max " + std::to_string(stats.maxMs) + " ms.").c_str());
+
+        if (!m_profilerTracePath.empty() && !profiler.exportChromeTrace(m_profilerTracePath))
+            DX3DLogWarning("Could not write the profiler trace.");
+    }
+}
+
+dx3d::GraphicsEngine& dx3d::Game::getGraphicsEngine() noexcept
+{
+    return *m_graphicsEngine;
+}
+
+dx3d::FrameScheduler& dx3d::Game::getFrameScheduler() noexcept
+{
+    return *m_frameScheduler;
 }
 
 void dx3d::Game::onInternalUpdate()
 {
+    DX3DProfileZone("Game::onInternalUpdate");
+
+    // waits out the frame cap instead of spinning, then runs the fixed steps that became due (none when threaded)
+    const auto timing = m_frameScheduler->beginFrame();
+    const auto step = m_frameScheduler->getSimulationStep();
+    for (ui32 i = 0; i < timing.simulationSteps; i++)
+        onFixedUpdate(step, m_simulationTick++, timing.firstStepTime + static_cast<d64>(i) * step);
+
+    onFrame(timing);
     m_graphicsEngine->render(m_display->getSwapChain());
 }
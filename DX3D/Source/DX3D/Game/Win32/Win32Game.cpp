@@ -1,20 +1,36 @@
 #include <DX3D/Game/Game.h>
+#include <DX3D/Core/Profiler.h>
 #include <Windows.h>
+#include <timeapi.h>
+
+#pragma comment(lib, "winmm.lib")
 
 void dx3d::Game::run()
 {
+	// 1 ms scheduler ticks for the frame pacing sleeps, instead of the default 15.6 ms
+	timeBeginPeriod(1);
+	if (m_simulationThread)
+		m_frameScheduler->startSimulationThread([this](d64 step, ui64 tick, d64 stepTime) { onFixedUpdate(step, tick, stepTime); });
+
 	MSG msg{};
 	while (m_isRunning) 
 	{
-		while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
+		DX3DProfileFrame();
 		{
-			if (msg.message == WM_QUIT) {
-				m_isRunning = false;
-				break;
+			DX3DProfileZone("Game::pumpMessages");
+			while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
+			{
+				if (msg.message == WM_QUIT) {
+					m_isRunning = false;
+					break;
+				}
+				TranslateMessage(&msg);
+				DispatchMessage(&msg);
 			}
-			TranslateMessage(&msg);
-			DispatchMessage(&msg);
 		}
 		onInternalUpdate();
 	}
+
+	m_frameScheduler->stopSimulationThread();
+	timeEndPeriod(1);
 }
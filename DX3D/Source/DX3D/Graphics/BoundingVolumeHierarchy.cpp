@@ -0,0 +1,331 @@
+#include <DX3D/Graphics/BoundingVolumeHierarchy.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+	using namespace dx3d;
+
+	inline f32 GetAxis(const Vec3& v, ui32 axis) noexcept
+	{
+		return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+	}
+
+	// partially sorts ids around the median centroid along the longest centroid axis, returns the split point
+	size_t SplitMedian(const std::vector<Aabb>& bounds, ui32* ids, size_t count)
+	{
+		auto centroids = Aabb::empty();
+		for (size_t i = 0; i < count; i++)
+			centroids.grow(bounds[ids[i]].center());
+
+		const auto size = centroids.max - centroids.min;
+		const ui32 axis = size.x >= size.y && size.x >= size.z ? 0 : size.y >= size.z ? 1 : 2;
+
+		// min + max orders the same way as the centroid and skips the multiply
+		const auto middle = count / 2;
+		std::nth_element(ids, ids + middle, ids + count, [&bounds, axis](ui32 a, ui32 b)
+			{
+				return GetAxis(bounds[a].min, axis) + GetAxis(bounds[a].max, axis) <
+					GetAxis(bounds[b].min, axis) + GetAxis(bounds[b].max, axis);
+			});
+		return middle;
+	}
+}
+
+void dx3d::BoundingVolumeHierarchy::insert(ui32 id, const Aabb& bounds)
+{
+	if (id >= m_states.size())
+	{
+		m_bounds.resize(static_cast<size_t>(id) + 1);
+		m_states.resize(static_cast<size_t>(id) + 1, ItemState::Absent);
+		m_pendingIndex.resize(static_cast<size_t>(id) + 1);
+	}
+	if (m_states[id] != ItemState::Absent)
+		throw std::invalid_argument("Item is already in the bounding volume hierarchy");
+
+	m_bounds[id] = bounds;
+	m_states[id] = ItemState::Pending;
+	m_pendingIndex[id] = static_cast<ui32>(m_pending.size());
+	m_pending.push_back(id);
+	m_itemCount++;
+}
+
+void dx3d::BoundingVolumeHierarchy::update(ui32 id, const Aabb& bounds)
+{
+	if (!contains(id))
+		throw std::invalid_argument("Item is not in the bounding volume hierarchy");
+
+	if (m_states[id] == ItemState::InTree)
+	{
+		// a small move is a refit; a jump would stretch every box up to the root, so the item leaves its leaf
+		// and waits in the pending list like a new one
+		auto stretched = m_bounds[id];
+		stretched.merge(bounds);
+		if (stretched.halfSurfaceArea() > 2.0f * m_bounds[id].halfSurfaceArea())
+		{
+			m_states[id] = ItemState::Pending;
+			m_pendingIndex[id] = static_cast<ui32>(m_pending.size());
+			m_pending.push_back(id);
+			m_removedFromTree++;
+		}
+		else
+		{
+			m_refitNeeded = true;
+		}
+	}
+	m_bounds[id] = bounds;
+}
+
+void dx3d::BoundingVolumeHierarchy::remove(ui32 id)
+{
+	if (!contains(id))
+		throw std::invalid_argument("Item is not in the bounding volume hierarchy");
+
+	if (m_states[id] == ItemState::Pending)
+	{
+		const auto index = m_pendingIndex[id];
+		m_pending[index] = m_pending.back();
+		m_pendingIndex[m_pending[index]] = index;
+		m_pending.pop_back();
+	}
+	else
+	{
+		// the leaf stays until the next rebuild, culling skips it
+		m_removedFromTree++;
+	}
+
+	m_states[id] = ItemState::Absent;
+	m_itemCount--;
+}
+
+void dx3d::BoundingVolumeHierarchy::clear()
+{
+	m_nodes.clear();
+	m_bounds.clear();
+	m_states.clear();
+	m_pendingIndex.clear();
+	m_pending.clear();
+	m_itemCount = 0;
+	m_builtCount = 0;
+	m_removedFromTree = 0;
+	m_builtCost = 0.0f;
+	m_refitNeeded = false;
+}
+
+bool dx3d::BoundingVolumeHierarchy::contains(ui32 id) const noexcept
+{
+	return id < m_states.size() && m_states[id] != ItemState::Absent;
+}
+
+void dx3d::BoundingVolumeHierarchy::cull(const Frustum& frustum, std::vector<ui32>& outVisible, CullingStats& stats)
+{
+	maintain(stats);
+
+	const auto visibleBefore = outVisible.size();
+	if (!m_nodes.empty())
+	{
+		m_stack.clear();
+		m_stack.push_back(0);
+		while (!m_stack.empty())
+		{
+			const auto& node = m_nodes[m_stack.back()];
+			m_stack.pop_back();
+			stats.nodesTested++;
+
+			const auto mask = frustum.classify4(node.bounds);
+			for (ui32 lane = 0; lane < node.count; lane++)
+			{
+				if (!(mask & (1u << lane)))
+					continue;
+
+				const auto child = node.children[lane];
+				if (child & LeafBit)
+				{
+					const auto id = child & ~LeafBit;
+					if (m_states[id] == ItemState::InTree)
+						outVisible.push_back(id);
+				}
+				else if (mask & (1u << (lane + 4)))
+				{
+					emitSubtree(child, outVisible);
+				}
+				else
+				{
+					m_stack.push_back(child);
+				}
+			}
+		}
+	}
+
+	for (const auto id : m_pending)
+	{
+		if (frustum.intersects(m_bounds[id]))
+			outVisible.push_back(id);
+	}
+
+	const auto visible = static_cast<ui32>(outVisible.size() - visibleBefore);
+	stats.visible += visible;
+	stats.culled += static_cast<ui32>(m_itemCount) - visible;
+}
+
+void dx3d::BoundingVolumeHierarchy::rebuild()
+{
+	std::vector<ui32> ids{};
+	ids.reserve(m_itemCount);
+	for (ui32 id = 0; id < m_states.size(); id++)
+	{
+		if (m_states[id] == ItemState::Absent)
+			continue;
+		m_states[id] = ItemState::InTree;
+		ids.push_back(id);
+	}
+
+	m_nodes.clear();
+	m_nodes.reserve(ids.size() / 3 + 1);
+	m_pending.clear();
+	m_builtCount = ids.size();
+	m_removedFromTree = 0;
+	m_refitNeeded = false;
+
+	if (!ids.empty())
+		buildNode(ids.data(), ids.size());
+	m_builtCost = getCost();
+}
+
+void dx3d::BoundingVolumeHierarchy::refit()
+{
+	// nodes are created before their children, so walking backwards sees every child before its parent
+	for (size_t i = m_nodes.size(); i-- > 0;)
+	{
+		auto& node = m_nodes[i];
+		for (ui32 lane = 0; lane < node.count; lane++)
+		{
+			const auto child = node.children[lane];
+			node.bounds.set(lane, child & LeafBit ? m_bounds[child & ~LeafBit] : getNodeBounds(child));
+		}
+	}
+	m_refitNeeded = false;
+}
+
+size_t dx3d::BoundingVolumeHierarchy::size() const noexcept
+{
+	return m_itemCount;
+}
+
+size_t dx3d::BoundingVolumeHierarchy::getNodeCount() const noexcept
+{
+	return m_nodes.size();
+}
+
+dx3d::ui32 dx3d::BoundingVolumeHierarchy::buildNode(ui32* ids, size_t count)
+{
+	const auto index = static_cast<ui32>(m_nodes.size());
+	m_nodes.emplace_back();
+
+	// up to four groups: one item each, or the quarters of two median splits
+	size_t groupBegin[4]{}, groupCount[4]{};
+	ui32 groups{};
+	if (count <= 4)
+	{
+		for (; groups < count; groups++)
+		{
+			groupBegin[groups] = groups;
+			groupCount[groups] = 1;
+		}
+	}
+	else
+	{
+		// count >= 5 leaves at least two items in each half
+		const auto half = SplitMedian(m_bounds, ids, count);
+		const auto firstQuarter = SplitMedian(m_bounds, ids, half);
+		const auto thirdQuarter = SplitMedian(m_bounds, ids + half, count - half);
+		groupBegin[0] = 0;                      groupCount[0] = firstQuarter;
+		groupBegin[1] = firstQuarter;           groupCount[1] = half - firstQuarter;
+		groupBegin[2] = half;                   groupCount[2] = thirdQuarter;
+		groupBegin[3] = half + thirdQuarter;    groupCount[3] = count - half - thirdQuarter;
+		groups = 4;
+	}
+
+	for (ui32 group = 0; group < groups; group++)
+	{
+		ui32 child{};
+		Aabb bounds{};
+		if (groupCount[group] == 1)
+		{
+			const auto id = ids[groupBegin[group]];
+			child = id | LeafBit;
+			bounds = m_bounds[id];
+		}
+		else
+		{
+			// m_nodes may reallocate in here, the node is only written through its index afterwards
+			child = buildNode(ids + groupBegin[group], groupCount[group]);
+			bounds = getNodeBounds(child);
+		}
+
+		auto& node = m_nodes[index];
+		node.children[group] = child;
+		node.bounds.set(group, bounds);
+	}
+	m_nodes[index].count = groups;
+	return index;
+}
+
+dx3d::Aabb dx3d::BoundingVolumeHierarchy::getNodeBounds(ui32 node) const noexcept
+{
+	const auto& n = m_nodes[node];
+	auto bounds = Aabb::empty();
+	for (ui32 lane = 0; lane < n.count; lane++)
+		bounds.merge(n.bounds.get(lane));
+	return bounds;
+}
+
+dx3d::f32 dx3d::BoundingVolumeHierarchy::getCost() const noexcept
+{
+	// surface area heuristic without the constants: how much space the child boxes cover in total
+	f32 cost{};
+	for (const auto& node : m_nodes)
+	{
+		for (ui32 lane = 0; lane < node.count; lane++)
+			cost += node.bounds.get(lane).halfSurfaceArea();
+	}
+	return cost;
+}
+
+void dx3d::BoundingVolumeHierarchy::emitSubtree(ui32 node, std::vector<ui32>& outVisible) const
+{
+	const auto& n = m_nodes[node];
+	for (ui32 lane = 0; lane < n.count; lane++)
+	{
+		const auto child = n.children[lane];
+		if (!(child & LeafBit))
+			emitSubtree(child, outVisible);
+		else if (m_states[child & ~LeafBit] == ItemState::InTree)
+			outVisible.push_back(child & ~LeafBit);
+	}
+}
+
+void dx3d::BoundingVolumeHierarchy::maintain(CullingStats& stats)
+{
+	// new and removed items cost a linear test or a dead leaf each, past an eighth of the tree a rebuild is cheaper
+	const auto churn = m_pending.size() + m_removedFromTree;
+	if (churn && churn > std::max<size_t>(32, m_builtCount / 8))
+	{
+		rebuild();
+		stats.rebuilds++;
+		return;
+	}
+
+	if (!m_refitNeeded)
+		return;
+
+	refit();
+	stats.refits++;
+
+	// refitting keeps the topology, once moved items have stretched the boxes to twice their size start over
+	if (getCost() > 2.0f * m_builtCost)
+	{
+		rebuild();
+		stats.rebuilds++;
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <DX3D/Math/Aabb.h>
+#include <DX3D/Math/Frustum.h>
+#include <vector>
+
+namespace dx3d
+{
+	struct CullingStats
+	{
+		ui32 visible{};
+		ui32 culled{};
+		ui32 nodesTested{};     // 4-wide nodes whose children went through the plane test
+		ui32 rebuilds{};
+		ui32 refits{};
+
+		CullingStats& operator+=(const CullingStats& other) noexcept
+		{
+			visible += other.visible;
+			culled += other.culled;
+			nodesTested += other.nodesTested;
+			rebuilds += other.rebuilds;
+			refits += other.refits;
+			return *this;
+		}
+	};
+
+	/*
+	* 4-wide BVH over items identified by small stable ids (the shape system uses entity slots).
+	* Every node holds the boxes of its four children as an Aabb4, so one Frustum::classify4 call tests
+	* all of them; children found completely inside are emitted without testing anything below them.
+	*
+	* Changes are cheap and applied lazily when culling:
+	* - moved items only refit the boxes bottom-up, the tree keeps its shape (items that jump far leave their leaf and go pending),
+	* - new items wait in a pending list that is tested one by one,
+	* - removed items stay in their leaf and are skipped,
+	* and the tree is rebuilt once the pending and removed items pile up or refits have let it grow loose.
+	*/
+	class BoundingVolumeHierarchy final
+	{
+	public:
+		void insert(ui32 id, const Aabb& bounds);
+		void update(ui32 id, const Aabb& bounds);
+		void remove(ui32 id);
+		void clear();
+		bool contains(ui32 id) const noexcept;
+
+		// appends the ids of all items touching the frustum to outVisible, rebuilding or refitting first when needed
+		void cull(const Frustum& frustum, std::vector<ui32>& outVisible, CullingStats& stats);
+
+		// top-down median split on the longest centroid axis, two levels per 4-wide node
+		void rebuild();
+		// recomputes every node box from the item boxes, children before parents
+		void refit();
+
+		size_t size() const noexcept;
+		size_t getNodeCount() const noexcept;
+
+	private:
+		enum class ItemState : unsigned char
+		{
+			Absent = 0,
+			InTree,
+			Pending
+		};
+
+		struct Node
+		{
+			Aabb4 bounds{};
+			ui32 children[4]{};     // node index, or item id with LeafBit set
+			ui32 count{};           // lanes in use
+		};
+
+		static constexpr ui32 LeafBit = 0x80000000u;
+
+		ui32 buildNode(ui32* ids, size_t count);
+		Aabb getNodeBounds(ui32 node) const noexcept;
+		f32 getCost() const noexcept;
+		void emitSubtree(ui32 node, std::vector<ui32>& outVisible) const;
+		void maintain(CullingStats& stats);
+
+	private:
+		std::vector<Node> m_nodes{};
+		std::vector<Aabb> m_bounds{};           // by id
+		std::vector<ItemState> m_states{};      // by id
+		std::vector<ui32> m_pendingIndex{};     // by id, where it sits in m_pending
+		std::vector<ui32> m_pending{};
+		std::vector<ui32> m_stack{};            // traversal scratch, kept to not allocate per cull
+
+		size_t m_itemCount{};
+		size_t m_builtCount{};                  // items the tree was built over
+		size_t m_removedFromTree{};
+		f32 m_builtCost{};                      // getCost() right after the last rebuild
+		bool m_refitNeeded{};
+	};
+}
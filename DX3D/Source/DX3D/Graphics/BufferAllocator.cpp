@@ -0,0 +1,130 @@
+#include <DX3D/Graphics/BufferAllocator.h>
+#include <algorithm>
+
+dx3d::BufferAllocator::BufferAllocator(ui32 capacity) : m_capacity(capacity)
+{
+	if (capacity) m_freeBlocks.push_back({ 0, capacity });
+}
+
+bool dx3d::BufferAllocator::allocate(ui32 size, Allocation& outAllocation)
+{
+	if (!size) throw std::invalid_argument("Cannot allocate an empty range.");
+
+	for (auto it = m_freeBlocks.begin(); it != m_freeBlocks.end(); ++it)
+	{
+		if (it->size < size) continue;
+
+		outAllocation = { it->offset, size };
+		it->offset += size;
+		it->size -= size;
+		if (!it->size) m_freeBlocks.erase(it);
+
+		m_usedSize += size;
+		return true;
+	}
+	return false;
+}
+
+void dx3d::BufferAllocator::free(const Allocation& allocation)
+{
+	if (!allocation.size) return;
+	if (allocation.offset + allocation.size > m_capacity)
+		throw std::invalid_argument("Freed range lies outside of the allocator.");
+
+	auto next = std::lower_bound(m_freeBlocks.begin(), m_freeBlocks.end(), allocation.offset,
+		[](const Allocation& block, ui32 offset) { return block.offset < offset; });
+
+	if (next != m_freeBlocks.end() && allocation.offset + allocation.size > next->offset)
+		throw std::invalid_argument("Freed range overlaps a free block (double free?).");
+	if (next != m_freeBlocks.begin())
+	{
+		auto& prev = *(next - 1);
+		if (prev.offset + prev.size > allocation.offset)
+			throw std::invalid_argument("Freed range overlaps a free block (double free?).");
+	}
+
+	m_usedSize -= allocation.size;
+
+	const bool touchesPrev = next != m_freeBlocks.begin() && (next - 1)->offset + (next - 1)->size == allocation.offset;
+	const bool touchesNext = next != m_freeBlocks.end() && allocation.offset + allocation.size == next->offset;
+
+	if (touchesPrev && touchesNext)
+	{
+		(next - 1)->size += allocation.size + next->size;
+		m_freeBlocks.erase(next);
+	}
+	else if (touchesPrev)
+	{
+		(next - 1)->size += allocation.size;
+	}
+	else if (touchesNext)
+	{
+		next->offset = allocation.offset;
+		next->size += allocation.size;
+	}
+	else
+	{
+		m_freeBlocks.insert(next, allocation);
+	}
+}
+
+void dx3d::BufferAllocator::grow(ui32 newCapacity)
+{
+	if (newCapacity <= m_capacity) return;
+
+	const ui32 extra = newCapacity - m_capacity;
+	if (!m_freeBlocks.empty() && m_freeBlocks.back().offset + m_freeBlocks.back().size == m_capacity)
+		m_freeBlocks.back().size += extra;
+	else
+		m_freeBlocks.push_back({ m_capacity, extra });
+
+	m_capacity = newCapacity;
+}
+
+void dx3d::BufferAllocator::reset()
+{
+	m_freeBlocks.clear();
+	if (m_capacity) m_freeBlocks.push_back({ 0, m_capacity });
+	m_usedSize = 0;
+}
+
+dx3d::ui32 dx3d::BufferAllocator::getCapacity() const noexcept
+{
+	return m_capacity;
+}
+
+dx3d::ui32 dx3d::BufferAllocator::getUsedSize() const noexcept
+{
+	return m_usedSize;
+}
+
+dx3d::ui32 dx3d::BufferAllocator::getLargestFreeBlock() const noexcept
+{
+	ui32 largest{};
+	for (const auto& block : m_freeBlocks)
+		largest = std::max(largest, block.size);
+	return largest;
+}
+
+size_t dx3d::BufferAllocator::getFreeBlockCount() const noexcept
+{
+	return m_freeBlocks.size();
+}
+
+std::vector<dx3d::BufferAllocator::Allocation> dx3d::BufferAllocator::mergeRanges(std::vector<Allocation> ranges)
+{
+	std::sort(ranges.begin(), ranges.end(),
+		[](const Allocation& a, const Allocation& b) { return a.offset < b.offset; });
+
+	std::vector<Allocation> merged{};
+	merged.reserve(ranges.size());
+	for (const auto& range : ranges)
+	{
+		if (!range.size) continue;
+		if (!merged.empty() && merged.back().offset + merged.back().size == range.offset)
+			merged.back().size += range.size;
+		else
+			merged.push_back(range);
+	}
+	return merged;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <vector>
+
+namespace dx3d
+{
+	/*
+	* Offset/size bookkeeping for sub-allocating a linear buffer.
+	* Units are whatever the owner decides (vertices, indices, bytes); nothing in here
+	* touches a graphics API, so it can be exercised on its own.
+	*/
+	class BufferAllocator final
+	{
+	public:
+		struct Allocation
+		{
+			ui32 offset{};
+			ui32 size{};
+		};
+
+	public:
+		explicit BufferAllocator(ui32 capacity = 0);
+
+		// first-fit, returns false when no free block is large enough (caller decides whether to grow)
+		bool allocate(ui32 size, Allocation& outAllocation);
+		// returns a range to the free-list, merging it with its neighbours
+		void free(const Allocation& allocation);
+		// extends the capacity at the tail, existing allocations keep their offsets
+		void grow(ui32 newCapacity);
+		void reset();
+
+		ui32 getCapacity() const noexcept;
+		ui32 getUsedSize() const noexcept;
+		ui32 getLargestFreeBlock() const noexcept;
+		size_t getFreeBlockCount() const noexcept;
+
+		// sorts ranges by offset and joins the ones that touch, so they can be drawn as one span
+		static std::vector<Allocation> mergeRanges(std::vector<Allocation> ranges);
+
+	private:
+		std::vector<Allocation> m_freeBlocks{}; // sorted by offset, never adjacent to each other
+		ui32 m_capacity{};
+		ui32 m_usedSize{};
+	};
+}
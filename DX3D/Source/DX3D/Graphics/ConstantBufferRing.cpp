@@ -0,0 +1,203 @@
+#include <DX3D/Graphics/ConstantBufferRing.h>
+#include <DX3D/Graphics/GraphicsBackend.h>
+#include <DX3D/Core/Hash.h>
+#include <DX3D/Core/Profiler.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	dx3d::ui32 AlignUp(dx3d::ui32 value, dx3d::ui32 alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+}
+
+dx3d::ConstantBufferRing::ConstantBufferRing(const ConstantBufferRingDesc& desc) :
+	Base(desc.base),
+	m_backend(desc.backend),
+	m_blockCapacity(std::max(desc.initialBlockCapacity, 1u))
+{
+	if (!desc.byteCapacity) DX3DLogThrowInvalidArg("Constant ring capacity must be greater than zero.");
+
+	m_uploadRing = std::make_unique<DynamicUploadRing>(DynamicUploadRingDesc{
+		desc.base, m_backend, AlignUp(desc.byteCapacity, ConstantBufferAlignment), BufferType::Constant });
+
+	m_blockContents.assign(static_cast<size_t>(m_blockCapacity) * BlockSize, 0);
+	m_blockAlive.assign(m_blockCapacity, 0);
+	m_blockBuffer = m_backend.createBuffer({ BufferType::Constant, BufferUsage::Default, m_blockCapacity * BlockSize,
+		m_blockContents.data() });
+}
+
+dx3d::ConstantBufferRing::~ConstantBufferRing()
+{
+	m_backend.destroyBuffer(m_blockBuffer);
+}
+
+void dx3d::ConstantBufferRing::begin()
+{
+	if (m_inFrame) DX3DLogThrowError("begin called twice without end.");
+
+	m_uploadRing->begin();
+	m_frameContents.clear();
+	m_frameBlocks.clear();
+	m_frameBlockIndices.clear();
+	m_inFrame = true;
+}
+
+dx3d::ConstantBufferBinding dx3d::ConstantBufferRing::upload(const void* data, ui32 byteSize)
+{
+	if (!m_inFrame) DX3DLogThrowError("Per-frame constants can only be uploaded between begin and end.");
+	if (!data || !byteSize) DX3DLogThrowInvalidArg("No constant data provided.");
+	if (byteSize > MaxConstantBufferBindingSize) DX3DLogThrowInvalidArg("Constant block is larger than a shader can address.");
+
+	// the same block twice in a frame (shared materials, objects at the same place) is written once
+	const auto hash = Hash::HashBytes(data, byteSize);
+	const auto found = m_frameBlockIndices.find(hash);
+	if (found != m_frameBlockIndices.end())
+	{
+		const auto& block = m_frameBlocks[found->second];
+		if (block.byteSize == byteSize && !std::memcmp(m_frameContents.data() + block.contentsOffset, data, byteSize))
+		{
+			m_stats.blocksDeduplicated++;
+			return block.binding;
+		}
+	}
+
+	const auto alignedSize = AlignUp(byteSize, ConstantBufferAlignment);
+	const auto allocation = m_uploadRing->allocate(alignedSize, ConstantBufferAlignment);
+	std::memcpy(allocation.data, data, byteSize);
+
+	const ConstantBufferBinding binding{ allocation.buffer, allocation.byteOffset, alignedSize };
+	const auto contentsOffset = static_cast<ui32>(m_frameContents.size());
+	const auto* bytes = static_cast<const unsigned char*>(data);
+	m_frameContents.insert(m_frameContents.end(), bytes, bytes + byteSize);
+	// a hash collision keeps the first block in the map, the second one is just never shared
+	m_frameBlockIndices.try_emplace(hash, static_cast<ui32>(m_frameBlocks.size()));
+	m_frameBlocks.push_back({ contentsOffset, byteSize, binding });
+
+	m_stats.blocksUploaded++;
+	m_stats.bytesUploaded += byteSize;
+	return binding;
+}
+
+void dx3d::ConstantBufferRing::end()
+{
+	if (!m_inFrame) DX3DLogThrowError("end called without begin.");
+	m_uploadRing->end();
+	m_inFrame = false;
+	flush();
+}
+
+void dx3d::ConstantBufferRing::flush()
+{
+	if (m_firstChangedBlock >= m_lastChangedBlock)
+		return;
+
+	// one update from the first to the last changed block; the unchanged ones in between cost a copy, not a call
+	DX3DProfileZone("ConstantBufferRing::flush");
+	const auto byteOffset = m_firstChangedBlock * BlockSize;
+	const auto byteSize = (m_lastChangedBlock - m_firstChangedBlock) * BlockSize;
+	m_backend.updateBuffer(m_blockBuffer, byteOffset, m_blockContents.data() + byteOffset, byteSize);
+	m_stats.flushes++;
+	m_stats.bytesUploaded += byteSize;
+
+	m_firstChangedBlock = ~0u;
+	m_lastChangedBlock = 0;
+}
+
+dx3d::ConstantBlockHandle dx3d::ConstantBufferRing::createBlock()
+{
+	ui32 index{};
+	if (!m_freeBlocks.empty())
+	{
+		index = m_freeBlocks.back();
+		m_freeBlocks.pop_back();
+	}
+	else
+	{
+		if (m_blockCount == m_blockCapacity)
+			growBlocks();
+		index = m_blockCount++;
+	}
+
+	// a reused block still holds what its last owner left, on the GPU as well
+	auto* contents = m_blockContents.data() + static_cast<size_t>(index) * BlockSize;
+	if (std::any_of(contents, contents + BlockSize, [](unsigned char byte) { return byte != 0; }))
+	{
+		std::memset(contents, 0, BlockSize);
+		m_firstChangedBlock = std::min(m_firstChangedBlock, index);
+		m_lastChangedBlock = std::max(m_lastChangedBlock, index + 1);
+	}
+
+	m_blockAlive[index] = 1;
+	return { index + 1 };
+}
+
+void dx3d::ConstantBufferRing::destroyBlock(ConstantBlockHandle block)
+{
+	const auto index = getBlockIndex(block);
+	m_blockAlive[index] = 0;
+	m_freeBlocks.push_back(index);
+}
+
+bool dx3d::ConstantBufferRing::updateBlock(ConstantBlockHandle block, const void* data, ui32 byteSize)
+{
+	const auto index = getBlockIndex(block);
+	if (!data || !byteSize) DX3DLogThrowInvalidArg("No constant data provided.");
+	if (byteSize > BlockSize) DX3DLogThrowInvalidArg("Retained constant blocks hold at most BlockSize bytes.");
+
+	auto* contents = m_blockContents.data() + static_cast<size_t>(index) * BlockSize;
+	if (!std::memcmp(contents, data, byteSize))
+	{
+		m_stats.blockUpdatesSkipped++;
+		return false;
+	}
+
+	std::memcpy(contents, data, byteSize);
+	m_firstChangedBlock = std::min(m_firstChangedBlock, index);
+	m_lastChangedBlock = std::max(m_lastChangedBlock, index + 1);
+	m_stats.blockUpdates++;
+	return true;
+}
+
+dx3d::ConstantBufferBinding dx3d::ConstantBufferRing::getBinding(ConstantBlockHandle block) const
+{
+	return { m_blockBuffer, getBlockIndex(block) * BlockSize, BlockSize };
+}
+
+const dx3d::DynamicUploadRing& dx3d::ConstantBufferRing::getUploadRing() const noexcept
+{
+	return *m_uploadRing;
+}
+
+const dx3d::ConstantBufferRingStats& dx3d::ConstantBufferRing::getStats() const noexcept
+{
+	return m_stats;
+}
+
+dx3d::ui32 dx3d::ConstantBufferRing::getBlockIndex(ConstantBlockHandle block) const
+{
+	if (!block || block.id > m_blockCount || !m_blockAlive[block.id - 1])
+		throw std::invalid_argument("Constant block handle is stale or null");
+	return block.id - 1;
+}
+
+void dx3d::ConstantBufferRing::growBlocks()
+{
+	// the new buffer starts out with everything, pending changes included
+	m_blockCapacity *= 2;
+	m_blockContents.resize(static_cast<size_t>(m_blockCapacity) * BlockSize, 0);
+	m_blockAlive.resize(m_blockCapacity, 0);
+
+	const auto buffer = m_backend.createBuffer({ BufferType::Constant, BufferUsage::Default, m_blockCapacity * BlockSize,
+		m_blockContents.data() });
+	m_backend.destroyBuffer(m_blockBuffer);
+	m_blockBuffer = buffer;
+	m_firstChangedBlock = ~0u;
+	m_lastChangedBlock = 0;
+
+	DX3DLogInfo(("Constant blocks grew to " + std::to_string(m_blockCapacity) + ".").c_str());
+}
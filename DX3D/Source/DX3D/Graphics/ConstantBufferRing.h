@@ -0,0 +1,125 @@
+#pragma once
+#include <DX3D/Core/Base.h>
+#include <DX3D/Graphics/GraphicsTypes.h>
+#include <DX3D/Graphics/DynamicUploadRing.h>
+#include <DX3D/Math/Mat4.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace dx3d
+{
+	// cbuffer FrameConstants of the vertex shaders, bound to FrameConstantsSlot
+	struct FrameConstants
+	{
+		Mat4 viewProjection{};
+	};
+
+	// cbuffer ObjectConstants of VertexShader.hlsl, bound to ObjectConstantsSlot
+	struct ObjectConstants
+	{
+		Mat4 world{};
+	};
+
+	struct ConstantBlockHandle
+	{
+		ui32 id{};
+		explicit operator bool() const noexcept { return id != 0; }
+		bool operator==(const ConstantBlockHandle&) const = default;
+	};
+
+	struct ConstantBufferRingStats
+	{
+		ui64 blocksUploaded{};          // per-frame blocks written into the ring
+		ui64 blocksDeduplicated{};      // per-frame blocks equal to one already written that frame, which got its binding
+		ui64 blockUpdates{};            // retained block updates that changed something
+		ui64 blockUpdatesSkipped{};     // retained block updates that did not, nothing is sent for them
+		ui64 flushes{};                 // buffer updates carrying the changed retained blocks, at most one per frame
+		ui64 bytesUploaded{};
+	};
+
+	/*
+	* Shader constants without a buffer per object and without a buffer update per object per frame.
+	* Every block is bound as a 256-byte aligned range of a shared buffer (ConstantBufferBinding), in two kinds:
+	*  - per-frame blocks, upload(): written into a DynamicUploadRing of constant buffers between begin() and end(),
+	*    all of a frame through a single mapping. A block equal to one written earlier in the same frame is not
+	*    written again, it gets the earlier block's binding (found by hash, confirmed byte for byte).
+	*  - retained blocks, createBlock(): live in one default-usage constant buffer and keep their contents across
+	*    frames. updateBlock() compares against a CPU copy and drops writes that change nothing; flush() sends the
+	*    blocks that did change as one update spanning all of them.
+	* Per-frame blocks suit what differs every frame, retained ones what mostly stays (a camera that stops moving
+	* costs nothing).
+	*/
+	class ConstantBufferRing final : public Base
+	{
+	public:
+		// the size of a retained block, 16 constants
+		static constexpr ui32 BlockSize = ConstantBufferAlignment;
+
+		explicit ConstantBufferRing(const ConstantBufferRingDesc& desc);
+		virtual ~ConstantBufferRing() override;
+
+		// reclaims the ring space of completed frames, before anything of the frame is uploaded
+		void begin();
+		// up to MaxConstantBufferBindingSize bytes, the binding is valid for the frame recorded after end()
+		ConstantBufferBinding upload(const void* data, ui32 byteSize);
+		template <typename T>
+		ConstantBufferBinding upload(const T& constants)
+		{
+			return upload(&constants, sizeof(T));
+		}
+		// unmaps the ring and flushes, must run before the frame is recorded
+		void end();
+		// sends the changed retained blocks, for frames without per-frame blocks
+		void flush();
+
+		// zeroed at first; growing moves every block into a bigger buffer, so not while a frame is recorded
+		ConstantBlockHandle createBlock();
+		void destroyBlock(ConstantBlockHandle block);
+		// up to BlockSize bytes from the start of the block, returns whether anything changed
+		bool updateBlock(ConstantBlockHandle block, const void* data, ui32 byteSize);
+		template <typename T>
+		bool updateBlock(ConstantBlockHandle block, const T& constants)
+		{
+			static_assert(sizeof(T) <= BlockSize, "Retained constant blocks hold 256 bytes");
+			return updateBlock(block, &constants, sizeof(T));
+		}
+		// stays valid until the block is destroyed or another one is created
+		ConstantBufferBinding getBinding(ConstantBlockHandle block) const;
+
+		const DynamicUploadRing& getUploadRing() const noexcept;
+		const ConstantBufferRingStats& getStats() const noexcept;
+
+	private:
+		// a per-frame block, its bytes are kept in m_frameContents to compare against
+		struct FrameBlock
+		{
+			ui32 contentsOffset{};
+			ui32 byteSize{};
+			ConstantBufferBinding binding{};
+		};
+
+		ui32 getBlockIndex(ConstantBlockHandle block) const;
+		void growBlocks();
+
+	private:
+		GraphicsBackend& m_backend;
+		std::unique_ptr<DynamicUploadRing> m_uploadRing{};
+		bool m_inFrame{};
+
+		std::vector<unsigned char> m_frameContents{};
+		std::vector<FrameBlock> m_frameBlocks{};
+		std::unordered_map<ui64, ui32> m_frameBlockIndices{};  // contents hash -> m_frameBlocks index
+
+		BufferHandle m_blockBuffer{};
+		ui32 m_blockCapacity{};
+		ui32 m_blockCount{};                        // indices handed out so far, freed ones included
+		std::vector<unsigned char> m_blockContents{};   // what the buffer holds once the changes are sent
+		std::vector<unsigned char> m_blockAlive{};
+		std::vector<ui32> m_freeBlocks{};
+		ui32 m_firstChangedBlock{ ~0u };            // changed blocks not sent yet, [first, last)
+		ui32 m_lastChangedBlock{};
+
+		ConstantBufferRingStats m_stats{};
+	};
+}
@@ -0,0 +1,695 @@
+#include <DX3D/Graphics/D3D11/D3D11GraphicsBackend.h>
+#include <DX3D/Core/Profiler.h>
+#include <DX3D/Graphics/GraphicsDevice.h>
+#include <DX3D/Graphics/DeviceContext.h>
+#include <DX3D/Graphics/SwapChain.h>
+#include <cstring>
+#include <string>
+
+namespace
+{
+	UINT GetBindFlags(dx3d::BufferType type)
+	{
+		switch (type)
+		{
+		case dx3d::BufferType::Vertex: return D3D11_BIND_VERTEX_BUFFER;
+		case dx3d::BufferType::Index: return D3D11_BIND_INDEX_BUFFER;
+		case dx3d::BufferType::Constant: return D3D11_BIND_CONSTANT_BUFFER;
+		default: return 0;
+		}
+	}
+
+	D3D11_USAGE GetUsage(dx3d::BufferUsage usage)
+	{
+		switch (usage)
+		{
+		case dx3d::BufferUsage::Immutable: return D3D11_USAGE_IMMUTABLE;
+		case dx3d::BufferUsage::Dynamic: return D3D11_USAGE_DYNAMIC;
+		default: return D3D11_USAGE_DEFAULT;
+		}
+	}
+
+	DXGI_FORMAT GetFormat(dx3d::VertexFormat format)
+	{
+		switch (format)
+		{
+		case dx3d::VertexFormat::Float2: return DXGI_FORMAT_R32G32_FLOAT;
+		case dx3d::VertexFormat::Float3: return DXGI_FORMAT_R32G32B32_FLOAT;
+		case dx3d::VertexFormat::Float4: return DXGI_FORMAT_R32G32B32A32_FLOAT;
+		case dx3d::VertexFormat::Half4: return DXGI_FORMAT_R16G16B16A16_FLOAT;
+		case dx3d::VertexFormat::Short4Norm: return DXGI_FORMAT_R16G16B16A16_SNORM;
+		case dx3d::VertexFormat::UByte4Norm: return DXGI_FORMAT_R8G8B8A8_UNORM;
+		default: return DXGI_FORMAT_UNKNOWN;
+		}
+	}
+
+	D3D11_PRIMITIVE_TOPOLOGY GetTopology(dx3d::PrimitiveTopology topology)
+	{
+		switch (topology)
+		{
+		case dx3d::PrimitiveTopology::TriangleStrip: return D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP;
+		case dx3d::PrimitiveTopology::LineList: return D3D11_PRIMITIVE_TOPOLOGY_LINELIST;
+		default: return D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+		}
+	}
+
+	D3D11_CULL_MODE GetCullMode(dx3d::CullMode mode)
+	{
+		switch (mode)
+		{
+		case dx3d::CullMode::Front: return D3D11_CULL_FRONT;
+		case dx3d::CullMode::None: return D3D11_CULL_NONE;
+		default: return D3D11_CULL_BACK;
+		}
+	}
+
+	// everything that makes a shader object different: stage, file, entry point and defines
+	std::string GetShaderKey(dx3d::Shader::Type type, const char* path, const char* entryPoint,
+		const std::vector<dx3d::ShaderMacro>& defines)
+	{
+		std::string key = type == dx3d::Shader::Type::Vertex ? "vs\n" : "ps\n";
+		key += path;
+		key += '\n';
+		key += entryPoint;
+		for (const auto& define : defines)
+			key += '\n' + define.name + '=' + define.definition;
+		return key;
+	}
+}
+
+dx3d::D3D11CommandList::D3D11CommandList(const D3D11GraphicsBackend& backend, ID3D11DeviceContext& context) :
+	m_backend(backend),
+	m_context(context)
+{
+	if (m_backend.m_constantBufferOffsetting)
+		m_context.QueryInterface(IID_PPV_ARGS(&m_context1));
+}
+
+void dx3d::D3D11CommandList::onSetPipeline(PipelineHandle pipeline)
+{
+	const auto& target = m_backend.getPipeline(pipeline);
+	m_topology = target.topology;
+
+	const auto topology = GetTopology(target.topology);
+	auto* vertexShader = target.vertexShader->getVertexShader();
+	auto* pixelShader = target.pixelShader->getPixelShader();
+
+	if (target.inputLayout->layout.Get() != m_inputLayout)
+	{
+		m_inputLayout = target.inputLayout->layout.Get();
+		m_context.IASetInputLayout(m_inputLayout);
+	}
+	else m_stats.stateChangesSkipped++;
+
+	if (topology != m_primitiveTopology)
+	{
+		m_primitiveTopology = topology;
+		m_context.IASetPrimitiveTopology(m_primitiveTopology);
+	}
+	else m_stats.stateChangesSkipped++;
+
+	if (vertexShader != m_vertexShader)
+	{
+		m_vertexShader = vertexShader;
+		m_context.VSSetShader(m_vertexShader, nullptr, 0);
+	}
+	else m_stats.stateChangesSkipped++;
+
+	if (pixelShader != m_pixelShader)
+	{
+		m_pixelShader = pixelShader;
+		m_context.PSSetShader(m_pixelShader, nullptr, 0);
+	}
+	else m_stats.stateChangesSkipped++;
+
+	if (target.rasterizerState != m_rasterizerState)
+	{
+		m_rasterizerState = target.rasterizerState;
+		m_context.RSSetState(m_rasterizerState);
+	}
+	else m_stats.stateChangesSkipped++;
+
+	if (target.blendState != m_blendState)
+	{
+		m_blendState = target.blendState;
+		m_context.OMSetBlendState(m_blendState, nullptr, 0xffffffff);
+	}
+	else m_stats.stateChangesSkipped++;
+
+	if (target.depthStencilState != m_depthStencilState)
+	{
+		m_depthStencilState = target.depthStencilState;
+		m_context.OMSetDepthStencilState(m_depthStencilState, 0);
+	}
+	else m_stats.stateChangesSkipped++;
+}
+
+void dx3d::D3D11CommandList::onSetVertexBuffer(ui32 slot, BufferHandle buffer, ui32 stride, ui32 byteOffset)
+{
+	ID3D11Buffer* vertexBuffers[] = { m_backend.getBuffer(buffer).buffer.Get() };
+	UINT strides[] = { stride };
+	UINT offsets[] = { byteOffset };
+	m_context.IASetVertexBuffers(slot, 1, vertexBuffers, strides, offsets);
+}
+
+void dx3d::D3D11CommandList::onSetIndexBuffer(BufferHandle buffer, ui32 byteOffset)
+{
+	m_context.IASetIndexBuffer(m_backend.getBuffer(buffer).buffer.Get(), DXGI_FORMAT_R32_UINT, byteOffset);
+}
+
+void dx3d::D3D11CommandList::onSetConstantBuffer(ui32 slot, const ConstantBufferBinding& binding)
+{
+	if (m_context1)
+	{
+		// offsets and sizes count shader constants, 16 bytes each
+		ID3D11Buffer* constantBuffers[] = { m_backend.getBuffer(binding.buffer).buffer.Get() };
+		UINT firstConstants[] = { binding.byteOffset / 16 };
+		UINT constantCounts[] = { binding.byteSize / 16 };
+		m_context1->VSSetConstantBuffers1(slot, 1, constantBuffers, firstConstants, constantCounts);
+		return;
+	}
+
+	// Direct3D 11.0: the range is copied out of the backend's CPU copy into a buffer of this list's own,
+	// discarded for every binding (the state cache already skips rebinding the same range)
+	const auto& source = m_backend.getBuffer(binding.buffer);
+	if (slot >= m_constantBufferCopies.size())
+		m_constantBufferCopies.resize(slot + 1);
+	auto& copy = m_constantBufferCopies[slot];
+	if (!copy)
+	{
+		D3D11_BUFFER_DESC bufferDesc = {};
+		bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+		bufferDesc.ByteWidth = MaxConstantBufferBindingSize;
+		bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		if (FAILED(m_backend.m_device.CreateBuffer(&bufferDesc, nullptr, &copy)))
+			throw std::runtime_error("Failed to create constant buffer copy.");
+	}
+
+	D3D11_MAPPED_SUBRESOURCE mapped = {};
+	if (FAILED(m_context.Map(copy.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)))
+		throw std::runtime_error("Failed to map constant buffer copy.");
+	std::memcpy(mapped.pData, source.constants.data() + binding.byteOffset, binding.byteSize);
+	m_context.Unmap(copy.Get(), 0);
+
+	ID3D11Buffer* constantBuffers[] = { copy.Get() };
+	m_context.VSSetConstantBuffers(slot, 1, constantBuffers);
+}
+
+void dx3d::D3D11CommandList::onInvalidateState()
+{
+	// a deferred context starts every command list from the default state
+	m_inputLayout = nullptr;
+	m_primitiveTopology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	m_vertexShader = nullptr;
+	m_pixelShader = nullptr;
+	m_rasterizerState = nullptr;
+	m_blendState = nullptr;
+	m_depthStencilState = nullptr;
+}
+
+void dx3d::D3D11CommandList::onDraw(ui32 vertexCount, ui32 startVertex)
+{
+	m_context.Draw(vertexCount, startVertex);
+}
+
+void dx3d::D3D11CommandList::onDrawIndexed(ui32 indexCount, ui32 startIndex, i32 baseVertex)
+{
+	m_context.DrawIndexed(indexCount, startIndex, baseVertex);
+}
+
+void dx3d::D3D11CommandList::onDrawIndexedInstanced(ui32 indexCount, ui32 instanceCount, ui32 startIndex, i32 baseVertex, ui32 startInstance)
+{
+	m_context.DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+}
+
+dx3d::D3D11GraphicsBackend::D3D11GraphicsBackend(const GraphicsResourceDesc& gDesc) :
+	GraphicsBackend(gDesc.base),
+	m_graphicsDevice(gDesc.graphicsDevice),
+	m_device(gDesc.device),
+	m_factory(gDesc.factory),
+	m_immediateContext(*gDesc.graphicsDevice->m_d3dContext.Get())
+{
+	// a Direct3D 11.0 runtime does not know the query, none of the options are there then
+	D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+	if (FAILED(m_device.CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))))
+		options = {};
+
+	m_constantBufferOffsetting = options.ConstantBufferOffsetting;
+	if (!m_constantBufferOffsetting)
+		DX3DLogWarning("No constant buffer offsetting (Direct3D 11.1), constant buffers are kept on the CPU and "
+			"copied into a buffer of their own for every binding.");
+	m_mapNoOverwriteOnConstantBuffers = options.MapNoOverwriteOnDynamicConstantBuffer;
+	m_partialConstantBufferUpdates = options.ConstantBufferPartialUpdate;
+}
+
+dx3d::D3D11GraphicsBackend::~D3D11GraphicsBackend()
+{
+}
+
+dx3d::BufferHandle dx3d::D3D11GraphicsBackend::createBuffer(const BufferDesc& desc)
+{
+	if (!desc.byteWidth) DX3DLogThrowInvalidArg("No buffer size provided.");
+	if (desc.usage == BufferUsage::Immutable && !desc.initialData)
+		DX3DLogThrowInvalidArg("Immutable buffers need their data at creation.");
+
+	D3D11_BUFFER_DESC bufferDesc = {};
+	bufferDesc.Usage = GetUsage(desc.usage);
+	bufferDesc.ByteWidth = desc.byteWidth;
+	bufferDesc.BindFlags = GetBindFlags(desc.type);
+	bufferDesc.CPUAccessFlags = desc.usage == BufferUsage::Dynamic ? D3D11_CPU_ACCESS_WRITE : 0;
+
+	D3D11_SUBRESOURCE_DATA initData = {};
+	initData.pSysMem = desc.initialData;
+
+	Buffer buffer{ nullptr, desc };
+	buffer.desc.initialData = nullptr;
+	if (desc.type == BufferType::Constant && !m_constantBufferOffsetting)
+	{
+		// only ever read by D3D11CommandList::onSetConstantBuffer, the device never sees this buffer
+		buffer.constants.assign(desc.byteWidth, 0);
+		if (desc.initialData) std::memcpy(buffer.constants.data(), desc.initialData, desc.byteWidth);
+	}
+	else DX3DGraphicsLogThrowOnFail(
+		m_device.CreateBuffer(&bufferDesc, desc.initialData ? &initData : nullptr, &buffer.buffer),
+		"Failed to create buffer"
+	);
+
+	ui32 index{};
+	if (m_freeBuffers.empty())
+	{
+		index = static_cast<ui32>(m_buffers.size());
+		m_buffers.push_back(std::move(buffer));
+	}
+	else
+	{
+		index = m_freeBuffers.back();
+		m_freeBuffers.pop_back();
+		m_buffers[index] = std::move(buffer);
+	}
+
+	m_stats.buffersCreated++;
+	if (desc.initialData) m_stats.bytesUploaded += desc.byteWidth;
+	return { index + 1 };
+}
+
+void dx3d::D3D11GraphicsBackend::updateBuffer(BufferHandle buffer, ui32 byteOffset, const void* data, ui32 byteSize)
+{
+	const auto& target = getBuffer(buffer);
+	if (!data || !byteSize) DX3DLogThrowInvalidArg("No buffer data provided.");
+	if (target.desc.usage == BufferUsage::Immutable) DX3DLogThrowInvalidArg("Immutable buffers cannot be updated.");
+	if (static_cast<ui64>(byteOffset) + byteSize > target.desc.byteWidth)
+		DX3DLogThrowInvalidArg("Buffer update is out of bounds.");
+
+	if (target.desc.usage == BufferUsage::Dynamic && byteOffset)
+		DX3DLogThrowInvalidArg("Dynamic buffers are always rewritten from the start.");
+
+	if (!target.constants.empty())
+	{
+		std::memcpy(m_buffers[buffer.id - 1].constants.data() + byteOffset, data, byteSize);
+	}
+	else if (target.desc.usage == BufferUsage::Dynamic)
+	{
+		D3D11_MAPPED_SUBRESOURCE mapped = {};
+		DX3DGraphicsLogThrowOnFail(
+			m_immediateContext.Map(target.buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped),
+			"Failed to map buffer"
+		);
+		std::memcpy(mapped.pData, data, byteSize);
+		m_immediateContext.Unmap(target.buffer.Get(), 0);
+	}
+	else if (target.desc.type == BufferType::Constant && (byteOffset || byteSize != target.desc.byteWidth) &&
+		!m_partialConstantBufferUpdates)
+	{
+		DX3DLogThrowInvalidArg("This device can only update constant buffers as a whole.");
+	}
+	else
+	{
+		D3D11_BOX box = {};
+		box.left = byteOffset;
+		box.right = byteOffset + byteSize;
+		box.bottom = 1;
+		box.back = 1;
+		m_immediateContext.UpdateSubresource(target.buffer.Get(), 0, &box, data, 0, 0);
+	}
+
+	m_stats.bytesUploaded += byteSize;
+}
+
+void dx3d::D3D11GraphicsBackend::destroyBuffer(BufferHandle buffer)
+{
+	getBuffer(buffer);
+	m_buffers[buffer.id - 1] = {};
+	m_freeBuffers.push_back(buffer.id - 1);
+	m_stats.buffersDestroyed++;
+}
+
+void* dx3d::D3D11GraphicsBackend::mapBuffer(BufferHandle buffer, MapMode mode)
+{
+	const auto& target = getBuffer(buffer);
+	if (target.desc.usage != BufferUsage::Dynamic) DX3DLogThrowInvalidArg("Only dynamic buffers can be mapped.");
+	if (!target.constants.empty())
+		return m_buffers[buffer.id - 1].constants.data();
+
+	// without no-overwrite on constant buffers every map renames the buffer; a caller writing all of a frame's
+	// constants through one mapping (DynamicUploadRing) still finds everything it wrote that frame
+	if (target.desc.type == BufferType::Constant && !m_mapNoOverwriteOnConstantBuffers)
+		mode = MapMode::Discard;
+
+	D3D11_MAPPED_SUBRESOURCE mapped = {};
+	DX3DGraphicsLogThrowOnFail(
+		m_immediateContext.Map(target.buffer.Get(), 0,
+			mode == MapMode::NoOverwrite ? D3D11_MAP_WRITE_NO_OVERWRITE : D3D11_MAP_WRITE_DISCARD, 0, &mapped),
+		"Failed to map buffer"
+	);
+	return mapped.pData;
+}
+
+void dx3d::D3D11GraphicsBackend::unmapBuffer(BufferHandle buffer)
+{
+	const auto& target = getBuffer(buffer);
+	if (target.constants.empty())
+		m_immediateContext.Unmap(target.buffer.Get(), 0);
+}
+
+dx3d::PipelineHandle dx3d::D3D11GraphicsBackend::createPipeline(const PipelineDesc& desc)
+{
+	if (!desc.vertexShaderPath) DX3DLogThrowInvalidArg("No vertex shader provided.");
+	if (!desc.pixelShaderPath) DX3DLogThrowInvalidArg("No pixel shader provided.");
+	if (desc.vertexLayout.empty()) DX3DLogThrowInvalidArg("No vertex layout provided.");
+
+	Pipeline pipeline{};
+	pipeline.topology = desc.topology;
+
+	// pipelines that differ in anything else still share their shaders and layout
+	const auto vertexShaderKey = GetShaderKey(Shader::Type::Vertex, desc.vertexShaderPath, desc.vertexShaderEntryPoint,
+		desc.vertexShaderDefines);
+	pipeline.vertexShader = getShader(vertexShaderKey, Shader::Type::Vertex, desc.vertexShaderPath,
+		desc.vertexShaderEntryPoint, desc.vertexShaderDefines);
+	pipeline.pixelShader = getShader(GetShaderKey(Shader::Type::Pixel, desc.pixelShaderPath, desc.pixelShaderEntryPoint, {}),
+		Shader::Type::Pixel, desc.pixelShaderPath, desc.pixelShaderEntryPoint, {});
+	pipeline.inputLayout = getInputLayout(vertexShaderKey, *pipeline.vertexShader, desc.vertexLayout);
+
+	pipeline.rasterizerState = getRasterizerState(desc.rasterizer);
+	pipeline.blendState = getBlendState(desc.blendMode);
+	pipeline.depthStencilState = getDepthStencilState(desc.depth);
+
+	ui32 index{};
+	if (m_freePipelines.empty())
+	{
+		index = static_cast<ui32>(m_pipelines.size());
+		m_pipelines.push_back(std::move(pipeline));
+	}
+	else
+	{
+		index = m_freePipelines.back();
+		m_freePipelines.pop_back();
+		m_pipelines[index] = std::move(pipeline);
+	}
+
+	m_stats.pipelinesCreated++;
+	return { index + 1 };
+}
+
+void dx3d::D3D11GraphicsBackend::destroyPipeline(PipelineHandle pipeline)
+{
+	getPipeline(pipeline);
+	m_pipelines[pipeline.id - 1] = {};
+	m_freePipelines.push_back(pipeline.id - 1);
+
+	std::erase_if(m_shaders, [](const auto& entry) { return entry.second.expired(); });
+	std::erase_if(m_inputLayouts, [](const auto& entry) { return entry.second.expired(); });
+}
+
+dx3d::GraphicsCommandList& dx3d::D3D11GraphicsBackend::beginFrame(const FrameDesc& desc)
+{
+	if (!m_swapChain) DX3DLogThrowError("No swap chain set before beginFrame.");
+	if (!desc.commandListCount) DX3DLogThrowInvalidArg("A frame needs at least one command list.");
+
+	while (m_commandLists.size() < desc.commandListCount)
+	{
+		FrameCommandList frameList{};
+		frameList.deviceContext = std::make_shared<DeviceContext>(
+			GraphicsResourceDesc{ {m_logger}, m_graphicsDevice, m_device, m_factory });
+		frameList.commandList = std::make_unique<D3D11CommandList>(*this, *frameList.deviceContext->m_context.Get());
+		m_commandLists.push_back(std::move(frameList));
+	}
+	m_commandListCount = desc.commandListCount;
+
+	// this thing matches the viewport to the window size
+	D3D11_VIEWPORT viewport = {};
+	DXGI_SWAP_CHAIN_DESC swapChainDesc;
+	m_swapChain->m_swapChain->GetDesc(&swapChainDesc);
+	viewport.Width = static_cast<float>(swapChainDesc.BufferDesc.Width);
+	viewport.Height = static_cast<float>(swapChainDesc.BufferDesc.Height);
+	viewport.MinDepth = 0.0f;
+	viewport.MaxDepth = 1.0f;
+
+	// deferred contexts start from default state, so every list gets the target and viewport; only the first clears
+	for (ui32 i = 0; i < m_commandListCount; i++)
+	{
+		auto& frameList = m_commandLists[i];
+		frameList.commandList->resetStats();
+		frameList.commandList->invalidateState();
+		if (i == 0) frameList.deviceContext->clearAndSetBackBuffer(*m_swapChain, desc.clearColor);
+		else frameList.deviceContext->setBackBuffer(*m_swapChain);
+		frameList.deviceContext->m_context->RSSetViewports(1, &viewport);
+	}
+
+	return *m_commandLists.front().commandList;
+}
+
+dx3d::GraphicsCommandList& dx3d::D3D11GraphicsBackend::getCommandList(ui32 index)
+{
+	if (index >= m_commandListCount) DX3DLogThrowInvalidArg("Invalid command list index.");
+	return *m_commandLists[index].commandList;
+}
+
+dx3d::ui32 dx3d::D3D11GraphicsBackend::getCommandListCount() const noexcept
+{
+	return m_commandListCount;
+}
+
+void dx3d::D3D11GraphicsBackend::endFrame()
+{
+	if (!m_swapChain) DX3DLogThrowError("No swap chain set before endFrame.");
+
+	GraphicsCommandListStats frameStats{};
+	{
+		DX3DProfileZone("D3D11::executeCommandList");
+		for (ui32 i = 0; i < m_commandListCount; i++)
+		{
+			auto& frameList = m_commandLists[i];
+			frameStats += frameList.commandList->getStats();
+
+			Microsoft::WRL::ComPtr<ID3D11CommandList> list{};
+			DX3DGraphicsLogThrowOnFail(frameList.deviceContext->m_context->FinishCommandList(false, &list),
+				"FinishCommandList failed.");
+			m_immediateContext.ExecuteCommandList(list.Get(), false);
+		}
+	}
+
+	FrameFence fence{ getSubmittedFrameCount() + 1 };
+	if (m_freeFenceQueries.empty())
+	{
+		D3D11_QUERY_DESC queryDesc = {};
+		queryDesc.Query = D3D11_QUERY_EVENT;
+		DX3DGraphicsLogThrowOnFail(m_device.CreateQuery(&queryDesc, &fence.query), "Failed to create frame fence");
+	}
+	else
+	{
+		fence.query = std::move(m_freeFenceQueries.back());
+		m_freeFenceQueries.pop_back();
+	}
+	m_immediateContext.End(fence.query.Get());
+	m_pendingFences.push_back(std::move(fence));
+	addFrameStats(frameStats);
+
+	{
+		DX3DProfileZone("D3D11::present");
+		m_swapChain->present();
+	}
+}
+
+dx3d::ui64 dx3d::D3D11GraphicsBackend::getCompletedFrameCount()
+{
+	// frames finish in order, so stop at the first fence the GPU has not passed yet
+	while (!m_pendingFences.empty())
+	{
+		auto& fence = m_pendingFences.front();
+		BOOL done = FALSE;
+		if (m_immediateContext.GetData(fence.query.Get(), &done, sizeof(done), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK || !done)
+			break;
+
+		m_completedFrames = fence.frame;
+		m_freeFenceQueries.push_back(std::move(fence.query));
+		m_pendingFences.pop_front();
+	}
+	return m_completedFrames;
+}
+
+void dx3d::D3D11GraphicsBackend::setSwapChain(SwapChain& swapChain) noexcept
+{
+	m_swapChain = &swapChain;
+}
+
+dx3d::DeviceContext& dx3d::D3D11GraphicsBackend::getDeviceContext(ui32 index)
+{
+	if (index >= m_commandLists.size()) DX3DLogThrowInvalidArg("Invalid command list index.");
+	return *m_commandLists[index].deviceContext;
+}
+
+const dx3d::D3D11PipelineObjectStats& dx3d::D3D11GraphicsBackend::getPipelineObjectStats() const noexcept
+{
+	return m_pipelineObjectStats;
+}
+
+const dx3d::D3D11GraphicsBackend::Buffer& dx3d::D3D11GraphicsBackend::getBuffer(BufferHandle buffer) const
+{
+	if (!buffer || buffer.id > m_buffers.size() || !m_buffers[buffer.id - 1].desc.byteWidth)
+		throw std::invalid_argument("Invalid buffer handle.");
+	return m_buffers[buffer.id - 1];
+}
+
+const dx3d::D3D11GraphicsBackend::Pipeline& dx3d::D3D11GraphicsBackend::getPipeline(PipelineHandle pipeline) const
+{
+	if (!pipeline || pipeline.id > m_pipelines.size() || !m_pipelines[pipeline.id - 1].inputLayout)
+		throw std::invalid_argument("Invalid pipeline handle.");
+	return m_pipelines[pipeline.id - 1];
+}
+
+std::shared_ptr<dx3d::Shader> dx3d::D3D11GraphicsBackend::getShader(const std::string& key, Shader::Type type, const char* path,
+	const char* entryPoint, const std::vector<ShaderMacro>& defines)
+{
+	auto& cached = m_shaders[key];
+	if (auto shader = cached.lock())
+	{
+		m_pipelineObjectStats.shadersShared++;
+		return shader;
+	}
+
+	const bool vertex = type == Shader::Type::Vertex;
+	auto shader = std::make_shared<Shader>(Shader::ShaderDesc{
+		{ {m_logger}, m_graphicsDevice, m_device, m_factory },
+		type,
+		entryPoint,
+		vertex ? "vs_5_0" : "ps_5_0",
+		defines
+	});
+	if (!shader->loadFromFile(path))
+		DX3DLogThrowError(vertex ? "Failed to load vertex shader" : "Failed to load pixel shader");
+
+	cached = shader;
+	m_pipelineObjectStats.shadersCreated++;
+	return shader;
+}
+
+std::shared_ptr<dx3d::D3D11GraphicsBackend::InputLayout> dx3d::D3D11GraphicsBackend::getInputLayout(
+	const std::string& vertexShaderKey, const Shader& vertexShader, const std::vector<VertexAttribute>& vertexLayout)
+{
+	// a layout is validated against the vertex shader's input signature, so it belongs to both
+	auto key = vertexShaderKey;
+	for (const auto& attribute : vertexLayout)
+	{
+		key += '\n';
+		if (attribute.semanticName) key += attribute.semanticName;
+		for (const auto value : { attribute.semanticIndex, static_cast<ui32>(attribute.format), attribute.slot,
+			attribute.offset, static_cast<ui32>(attribute.inputRate) })
+			key += ' ' + std::to_string(value);
+	}
+
+	auto& cached = m_inputLayouts[key];
+	if (auto inputLayout = cached.lock())
+	{
+		m_pipelineObjectStats.inputLayoutsShared++;
+		return inputLayout;
+	}
+
+	std::vector<D3D11_INPUT_ELEMENT_DESC> layoutDesc{};
+	for (const auto& attribute : vertexLayout)
+	{
+		const bool perInstance = attribute.inputRate == VertexInputRate::PerInstance;
+		layoutDesc.push_back({
+			attribute.semanticName,
+			attribute.semanticIndex,
+			GetFormat(attribute.format),
+			attribute.slot,
+			attribute.offset,
+			perInstance ? D3D11_INPUT_PER_INSTANCE_DATA : D3D11_INPUT_PER_VERTEX_DATA,
+			perInstance ? 1u : 0u
+		});
+	}
+
+	auto inputLayout = std::make_shared<InputLayout>();
+	const auto& byteCode = vertexShader.getByteCode();
+	DX3DGraphicsLogThrowOnFail(
+		m_device.CreateInputLayout(layoutDesc.data(), static_cast<UINT>(layoutDesc.size()),
+			byteCode.data(), byteCode.size(), &inputLayout->layout),
+		"Failed to create input layout"
+	);
+
+	cached = inputLayout;
+	m_pipelineObjectStats.inputLayoutsCreated++;
+	return inputLayout;
+}
+
+ID3D11RasterizerState* dx3d::D3D11GraphicsBackend::getRasterizerState(const RasterizerState& state)
+{
+	const auto key = static_cast<ui32>(state.fillMode) | static_cast<ui32>(state.cullMode) << 2 |
+		static_cast<ui32>(state.frontCounterClockwise) << 4 | static_cast<ui32>(state.depthClip) << 5;
+	auto& cached = m_rasterizerStates[key];
+	if (!cached)
+	{
+		D3D11_RASTERIZER_DESC rasterizerDesc = {};
+		rasterizerDesc.FillMode = state.fillMode == FillMode::Wireframe ? D3D11_FILL_WIREFRAME : D3D11_FILL_SOLID;
+		rasterizerDesc.CullMode = GetCullMode(state.cullMode);
+		rasterizerDesc.FrontCounterClockwise = state.frontCounterClockwise;
+		rasterizerDesc.DepthClipEnable = state.depthClip;
+		DX3DGraphicsLogThrowOnFail(m_device.CreateRasterizerState(&rasterizerDesc, &cached), "Failed to create rasterizer state");
+		m_pipelineObjectStats.stateObjectsCreated++;
+	}
+	return cached.Get();
+}
+
+ID3D11BlendState* dx3d::D3D11GraphicsBackend::getBlendState(BlendMode mode)
+{
+	auto& cached = m_blendStates[static_cast<ui32>(mode)];
+	if (!cached)
+	{
+		// Opaque is the default blend state: blending off, the color written as it is
+		const bool additive = mode == BlendMode::Additive;
+		D3D11_BLEND_DESC blendDesc = {};
+		auto& target = blendDesc.RenderTarget[0];
+		target.BlendEnable = mode != BlendMode::Opaque;
+		target.SrcBlend = target.BlendEnable ? D3D11_BLEND_SRC_ALPHA : D3D11_BLEND_ONE;
+		target.DestBlend = !target.BlendEnable ? D3D11_BLEND_ZERO : additive ? D3D11_BLEND_ONE : D3D11_BLEND_INV_SRC_ALPHA;
+		target.BlendOp = D3D11_BLEND_OP_ADD;
+		target.SrcBlendAlpha = D3D11_BLEND_ONE;
+		target.DestBlendAlpha = !target.BlendEnable ? D3D11_BLEND_ZERO : additive ? D3D11_BLEND_ONE : D3D11_BLEND_INV_SRC_ALPHA;
+		target.BlendOpAlpha = D3D11_BLEND_OP_ADD;
+		target.RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+		DX3DGraphicsLogThrowOnFail(m_device.CreateBlendState(&blendDesc, &cached), "Failed to create blend state");
+		m_pipelineObjectStats.stateObjectsCreated++;
+	}
+	return cached.Get();
+}
+
+ID3D11DepthStencilState* dx3d::D3D11GraphicsBackend::getDepthStencilState(const DepthState& state)
+{
+	const auto key = static_cast<ui32>(state.depthTest) | static_cast<ui32>(state.depthWrite) << 1;
+	auto& cached = m_depthStencilStates[key];
+	if (!cached)
+	{
+		D3D11_DEPTH_STENCIL_DESC depthStencilDesc = {};
+		depthStencilDesc.DepthEnable = state.depthTest;
+		depthStencilDesc.DepthWriteMask = state.depthWrite ? D3D11_DEPTH_WRITE_MASK_ALL : D3D11_DEPTH_WRITE_MASK_ZERO;
+		depthStencilDesc.DepthFunc = D3D11_COMPARISON_LESS;
+		depthStencilDesc.StencilReadMask = D3D11_DEFAULT_STENCIL_READ_MASK;
+		depthStencilDesc.StencilWriteMask = D3D11_DEFAULT_STENCIL_WRITE_MASK;
+		depthStencilDesc.FrontFace = { D3D11_STENCIL_OP_KEEP, D3D11_STENCIL_OP_KEEP, D3D11_STENCIL_OP_KEEP, D3D11_COMPARISON_ALWAYS };
+		depthStencilDesc.BackFace = depthStencilDesc.FrontFace;
+		DX3DGraphicsLogThrowOnFail(m_device.CreateDepthStencilState(&depthStencilDesc, &cached), "Failed to create depth-stencil state");
+		m_pipelineObjectStats.stateObjectsCreated++;
+	}
+	return cached.Get();
+}
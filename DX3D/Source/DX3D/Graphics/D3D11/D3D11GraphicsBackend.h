@@ -0,0 +1,181 @@
+#pragma once
+#include <DX3D/Graphics/GraphicsBackend.h>
+#include <DX3D/Graphics/GraphicsResource.h>
+#include <DX3D/Graphics/Shader.h>
+#include <d3d11_1.h>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dx3d
+{
+	class D3D11GraphicsBackend;
+
+	class D3D11CommandList final : public GraphicsCommandList
+	{
+	public:
+		D3D11CommandList(const D3D11GraphicsBackend& backend, ID3D11DeviceContext& context);
+
+	protected:
+		virtual void onSetPipeline(PipelineHandle pipeline) override;
+		virtual void onSetVertexBuffer(ui32 slot, BufferHandle buffer, ui32 stride, ui32 byteOffset) override;
+		virtual void onSetIndexBuffer(BufferHandle buffer, ui32 byteOffset) override;
+		virtual void onSetConstantBuffer(ui32 slot, const ConstantBufferBinding& binding) override;
+		virtual void onDraw(ui32 vertexCount, ui32 startVertex) override;
+		virtual void onDrawIndexed(ui32 indexCount, ui32 startIndex, i32 baseVertex) override;
+		virtual void onDrawIndexedInstanced(ui32 indexCount, ui32 instanceCount, ui32 startIndex, i32 baseVertex, ui32 startInstance) override;
+		virtual void onInvalidateState() override;
+
+	private:
+		const D3D11GraphicsBackend& m_backend;
+		ID3D11DeviceContext& m_context;
+		// for binding constant buffer ranges, null when the device cannot (Direct3D 11.0)
+		Microsoft::WRL::ComPtr<ID3D11DeviceContext1> m_context1{};
+		// without it: per slot, the buffer bound ranges are copied into
+		std::vector<Microsoft::WRL::ComPtr<ID3D11Buffer>> m_constantBufferCopies{};
+
+		// what the context has bound, so pipelines sharing shaders or layouts only set what differs
+		ID3D11InputLayout* m_inputLayout{};
+		D3D11_PRIMITIVE_TOPOLOGY m_primitiveTopology{ D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED };
+		ID3D11VertexShader* m_vertexShader{};
+		ID3D11PixelShader* m_pixelShader{};
+		ID3D11RasterizerState* m_rasterizerState{};
+		ID3D11BlendState* m_blendState{};
+		ID3D11DepthStencilState* m_depthStencilState{};
+	};
+
+	// what createPipeline made on the device and what it found already made
+	struct D3D11PipelineObjectStats
+	{
+		ui64 shadersCreated{};
+		ui64 shadersShared{};
+		ui64 inputLayoutsCreated{};
+		ui64 inputLayoutsShared{};
+		ui64 stateObjectsCreated{};     // rasterizer, blend and depth-stencil states, each kept for the backend's lifetime
+	};
+
+	/*
+	* GraphicsBackend on top of GraphicsDevice: resources are created on the device, updates go through
+	* the immediate context and the frame is recorded into one deferred context per command list.
+	* endFrame finishes and executes them in index order, so the result does not depend on which
+	* thread recorded what or when.
+	* Constant buffers are bound as ranges (ConstantBufferBinding), which needs a Direct3D 11.1 runtime.
+	* On 11.0 constant buffers only exist on the CPU and every binding copies its range into a dynamic buffer
+	* of the command list, slower but the same to everything above the backend.
+	* Pipelines share what they have in common: a shader (file, entry point, defines) is created once for all
+	* pipelines using it and an input layout once per vertex shader and layout, both go with their last
+	* pipeline. The few fixed-function state combinations are created on first use and kept.
+	*/
+	class D3D11GraphicsBackend final : public GraphicsBackend
+	{
+	public:
+		explicit D3D11GraphicsBackend(const GraphicsResourceDesc& gDesc);
+		virtual ~D3D11GraphicsBackend() override;
+
+		virtual BufferHandle createBuffer(const BufferDesc& desc) override;
+		virtual void updateBuffer(BufferHandle buffer, ui32 byteOffset, const void* data, ui32 byteSize) override;
+		virtual void destroyBuffer(BufferHandle buffer) override;
+		virtual void* mapBuffer(BufferHandle buffer, MapMode mode) override;
+		virtual void unmapBuffer(BufferHandle buffer) override;
+
+		virtual PipelineHandle createPipeline(const PipelineDesc& desc) override;
+		virtual void destroyPipeline(PipelineHandle pipeline) override;
+
+		virtual GraphicsCommandList& beginFrame(const FrameDesc& desc) override;
+		virtual GraphicsCommandList& getCommandList(ui32 index) override;
+		virtual ui32 getCommandListCount() const noexcept override;
+		virtual void endFrame() override;
+		virtual ui64 getCompletedFrameCount() override;
+
+		// the swap chain the following frames are drawn into and presented on
+		void setSwapChain(SwapChain& swapChain) noexcept;
+		// deferred context behind command list [index]
+		DeviceContext& getDeviceContext(ui32 index = 0);
+		const D3D11PipelineObjectStats& getPipelineObjectStats() const noexcept;
+
+	private:
+		struct Buffer
+		{
+			Microsoft::WRL::ComPtr<ID3D11Buffer> buffer{};
+			BufferDesc desc{};
+			std::vector<unsigned char> constants{};    // instead of buffer, constant buffers without offsetting
+		};
+
+		struct InputLayout
+		{
+			Microsoft::WRL::ComPtr<ID3D11InputLayout> layout{};
+		};
+
+		struct Pipeline
+		{
+			std::shared_ptr<Shader> vertexShader{};
+			std::shared_ptr<Shader> pixelShader{};
+			std::shared_ptr<InputLayout> inputLayout{};
+			PrimitiveTopology topology{};
+			ID3D11RasterizerState* rasterizerState{};       // owned by the backend's state maps
+			ID3D11BlendState* blendState{};
+			ID3D11DepthStencilState* depthStencilState{};
+		};
+
+		struct FrameCommandList
+		{
+			DeviceContextPtr deviceContext{};
+			std::unique_ptr<D3D11CommandList> commandList{};
+		};
+
+		// event query ended right after the frame's command lists were executed
+		struct FrameFence
+		{
+			ui64 frame{};
+			Microsoft::WRL::ComPtr<ID3D11Query> query{};
+		};
+
+		const Buffer& getBuffer(BufferHandle buffer) const;
+		const Pipeline& getPipeline(PipelineHandle pipeline) const;
+
+		// key: GetShaderKey of the arguments
+		std::shared_ptr<Shader> getShader(const std::string& key, Shader::Type type, const char* path, const char* entryPoint,
+			const std::vector<ShaderMacro>& defines);
+		std::shared_ptr<InputLayout> getInputLayout(const std::string& vertexShaderKey, const Shader& vertexShader,
+			const std::vector<VertexAttribute>& vertexLayout);
+		ID3D11RasterizerState* getRasterizerState(const RasterizerState& state);
+		ID3D11BlendState* getBlendState(BlendMode mode);
+		ID3D11DepthStencilState* getDepthStencilState(const DepthState& state);
+
+	private:
+		std::shared_ptr<const GraphicsDevice> m_graphicsDevice;
+		ID3D11Device& m_device;
+		IDXGIFactory& m_factory;
+		ID3D11DeviceContext& m_immediateContext;
+
+		std::vector<Buffer> m_buffers{};
+		std::vector<ui32> m_freeBuffers{};
+		std::vector<Pipeline> m_pipelines{};
+		std::vector<ui32> m_freePipelines{};
+
+		// keyed by their descriptions in text form, expired entries are swept when a pipeline is destroyed
+		std::unordered_map<std::string, std::weak_ptr<Shader>> m_shaders{};
+		std::unordered_map<std::string, std::weak_ptr<InputLayout>> m_inputLayouts{};
+		std::unordered_map<ui32, Microsoft::WRL::ComPtr<ID3D11RasterizerState>> m_rasterizerStates{};
+		std::unordered_map<ui32, Microsoft::WRL::ComPtr<ID3D11BlendState>> m_blendStates{};
+		std::unordered_map<ui32, Microsoft::WRL::ComPtr<ID3D11DepthStencilState>> m_depthStencilStates{};
+		D3D11PipelineObjectStats m_pipelineObjectStats{};
+
+		std::vector<FrameCommandList> m_commandLists{};
+		ui32 m_commandListCount{};
+		SwapChain* m_swapChain{};
+
+		std::deque<FrameFence> m_pendingFences{};
+		std::vector<Microsoft::WRL::ComPtr<ID3D11Query>> m_freeFenceQueries{};
+		ui64 m_completedFrames{};
+
+		// D3D11_FEATURE_DATA_D3D11_OPTIONS
+		bool m_constantBufferOffsetting{};
+		bool m_mapNoOverwriteOnConstantBuffers{};
+		bool m_partialConstantBufferUpdates{};
+
+		friend class D3D11CommandList;
+	};
+}
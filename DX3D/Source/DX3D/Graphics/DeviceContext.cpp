@@ -16,6 +16,12 @@ void dx3d::DeviceContext::clearAndSetBackBuffer(const SwapChain& swapChain, cons
 	m_context->OMSetRenderTargets(1, &rtv, nullptr);
 }
 
+void dx3d::DeviceContext::setBackBuffer(const SwapChain& swapChain)
+{
+	auto rtv = swapChain.m_rtv.Get();
+	m_context->OMSetRenderTargets(1, &rtv, nullptr);
+}
+
 void dx3d::DeviceContext::setGraphicsPipelineState(const GraphicsPipelineState& pipeline)
 {
 	m_context->VSSetShader(pipeline.m_vs.Get(), nullptr, 0);
@@ -9,6 +9,7 @@ namespace dx3d
 	public:
 		explicit DeviceContext(const GraphicsResourceDesc& gDesc);
 		void clearAndSetBackBuffer(const SwapChain& swapChain, const Vec4& color);
+		void setBackBuffer(const SwapChain& swapChain);
 		void setGraphicsPipelineState(const GraphicsPipelineState& pipeline);
 
 	public:
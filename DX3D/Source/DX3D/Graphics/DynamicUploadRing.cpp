@@ -0,0 +1,141 @@
+#include <DX3D/Graphics/DynamicUploadRing.h>
+#include <DX3D/Graphics/GraphicsBackend.h>
+#include <algorithm>
+#include <string>
+
+namespace
+{
+	dx3d::ui32 AlignUp(dx3d::ui32 value, dx3d::ui32 alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+}
+
+dx3d::DynamicUploadRing::DynamicUploadRing(const DynamicUploadRingDesc& desc) :
+	Base(desc.base),
+	m_backend(desc.backend),
+	m_type(desc.type),
+	m_capacity(desc.byteCapacity)
+{
+	if (!desc.byteCapacity) DX3DLogThrowInvalidArg("Upload ring capacity must be greater than zero.");
+	m_buffer = m_backend.createBuffer({ m_type, BufferUsage::Dynamic, m_capacity });
+}
+
+dx3d::DynamicUploadRing::~DynamicUploadRing()
+{
+	if (m_mapped) m_backend.unmapBuffer(m_buffer);
+	m_backend.destroyBuffer(m_buffer);
+	for (const auto& retired : m_retiredBuffers)
+		m_backend.destroyBuffer(retired.buffer);
+}
+
+void dx3d::DynamicUploadRing::begin()
+{
+	if (m_mapped) DX3DLogThrowError("begin called twice without end.");
+
+	// a frame is done once the completed count has moved past its index
+	const auto completed = m_backend.getCompletedFrameCount();
+	while (!m_frames.empty() && m_frames.front().frame < completed)
+	{
+		m_tail = m_frames.front().end;
+		m_frames.pop_front();
+	}
+	if (m_frames.empty())
+	{
+		m_head = m_tail = 0;
+		m_empty = true;
+	}
+
+	std::erase_if(m_retiredBuffers, [&](const RetiredBuffer& retired)
+		{
+			if (retired.frame >= completed) return false;
+			m_backend.destroyBuffer(retired.buffer);
+			return true;
+		});
+
+	m_frameAllocated = false;
+}
+
+dx3d::UploadAllocation dx3d::DynamicUploadRing::allocate(ui32 byteSize, ui32 alignment)
+{
+	if (!byteSize) DX3DLogThrowInvalidArg("Upload allocation size must be greater than zero.");
+	if (!alignment || (alignment & (alignment - 1))) DX3DLogThrowInvalidArg("Upload alignment must be a power of two.");
+
+	// free space is [head, capacity) + [0, tail) while the used part does not wrap, [head, tail) once it does
+	ui32 offset = AlignUp(m_head, alignment);
+	bool fits{};
+	if (m_empty || m_head > m_tail)
+	{
+		if (static_cast<ui64>(offset) + byteSize <= m_capacity) fits = true;
+		else if (byteSize <= m_tail)
+		{
+			offset = 0;
+			fits = true;
+			m_stats.wraps++;
+		}
+	}
+	else fits = static_cast<ui64>(offset) + byteSize <= m_tail;
+
+	if (!fits)
+	{
+		grow(AlignUp(byteSize, alignment));
+		offset = 0;
+	}
+
+	if (!m_mapped) map();
+
+	m_head = offset + byteSize;
+	m_empty = false;
+	m_frameAllocated = true;
+	m_stats.allocations++;
+	m_stats.bytesAllocated += byteSize;
+	return { m_buffer, offset, m_mapped + offset };
+}
+
+void dx3d::DynamicUploadRing::end()
+{
+	if (m_mapped) unmap();
+	if (m_frameAllocated) m_frames.push_back({ m_backend.getSubmittedFrameCount(), m_head });
+	m_frameAllocated = false;
+}
+
+dx3d::ui32 dx3d::DynamicUploadRing::getCapacity() const noexcept
+{
+	return m_capacity;
+}
+
+const dx3d::DynamicUploadRingStats& dx3d::DynamicUploadRing::getStats() const noexcept
+{
+	return m_stats;
+}
+
+void dx3d::DynamicUploadRing::map()
+{
+	m_mapped = static_cast<unsigned char*>(
+		m_backend.mapBuffer(m_buffer, m_discardOnMap ? MapMode::Discard : MapMode::NoOverwrite));
+	m_discardOnMap = false;
+}
+
+void dx3d::DynamicUploadRing::unmap()
+{
+	m_backend.unmapBuffer(m_buffer);
+	m_mapped = nullptr;
+}
+
+void dx3d::DynamicUploadRing::grow(ui32 requiredSize)
+{
+	// the old buffer may still be read by every frame in flight and by this frame's earlier allocations
+	if (m_mapped) unmap();
+	m_retiredBuffers.push_back({ m_backend.getSubmittedFrameCount(), m_buffer });
+
+	m_capacity = std::max(m_capacity * 2, requiredSize);
+	m_buffer = m_backend.createBuffer({ m_type, BufferUsage::Dynamic, m_capacity });
+	m_discardOnMap = true;
+
+	m_frames.clear();
+	m_head = m_tail = 0;
+	m_empty = true;
+	m_stats.grows++;
+
+	DX3DLogInfo(("Upload ring grew to " + std::to_string(m_capacity) + " bytes.").c_str());
+}
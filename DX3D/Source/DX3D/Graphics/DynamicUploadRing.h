@@ -0,0 +1,83 @@
+#pragma once
+#include <DX3D/Core/Base.h>
+#include <DX3D/Graphics/GraphicsTypes.h>
+#include <deque>
+#include <vector>
+
+namespace dx3d
+{
+	struct UploadAllocation
+	{
+		BufferHandle buffer{};
+		ui32 byteOffset{};
+		void* data{};           // write-only, valid until end()
+	};
+
+	struct DynamicUploadRingStats
+	{
+		ui64 allocations{};
+		ui64 bytesAllocated{};
+		ui64 wraps{};           // allocations that went back to the start of the buffer
+		ui64 grows{};           // times a frame did not fit next to the frames still in flight
+	};
+
+	/*
+	* One large dynamic buffer that per-frame data (moving instances, streamed vertices, constants) is
+	* written into, instead of creating or discarding a buffer per object per frame.
+	* The buffer stays mapped with no-overwrite between begin() and end(); every frame's range is
+	* tagged with its frame index and only handed out again once the backend's frame fence says the
+	* GPU is done with it. A frame that does not fit moves to a bigger buffer, the old one is
+	* destroyed when its last frame completes.
+	*/
+	class DynamicUploadRing final : public Base
+	{
+	public:
+		explicit DynamicUploadRing(const DynamicUploadRingDesc& desc);
+		virtual ~DynamicUploadRing() override;
+
+		// reclaims the ranges of completed frames, before anything of the frame is allocated
+		void begin();
+		// alignment has to be a power of two
+		UploadAllocation allocate(ui32 byteSize, ui32 alignment = 16);
+		// unmaps the buffer, must run before the frame is recorded
+		void end();
+
+		ui32 getCapacity() const noexcept;
+		const DynamicUploadRingStats& getStats() const noexcept;
+
+	private:
+		struct FrameRange
+		{
+			ui64 frame{};
+			ui32 end{};         // head of the ring after the frame, the tail moves here once it completes
+		};
+
+		struct RetiredBuffer
+		{
+			ui64 frame{};
+			BufferHandle buffer{};
+		};
+
+		void map();
+		void unmap();
+		void grow(ui32 requiredSize);
+
+	private:
+		GraphicsBackend& m_backend;
+		BufferType m_type{};
+		BufferHandle m_buffer{};
+		ui32 m_capacity{};
+
+		ui32 m_head{};
+		ui32 m_tail{};
+		bool m_empty{ true };               // head == tail is ambiguous, this tells empty from full
+		bool m_frameAllocated{};
+		std::deque<FrameRange> m_frames{};
+		std::vector<RetiredBuffer> m_retiredBuffers{};
+
+		unsigned char* m_mapped{};
+		bool m_discardOnMap{ true };        // the first map of a new buffer discards it
+
+		DynamicUploadRingStats m_stats{};
+	};
+}
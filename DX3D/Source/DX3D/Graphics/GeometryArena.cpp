@@ -0,0 +1,263 @@
+#include <DX3D/Graphics/GeometryArena.h>
+#include <DX3D/Graphics/GraphicsBackend.h>
+#include <cstring>
+
+namespace
+{
+	dx3d::ui32 GetGrownCapacity(const dx3d::BufferAllocator& allocator, dx3d::ui32 requiredSize)
+	{
+		const auto capacity = allocator.getCapacity();
+		return capacity + std::max(std::max(capacity, requiredSize), 64u);
+	}
+}
+
+dx3d::GeometryArena::GeometryArena(const GeometryArenaDesc& desc) :
+	Base(desc.base),
+	m_backend(desc.backend),
+	m_inputStride(desc.vertexStride),
+	m_vertexStride(desc.encoding.getStride()),
+	m_encoding(desc.encoding),
+	m_bounds(desc.bounds),
+	m_vertexAllocator(desc.initialVertexCapacity),
+	m_indexAllocator(desc.initialIndexCapacity)
+{
+	if (!desc.vertexStride) DX3DLogThrowInvalidArg("No vertex stride provided.");
+	if (desc.vertexStride < 7 * sizeof(f32)) DX3DLogThrowInvalidArg("Arena vertices must start with x y z r g b a floats.");
+	if (!desc.initialVertexCapacity) DX3DLogThrowInvalidArg("Initial vertex capacity must be greater than zero.");
+	if (!desc.initialIndexCapacity) DX3DLogThrowInvalidArg("Initial index capacity must be greater than zero.");
+
+	m_vertexData.resize(static_cast<size_t>(desc.initialVertexCapacity) * m_vertexStride);
+	m_indexData.resize(desc.initialIndexCapacity);
+}
+
+dx3d::GeometryArena::~GeometryArena()
+{
+	if (m_vertexBuffer) m_backend.destroyBuffer(m_vertexBuffer);
+	if (m_indexBuffer) m_backend.destroyBuffer(m_indexBuffer);
+}
+
+dx3d::GeometryAllocation dx3d::GeometryArena::allocate(const void* vertices, ui32 vertexCount, const ui32* indices, ui32 indexCount)
+{
+	GeometryAllocation allocation{};
+	allocateBatch(vertices, 1, vertexCount, indices, indexCount, &allocation);
+	return allocation;
+}
+
+void dx3d::GeometryArena::allocateBatch(const void* vertices, ui32 shapeCount, ui32 verticesPerShape,
+	const ui32* shapeIndices, ui32 indicesPerShape, GeometryAllocation* outAllocations)
+{
+	if (!vertices || !verticesPerShape) DX3DLogThrowInvalidArg("No vertex data provided.");
+	if (indicesPerShape && !shapeIndices) DX3DLogThrowInvalidArg("Index count provided without index data.");
+	if (!shapeCount) return;
+	for (ui32 i = 0; i < indicesPerShape; i++)
+	{
+		if (shapeIndices[i] >= verticesPerShape)
+			DX3DLogThrowInvalidArg("Index references a vertex outside of its own allocation.");
+	}
+
+	// one block for the whole batch (at most one grow), carved into one allocation per shape afterwards;
+	// the allocators only track free ranges, so the pieces can be freed independently later
+	const auto vertexCount = shapeCount * verticesPerShape;
+	const auto vertexBlock = reserveVertices(vertexCount);
+	VertexEncoder::Encode(m_encoding, m_bounds, vertices, m_inputStride, vertexCount,
+		m_vertexData.data() + static_cast<size_t>(vertexBlock.offset) * m_vertexStride);
+	m_vertexDirty.add(vertexBlock.offset, vertexCount);
+
+	BufferAllocator::Allocation indexBlock{};
+	if (indicesPerShape)
+	{
+		const auto indexCount = shapeCount * indicesPerShape;
+		indexBlock = reserveIndices(indexCount);
+		auto* indices = m_indexData.data() + indexBlock.offset;
+		for (ui32 shape = 0; shape < shapeCount; shape++)
+		{
+			const auto baseVertex = vertexBlock.offset + shape * verticesPerShape;
+			for (ui32 i = 0; i < indicesPerShape; i++)
+				*indices++ = shapeIndices[i] + baseVertex;
+		}
+		m_indexDirty.add(indexBlock.offset, indexCount);
+	}
+
+	for (ui32 shape = 0; shape < shapeCount; shape++)
+	{
+		auto& allocation = outAllocations[shape];
+		allocation.vertices = { vertexBlock.offset + shape * verticesPerShape, verticesPerShape };
+		allocation.indices = indicesPerShape ? BufferAllocator::Allocation{ indexBlock.offset + shape * indicesPerShape, indicesPerShape }
+			: BufferAllocator::Allocation{};
+	}
+}
+
+void dx3d::GeometryArena::free(const GeometryAllocation& allocation)
+{
+	m_vertexAllocator.free(allocation.vertices);
+	m_indexAllocator.free(allocation.indices);
+}
+
+void dx3d::GeometryArena::update(const GeometryAllocation& allocation, const void* vertices)
+{
+	if (!vertices) DX3DLogThrowInvalidArg("No vertex data provided.");
+	if (allocation.vertices.offset + allocation.vertices.size > m_vertexAllocator.getCapacity())
+		DX3DLogThrowInvalidArg("Updated allocation lies outside of the arena.");
+
+	VertexEncoder::Encode(m_encoding, m_bounds, vertices, m_inputStride, allocation.vertices.size,
+		m_vertexData.data() + static_cast<size_t>(allocation.vertices.offset) * m_vertexStride);
+	m_vertexDirty.add(allocation.vertices.offset, allocation.vertices.size);
+}
+
+void dx3d::GeometryArena::compact(GeometryAllocation* allocations, size_t count)
+{
+	if (!count) return;
+
+	// copied out first (already encoded), the new block may overlap the old places; indices go back to being block relative
+	ui32 vertexCount{}, indexCount{};
+	for (size_t i = 0; i < count; i++)
+	{
+		vertexCount += allocations[i].vertices.size;
+		indexCount += allocations[i].indices.size;
+	}
+
+	std::vector<unsigned char> vertices{};
+	std::vector<ui32> indices{};
+	vertices.reserve(static_cast<size_t>(vertexCount) * m_vertexStride);
+	indices.reserve(indexCount);
+	for (size_t i = 0; i < count; i++)
+	{
+		const auto& allocation = allocations[i];
+		const auto base = static_cast<ui32>(vertices.size() / m_vertexStride);
+		const auto vertexBegin = m_vertexData.begin() + static_cast<size_t>(allocation.vertices.offset) * m_vertexStride;
+		vertices.insert(vertices.end(), vertexBegin, vertexBegin + static_cast<size_t>(allocation.vertices.size) * m_vertexStride);
+		for (ui32 index = 0; index < allocation.indices.size; index++)
+			indices.push_back(m_indexData[allocation.indices.offset + index] - allocation.vertices.offset + base);
+		free(allocation);
+	}
+
+	// one block for everything, then carved back up; the allocators only track free ranges, so the pieces free independently
+	const auto vertexBlock = reserveVertices(vertexCount);
+	std::memcpy(m_vertexData.data() + static_cast<size_t>(vertexBlock.offset) * m_vertexStride, vertices.data(), vertices.size());
+	m_vertexDirty.add(vertexBlock.offset, vertexCount);
+
+	BufferAllocator::Allocation indexBlock{};
+	if (indexCount)
+	{
+		indexBlock = reserveIndices(indexCount);
+		for (ui32 i = 0; i < indexCount; i++)
+			m_indexData[indexBlock.offset + i] = indices[i] + vertexBlock.offset;
+		m_indexDirty.add(indexBlock.offset, indexCount);
+	}
+
+	ui32 vertexOffset = vertexBlock.offset, indexOffset = indexBlock.offset;
+	for (size_t i = 0; i < count; i++)
+	{
+		auto& allocation = allocations[i];
+		allocation.vertices.offset = vertexOffset;
+		allocation.indices.offset = allocation.indices.size ? indexOffset : 0;
+		vertexOffset += allocation.vertices.size;
+		indexOffset += allocation.indices.size;
+	}
+}
+
+void dx3d::GeometryArena::flush()
+{
+	if (m_vertexBufferStale)
+	{
+		recreateBuffer(m_vertexBuffer, BufferType::Vertex, m_vertexData.data(), static_cast<ui32>(m_vertexData.size()));
+		m_vertexBufferStale = false;
+	}
+	else if (!m_vertexDirty.empty())
+	{
+		const auto byteBegin = m_vertexDirty.begin * m_vertexStride;
+		m_backend.updateBuffer(m_vertexBuffer, byteBegin, m_vertexData.data() + byteBegin,
+			(m_vertexDirty.end - m_vertexDirty.begin) * m_vertexStride);
+	}
+	m_vertexDirty = {};
+
+	if (m_indexBufferStale)
+	{
+		recreateBuffer(m_indexBuffer, BufferType::Index, m_indexData.data(), static_cast<ui32>(m_indexData.size() * sizeof(ui32)));
+		m_indexBufferStale = false;
+	}
+	else if (!m_indexDirty.empty())
+	{
+		m_backend.updateBuffer(m_indexBuffer, m_indexDirty.begin * static_cast<ui32>(sizeof(ui32)),
+			m_indexData.data() + m_indexDirty.begin, (m_indexDirty.end - m_indexDirty.begin) * static_cast<ui32>(sizeof(ui32)));
+	}
+	m_indexDirty = {};
+}
+
+void dx3d::GeometryArena::bind(GraphicsCommandList& commandList) const
+{
+	commandList.setVertexBuffer(0, m_vertexBuffer, m_vertexStride);
+	commandList.setIndexBuffer(m_indexBuffer);
+}
+
+dx3d::VertexBufferBinding dx3d::GeometryArena::getVertexBufferBinding() const noexcept
+{
+	return { m_vertexBuffer, m_vertexStride };
+}
+
+dx3d::BufferHandle dx3d::GeometryArena::getIndexBuffer() const noexcept
+{
+	return m_indexBuffer;
+}
+
+dx3d::ui32 dx3d::GeometryArena::getVertexStride() const noexcept
+{
+	return m_vertexStride;
+}
+
+dx3d::ui32 dx3d::GeometryArena::getInputStride() const noexcept
+{
+	return m_inputStride;
+}
+
+const dx3d::VertexEncoding& dx3d::GeometryArena::getEncoding() const noexcept
+{
+	return m_encoding;
+}
+
+const dx3d::PositionBounds& dx3d::GeometryArena::getBounds() const noexcept
+{
+	return m_bounds;
+}
+
+dx3d::ui32 dx3d::GeometryArena::getVertexCapacity() const noexcept
+{
+	return m_vertexAllocator.getCapacity();
+}
+
+dx3d::ui32 dx3d::GeometryArena::getIndexCapacity() const noexcept
+{
+	return m_indexAllocator.getCapacity();
+}
+
+dx3d::BufferAllocator::Allocation dx3d::GeometryArena::reserveVertices(ui32 count)
+{
+	BufferAllocator::Allocation allocation{};
+	if (!m_vertexAllocator.allocate(count, allocation))
+	{
+		m_vertexAllocator.grow(GetGrownCapacity(m_vertexAllocator, count));
+		m_vertexAllocator.allocate(count, allocation);
+		m_vertexData.resize(static_cast<size_t>(m_vertexAllocator.getCapacity()) * m_vertexStride);
+		m_vertexBufferStale = true;
+	}
+	return allocation;
+}
+
+dx3d::BufferAllocator::Allocation dx3d::GeometryArena::reserveIndices(ui32 count)
+{
+	BufferAllocator::Allocation allocation{};
+	if (!m_indexAllocator.allocate(count, allocation))
+	{
+		m_indexAllocator.grow(GetGrownCapacity(m_indexAllocator, count));
+		m_indexAllocator.allocate(count, allocation);
+		m_indexData.resize(m_indexAllocator.getCapacity());
+		m_indexBufferStale = true;
+	}
+	return allocation;
+}
+
+void dx3d::GeometryArena::recreateBuffer(BufferHandle& buffer, BufferType type, const void* data, ui32 byteWidth)
+{
+	if (buffer) m_backend.destroyBuffer(buffer);
+	buffer = m_backend.createBuffer({ type, BufferUsage::Default, byteWidth, data });
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <DX3D/Core/Base.h>
+#include <DX3D/Graphics/GraphicsTypes.h>
+#include <DX3D/Graphics/BufferAllocator.h>
+#include <DX3D/Graphics/VertexEncoding.h>
+#include <algorithm>
+#include <vector>
+
+namespace dx3d
+{
+	struct GeometryAllocation
+	{
+		BufferAllocator::Allocation vertices{};
+		BufferAllocator::Allocation indices{};
+	};
+
+	/*
+	* One large vertex buffer + one large index buffer that the shape meshes are carved
+	* out of, instead of creating two tiny buffers per mesh.
+	* Indices are rebased onto the vertex allocation when they are written, so neighbouring
+	* allocations can be drawn together with a single DrawIndexed and no base vertex.
+	* Vertices come in as x y z r g b a floats and are stored in the arena's VertexEncoding;
+	* ShapeSystem builds its input layout and shader defines from getEncoding() / getBounds().
+	*/
+	class GeometryArena final : public Base
+	{
+	public:
+		explicit GeometryArena(const GeometryArenaDesc& desc);
+		virtual ~GeometryArena() override;
+
+		GeometryAllocation allocate(const void* vertices, ui32 vertexCount, const ui32* indices = nullptr, ui32 indexCount = 0);
+		// shapeCount shapes of the same size packed back to back in vertices, all using the same allocation relative
+		// shapeIndices; one allocation per shape is written to outAllocations
+		void allocateBatch(const void* vertices, ui32 shapeCount, ui32 verticesPerShape,
+			const ui32* shapeIndices, ui32 indicesPerShape, GeometryAllocation* outAllocations);
+		void free(const GeometryAllocation& allocation);
+		// rewrites the vertices of an allocation in place, the vertex count stays the same
+		void update(const GeometryAllocation& allocation, const void* vertices);
+		// moves the given allocations next to each other, in order, so they can be drawn as one run
+		void compact(GeometryAllocation* allocations, size_t count);
+
+		// pushes pending writes to the GPU, recreating the buffers if the arena grew since the last flush
+		void flush();
+		void bind(GraphicsCommandList& commandList) const;
+		// what bind() binds, for draws that go through a RenderQueue
+		VertexBufferBinding getVertexBufferBinding() const noexcept;
+		BufferHandle getIndexBuffer() const noexcept;
+
+		// stride of the encoded vertices in the GPU buffer
+		ui32 getVertexStride() const noexcept;
+		// stride of the float vertices allocate() and update() take
+		ui32 getInputStride() const noexcept;
+		const VertexEncoding& getEncoding() const noexcept;
+		const PositionBounds& getBounds() const noexcept;
+		ui32 getVertexCapacity() const noexcept;
+		ui32 getIndexCapacity() const noexcept;
+
+	private:
+		struct DirtyRange
+		{
+			ui32 begin{ UINT32_MAX };
+			ui32 end{};
+			void add(ui32 offset, ui32 size) { begin = std::min(begin, offset); end = std::max(end, offset + size); }
+			bool empty() const { return begin >= end; }
+		};
+
+		// grows the arena when no free block is large enough
+		BufferAllocator::Allocation reserveVertices(ui32 count);
+		BufferAllocator::Allocation reserveIndices(ui32 count);
+		void recreateBuffer(BufferHandle& buffer, BufferType type, const void* data, ui32 byteWidth);
+
+	private:
+		GraphicsBackend& m_backend;
+		ui32 m_inputStride{};
+		ui32 m_vertexStride{};
+		VertexEncoding m_encoding{};
+		PositionBounds m_bounds{};
+		BufferAllocator m_vertexAllocator;
+		BufferAllocator m_indexAllocator;
+
+		// CPU copy of the arena contents, used to rebuild the GPU buffers when they have to grow
+		std::vector<unsigned char> m_vertexData{};
+		std::vector<ui32> m_indexData{};
+		DirtyRange m_vertexDirty{};
+		DirtyRange m_indexDirty{};
+		bool m_vertexBufferStale{ true };
+		bool m_indexBufferStale{ true };
+
+		BufferHandle m_vertexBuffer{};
+		BufferHandle m_indexBuffer{};
+	};
+}
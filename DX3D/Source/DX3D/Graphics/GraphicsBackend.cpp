@@ -0,0 +1,140 @@
+#include <DX3D/Graphics/GraphicsBackend.h>
+#include <DX3D/Graphics/ImmutableBufferCache.h>
+#include <DX3D/Graphics/PipelineCache.h>
+
+void dx3d::GraphicsCommandList::setPipeline(PipelineHandle pipeline)
+{
+	if (pipeline && pipeline == m_boundPipeline)
+	{
+		m_stats.stateChangesSkipped++;
+		return;
+	}
+
+	m_stats.pipelineChanges++;
+	onSetPipeline(pipeline);
+	m_boundPipeline = pipeline;
+}
+
+void dx3d::GraphicsCommandList::setVertexBuffer(ui32 slot, BufferHandle buffer, ui32 stride, ui32 byteOffset)
+{
+	const VertexBufferBinding binding{ buffer, stride, byteOffset };
+	if (slot < MaxCachedVertexBuffers && buffer && m_boundVertexBuffers[slot] == binding)
+	{
+		m_stats.stateChangesSkipped++;
+		return;
+	}
+
+	m_stats.bufferBindings++;
+	onSetVertexBuffer(slot, buffer, stride, byteOffset);
+	if (slot < MaxCachedVertexBuffers) m_boundVertexBuffers[slot] = binding;
+}
+
+void dx3d::GraphicsCommandList::setIndexBuffer(BufferHandle buffer, ui32 byteOffset)
+{
+	if (buffer && buffer == m_boundIndexBuffer && byteOffset == m_boundIndexByteOffset)
+	{
+		m_stats.stateChangesSkipped++;
+		return;
+	}
+
+	m_stats.bufferBindings++;
+	onSetIndexBuffer(buffer, byteOffset);
+	m_boundIndexBuffer = buffer;
+	m_boundIndexByteOffset = byteOffset;
+}
+
+void dx3d::GraphicsCommandList::setConstantBuffer(ui32 slot, const ConstantBufferBinding& binding)
+{
+	if (slot < MaxCachedConstantBuffers && binding.buffer && m_boundConstantBuffers[slot] == binding)
+	{
+		m_stats.stateChangesSkipped++;
+		return;
+	}
+
+	m_stats.bufferBindings++;
+	onSetConstantBuffer(slot, binding);
+	if (slot < MaxCachedConstantBuffers) m_boundConstantBuffers[slot] = binding;
+}
+
+void dx3d::GraphicsCommandList::draw(ui32 vertexCount, ui32 startVertex)
+{
+	m_stats.drawCalls++;
+	m_stats.instances++;
+	m_stats.primitives += GetPrimitiveCount(m_topology, vertexCount);
+	onDraw(vertexCount, startVertex);
+}
+
+void dx3d::GraphicsCommandList::drawIndexed(ui32 indexCount, ui32 startIndex, i32 baseVertex)
+{
+	m_stats.drawCalls++;
+	m_stats.instances++;
+	m_stats.primitives += GetPrimitiveCount(m_topology, indexCount);
+	onDrawIndexed(indexCount, startIndex, baseVertex);
+}
+
+void dx3d::GraphicsCommandList::drawIndexedInstanced(ui32 indexCount, ui32 instanceCount, ui32 startIndex, i32 baseVertex, ui32 startInstance)
+{
+	m_stats.drawCalls++;
+	m_stats.instances += instanceCount;
+	m_stats.primitives += static_cast<ui64>(GetPrimitiveCount(m_topology, indexCount)) * instanceCount;
+	onDrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+}
+
+const dx3d::GraphicsCommandListStats& dx3d::GraphicsCommandList::getStats() const noexcept
+{
+	return m_stats;
+}
+
+void dx3d::GraphicsCommandList::resetStats() noexcept
+{
+	m_stats = {};
+}
+
+void dx3d::GraphicsCommandList::invalidateState() noexcept
+{
+	m_boundPipeline = {};
+	for (auto& binding : m_boundVertexBuffers)
+		binding = {};
+	m_boundIndexBuffer = {};
+	m_boundIndexByteOffset = 0;
+	for (auto& binding : m_boundConstantBuffers)
+		binding = {};
+	onInvalidateState();
+}
+
+dx3d::GraphicsBackend::GraphicsBackend(const BaseDesc& desc) : Base(desc),
+	m_immutableBufferCache(std::make_unique<ImmutableBufferCache>(desc, *this)),
+	m_pipelineCache(std::make_unique<PipelineCache>(desc, *this))
+{
+}
+
+dx3d::GraphicsBackend::~GraphicsBackend()
+{
+}
+
+dx3d::ImmutableBufferCache& dx3d::GraphicsBackend::getImmutableBufferCache() noexcept
+{
+	return *m_immutableBufferCache;
+}
+
+dx3d::PipelineCache& dx3d::GraphicsBackend::getPipelineCache() noexcept
+{
+	return *m_pipelineCache;
+}
+
+dx3d::ui64 dx3d::GraphicsBackend::getSubmittedFrameCount() const noexcept
+{
+	return m_stats.frames;
+}
+
+const dx3d::GraphicsBackendStats& dx3d::GraphicsBackend::getStats() const noexcept
+{
+	return m_stats;
+}
+
+void dx3d::GraphicsBackend::addFrameStats(const GraphicsCommandListStats& frameStats) noexcept
+{
+	m_stats.frames++;
+	m_stats.lastFrame = frameStats;
+	m_stats.total += frameStats;
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include <DX3D/Core/Base.h>
+#include <DX3D/Graphics/GraphicsTypes.h>
+#include <memory>
+
+namespace dx3d
+{
+	/*
+	* Records draw work for one frame.
+	* The public calls do the bookkeeping shared by every backend (draw and state-change counters)
+	* and forward to the backend through the protected on* hooks.
+	* They also keep a state cache: binding the pipeline or buffer that is already bound does not
+	* reach the backend and is counted in stateChangesSkipped instead.
+	*/
+	class GraphicsCommandList
+	{
+	public:
+		virtual ~GraphicsCommandList() = default;
+
+		void setPipeline(PipelineHandle pipeline);
+		void setVertexBuffer(ui32 slot, BufferHandle buffer, ui32 stride, ui32 byteOffset = 0);
+		void setIndexBuffer(BufferHandle buffer, ui32 byteOffset = 0);
+		// vertex shader constants, byteOffset and byteSize multiples of ConstantBufferAlignment
+		void setConstantBuffer(ui32 slot, const ConstantBufferBinding& binding);
+
+		void draw(ui32 vertexCount, ui32 startVertex);
+		void drawIndexed(ui32 indexCount, ui32 startIndex, i32 baseVertex = 0);
+		void drawIndexedInstanced(ui32 indexCount, ui32 instanceCount, ui32 startIndex, i32 baseVertex = 0, ui32 startInstance = 0);
+
+		const GraphicsCommandListStats& getStats() const noexcept;
+		void resetStats() noexcept;
+		// forget the cached bindings, backends call this whenever the API state is reset (every beginFrame)
+		void invalidateState() noexcept;
+
+		// vertex and constant buffer slots the state cache tracks, bindings to higher slots are always forwarded
+		static constexpr ui32 MaxCachedVertexBuffers = 8;
+		static constexpr ui32 MaxCachedConstantBuffers = 4;
+
+	protected:
+		virtual void onSetPipeline(PipelineHandle pipeline) = 0;
+		virtual void onSetVertexBuffer(ui32 slot, BufferHandle buffer, ui32 stride, ui32 byteOffset) = 0;
+		virtual void onSetIndexBuffer(BufferHandle buffer, ui32 byteOffset) = 0;
+		virtual void onSetConstantBuffer(ui32 slot, const ConstantBufferBinding& binding) = 0;
+		virtual void onDraw(ui32 vertexCount, ui32 startVertex) = 0;
+		virtual void onDrawIndexed(ui32 indexCount, ui32 startIndex, i32 baseVertex) = 0;
+		virtual void onDrawIndexedInstanced(ui32 indexCount, ui32 instanceCount, ui32 startIndex, i32 baseVertex, ui32 startInstance) = 0;
+		// for backends with a finer grained cache of their own
+		virtual void onInvalidateState() {}
+
+	protected:
+		GraphicsCommandListStats m_stats{};
+		PrimitiveTopology m_topology{ PrimitiveTopology::TriangleList }; // of the bound pipeline, set by onSetPipeline
+
+	private:
+		PipelineHandle m_boundPipeline{};
+		VertexBufferBinding m_boundVertexBuffers[MaxCachedVertexBuffers]{};
+		BufferHandle m_boundIndexBuffer{};
+		ui32 m_boundIndexByteOffset{};
+		ConstantBufferBinding m_boundConstantBuffers[MaxCachedConstantBuffers]{};
+	};
+
+	/*
+	* Everything the renderer needs from a graphics API: buffers, pipelines and a per-frame command list.
+	* The shape system and the scene renderer only ever talk to this interface, so they build and run
+	* without any graphics API headers (see NullGraphicsBackend for the headless implementation).
+	* Resource creation and updates happen outside beginFrame/endFrame, on the calling thread.
+	*/
+	class GraphicsBackend : public Base
+	{
+	public:
+		explicit GraphicsBackend(const BaseDesc& desc);
+		virtual ~GraphicsBackend() override;
+
+		virtual BufferHandle createBuffer(const BufferDesc& desc) = 0;
+		// Dynamic buffers are always rewritten from offset 0, the previous contents are discarded
+		virtual void updateBuffer(BufferHandle buffer, ui32 byteOffset, const void* data, ui32 byteSize) = 0;
+		virtual void destroyBuffer(BufferHandle buffer) = 0;
+		// Dynamic buffers only; the pointer stays valid until unmapBuffer, which has to happen before
+		// the buffer is used by a command list
+		virtual void* mapBuffer(BufferHandle buffer, MapMode mode) = 0;
+		virtual void unmapBuffer(BufferHandle buffer) = 0;
+
+		virtual PipelineHandle createPipeline(const PipelineDesc& desc) = 0;
+		virtual void destroyPipeline(PipelineHandle pipeline) = 0;
+
+		// returns the first command list of this frame, with the render target bound and cleared
+		virtual GraphicsCommandList& beginFrame(const FrameDesc& desc) = 0;
+		// list [index] of the current frame, every list has the render target bound.
+		// Different lists may be recorded on different threads, one list only by one thread at a time.
+		// No resources may be created, updated or destroyed while lists are being recorded.
+		virtual GraphicsCommandList& getCommandList(ui32 index) = 0;
+		virtual ui32 getCommandListCount() const noexcept = 0;
+		// submits the recorded lists in index order and presents
+		virtual void endFrame() = 0;
+
+		// frames submitted with endFrame so far, which is also the index of the frame being prepared
+		ui64 getSubmittedFrameCount() const noexcept;
+		// frames the GPU is done with (the frame fence), never more than getSubmittedFrameCount()
+		virtual ui64 getCompletedFrameCount() = 0;
+
+		ImmutableBufferCache& getImmutableBufferCache() noexcept;
+		// one shared pipeline per description, for everything that does not need a private one
+		PipelineCache& getPipelineCache() noexcept;
+		const GraphicsBackendStats& getStats() const noexcept;
+
+	protected:
+		void addFrameStats(const GraphicsCommandListStats& frameStats) noexcept;
+
+	protected:
+		GraphicsBackendStats m_stats{};
+
+	private:
+		std::unique_ptr<ImmutableBufferCache> m_immutableBufferCache{};
+		std::unique_ptr<PipelineCache> m_pipelineCache{};
+	};
+}
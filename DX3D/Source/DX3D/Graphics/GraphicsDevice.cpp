@@ -4,6 +4,9 @@
 #include <DX3D/Graphics/DeviceContext.h>
 #include <DX3D/Graphics/ShaderBinary.h>
 #include <DX3D/Graphics/GraphicsPipelineState.h>
+#include <DX3D/Graphics/ShaderCache.h>
+#include <d3dcompiler.h>
+#include <string>
 
 using namespace dx3d;
 
@@ -30,6 +33,35 @@ dx3d::GraphicsDevice::GraphicsDevice(const GraphicsDeviceDesc& desc) : Base(desc
     DX3DGraphicsLogThrowOnFail(m_dxgiAdapter->GetParent(IID_PPV_ARGS(&m_dxgiFactory)),
         "GetParent failed to retrieve IDXGIFactory.");
 
+    auto compileWithD3D = [this](const ShaderCompileRequest& request, ShaderBytecode& outBytecode, std::string& outErrors)
+        {
+            std::vector<D3D_SHADER_MACRO> macros{};
+            for (const auto& define : request.defines)
+                macros.push_back({ define.name.c_str(), define.definition.c_str() });
+            macros.push_back({ nullptr, nullptr });
+
+            Microsoft::WRL::ComPtr<ID3DBlob> shaderBlob{};
+            Microsoft::WRL::ComPtr<ID3DBlob> errorBlob{};
+            HRESULT hr = D3DCompile(request.sourceCode, request.sourceCodeSize, request.sourceName,
+                macros.data(), nullptr, request.entryPoint, request.target, request.flags, 0,
+                &shaderBlob, &errorBlob);
+
+            auto errorMsg = errorBlob ? static_cast<const char*>(errorBlob->GetBufferPointer()) : nullptr;
+            if (FAILED(hr))
+            {
+                outErrors = errorMsg ? errorMsg : "Shader compilation failed.";
+                return false;
+            }
+            if (errorMsg)
+                DX3DLogWarning(errorMsg);
+
+            auto data = static_cast<const unsigned char*>(shaderBlob->GetBufferPointer());
+            outBytecode.assign(data, data + shaderBlob->GetBufferSize());
+            return true;
+        };
+
+    m_shaderCache = std::make_unique<ShaderCache>(ShaderCacheDesc{ {m_logger}, "ShaderCache",
+        "D3DCompile/" + std::to_string(D3D_COMPILER_VERSION), compileWithD3D });
 }
 
 dx3d::GraphicsDevice::~GraphicsDevice()
@@ -64,6 +96,11 @@ void dx3d::GraphicsDevice::executeCommandList(DeviceContext& context)
     m_d3dContext->ExecuteCommandList(list.Get(), false);
 }
 
+ShaderCache& dx3d::GraphicsDevice::getShaderCache() const noexcept
+{
+    return *m_shaderCache;
+}
+
 GraphicsResourceDesc dx3d::GraphicsDevice::getGraphicsResourceDesc() const noexcept
 {
     return { {m_logger}, shared_from_this(), *m_d3dDevice.Get(), *m_dxgiFactory.Get() };
@@ -22,6 +22,8 @@ namespace dx3d
 
         void executeCommandList(DeviceContext& context);
 
+        ShaderCache& getShaderCache() const noexcept;
+
     private:
         GraphicsResourceDesc getGraphicsResourceDesc() const noexcept;
 
@@ -31,5 +33,8 @@ namespace dx3d
         Microsoft::WRL::ComPtr<IDXGIDevice> m_dxgiDevice{};
         Microsoft::WRL::ComPtr<IDXGIAdapter> m_dxgiAdapter{};
         Microsoft::WRL::ComPtr<IDXGIFactory> m_dxgiFactory{};
+
+    private:
+        std::unique_ptr<ShaderCache> m_shaderCache{};
     };
 }
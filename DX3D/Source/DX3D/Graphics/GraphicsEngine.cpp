@@ -1,163 +1,163 @@
 #include <DX3D/Graphics/GraphicsEngine.h>
+#include <DX3D/Core/Profiler.h>
+#include <DX3D/Core/ThreadPool.h>
 #include <DX3D/Graphics/GraphicsDevice.h>
-#include <DX3D/Graphics/DeviceContext.h>
 #include <DX3D/Graphics/SwapChain.h>
+#include <DX3D/Graphics/SceneRenderer.h>
+#include <DX3D/Graphics/D3D11/D3D11GraphicsBackend.h>
+#include <DX3D/Graphics/ImmutableBufferCache.h>
+#include <DX3D/Graphics/PipelineCache.h>
+#include <string>
 
 using namespace dx3d;
 
-GraphicsEngine::GraphicsEngine(const GraphicsEngineDesc& desc) : Base(desc.base)
+GraphicsEngine::GraphicsEngine(const GraphicsEngineDesc& desc) : Base(desc.base), m_logStatistics(desc.logStatistics)
 {
     m_graphicsDevice = std::make_shared<GraphicsDevice>(GraphicsDeviceDesc{ m_logger });
 
-    auto& device = *m_graphicsDevice;
-    m_deviceContext = device.createDeviceContext();
+    GraphicsResourceDesc gDesc = { {m_logger}, m_graphicsDevice,
+                                *m_graphicsDevice->m_d3dDevice.Get(),
+                                *m_graphicsDevice->m_dxgiFactory.Get() };
+    m_backend = std::make_unique<D3D11GraphicsBackend>(gDesc);
+    m_threadPool = std::make_unique<ThreadPool>(ThreadPoolDesc{ {m_logger} });
+    m_sceneRenderer = std::make_unique<SceneRenderer>(SceneRendererDesc{ {m_logger}, *m_backend, m_threadPool.get() });
+
+    addCube(0.0f, -0.5f, 0.0f, 0.5f);
+}
 
-    constexpr char shaderSourceCode[] =
-        R"(
-void VSMain()
+GraphicsEngine::~GraphicsEngine()
 {
+    if (m_logStatistics)
+        logStatistics();
 }
-void PSMain()
+
+void GraphicsEngine::logStatistics() const
 {
+    const auto& cacheStats = m_backend->getImmutableBufferCache().getStats();
+    DX3DLogInfo(("Immutable buffer cache: " + std::to_string(cacheStats.hits) + " hits, " +
+        std::to_string(cacheStats.misses) + " misses, " +
+        std::to_string(cacheStats.bytesSaved) + " bytes saved.").c_str());
+
+    const auto& pipelineStats = m_backend->getPipelineCache().getStats();
+    const auto& objectStats = m_backend->getPipelineObjectStats();
+    DX3DLogInfo(("Pipeline cache: " + std::to_string(pipelineStats.hits) + " hits, " +
+        std::to_string(pipelineStats.misses) + " pipelines created, " +
+        std::to_string(objectStats.shadersCreated) + " shaders (" + std::to_string(objectStats.shadersShared) + " shared), " +
+        std::to_string(objectStats.inputLayoutsCreated) + " input layouts (" + std::to_string(objectStats.inputLayoutsShared) + " shared), " +
+        std::to_string(objectStats.stateObjectsCreated) + " state objects.").c_str());
+
+    const auto& backendStats = m_backend->getStats();
+    DX3DLogInfo(("Graphics backend: " + std::to_string(backendStats.frames) + " frames, " +
+        std::to_string(backendStats.total.drawCalls) + " draw calls, " +
+        std::to_string(backendStats.total.getStateChanges()) + " state changes (" +
+        std::to_string(backendStats.total.stateChangesSkipped) + " redundant ones skipped, " +
+        std::to_string(backendStats.lastFrame.stateChangesSkipped) + " in the last frame), " +
+        std::to_string(backendStats.bytesUploaded) + " bytes uploaded.").c_str());
+
+    const auto& ringStats = m_sceneRenderer->getUploadRing().getStats();
+    DX3DLogInfo(("Upload ring: " + std::to_string(ringStats.allocations) + " allocations, " +
+        std::to_string(ringStats.bytesAllocated) + " bytes streamed, " +
+        std::to_string(ringStats.wraps) + " wraps, " +
+        std::to_string(ringStats.grows) + " grows, " +
+        std::to_string(m_sceneRenderer->getUploadRing().getCapacity()) + " bytes capacity.").c_str());
+
+    const auto& constantStats = m_sceneRenderer->getConstantRing().getStats();
+    DX3DLogInfo(("Constants: " + std::to_string(constantStats.blocksUploaded) + " per-frame blocks, " +
+        std::to_string(constantStats.blocksDeduplicated) + " deduplicated, " +
+        std::to_string(constantStats.blockUpdates) + " retained updates, " +
+        std::to_string(constantStats.blockUpdatesSkipped) + " unchanged skipped, " +
+        std::to_string(constantStats.flushes) + " flushes.").c_str());
+
+    const auto& cullingStats = m_sceneRenderer->getCullingStats();
+    DX3DLogInfo(("Culling (last frame): " + std::to_string(cullingStats.visible) + " visible, " +
+        std::to_string(cullingStats.culled) + " culled, " +
+        std::to_string(cullingStats.nodesTested) + " BVH nodes tested.").c_str());
+
+    const auto& sceneGraphStats = m_sceneRenderer->getSceneGraphStats();
+    DX3DLogInfo(("Scene graph (last frame): " + std::to_string(sceneGraphStats.nodes) + " nodes in " +
+        std::to_string(sceneGraphStats.levels) + " levels, " +
+        std::to_string(sceneGraphStats.recomputed) + " world matrices recomputed.").c_str());
 }
-)";
-    constexpr char shaderSourceName[] = "Basic";
-    constexpr auto shaderSourceCodeSize = std::size(shaderSourceCode);
 
-    auto vs = device.compileShader({ shaderSourceName, shaderSourceCode, shaderSourceCodeSize,
-        "VSMain", ShaderType::VertexShader });
-    auto ps = device.compileShader({ shaderSourceName, shaderSourceCode, shaderSourceCodeSize,
-        "PSMain", ShaderType::PixelShader });
+GraphicsDevice& GraphicsEngine::getGraphicsDevice() noexcept
+{
+    return *m_graphicsDevice;
+}
 
-    m_pipeline = device.createGraphicsPipelineState({ *vs,*ps });
+Entity GraphicsEngine::addTriangle(float posX, float posY, float size, float r, float g, float b, float a)
+{
+    return m_sceneRenderer->addTriangle(posX, posY, size, r, g, b, a);
+}
 
-    GraphicsResourceDesc gDesc = { {m_logger}, m_graphicsDevice,
-                                *m_graphicsDevice->m_d3dDevice.Get(),
-                                *m_graphicsDevice->m_dxgiFactory.Get() };
-    m_triangleManager = std::make_unique<Triangle>(gDesc);
-    m_rectangleManager = std::make_unique<Rectangle>(gDesc);
-    m_cubeManager = std::make_unique<Cube>(gDesc);
+std::vector<dx3d::Entity> dx3d::GraphicsEngine::addTriangles(std::span<const TriangleDesc> triangles)
+{
+    return m_sceneRenderer->addTriangles(triangles);
+}
+
+dx3d::Entity dx3d::GraphicsEngine::addRectangle(float posX, float posY, float width, float height, float r, float g, float b, float a)
+{
+    return m_sceneRenderer->addRectangle(posX, posY, width, height, r, g, b, a);
+}
 
-    m_triangleManager->initializeSharedResources();
-    m_rectangleManager->initializeSharedResources();
-    m_cubeManager->initializeSharedResources();
+std::vector<dx3d::Entity> dx3d::GraphicsEngine::addRectangles(std::span<const RectangleDesc> rectangles)
+{
+    return m_sceneRenderer->addRectangles(rectangles);
+}
 
-    addCube(0.0f, -0.5f, 0.0f, 0.5f);
+dx3d::Entity dx3d::GraphicsEngine::addCube(float posX, float posY, float posZ, float size, float r, float g, float b, float a)
+{
+    return m_sceneRenderer->addCube(posX, posY, posZ, size, r, g, b, a);
 }
 
-GraphicsEngine::~GraphicsEngine()
+std::vector<dx3d::Entity> dx3d::GraphicsEngine::addCubes(std::span<const CubeDesc> cubes)
 {
+    return m_sceneRenderer->addCubes(cubes);
 }
 
-GraphicsDevice& GraphicsEngine::getGraphicsDevice() noexcept
+void dx3d::GraphicsEngine::moveShape(Entity shape, float posX, float posY, float posZ, float size)
 {
-    return *m_graphicsDevice;
+    m_sceneRenderer->moveShape(shape, posX, posY, posZ, size);
+}
+
+void dx3d::GraphicsEngine::removeShape(Entity shape)
+{
+    m_sceneRenderer->removeShape(shape);
 }
 
-void GraphicsEngine::addTriangle(float posX, float posY, float size, float r, float g, float b, float a)
-{
-    std::vector<TriangleVertex> vertices;
-    if (r < 0 || g < 0 || b < 0) {
-        vertices = {
-            { posX,         posY + size / 2, 0.0f, 0.0f, 0.0f, 0.0f, a },  // Top: Red
-            { posX + size / 2, posY - size / 2, 0.0f, 0.0f, 1.0f, 0.0f, a },  // Bottom right: Green
-            { posX - size / 2, posY - size / 2, 0.0f, 0.0f, 0.0f, 1.0f, a }   // Bottom left: Blue
-        };
-    }
-    else {
-        vertices = {
-            { posX,         posY + size / 2, 0.0f, r, g, b, a },  // Top vertex
-            { posX + size / 2, posY - size / 2, 0.0f, r, g, b, a },  // Bottom right vertex
-            { posX - size / 2, posY - size / 2, 0.0f, r, g, b, a }   // Bottom left vertex
-        };
-    }
-
-    m_triangleManager->createTriangle(vertices);
-}
-
-void dx3d::GraphicsEngine::addRectangle(float posX, float posY, float width, float height, float r, float g, float b, float a)
-{
-    std::vector<RectangleVertex> vertices;
-    float halfWidth = width / 2.0f;
-    float halfHeight = height / 2.0f;
-
-    if (r < 0 || g < 0 || b < 0) {
-        vertices = {
-            { posX - halfWidth, posY + halfHeight, 0.0f, 0.0f, 1.0f, 0.0f, a },  // Top-left: Green
-            { posX + halfWidth, posY + halfHeight, 0.0f, 1.0f, 1.0f, 0.0f, a },  // Top-right: Yellow
-            { posX + halfWidth, posY - halfHeight, 0.0f, 0.0f, 0.0f, 1.0f, a },  // Bottom-right: Blue
-            { posX - halfWidth, posY - halfHeight, 0.0f, 1.0f, 0.0f, 0.0f, a }   // Bottom-left: Red
-        };
-    }
-    else {
-        vertices = {
-            { posX - halfWidth, posY + halfHeight, 0.0f, r, g, b, a },  // Top-left
-            { posX + halfWidth, posY + halfHeight, 0.0f, r, g, b, a },  // Top-right
-            { posX + halfWidth, posY - halfHeight, 0.0f, r, g, b, a },  // Bottom-right
-            { posX - halfWidth, posY - halfHeight, 0.0f, r, g, b, a }   // Bottom-left
-        };
-    }
-
-    m_rectangleManager->createRectangle(vertices);
-}
-
-void dx3d::GraphicsEngine::addCube(float posX, float posY, float posZ, float size, float r, float g, float b, float a)
-{
-    std::vector<CubeVertex> vertices;
-    float halfSize = size / 2.0f;
-
-    if (r < 0 || g < 0 || b < 0) {
-        vertices = {
-            { posX - halfSize, posY + halfSize, posZ + halfSize, 1.0f, 0.0f, 0.0f, a },  // Red
-            { posX + halfSize, posY + halfSize, posZ + halfSize, 0.0f, 1.0f, 0.0f, a },  // Green
-            { posX + halfSize, posY - halfSize, posZ + halfSize, 0.0f, 0.0f, 1.0f, a },  // Blue
-            { posX - halfSize, posY - halfSize, posZ + halfSize, 1.0f, 1.0f, 0.0f, a },  // Yellow
-
-            { posX - halfSize, posY + halfSize, posZ - halfSize, 1.0f, 0.0f, 1.0f, a },  // Magenta
-            { posX + halfSize, posY + halfSize, posZ - halfSize, 0.0f, 1.0f, 1.0f, a },  // Cyan
-            { posX + halfSize, posY - halfSize, posZ - halfSize, 1.0f, 1.0f, 1.0f, a },  // White
-            { posX - halfSize, posY - halfSize, posZ - halfSize, 0.5f, 0.5f, 0.5f, a }   // Gray
-        };
-    }
-    else {
-        vertices = {
-            { posX - halfSize, posY + halfSize, posZ + halfSize, r, g, b, a },
-            { posX + halfSize, posY + halfSize, posZ + halfSize, r, g, b, a },
-            { posX + halfSize, posY - halfSize, posZ + halfSize, r, g, b, a },
-            { posX - halfSize, posY - halfSize, posZ + halfSize, r, g, b, a },
-
-            { posX - halfSize, posY + halfSize, posZ - halfSize, r, g, b, a },
-            { posX + halfSize, posY + halfSize, posZ - halfSize, r, g, b, a },
-            { posX + halfSize, posY - halfSize, posZ - halfSize, r, g, b, a },
-            { posX - halfSize, posY - halfSize, posZ - halfSize, r, g, b, a }
-        };
-    }
-
-    m_cubeManager->createCube(vertices);
+dx3d::EntityStore& dx3d::GraphicsEngine::getEntityStore() noexcept
+{
+    return m_sceneRenderer->getEntityStore();
+}
+
+dx3d::SceneNode dx3d::GraphicsEngine::attachShape(Entity shape, SceneNode parent)
+{
+    return m_sceneRenderer->attachShape(shape, parent);
+}
+
+dx3d::SceneGraph& dx3d::GraphicsEngine::getSceneGraph() noexcept
+{
+    return m_sceneRenderer->getSceneGraph();
+}
+
+void dx3d::GraphicsEngine::setCamera(const Mat4& viewProjection)
+{
+    m_sceneRenderer->setCamera(viewProjection);
 }
 
 void GraphicsEngine::render(SwapChain& swapChain)
 {
-    auto& context = *m_deviceContext;
-    context.clearAndSetBackBuffer(swapChain, { 0.f, 0.27f, 0.4f, 1.0f });
+    DX3DProfileZone("GraphicsEngine::render");
 
-    context.setGraphicsPipelineState(*m_pipeline);
+    // uploads go through the immediate context so they land before the recorded draws execute,
+    // the upload ring is unmapped again before anything is recorded
+    m_sceneRenderer->update();
+    m_sceneRenderer->prepare();
 
-    // this thing matches the viewport to the window size
-    D3D11_VIEWPORT viewport = {};
-    DXGI_SWAP_CHAIN_DESC desc;
-    swapChain.m_swapChain->GetDesc(&desc);
-    viewport.Width = static_cast<float>(desc.BufferDesc.Width);
-    viewport.Height = static_cast<float>(desc.BufferDesc.Height);
-    viewport.MinDepth = 0.0f;
-    viewport.MaxDepth = 1.0f;
-    context.m_context->RSSetViewports(1, &viewport);
+    m_backend->setSwapChain(swapChain);
+    m_backend->beginFrame({ { 0.f, 0.27f, 0.4f, 1.0f }, m_sceneRenderer->getCommandListCount() });
 
-    m_triangleManager->render(*context.m_context.Get());
-    m_rectangleManager->render(*context.m_context.Get());
-    m_cubeManager->render(*context.m_context.Get());
+    // every draw binds its own pipeline, the sorted queue is recorded on worker threads, one deferred context each
+    m_sceneRenderer->render();
 
-    auto& device = *m_graphicsDevice;
-    device.executeCommandList(context);
-    swapChain.present();
+    m_backend->endFrame();
 }
\ No newline at end of file
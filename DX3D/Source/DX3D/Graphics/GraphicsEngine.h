@@ -1,9 +1,10 @@
 #pragma once
 #include <DX3D/Core/Core.h>
 #include <DX3D/Core/Base.h>
-#include <DX3D/Graphics/Triangle.h> 
-#include <DX3D/Graphics/Rectangle.h>
-#include <DX3D/Graphics/Cube.h>
+#include <DX3D/Core/SlotMap.h>
+#include <DX3D/Math/Mat4.h>
+#include <memory>
+#include <span>
 #include <vector>
 
 namespace dx3d
@@ -19,24 +20,45 @@ namespace dx3d
         void render(SwapChain& swapChain);
 
         // add a triangle at specified position with specified color
-        void addTriangle(float posX, float posY, float size = 1.0f,
+        Entity addTriangle(float posX, float posY, float size = 1.0f,
             float r = -1.0f, float g = -1.0f, float b = -1.0f, float a = 1.0f);
+        std::vector<Entity> addTriangles(std::span<const TriangleDesc> triangles);
 
         // add a rectangle at specified position with specified size and color
-        void addRectangle(float posX, float posY, float width = 1.0f, float height = 1.0f,
+        Entity addRectangle(float posX, float posY, float width = 1.0f, float height = 1.0f,
             float r = -1.0f, float g = -1.0f, float b = -1.0f, float a = 1.0f);
+        std::vector<Entity> addRectangles(std::span<const RectangleDesc> rectangles);
 
         // add a cube at specified position with specified size and color
-        void addCube(float posX, float posY, float posZ, float size = 1.0f,
+        Entity addCube(float posX, float posY, float posZ, float size = 1.0f,
             float r = -1.0f, float g = -1.0f, float b = -1.0f, float a = 1.0f);
+        // bulk version for whole levels: the entities are filled in parallel, one upload on the next frame
+        std::vector<Entity> addCubes(std::span<const CubeDesc> cubes);
+
+        // moves a shape added before, a moving shape costs a memcpy per frame instead of a buffer
+        void moveShape(Entity shape, float posX, float posY, float posZ, float size = 1.0f);
+        // handles go stale on removal, using one afterwards throws
+        void removeShape(Entity shape);
+
+        // where the shapes live, for systems that update many of them at once
+        EntityStore& getEntityStore() noexcept;
+
+        // hangs a shape in the transform hierarchy, see SceneRenderer::attachShape
+        SceneNode attachShape(Entity shape, SceneNode parent = {});
+        SceneGraph& getSceneGraph() noexcept;
+
+        // the view-projection matrix the shapes are drawn with, identity (clip space) until set
+        void setCamera(const Mat4& viewProjection);
+
+    private:
+        void logStatistics() const;
 
     private:
         std::shared_ptr<GraphicsDevice> m_graphicsDevice{};
-        DeviceContextPtr m_deviceContext{};
-        GraphicsPipelineStatePtr m_pipeline{};
 
-        std::unique_ptr<Triangle> m_triangleManager{};
-        std::unique_ptr<Rectangle> m_rectangleManager{};
-        std::unique_ptr<Cube> m_cubeManager{};
+        std::unique_ptr<D3D11GraphicsBackend> m_backend{};
+        std::unique_ptr<ThreadPool> m_threadPool{};
+        std::unique_ptr<SceneRenderer> m_sceneRenderer{};
+        bool m_logStatistics{};
     };
 }
\ No newline at end of file
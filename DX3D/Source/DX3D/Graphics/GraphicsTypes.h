@@ -0,0 +1,233 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <DX3D/Graphics/BufferTypes.h>
+#include <DX3D/Math/Vec4.h>
+#include <string>
+#include <vector>
+
+namespace dx3d
+{
+	/*
+	* Backend-neutral resource handles and descriptors.
+	* Nothing in here may pull in a graphics API header, this is what the headless
+	* backends and the shape system are written against.
+	*/
+
+	struct BufferHandle
+	{
+		ui32 id{};
+		explicit operator bool() const noexcept { return id != 0; }
+		bool operator==(const BufferHandle&) const = default;
+	};
+
+	struct PipelineHandle
+	{
+		ui32 id{};
+		explicit operator bool() const noexcept { return id != 0; }
+		bool operator==(const PipelineHandle&) const = default;
+	};
+
+	enum class BufferUsage
+	{
+		Immutable = 0, // written once at creation
+		Default,       // updated occasionally through updateBuffer
+		Dynamic        // rewritten by the CPU, updates discard the previous contents
+	};
+
+	enum class MapMode
+	{
+		Discard = 0,    // the previous contents are gone, the GPU keeps reading its own copy
+		NoOverwrite     // contents stay, the caller only writes ranges no submitted frame still reads
+	};
+
+	struct BufferDesc
+	{
+		BufferType type{};
+		BufferUsage usage{};
+		ui32 byteWidth{};
+		const void* initialData{};
+	};
+
+	enum class VertexFormat
+	{
+		Float2 = 0,
+		Float3,
+		Float4,
+		Half4,          // 4 x fp16
+		Short4Norm,     // 4 x int16 mapped to [-1, 1]
+		UByte4Norm      // 4 x uint8 mapped to [0, 1]
+	};
+
+	enum class VertexInputRate
+	{
+		PerVertex = 0,
+		PerInstance
+	};
+
+	struct VertexAttribute
+	{
+		const char* semanticName{};
+		ui32 semanticIndex{};
+		VertexFormat format{};
+		ui32 slot{};
+		ui32 offset{};
+		VertexInputRate inputRate{ VertexInputRate::PerVertex };
+	};
+
+	enum class PrimitiveTopology
+	{
+		TriangleList = 0,
+		TriangleStrip,
+		LineList
+	};
+
+	enum class FillMode
+	{
+		Solid = 0,
+		Wireframe
+	};
+
+	enum class CullMode
+	{
+		Back = 0,
+		Front,
+		None
+	};
+
+	// the defaults are Direct3D's default rasterizer state, which everything was drawn with before pipelines carried one
+	struct RasterizerState
+	{
+		FillMode fillMode{ FillMode::Solid };
+		CullMode cullMode{ CullMode::Back };
+		bool frontCounterClockwise{};
+		bool depthClip{ true };
+
+		bool operator==(const RasterizerState&) const = default;
+	};
+
+	enum class BlendMode
+	{
+		Opaque = 0,
+		AlphaBlend,     // source * alpha + target * (1 - alpha)
+		Additive        // source * alpha + target
+	};
+
+	// only has an effect on frames with a depth buffer; the default is Direct3D's, a less-than test that writes
+	struct DepthState
+	{
+		bool depthTest{ true };
+		bool depthWrite{ true };
+
+		bool operator==(const DepthState&) const = default;
+	};
+
+	// a preprocessor define handed to the shader compiler (name=definition)
+	struct ShaderMacro
+	{
+		std::string name{};
+		std::string definition{};
+	};
+
+	struct PipelineDesc
+	{
+		const char* vertexShaderPath{};
+		const char* pixelShaderPath{};
+		const char* vertexShaderEntryPoint{ "main" };
+		const char* pixelShaderEntryPoint{ "main" };
+		std::vector<VertexAttribute> vertexLayout{};
+		PrimitiveTopology topology{ PrimitiveTopology::TriangleList };
+		// e.g. the vertex decode VertexEncoder::GetShaderDefines selects, pipelines with different defines are different shaders
+		std::vector<ShaderMacro> vertexShaderDefines{};
+		RasterizerState rasterizer{};
+		BlendMode blendMode{ BlendMode::Opaque };
+		DepthState depth{};
+	};
+
+	struct VertexBufferBinding
+	{
+		BufferHandle buffer{};
+		ui32 stride{};
+		ui32 byteOffset{};
+
+		bool operator==(const VertexBufferBinding&) const = default;
+	};
+
+	// constant buffer ranges are bound in whole multiples of 16 constants (256 bytes), at offsets aligned the same
+	constexpr ui32 ConstantBufferAlignment = 256;
+	// the most a single binding can expose to a shader, 4096 constants
+	constexpr ui32 MaxConstantBufferBindingSize = 64 * 1024;
+
+	struct ConstantBufferBinding
+	{
+		BufferHandle buffer{};
+		ui32 byteOffset{};
+		ui32 byteSize{};
+
+		bool operator==(const ConstantBufferBinding&) const = default;
+	};
+
+	struct FrameDesc
+	{
+		Vec4 clearColor{};
+		ui32 commandListCount{ 1 };  // lists that can be recorded in parallel, executed in index order
+	};
+
+	struct GraphicsCommandListStats
+	{
+		ui64 drawCalls{};
+		ui64 instances{};
+		ui64 primitives{};
+		ui64 pipelineChanges{};
+		ui64 bufferBindings{};
+		ui64 stateChangesSkipped{};    // redundant state calls the command list's state cache filtered out
+
+		ui64 getStateChanges() const noexcept { return pipelineChanges + bufferBindings; }
+
+		GraphicsCommandListStats& operator+=(const GraphicsCommandListStats& other) noexcept
+		{
+			drawCalls += other.drawCalls;
+			instances += other.instances;
+			primitives += other.primitives;
+			pipelineChanges += other.pipelineChanges;
+			bufferBindings += other.bufferBindings;
+			stateChangesSkipped += other.stateChangesSkipped;
+			return *this;
+		}
+	};
+
+	struct GraphicsBackendStats
+	{
+		ui64 buffersCreated{};
+		ui64 buffersDestroyed{};
+		ui64 pipelinesCreated{};
+		ui64 bytesUploaded{};
+		ui64 frames{};
+		GraphicsCommandListStats lastFrame{};
+		GraphicsCommandListStats total{};
+	};
+
+	inline ui32 GetVertexFormatSize(VertexFormat format) noexcept
+	{
+		switch (format)
+		{
+		case VertexFormat::Float2: return 8;
+		case VertexFormat::Float3: return 12;
+		case VertexFormat::Float4: return 16;
+		case VertexFormat::Half4: return 8;
+		case VertexFormat::Short4Norm: return 8;
+		case VertexFormat::UByte4Norm: return 4;
+		default: return 0;
+		}
+	}
+
+	inline ui32 GetPrimitiveCount(PrimitiveTopology topology, ui32 vertexCount) noexcept
+	{
+		switch (topology)
+		{
+		case PrimitiveTopology::TriangleList: return vertexCount / 3;
+		case PrimitiveTopology::TriangleStrip: return vertexCount >= 3 ? vertexCount - 2 : 0;
+		case PrimitiveTopology::LineList: return vertexCount / 2;
+		default: return 0;
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#include <DX3D/Graphics/ImmutableBufferCache.h>
+#include <DX3D/Graphics/GraphicsBackend.h>
+#include <DX3D/Core/Hash.h>
+#include <cstring>
+
+dx3d::ImmutableBufferCache::ImmutableBufferCache(const BaseDesc& desc, GraphicsBackend& backend) :
+	Base(desc),
+	m_backend(backend)
+{
+}
+
+dx3d::BufferHandle dx3d::ImmutableBufferCache::acquire(const ImmutableBufferDesc& desc)
+{
+	if (!desc.data) DX3DLogThrowInvalidArg("No buffer data provided.");
+	if (!desc.byteWidth) DX3DLogThrowInvalidArg("No buffer size provided.");
+	if (desc.usage == BufferUsage::Dynamic)
+		DX3DLogThrowInvalidArg("Only buffers that are never written can be shared through the cache.");
+
+	auto key = desc.contentHash ? desc.contentHash : Hash::HashBytes(desc.data, desc.byteWidth);
+	key = Hash::Combine(key, static_cast<ui64>(desc.type));
+	key = Hash::Combine(key, static_cast<ui64>(desc.usage));
+
+	auto& bucket = m_entries[key];
+	for (auto& entry : bucket)
+	{
+		// the compare only runs on a hash match, which is a hit unless the hash lied
+		if (entry.type == desc.type && entry.usage == desc.usage && entry.byteWidth == desc.byteWidth &&
+			std::memcmp(entry.contents.data(), desc.data, desc.byteWidth) == 0)
+		{
+			entry.references++;
+			m_stats.hits++;
+			m_stats.bytesSaved += desc.byteWidth;
+			return entry.buffer;
+		}
+	}
+
+	Entry entry{ desc.type, desc.usage, desc.byteWidth };
+	entry.buffer = m_backend.createBuffer({ desc.type, desc.usage, desc.byteWidth, desc.data });
+	entry.references = 1;
+	auto bytes = static_cast<const unsigned char*>(desc.data);
+	entry.contents.assign(bytes, bytes + desc.byteWidth);
+	bucket.push_back(std::move(entry));
+	m_keys[bucket.back().buffer.id] = key;
+
+	m_stats.misses++;
+	m_stats.bytesUploaded += desc.byteWidth;
+	m_stats.bufferCount++;
+	return bucket.back().buffer;
+}
+
+void dx3d::ImmutableBufferCache::release(BufferHandle buffer)
+{
+	auto key = m_keys.find(buffer.id);
+	if (key == m_keys.end()) DX3DLogThrowInvalidArg("Buffer was not acquired from this cache.");
+
+	auto bucket = m_entries.find(key->second);
+	for (auto entry = bucket->second.begin(); entry != bucket->second.end(); ++entry)
+	{
+		if (entry->buffer != buffer) continue;
+		if (--entry->references) return;
+
+		m_backend.destroyBuffer(buffer);
+		bucket->second.erase(entry);
+		if (bucket->second.empty()) m_entries.erase(bucket);
+		m_keys.erase(key);
+		m_stats.bufferCount--;
+		return;
+	}
+}
+
+const dx3d::ImmutableBufferCacheStats& dx3d::ImmutableBufferCache::getStats() const noexcept
+{
+	return m_stats;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <DX3D/Core/Base.h>
+#include <DX3D/Graphics/GraphicsTypes.h>
+#include <unordered_map>
+#include <vector>
+
+namespace dx3d
+{
+	struct ImmutableBufferDesc
+	{
+		const void* data{};
+		ui32 byteWidth{};
+		BufferType type{};
+		BufferUsage usage{ BufferUsage::Immutable };
+		// 0 = hash data. Otherwise Hash::HashBytes of data computed ahead of time (e.g. stored in a mesh file), which
+		// saves hashing it; the hash only picks the bucket, a buffer is still only shared when the bytes compare equal,
+		// so a wrong or stale hash costs sharing, never correctness
+		ui64 contentHash{};
+	};
+
+	struct ImmutableBufferCacheStats
+	{
+		ui64 hits{};
+		ui64 misses{};
+		ui64 bytesUploaded{};
+		ui64 bytesSaved{};
+		size_t bufferCount{};
+	};
+
+	/*
+	* Hands out one shared GPU buffer per unique (contents, type, usage) combination.
+	* Only for data that is never written after creation; the buffers are shared, so a
+	* write through one user would show up in all of them.
+	* Every acquire has to be paired with a release, the buffer is destroyed with its last user.
+	*/
+	class ImmutableBufferCache final : public Base
+	{
+	public:
+		ImmutableBufferCache(const BaseDesc& desc, GraphicsBackend& backend);
+
+		BufferHandle acquire(const ImmutableBufferDesc& desc);
+		void release(BufferHandle buffer);
+
+		const ImmutableBufferCacheStats& getStats() const noexcept;
+
+	private:
+		struct Entry
+		{
+			BufferType type{};
+			BufferUsage usage{};
+			ui32 byteWidth{};
+			std::vector<unsigned char> contents{}; // kept to rule out hash collisions and wrong precomputed hashes
+			BufferHandle buffer{};
+			ui32 references{};
+		};
+
+		GraphicsBackend& m_backend;
+		std::unordered_map<ui64, std::vector<Entry>> m_entries{};
+		std::unordered_map<ui32, ui64> m_keys{}; // buffer id -> bucket, so release does not have to rehash
+		ImmutableBufferCacheStats m_stats{};
+	};
+}
@@ -1,82 +1,264 @@
 #include <DX3D/Graphics/Mesh.h>
-#include <DX3D/Graphics/GraphicsLogUtils.h>
+#include <DX3D/Graphics/GraphicsBackend.h>
+#include <DX3D/Graphics/RenderQueue.h>
+#include <DX3D/Graphics/ConstantBufferRing.h>
+#include <DX3D/Graphics/ImmutableBufferCache.h>
+#include <DX3D/Graphics/PipelineCache.h>
+#include <DX3D/Graphics/MeshFile.h>
+#include <DX3D/Graphics/MeshImporter.h>
+#include <algorithm>
+#include <string>
 
 namespace dx3d
 {
-    Mesh::Mesh(const GraphicsResourceDesc& gDesc) : GraphicsResource(gDesc)
+    Mesh::Mesh(const BaseDesc& desc, GraphicsBackend& backend, const VertexEncoding& encoding) : Base(desc), m_backend(backend),
+        m_encoding(encoding), m_bounds(), m_stride(encoding.getStride()), m_offset(0), m_vertexCount(0), m_indexCount(0), m_optimizerStats(),
+        m_lods(), m_localBounds()
     {
         initializeShaders();
     }
 
+    Mesh::~Mesh()
+    {
+        releaseBuffers();
+        if (m_pipeline)
+            m_backend.getPipelineCache().release(m_pipeline);
+    }
+
     void Mesh::initializeBuffers(const std::vector<Vertex>& vertices)
     {
-        D3D11_BUFFER_DESC bufferDesc = {};
-        bufferDesc.Usage = D3D11_USAGE_DEFAULT;
-        bufferDesc.ByteWidth = static_cast<UINT>(vertices.size() * sizeof(Vertex));
-        bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-
-        D3D11_SUBRESOURCE_DATA initData = {};
-        initData.pSysMem = vertices.data();
-
-        DX3DGraphicsLogThrowOnFail(
-            m_device.CreateBuffer(&bufferDesc, &initData, &m_vertexBuffer),
-            "Failed to create vertex buffer"
-        );
-
-        D3D11_INPUT_ELEMENT_DESC layoutDesc[] = {
-            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 }
-        };
-
-        DX3DGraphicsLogThrowOnFail(
-            m_device.CreateInputLayout(layoutDesc, 2, m_vertexShader->getByteCode().data(), m_vertexShader->getByteCode().size(), &m_inputLayout),
-            "Failed to create input layout"
-        );
-
-        m_stride = sizeof(Vertex);
-        m_offset = 0;
-        m_vertexCount = static_cast<UINT>(vertices.size());
+        // every shared corner was its own vertex and got transformed once per triangle; welded, indexed and
+        // ordered for the post-transform cache each one is fetched and transformed about once
+        std::vector<unsigned char> optimized;
+        std::vector<ui32> indices;
+        m_optimizerStats = MeshOptimizer::Optimize(vertices.data(), sizeof(Vertex), vertices.size(), optimized, indices);
+        uploadOptimized(optimized, indices);
     }
 
-    void Mesh::initializeShaders()
+    void Mesh::initializeBuffers(const std::vector<Vertex>& vertices, const std::vector<ui32>& indices)
     {
-        Shader::ShaderDesc vertexShaderDesc = {
-            { m_logger, m_graphicsDevice, m_device, m_factory },
-            Shader::Type::Vertex,
-            "main",
-            "vs_5_0"
-        };
-        m_vertexShader = std::make_unique<Shader>(vertexShaderDesc);
-        if (!m_vertexShader->loadFromFile("DX3D/Source/DX3D/Graphics/Shaders/VertexShader.hlsl"))
-        {
-            DX3DLogThrowError("Failed to load vertex shader");
-        }
+        std::vector<unsigned char> optimized;
+        std::vector<ui32> optimizedIndices;
+        m_optimizerStats = MeshOptimizer::Optimize(vertices.data(), sizeof(Vertex), vertices.size(),
+            indices.data(), indices.size(), optimized, optimizedIndices);
+        uploadOptimized(optimized, optimizedIndices);
+    }
+
+    void Mesh::uploadOptimized(const std::vector<unsigned char>& vertices, const std::vector<ui32>& indices)
+    {
+        auto& cache = m_backend.getImmutableBufferCache();
+        releaseBuffers();
+        const auto vertexCount = static_cast<size_t>(m_optimizerStats.uniqueVertices);
+
+        DX3DLogInfo(("Mesh optimized: " + std::to_string(m_optimizerStats.inputVertices) + " -> " +
+            std::to_string(m_optimizerStats.uniqueVertices) + " vertices, " +
+            std::to_string(m_optimizerStats.triangles) + " triangles in " + std::to_string(m_optimizerStats.clusters) +
+            " clusters, ACMR " + std::to_string(m_optimizerStats.acmrBefore) + " -> " +
+            std::to_string(m_optimizerStats.acmrAfter)).c_str());
 
-        Shader::ShaderDesc pixelShaderDesc = {
-            { m_logger, m_graphicsDevice, m_device, m_factory },
-            Shader::Type::Pixel,
-            "main",
-            "ps_5_0"
-        };
-        m_pixelShader = std::make_unique<Shader>(pixelShaderDesc);
-        if (!m_pixelShader->loadFromFile("DX3D/Source/DX3D/Graphics/Shaders/PixelShader.hlsl"))
+        // the bounds are only baked into the shader for Snorm16x4, a new box means a new pipeline
+        if (m_encoding.position == PositionEncoding::Snorm16x4)
         {
-            DX3DLogThrowError("Failed to load pixel shader");
+            m_bounds = PositionBounds::FromVertices(vertices.data(), sizeof(Vertex), vertexCount);
+            initializeShaders();
         }
+
+        // the levels only drop and re-point triangles, so they all draw from the one vertex buffer
+        std::vector<ui32> lodIndices;
+        m_lods = MeshSimplifier::BuildLodChain(indices.data(), indices.size(), vertices.data(), sizeof(Vertex), vertexCount, lodIndices);
+        m_localBounds = Aabb::fromPoints(vertices.data(), sizeof(Vertex), vertexCount);
+
+        std::string levels;
+        for (const auto& level : m_lods)
+            levels += (levels.empty() ? "" : ", ") + std::to_string(level.indexCount / 3);
+        DX3DLogInfo(("Mesh LODs: " + levels + " triangles, error up to " + std::to_string(m_lods.back().error)).c_str());
+
+        m_stride = m_encoding.getStride();
+        m_offset = 0;
+        m_vertexCount = static_cast<ui32>(vertexCount);
+        m_indexCount = static_cast<ui32>(lodIndices.size());
+        if (!m_indexCount)
+            return;
+
+        std::vector<unsigned char> encoded(vertexCount * m_stride);
+        VertexEncoder::Encode(m_encoding, m_bounds, vertices.data(), sizeof(Vertex), vertexCount, encoded.data());
+
+        // meshes never write their vertices after creation, so identical meshes can share one buffer
+        m_vertexBuffer = cache.acquire({
+            encoded.data(),
+            static_cast<ui32>(encoded.size()),
+            BufferType::Vertex
+        });
+        m_indexBuffer = cache.acquire({
+            lodIndices.data(),
+            static_cast<ui32>(lodIndices.size() * sizeof(ui32)),
+            BufferType::Index
+        });
+    }
+
+    void Mesh::importFromFile(const std::filesystem::path& path, ThreadPool* threadPool)
+    {
+        ImportedMesh imported;
+        MeshImportOptions options{};
+        options.threadPool = threadPool;
+        std::string error;
+        if (!MeshImporter::Import(path, imported, options, &error))
+            DX3DLogThrowError(("Could not import mesh " + path.string() + ": " + error).c_str());
+
+        const auto& stats = imported.stats;
+        DX3DLogInfo(("Mesh imported: " + path.string() + ", " + std::to_string(stats.bytes / (1024.0 * 1024.0)) +
+            " MB in " + std::to_string(stats.seconds * 1000.0) + " ms (" + std::to_string(stats.megabytesPerSecond) +
+            " MB/s, " + std::to_string(stats.chunks) + " chunks)").c_str());
+
+        initializeBuffers(imported.vertices, imported.indices);
+    }
+
+    void Mesh::loadFromFile(const std::filesystem::path& path)
+    {
+        MeshFile file;
+        std::string error;
+        if (!file.open(path, &error))
+            DX3DLogThrowError(("Could not load mesh " + path.string() + ": " + error).c_str());
+
+        const auto& data = file.getData();
+        releaseBuffers();
+
+        // the file was encoded for its own encoding and bounds, the pipeline has to decode exactly that
+        m_encoding = data.encoding;
+        m_bounds = data.positionBounds;
+        initializeShaders();
+
+        m_stride = m_encoding.getStride();
+        m_offset = 0;
+        m_vertexCount = data.vertexCount;
+        m_indexCount = data.indexCount;
+        m_optimizerStats = data.optimizerStats;
+        // mesh files store a single index list, they draw at full detail
+        m_lods = { { 0, m_indexCount, 0.0f } };
+        m_localBounds = data.bounds;
+
+        DX3DLogInfo(("Mesh loaded: " + path.string() + ", " + std::to_string(m_vertexCount) + " vertices, " +
+            std::to_string(m_indexCount / 3) + " triangles, ACMR " + std::to_string(m_optimizerStats.acmrAfter)).c_str());
+
+        if (!m_indexCount)
+            return;
+
+        // the mapped pages are handed to buffer creation as they are (D3D11_SUBRESOURCE_DATA::pSysMem); the hashes
+        // stored in the file spare the cache hashing them, it still compares the bytes before sharing a buffer
+        auto& cache = m_backend.getImmutableBufferCache();
+        m_vertexBuffer = cache.acquire({
+            data.vertices,
+            file.getVertexDataSize(),
+            BufferType::Vertex,
+            BufferUsage::Immutable,
+            file.getVertexHash()
+        });
+        m_indexBuffer = cache.acquire({
+            data.indices,
+            file.getIndexDataSize(),
+            BufferType::Index,
+            BufferUsage::Immutable,
+            file.getIndexHash()
+        });
     }
 
-    void Mesh::render(ID3D11DeviceContext& context)
+    void Mesh::initializeShaders()
     {
-        context.IASetInputLayout(m_inputLayout.Get());
+        PipelineDesc pipelineDesc = {};
+        pipelineDesc.vertexShaderPath = "DX3D/Source/DX3D/Graphics/Shaders/VertexShader.hlsl";
+        pipelineDesc.pixelShaderPath = "DX3D/Source/DX3D/Graphics/Shaders/PixelShader.hlsl";
+        pipelineDesc.vertexLayout = VertexEncoder::GetVertexLayout(m_encoding);
+        pipelineDesc.vertexShaderDefines = VertexEncoder::GetShaderDefines(m_encoding, m_bounds);
+        // meshes with the same encoding (and for Snorm16x4 the same bounds) draw with one pipeline; the new one is
+        // acquired before the old one is released, so an unchanged description keeps its pipeline
+        auto& cache = m_backend.getPipelineCache();
+        const auto pipeline = cache.acquire(pipelineDesc);
+        if (m_pipeline)
+            cache.release(m_pipeline);
+        m_pipeline = pipeline;
+    }
 
-        ID3D11Buffer* vertexBuffers[] = { m_vertexBuffer.Get() };
-        context.IASetVertexBuffers(0, 1, vertexBuffers, &m_stride, &m_offset);
+    void Mesh::releaseBuffers()
+    {
+        auto& cache = m_backend.getImmutableBufferCache();
+        if (m_vertexBuffer)
+            cache.release(m_vertexBuffer);
+        if (m_indexBuffer)
+            cache.release(m_indexBuffer);
+        m_vertexBuffer = {};
+        m_indexBuffer = {};
+    }
 
-        context.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    const MeshOptimizerStats& Mesh::getOptimizerStats() const noexcept
+    {
+        return m_optimizerStats;
+    }
 
-        context.VSSetShader(m_vertexShader->getVertexShader(), nullptr, 0);
-        context.PSSetShader(m_pixelShader->getPixelShader(), nullptr, 0);
+    const std::vector<MeshLodLevel>& Mesh::getLodLevels() const noexcept
+    {
+        return m_lods;
+    }
+
+    ui32 Mesh::selectLod(const Mat4& world, const MeshLodContext& lod, ui32 current) const noexcept
+    {
+        if (m_lods.size() < 2 || m_localBounds.isEmpty())
+            return 0;
+
+        // the camera inside or behind the mesh's centre sees it as large as it gets
+        const auto center = world.transformPoint(m_localBounds.center());
+        const auto clip = lod.viewProjection.transform(Vec4{ center, 1.0f });
+        if (clip.w <= 1e-4f)
+            return 0;
+
+        // object units to pixels at the centre's depth: the largest scale of the world matrix, then the
+        // clip-space height of a world unit (the projection's y column) over w, then half the viewport
+        const auto& w = world.m;
+        const auto& vp = lod.viewProjection.m;
+        const auto scale = std::max({ Vec3{ w[0][0], w[0][1], w[0][2] }.length(), Vec3{ w[1][0], w[1][1], w[1][2] }.length(),
+            Vec3{ w[2][0], w[2][1], w[2][2] }.length() });
+        const auto clipPerUnit = Vec3{ vp[0][1], vp[1][1], vp[2][1] }.length();
+        const auto pixelsPerUnit = scale * clipPerUnit / clip.w * lod.viewportHeight * 0.5f;
+
+        ui32 level = 0;
+        for (ui32 i = 1; i < static_cast<ui32>(m_lods.size()); i++)
+        {
+            const auto allowed = i > current ? lod.pixelError * (1.0f - lod.hysteresis) : lod.pixelError;
+            if (m_lods[i].error * pixelsPerUnit > allowed)
+                break;
+            level = i;
+        }
+        return level;
+    }
+
+    void Mesh::submit(RenderQueue& queue, ConstantBufferRing& constants, const Mat4& world, MeshLodContext* lod,
+        ui32* lodLevel) const
+    {
+        if (!m_vertexBuffer)
+            return;
+
+        const auto* level = &m_lods[0];
+        if (lod)
+        {
+            // a level kept from before the mesh was reloaded may not exist anymore
+            const auto current = lodLevel ? std::min(*lodLevel, static_cast<ui32>(m_lods.size() - 1)) : 0;
+            const auto selected = selectLod(world, *lod, current);
+            if (lodLevel)
+                *lodLevel = selected;
+            level = &m_lods[selected];
+            lod->stats.trianglesDrawn += level->indexCount / 3;
+            lod->stats.trianglesSaved += (m_lods[0].indexCount - level->indexCount) / 3;
+            lod->stats.levelDraws[selected]++;
+        }
 
-        context.Draw(m_vertexCount, 0);
+        DrawItem item = {};
+        item.pipeline = m_pipeline;
+        item.vertexBuffers[0] = { m_vertexBuffer, m_stride, m_offset };
+        item.indexBuffer = m_indexBuffer;
+        // meshes drawn with the same transform share one block
+        item.objectConstants = constants.upload(ObjectConstants{ world });
+        item.startElement = level->firstIndex;
+        item.elementCount = level->indexCount;
+        item.sortKey = RenderQueue::MakeSortKey(item.pipeline, m_vertexBuffer, m_indexBuffer);
+        queue.submit(item);
     }
 } 
\ No newline at end of file
@@ -0,0 +1,292 @@
+#include <DX3D/Graphics/MeshFile.h>
+#include <DX3D/Core/Hash.h>
+#include <DX3D/Core/Profiler.h>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	constexpr char MeshFileMagic[4] = { 'D', 'X', 'M', 'F' };
+	constexpr size_t SemanticNameSize = 16;
+
+	struct FileHeader
+	{
+		char magic[4]{};
+		dx3d::ui32 version{};
+		dx3d::ui32 headerSize{};
+		dx3d::ui32 attributeCount{};
+		dx3d::ui32 positionEncoding{};
+		dx3d::ui32 colorEncoding{};
+		dx3d::ui32 vertexStride{};
+		dx3d::ui32 vertexCount{};
+		dx3d::ui32 indexCount{};
+		dx3d::ui32 inputVertices{};
+		dx3d::ui32 clusters{};
+		dx3d::f32 acmrBefore{};
+		dx3d::f32 acmrAfter{};
+		dx3d::f32 positionCenter[3]{};
+		dx3d::f32 positionExtent[3]{};
+		dx3d::f32 boundsMin[3]{};
+		dx3d::f32 boundsMax[3]{};
+		dx3d::ui32 reserved{};
+		dx3d::ui64 attributeOffset{};
+		dx3d::ui64 vertexOffset{};
+		dx3d::ui64 vertexSize{};
+		dx3d::ui64 indexOffset{};
+		dx3d::ui64 indexSize{};
+		dx3d::ui64 vertexHash{};
+		dx3d::ui64 indexHash{};
+	};
+	static_assert(sizeof(FileHeader) == 160, "the header is part of the file format");
+
+	struct FileAttribute
+	{
+		char semanticName[SemanticNameSize]{};  // zero terminated
+		dx3d::ui32 semanticIndex{};
+		dx3d::ui32 format{};
+		dx3d::ui32 slot{};
+		dx3d::ui32 offset{};
+		dx3d::ui32 inputRate{};
+		dx3d::ui32 reserved{};
+	};
+	static_assert(sizeof(FileAttribute) == 40, "attribute records are part of the file format");
+
+	bool Fail(std::string* outError, const char* message)
+	{
+		if (outError) *outError = message;
+		return false;
+	}
+
+	dx3d::ui64 AlignUp(dx3d::ui64 value, dx3d::ui64 alignment) noexcept
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// offset and size lie inside a file of fileSize bytes, without overflowing on garbage
+	bool InFile(dx3d::ui64 offset, dx3d::ui64 size, size_t fileSize) noexcept
+	{
+		return offset <= fileSize && size <= fileSize - offset;
+	}
+
+	void StoreVec3(dx3d::f32 (&out)[3], const dx3d::Vec3& v) noexcept
+	{
+		out[0] = v.x;
+		out[1] = v.y;
+		out[2] = v.z;
+	}
+
+	dx3d::Vec3 LoadVec3(const dx3d::f32 (&in)[3]) noexcept
+	{
+		return { in[0], in[1], in[2] };
+	}
+}
+
+bool dx3d::MeshFile::Write(const std::filesystem::path& path, const MeshFileData& data, std::string* outError)
+{
+	DX3DProfileZone("MeshFile::Write");
+
+	const ui64 stride = data.encoding.getStride();
+	const ui64 vertexSize = stride * data.vertexCount;
+	const ui64 indexSize = static_cast<ui64>(data.indexCount) * sizeof(ui32);
+	if (data.vertexCount && !data.vertices) return Fail(outError, "No vertex data provided.");
+	if (data.indexCount && !data.indices) return Fail(outError, "No index data provided.");
+	if (data.indexCount % 3) return Fail(outError, "Triangle lists need a multiple of three indices.");
+	// the blobs become GPU buffers, whose sizes are 32-bit
+	if (vertexSize > ~0u || indexSize > ~0u) return Fail(outError, "The mesh is too large for a single buffer.");
+
+	const auto layout = VertexEncoder::GetVertexLayout(data.encoding);
+
+	FileHeader header{};
+	std::memcpy(header.magic, MeshFileMagic, sizeof(MeshFileMagic));
+	header.version = Version;
+	header.headerSize = sizeof(FileHeader);
+	header.attributeCount = static_cast<ui32>(layout.size());
+	header.positionEncoding = static_cast<ui32>(data.encoding.position);
+	header.colorEncoding = static_cast<ui32>(data.encoding.color);
+	header.vertexStride = static_cast<ui32>(stride);
+	header.vertexCount = data.vertexCount;
+	header.indexCount = data.indexCount;
+	header.inputVertices = data.optimizerStats.inputVertices;
+	header.clusters = data.optimizerStats.clusters;
+	header.acmrBefore = data.optimizerStats.acmrBefore;
+	header.acmrAfter = data.optimizerStats.acmrAfter;
+	StoreVec3(header.positionCenter, data.positionBounds.center);
+	StoreVec3(header.positionExtent, data.positionBounds.extent);
+	StoreVec3(header.boundsMin, data.bounds.min);
+	StoreVec3(header.boundsMax, data.bounds.max);
+	header.attributeOffset = sizeof(FileHeader);
+	header.vertexOffset = AlignUp(header.attributeOffset + layout.size() * sizeof(FileAttribute), BlobAlignment);
+	header.vertexSize = vertexSize;
+	header.indexOffset = AlignUp(header.vertexOffset + vertexSize, BlobAlignment);
+	header.indexSize = indexSize;
+	header.vertexHash = Hash::HashBytes(data.vertices, static_cast<size_t>(vertexSize));
+	header.indexHash = Hash::HashBytes(data.indices, static_cast<size_t>(indexSize));
+
+	std::vector<FileAttribute> attributes(layout.size());
+	for (size_t i = 0; i < layout.size(); i++)
+	{
+		std::strncpy(attributes[i].semanticName, layout[i].semanticName, SemanticNameSize - 1);
+		attributes[i].semanticIndex = layout[i].semanticIndex;
+		attributes[i].format = static_cast<ui32>(layout[i].format);
+		attributes[i].slot = layout[i].slot;
+		attributes[i].offset = layout[i].offset;
+		attributes[i].inputRate = static_cast<ui32>(layout[i].inputRate);
+	}
+
+	// written next to the final name first, so a crash never leaves a valid-looking partial file
+	auto tempPath = path;
+	tempPath += ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file) return Fail(outError, "Could not create the mesh file.");
+
+		const char padding[BlobAlignment]{};
+		auto pad = [&](ui64 offset)
+			{
+				file.write(padding, static_cast<std::streamsize>(offset - static_cast<ui64>(file.tellp())));
+			};
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(attributes.data()),
+			static_cast<std::streamsize>(attributes.size() * sizeof(FileAttribute)));
+		pad(header.vertexOffset);
+		file.write(static_cast<const char*>(data.vertices), static_cast<std::streamsize>(vertexSize));
+		pad(header.indexOffset);
+		file.write(reinterpret_cast<const char*>(data.indices), static_cast<std::streamsize>(indexSize));
+		if (!file) return Fail(outError, "Could not write the mesh file.");
+	}
+
+	std::error_code error{};
+	std::filesystem::rename(tempPath, path, error);
+	if (error)
+	{
+		std::filesystem::remove(tempPath, error);
+		return Fail(outError, "Could not replace the mesh file.");
+	}
+	return true;
+}
+
+bool dx3d::MeshFile::Write(const std::filesystem::path& path, const void* vertices, size_t vertexStride, size_t count,
+	const VertexEncoding& encoding, std::string* outError)
+{
+	std::vector<unsigned char> optimized;
+	std::vector<ui32> indices;
+	MeshFileData data{};
+	data.optimizerStats = MeshOptimizer::Optimize(vertices, vertexStride, count, optimized, indices);
+
+	const size_t vertexCount = data.optimizerStats.uniqueVertices;
+	data.encoding = encoding;
+	data.bounds = Aabb::fromPoints(optimized.data(), vertexStride, vertexCount);
+	if (encoding.position == PositionEncoding::Snorm16x4)
+		data.positionBounds = PositionBounds::FromVertices(optimized.data(), vertexStride, vertexCount);
+
+	std::vector<unsigned char> encoded(vertexCount * encoding.getStride());
+	VertexEncoder::Encode(encoding, data.positionBounds, optimized.data(), vertexStride, vertexCount, encoded.data());
+
+	data.vertices = encoded.data();
+	data.vertexCount = static_cast<ui32>(vertexCount);
+	data.indices = indices.data();
+	data.indexCount = static_cast<ui32>(indices.size());
+	return Write(path, data, outError);
+}
+
+bool dx3d::MeshFile::open(const std::filesystem::path& path, std::string* outError)
+{
+	DX3DProfileZone("MeshFile::open");
+	close();
+
+	MappedFile file(path);
+	if (!file.isOpen()) return Fail(outError, "Could not map the mesh file.");
+
+	// only the header and the attribute table are read here, the blobs stay untouched until the upload reads them
+	if (file.size() < sizeof(FileHeader)) return Fail(outError, "The mesh file is truncated.");
+	FileHeader header{};
+	std::memcpy(&header, file.data(), sizeof(header));
+
+	if (std::memcmp(header.magic, MeshFileMagic, sizeof(MeshFileMagic)) != 0)
+		return Fail(outError, "Not a mesh file.");
+	if (header.version != Version || header.headerSize != sizeof(FileHeader))
+		return Fail(outError, "Unsupported mesh file version.");
+	if (header.positionEncoding > static_cast<ui32>(PositionEncoding::Snorm16x4) ||
+		header.colorEncoding > static_cast<ui32>(ColorEncoding::Unorm8x4))
+		return Fail(outError, "Unknown vertex encoding in the mesh file.");
+
+	MeshFileData data{};
+	data.encoding.position = static_cast<PositionEncoding>(header.positionEncoding);
+	data.encoding.color = static_cast<ColorEncoding>(header.colorEncoding);
+	if (header.vertexStride != data.encoding.getStride())
+		return Fail(outError, "The vertex stride does not match the encoding.");
+
+	// the engine's vertex shaders only read the layout VertexEncoder describes, anything else would draw garbage
+	const auto expectedLayout = VertexEncoder::GetVertexLayout(data.encoding);
+	if (header.attributeCount != expectedLayout.size() ||
+		!InFile(header.attributeOffset, static_cast<ui64>(header.attributeCount) * sizeof(FileAttribute), file.size()) ||
+		header.attributeOffset % alignof(FileAttribute))
+		return Fail(outError, "The vertex layout does not match the encoding.");
+
+	auto attributes = reinterpret_cast<const FileAttribute*>(file.data() + header.attributeOffset);
+	for (ui32 i = 0; i < header.attributeCount; i++)
+	{
+		const auto& attribute = attributes[i];
+		const auto& expected = expectedLayout[i];
+		if (std::memchr(attribute.semanticName, '\0', SemanticNameSize) == nullptr ||
+			std::strcmp(attribute.semanticName, expected.semanticName) != 0 ||
+			attribute.semanticIndex != expected.semanticIndex ||
+			attribute.format != static_cast<ui32>(expected.format) ||
+			attribute.slot != expected.slot ||
+			attribute.offset != expected.offset ||
+			attribute.inputRate != static_cast<ui32>(expected.inputRate))
+			return Fail(outError, "The vertex layout does not match the encoding.");
+	}
+
+	// the blobs become GPU buffers, whose sizes are 32-bit
+	if (header.vertexSize > UINT32_MAX || header.indexSize > UINT32_MAX)
+		return Fail(outError, "The mesh is too large for a single buffer.");
+	if (header.vertexSize != static_cast<ui64>(header.vertexStride) * header.vertexCount ||
+		header.indexSize != static_cast<ui64>(header.indexCount) * sizeof(ui32) || header.indexCount % 3)
+		return Fail(outError, "The blob sizes do not match the counts.");
+	if (header.vertexOffset % BlobAlignment || header.indexOffset % BlobAlignment ||
+		!InFile(header.vertexOffset, header.vertexSize, file.size()) ||
+		!InFile(header.indexOffset, header.indexSize, file.size()))
+		return Fail(outError, "The mesh file is truncated.");
+
+	data.positionBounds = { LoadVec3(header.positionCenter), LoadVec3(header.positionExtent) };
+	data.bounds = { LoadVec3(header.boundsMin), LoadVec3(header.boundsMax) };
+	data.vertices = file.data() + header.vertexOffset;
+	data.vertexCount = header.vertexCount;
+	data.indices = reinterpret_cast<const ui32*>(file.data() + header.indexOffset);
+	data.indexCount = header.indexCount;
+	data.optimizerStats.inputVertices = header.inputVertices;
+	data.optimizerStats.uniqueVertices = header.vertexCount;
+	data.optimizerStats.triangles = header.indexCount / 3;
+	data.optimizerStats.clusters = header.clusters;
+	data.optimizerStats.acmrBefore = header.acmrBefore;
+	data.optimizerStats.acmrAfter = header.acmrAfter;
+
+	m_file = std::move(file);
+	m_data = data;
+	m_vertexLayout = expectedLayout;
+	m_vertexHash = header.vertexHash;
+	m_indexHash = header.indexHash;
+	return true;
+}
+
+void dx3d::MeshFile::close() noexcept
+{
+	m_file.close();
+	m_data = {};
+	m_vertexLayout.clear();
+	m_vertexHash = 0;
+	m_indexHash = 0;
+}
+
+dx3d::ui32 dx3d::MeshFile::getVertexDataSize() const noexcept
+{
+	return m_data.vertexCount * m_data.encoding.getStride();
+}
+
+dx3d::ui32 dx3d::MeshFile::getIndexDataSize() const noexcept
+{
+	return m_data.indexCount * static_cast<ui32>(sizeof(ui32));
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <DX3D/Core/MappedFile.h>
+#include <DX3D/Graphics/MeshOptimizer.h>
+#include <DX3D/Graphics/VertexEncoding.h>
+#include <DX3D/Math/Aabb.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace dx3d
+{
+	/*
+	* Versioned binary container for a mesh that is ready to draw, laid out so loading it is mapping it:
+	*   header          magic "DXMF", version, counts, encoding, bounds, blob offsets and hashes
+	*   attributes      the vertex layout, one fixed size record per attribute
+	*   vertices        already encoded (VertexEncoding) and optimized, BlobAlignment aligned
+	*   indices         32-bit triangle list, BlobAlignment aligned
+	* All values are little endian. The blobs are handed to the GPU straight out of the mapped pages and the
+	* stored hashes spare the immutable buffer cache hashing them. They are not checked when opening, which would
+	* read every page; the cache compares the bytes before it shares a buffer, so a wrong hash cannot alias meshes.
+	*/
+	struct MeshFileData
+	{
+		VertexEncoding encoding{};
+		PositionBounds positionBounds{};    // what Snorm16x4 positions were normalized into
+		Aabb bounds{};
+		const void* vertices{};             // vertexCount * encoding.getStride() bytes
+		ui32 vertexCount{};
+		const ui32* indices{};
+		ui32 indexCount{};
+		MeshOptimizerStats optimizerStats{};
+	};
+
+	class MeshFile final
+	{
+	public:
+		static constexpr ui32 Version = 1;
+		static constexpr ui32 BlobAlignment = 64;
+
+		// returns false and fills outError when the file cannot be written
+		static bool Write(const std::filesystem::path& path, const MeshFileData& data, std::string* outError = nullptr);
+		// welds, optimizes and encodes count x y z r g b a float vertices (a triangle list, vertexStride bytes apart) and writes them
+		static bool Write(const std::filesystem::path& path, const void* vertices, size_t vertexStride, size_t count,
+			const VertexEncoding& encoding, std::string* outError = nullptr);
+
+		MeshFile() = default;
+
+		// maps and validates the file, returns false and fills outError when it is missing, truncated or of another version
+		bool open(const std::filesystem::path& path, std::string* outError = nullptr);
+		void close() noexcept;
+		bool isOpen() const noexcept { return m_file.isOpen(); }
+
+		// the blob pointers in the data point into the mapping and are only valid while the file is open
+		const MeshFileData& getData() const noexcept { return m_data; }
+		// the stored attribute table, checked against VertexEncoder::GetVertexLayout of the encoding when opening
+		const std::vector<VertexAttribute>& getVertexLayout() const noexcept { return m_vertexLayout; }
+		ui32 getVertexDataSize() const noexcept;
+		ui32 getIndexDataSize() const noexcept;
+		ui64 getVertexHash() const noexcept { return m_vertexHash; }
+		ui64 getIndexHash() const noexcept { return m_indexHash; }
+
+	private:
+		MappedFile m_file{};
+		MeshFileData m_data{};
+		std::vector<VertexAttribute> m_vertexLayout{};
+		ui64 m_vertexHash{};
+		ui64 m_indexHash{};
+	};
+}
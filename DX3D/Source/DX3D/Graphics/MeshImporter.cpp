@@ -0,0 +1,926 @@
+#include <DX3D/Graphics/MeshImporter.h>
+#include <DX3D/Core/MappedFile.h>
+#include <DX3D/Core/Profiler.h>
+#include <DX3D/Core/ThreadPool.h>
+#include <DX3D/Math/Mat4.h>
+#include <DX3D/Math/Quat.h>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+namespace
+{
+	using namespace dx3d;
+
+	// thrown from anywhere inside a parse (also from pool workers) and turned into outError at the top
+	class ImportError final : public std::runtime_error
+	{
+	public:
+		using std::runtime_error::runtime_error;
+	};
+
+	constexpr size_t ObjChunkSize = 1 << 20;
+	constexpr ui32 GlbRangeSize = 1 << 16;     // vertices, or indices times three, per work item
+
+	void RunParallel(ThreadPool* threadPool, ui32 count, const std::function<void(ui32)>& task)
+	{
+		if (threadPool && count > 1) threadPool->parallelFor(count, task);
+		else for (ui32 i = 0; i < count; i++) task(i);
+	}
+
+	bool Fail(std::string* outError, const char* message)
+	{
+		if (outError) *outError = message;
+		return false;
+	}
+
+	template <typename ImportFunction>
+	bool RunImport(const void* data, size_t size, ImportedMesh& outMesh, std::string* outError, ImportFunction&& import)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		outMesh = {};
+		try
+		{
+			import(static_cast<const unsigned char*>(data), size, outMesh);
+		}
+		catch (const std::exception& e)
+		{
+			outMesh = {};
+			return Fail(outError, e.what());
+		}
+
+		auto& stats = outMesh.stats;
+		stats.bytes = size;
+		stats.seconds = std::chrono::duration<d64>(std::chrono::steady_clock::now() - start).count();
+		stats.megabytesPerSecond = stats.seconds > 0.0 ? static_cast<d64>(size) / (1024.0 * 1024.0) / stats.seconds : 0.0;
+		return true;
+	}
+
+	inline bool IsDigit(char c) noexcept { return c >= '0' && c <= '9'; }
+	inline bool IsBlank(char c) noexcept { return c == ' ' || c == '\t' || c == '\r'; }
+
+	inline const char* SkipBlanks(const char* p, const char* end) noexcept
+	{
+		while (p < end && IsBlank(*p)) p++;
+		return p;
+	}
+
+	inline const char* SkipLine(const char* p, const char* end) noexcept
+	{
+		auto newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+		return newline ? newline + 1 : end;
+	}
+
+	// --- OBJ -----------------------------------------------------------------------------------------------
+
+	struct ObjChunk
+	{
+		const char* begin{};
+		const char* end{};
+		std::vector<Vertex> vertices{};
+		std::vector<ui32> indices{};
+		std::vector<size_t> relativeIndices{};  // positions in indices holding an offset from firstVertex, from negative OBJ indices
+		ui32 firstVertex{};
+		ui32 firstIndex{};
+		size_t byteOffset{};                    // of begin in the file, only for error messages
+	};
+
+	// one position reference of a face corner ("7", "7/2", "7//3", "-1/2/3"), the rest of the corner is skipped
+	bool ParseCorner(const char*& p, const char* end, i32& outIndex) noexcept
+	{
+		const char* q = p;
+		bool negative = false;
+		if (q < end && *q == '-')
+		{
+			negative = true;
+			q++;
+		}
+		if (q == end || !IsDigit(*q)) return false;
+
+		ui64 value = 0;
+		while (q < end && IsDigit(*q))
+		{
+			value = value * 10 + static_cast<ui64>(*q - '0');
+			if (value > 0x7fffffffull) return false;
+			q++;
+		}
+		while (q < end && !IsBlank(*q) && *q != '\n') q++;
+
+		p = q;
+		outIndex = negative ? -static_cast<i32>(value) : static_cast<i32>(value);
+		return value != 0;
+	}
+
+	void ParseObjChunk(ObjChunk& chunk, const MeshImportOptions& options)
+	{
+		std::vector<i32> corners;
+		const char* p = chunk.begin;
+		const char* end = chunk.end;
+
+		// lines are not counted, that would need every earlier chunk to be parsed first
+		auto fail = [&](const char* what)
+			{
+				throw ImportError("OBJ at byte " + std::to_string(chunk.byteOffset + static_cast<size_t>(p - chunk.begin)) + ": " + what);
+			};
+
+		for (; p < end; p = SkipLine(p, end))
+		{
+			p = SkipBlanks(p, end);
+			if (end - p < 2 || !IsBlank(p[1]) || (p[0] != 'v' && p[0] != 'f')) continue;
+
+			if (p[0] == 'v')
+			{
+				// x y z, optionally followed by r g b [a] (a widespread extension); a lone w is ignored
+				f32 values[7]{};
+				ui32 count = 0;
+				const char* q = p + 2;
+				for (; count < 7; count++)
+				{
+					q = SkipBlanks(q, end);
+					if (!MeshImporter::ParseFloat(q, end, values[count])) break;
+				}
+				if (count < 3) fail("a vertex needs x y z.");
+
+				Vertex vertex{ values[0], values[1], values[2],
+					options.defaultColor.x, options.defaultColor.y, options.defaultColor.z, options.defaultColor.w };
+				if (count >= 6)
+				{
+					vertex.r = values[3];
+					vertex.g = values[4];
+					vertex.b = values[5];
+					if (count == 7) vertex.a = values[6];
+				}
+				if (options.convertToLeftHanded) vertex.z = -vertex.z;
+				chunk.vertices.push_back(vertex);
+				continue;
+			}
+
+			corners.clear();
+			const char* q = p + 2;
+			while (true)
+			{
+				q = SkipBlanks(q, end);
+				if (q == end || *q == '\n' || *q == '#') break;
+				i32 index{};
+				if (!ParseCorner(q, end, index)) fail("malformed face.");
+				corners.push_back(index);
+			}
+			if (corners.size() < 3) fail("a face needs at least three corners.");
+
+			auto emit = [&](i32 corner)
+				{
+					if (corner > 0)
+					{
+						chunk.indices.push_back(static_cast<ui32>(corner - 1));
+						return;
+					}
+					// relative to the vertices seen so far, which may reach into earlier chunks: stored as an
+					// offset from this chunk's first vertex (wrapping below zero) and resolved in the gather
+					chunk.relativeIndices.push_back(chunk.indices.size());
+					chunk.indices.push_back(static_cast<ui32>(static_cast<i32>(chunk.vertices.size()) + corner));
+				};
+
+			// polygons are fanned around their first corner
+			for (size_t i = 1; i + 1 < corners.size(); i++)
+			{
+				emit(corners[0]);
+				emit(corners[options.convertToLeftHanded ? i + 1 : i]);
+				emit(corners[options.convertToLeftHanded ? i : i + 1]);
+			}
+		}
+	}
+
+	void ImportObjData(const unsigned char* data, size_t size, ImportedMesh& outMesh, const MeshImportOptions& options)
+	{
+		DX3DProfileZone("MeshImporter::ImportObj");
+		const auto text = reinterpret_cast<const char*>(data);
+		const auto textEnd = text + size;
+
+		// chunks start right after a newline, so every line belongs to exactly one of them
+		std::vector<ObjChunk> chunks;
+		for (const char* p = text; p < textEnd;)
+		{
+			const char* chunkEnd = static_cast<size_t>(textEnd - p) > ObjChunkSize ? SkipLine(p + ObjChunkSize, textEnd) : textEnd;
+			chunks.push_back({ p, chunkEnd });
+			chunks.back().byteOffset = static_cast<size_t>(p - text);
+			p = chunkEnd;
+		}
+		outMesh.stats.chunks = static_cast<ui32>(chunks.size());
+
+		const auto chunkCount = static_cast<ui32>(chunks.size());
+		RunParallel(options.threadPool, chunkCount, [&](ui32 index) { ParseObjChunk(chunks[index], options); });
+
+		ui64 vertexCount = 0;
+		ui64 indexCount = 0;
+		for (auto& chunk : chunks)
+		{
+			chunk.firstVertex = static_cast<ui32>(vertexCount);
+			chunk.firstIndex = static_cast<ui32>(indexCount);
+			vertexCount += chunk.vertices.size();
+			indexCount += chunk.indices.size();
+			if (vertexCount > 0xffffffffull || indexCount > 0xffffffffull) throw ImportError("The OBJ is too large for 32-bit indices.");
+		}
+
+		outMesh.vertices.resize(static_cast<size_t>(vertexCount));
+		outMesh.indices.resize(static_cast<size_t>(indexCount));
+		RunParallel(options.threadPool, chunkCount, [&](ui32 index)
+			{
+				auto& chunk = chunks[index];
+				for (auto relative : chunk.relativeIndices)
+					chunk.indices[relative] += chunk.firstVertex;
+				for (auto i : chunk.indices)
+					if (i >= vertexCount) throw ImportError("An OBJ face references a vertex that does not exist.");
+
+				std::copy(chunk.vertices.begin(), chunk.vertices.end(), outMesh.vertices.begin() + chunk.firstVertex);
+				std::copy(chunk.indices.begin(), chunk.indices.end(), outMesh.indices.begin() + chunk.firstIndex);
+				chunk.vertices = {};
+				chunk.indices = {};
+			});
+	}
+
+	// --- glTF ----------------------------------------------------------------------------------------------
+
+	// just enough JSON for the glTF chunk: strings stay raw views into the text, escapes are not decoded
+	struct JsonValue
+	{
+		enum class Type
+		{
+			Null = 0,
+			Boolean,
+			Number,
+			String,
+			Array,
+			Object
+		};
+
+		Type type{};
+		d64 number{};
+		std::string_view string{};
+		std::vector<JsonValue> items{};
+		std::vector<std::pair<std::string_view, JsonValue>> members{};
+
+		const JsonValue* find(std::string_view key) const noexcept
+		{
+			for (const auto& [name, value] : members)
+				if (name == key) return &value;
+			return nullptr;
+		}
+
+		const JsonValue* at(size_t index) const noexcept
+		{
+			return type == Type::Array && index < items.size() ? &items[index] : nullptr;
+		}
+
+		d64 getNumber(std::string_view key, d64 fallback) const noexcept
+		{
+			auto value = find(key);
+			return value && value->type == Type::Number ? value->number : fallback;
+		}
+
+		// a non-negative integer property, fallback when it is missing
+		ui32 getIndex(std::string_view key, ui32 fallback) const
+		{
+			auto value = find(key);
+			if (!value) return fallback;
+			if (value->type != Type::Number || value->number < 0.0 || value->number > 4294967295.0 ||
+				value->number != static_cast<d64>(static_cast<ui64>(value->number)))
+				throw ImportError("glTF: '" + std::string(key) + "' is not a valid index.");
+			return static_cast<ui32>(value->number);
+		}
+	};
+
+	class JsonParser
+	{
+	public:
+		JsonParser(const char* text, const char* end) : m_p(text), m_end(end) {}
+
+		JsonValue parseDocument()
+		{
+			auto value = parseValue(0);
+			skipWhitespace();
+			if (m_p != m_end) fail();
+			return value;
+		}
+
+	private:
+		static constexpr ui32 MaxDepth = 64;
+
+		[[noreturn]] void fail() const
+		{
+			throw ImportError("glTF: malformed JSON chunk.");
+		}
+
+		void skipWhitespace() noexcept
+		{
+			while (m_p < m_end && (*m_p == ' ' || *m_p == '\t' || *m_p == '\n' || *m_p == '\r')) m_p++;
+		}
+
+		bool consume(std::string_view literal) noexcept
+		{
+			if (static_cast<size_t>(m_end - m_p) < literal.size() || std::memcmp(m_p, literal.data(), literal.size()) != 0)
+				return false;
+			m_p += literal.size();
+			return true;
+		}
+
+		std::string_view parseString()
+		{
+			if (m_p == m_end || *m_p != '"') fail();
+			const char* start = ++m_p;
+			while (m_p < m_end && *m_p != '"')
+				m_p += *m_p == '\\' ? 2 : 1;
+			if (m_p >= m_end) fail();
+			return { start, static_cast<size_t>(m_p++ - start) };
+		}
+
+		JsonValue parseValue(ui32 depth)
+		{
+			if (depth > MaxDepth) fail();
+			skipWhitespace();
+			if (m_p == m_end) fail();
+
+			JsonValue value{};
+			switch (*m_p)
+			{
+			case '{':
+				value.type = JsonValue::Type::Object;
+				m_p++;
+				skipWhitespace();
+				if (m_p < m_end && *m_p == '}')
+				{
+					m_p++;
+					break;
+				}
+				while (true)
+				{
+					skipWhitespace();
+					auto key = parseString();
+					skipWhitespace();
+					if (!consume(":")) fail();
+					value.members.emplace_back(key, parseValue(depth + 1));
+					skipWhitespace();
+					if (consume(",")) continue;
+					if (consume("}")) break;
+					fail();
+				}
+				break;
+			case '[':
+				value.type = JsonValue::Type::Array;
+				m_p++;
+				skipWhitespace();
+				if (m_p < m_end && *m_p == ']')
+				{
+					m_p++;
+					break;
+				}
+				while (true)
+				{
+					value.items.push_back(parseValue(depth + 1));
+					skipWhitespace();
+					if (consume(",")) continue;
+					if (consume("]")) break;
+					fail();
+				}
+				break;
+			case '"':
+				value.type = JsonValue::Type::String;
+				value.string = parseString();
+				break;
+			case 't':
+			case 'f':
+				value.type = JsonValue::Type::Boolean;
+				value.number = *m_p == 't' ? 1.0 : 0.0;
+				if (!consume("true") && !consume("false")) fail();
+				break;
+			case 'n':
+				if (!consume("null")) fail();
+				break;
+			default:
+			{
+				// offsets and lengths need more than a float's 24 bits, so JSON numbers are parsed as doubles
+				value.type = JsonValue::Type::Number;
+				auto [next, error] = std::from_chars(m_p, m_end, value.number);
+				if (error != std::errc{}) fail();
+				m_p = next;
+				break;
+			}
+			}
+			return value;
+		}
+
+	private:
+		const char* m_p;
+		const char* m_end;
+	};
+
+	constexpr ui32 GlbMagic = 0x46546C67;       // "glTF"
+	constexpr ui32 GlbChunkJson = 0x4E4F534A;   // "JSON"
+	constexpr ui32 GlbChunkBin = 0x004E4942;    // "BIN\0"
+
+	enum GltfComponentType : ui32
+	{
+		GltfUnsignedByte = 5121,
+		GltfUnsignedShort = 5123,
+		GltfUnsignedInt = 5125,
+		GltfFloat = 5126
+	};
+
+	constexpr ui32 GltfTriangles = 4;
+
+	// an accessor resolved against the BIN chunk, element i starts at data + i * stride
+	struct GltfAccessor
+	{
+		const unsigned char* data{};
+		ui32 count{};
+		ui32 stride{};
+		ui32 componentType{};
+		ui32 components{};
+	};
+
+	struct GltfPrimitive
+	{
+		Mat4 world{};
+		bool flipWinding{};
+		Vec4 baseColor{ 1.0f, 1.0f, 1.0f, 1.0f };
+		GltfAccessor positions{};
+		GltfAccessor colors{};          // count 0 = none
+		GltfAccessor indices{};         // count 0 = none, the vertices are the triangle list
+		ui32 indexCount{};
+		ui32 firstVertex{};
+		ui32 firstIndex{};
+	};
+
+	struct GltfRange
+	{
+		ui32 primitive{};
+		bool indices{};
+		ui32 begin{};
+		ui32 end{};
+	};
+
+	class GlbReader
+	{
+	public:
+		GlbReader(const JsonValue& json, const unsigned char* bin, size_t binSize, const MeshImportOptions& options) :
+			m_json(json), m_bin(bin), m_binSize(binSize), m_options(options)
+		{
+		}
+
+		std::vector<GltfPrimitive> collectPrimitives()
+		{
+			auto nodes = m_json.find("nodes");
+			auto scenes = m_json.find("scenes");
+			const auto sceneIndex = m_json.getIndex("scene", 0);
+			auto scene = scenes ? scenes->at(sceneIndex) : nullptr;
+
+			if (scene && nodes)
+			{
+				std::vector<bool> visited(nodes->items.size());
+				if (auto roots = scene->find("nodes"); roots && roots->type == JsonValue::Type::Array)
+					for (const auto& root : roots->items)
+						visitNode(*nodes, toIndex(root), Mat4::identity(), visited);
+			}
+			else if (auto meshes = m_json.find("meshes"))
+			{
+				// no scene to place them: every mesh once, untransformed
+				for (size_t i = 0; i < meshes->items.size(); i++)
+					addMesh(static_cast<ui32>(i), Mat4::identity());
+			}
+			return std::move(m_primitives);
+		}
+
+	private:
+		ui32 toIndex(const JsonValue& value) const
+		{
+			if (value.type != JsonValue::Type::Number || value.number < 0.0 || value.number > 4294967295.0)
+				throw ImportError("glTF: invalid node index.");
+			return static_cast<ui32>(value.number);
+		}
+
+		const JsonValue& getElement(const char* arrayName, ui32 index) const
+		{
+			auto array = m_json.find(arrayName);
+			auto element = array ? array->at(index) : nullptr;
+			if (!element || element->type != JsonValue::Type::Object)
+				throw ImportError(std::string("glTF: missing ") + arrayName + " entry " + std::to_string(index) + ".");
+			return *element;
+		}
+
+		static Mat4 getLocalTransform(const JsonValue& node)
+		{
+			// column-major column-vector matrices, read in order they are the transposed row-vector Mat4
+			if (auto matrix = node.find("matrix"); matrix && matrix->items.size() == 16)
+			{
+				Mat4 result{};
+				for (ui32 i = 0; i < 16; i++)
+					result.m[i / 4][i % 4] = static_cast<f32>(matrix->items[i].number);
+				return result;
+			}
+
+			auto readVector = [&](const char* key, Vec4 fallback)
+				{
+					auto value = node.find(key);
+					if (!value || value->items.size() < 3) return fallback;
+					fallback.x = static_cast<f32>(value->items[0].number);
+					fallback.y = static_cast<f32>(value->items[1].number);
+					fallback.z = static_cast<f32>(value->items[2].number);
+					if (value->items.size() > 3) fallback.w = static_cast<f32>(value->items[3].number);
+					return fallback;
+				};
+			const auto t = readVector("translation", { 0.0f, 0.0f, 0.0f, 0.0f });
+			const auto r = readVector("rotation", { 0.0f, 0.0f, 0.0f, 1.0f });
+			const auto s = readVector("scale", { 1.0f, 1.0f, 1.0f, 0.0f });
+			// T * R * S for column vectors is S, then R, then T for row vectors
+			return Mat4::scale(s.xyz()) * Quat::fromVec4(r).normalized().toMat4() * Mat4::translation(t.xyz());
+		}
+
+		void visitNode(const JsonValue& nodes, ui32 index, const Mat4& parent, std::vector<bool>& visited)
+		{
+			auto node = nodes.at(index);
+			if (!node || node->type != JsonValue::Type::Object) throw ImportError("glTF: invalid node index.");
+			// the spec forbids cycles and shared children, a broken file must not recurse forever
+			if (visited[index]) throw ImportError("glTF: the node hierarchy is not a tree.");
+			visited[index] = true;
+
+			const auto world = getLocalTransform(*node) * parent;
+			if (auto mesh = node->find("mesh")) addMesh(toIndex(*mesh), world);
+			if (auto children = node->find("children"); children && children->type == JsonValue::Type::Array)
+				for (const auto& child : children->items)
+					visitNode(nodes, toIndex(child), world, visited);
+		}
+
+		void addMesh(ui32 meshIndex, const Mat4& world)
+		{
+			const auto& mesh = getElement("meshes", meshIndex);
+			auto primitives = mesh.find("primitives");
+			if (!primitives) return;
+
+			// a mirroring transform turns the winding around as well
+			const auto& m = world.m;
+			const auto determinant =
+				m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+				m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+				m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+
+			for (const auto& primitive : primitives->items)
+			{
+				// points, lines and strips have no place in a triangle list mesh
+				if (primitive.getIndex("mode", GltfTriangles) != GltfTriangles) continue;
+				auto attributes = primitive.find("attributes");
+				auto position = attributes ? attributes->find("POSITION") : nullptr;
+				if (!position) continue;
+
+				GltfPrimitive result{};
+				result.world = world;
+				result.flipWinding = m_options.convertToLeftHanded != (determinant < 0.0f);
+				result.baseColor = m_options.defaultColor;
+				result.positions = getAccessor(toIndex(*position));
+				if (result.positions.componentType != GltfFloat || result.positions.components != 3)
+					throw ImportError("glTF: POSITION has to be float VEC3.");
+
+				if (auto color = attributes->find("COLOR_0"))
+				{
+					result.colors = getAccessor(toIndex(*color));
+					const auto type = result.colors.componentType;
+					if ((type != GltfFloat && type != GltfUnsignedByte && type != GltfUnsignedShort) ||
+						result.colors.components < 3 || result.colors.count != result.positions.count)
+						throw ImportError("glTF: unsupported COLOR_0 accessor.");
+				}
+
+				if (primitive.find("material"))
+				{
+					const auto& material = getElement("materials", primitive.getIndex("material", 0));
+					auto pbr = material.find("pbrMetallicRoughness");
+					auto factor = pbr ? pbr->find("baseColorFactor") : nullptr;
+					if (factor && factor->items.size() == 4)
+					{
+						result.baseColor.x *= static_cast<f32>(factor->items[0].number);
+						result.baseColor.y *= static_cast<f32>(factor->items[1].number);
+						result.baseColor.z *= static_cast<f32>(factor->items[2].number);
+						result.baseColor.w *= static_cast<f32>(factor->items[3].number);
+					}
+				}
+
+				result.indexCount = result.positions.count;
+				if (primitive.find("indices"))
+				{
+					result.indices = getAccessor(primitive.getIndex("indices", 0));
+					const auto type = result.indices.componentType;
+					if ((type != GltfUnsignedByte && type != GltfUnsignedShort && type != GltfUnsignedInt) ||
+						result.indices.components != 1)
+						throw ImportError("glTF: unsupported index accessor.");
+					result.indexCount = result.indices.count;
+				}
+				if (result.indexCount % 3) throw ImportError("glTF: a triangle primitive needs a multiple of three indices.");
+
+				m_primitives.push_back(result);
+			}
+		}
+
+		GltfAccessor getAccessor(ui32 index) const
+		{
+			const auto& accessor = getElement("accessors", index);
+			if (accessor.find("sparse")) throw ImportError("glTF: sparse accessors are not supported.");
+			if (!accessor.find("bufferView")) throw ImportError("glTF: accessors without a buffer view are not supported.");
+
+			const auto& view = getElement("bufferViews", accessor.getIndex("bufferView", 0));
+			if (view.getIndex("buffer", 0) != 0 || !m_bin)
+				throw ImportError("glTF: only the embedded BIN buffer is supported.");
+
+			GltfAccessor result{};
+			result.count = accessor.getIndex("count", 0);
+			result.componentType = accessor.getIndex("componentType", 0);
+
+			auto type = accessor.find("type");
+			const auto typeName = type ? type->string : std::string_view{};
+			if (typeName == "SCALAR") result.components = 1;
+			else if (typeName == "VEC2") result.components = 2;
+			else if (typeName == "VEC3") result.components = 3;
+			else if (typeName == "VEC4") result.components = 4;
+			else throw ImportError("glTF: unsupported accessor type.");
+
+			ui32 componentSize = 0;
+			switch (result.componentType)
+			{
+			case GltfUnsignedByte: componentSize = 1; break;
+			case GltfUnsignedShort: componentSize = 2; break;
+			case GltfUnsignedInt:
+			case GltfFloat: componentSize = 4; break;
+			default: throw ImportError("glTF: unsupported component type.");
+			}
+
+			const ui64 elementSize = static_cast<ui64>(componentSize) * result.components;
+			const ui64 viewOffset = view.getIndex("byteOffset", 0);
+			const ui64 viewLength = view.getIndex("byteLength", 0);
+			const ui64 accessorOffset = accessor.getIndex("byteOffset", 0);
+			result.stride = view.getIndex("byteStride", static_cast<ui32>(elementSize));
+
+			if (viewOffset + viewLength > m_binSize ||
+				(result.count && accessorOffset + (result.count - 1ull) * result.stride + elementSize > viewLength))
+				throw ImportError("glTF: an accessor reaches past its buffer.");
+
+			result.data = m_bin + viewOffset + accessorOffset;
+			return result;
+		}
+
+	private:
+		const JsonValue& m_json;
+		const unsigned char* m_bin;
+		size_t m_binSize;
+		const MeshImportOptions& m_options;
+		std::vector<GltfPrimitive> m_primitives{};
+	};
+
+	template <typename T>
+	inline T Read(const unsigned char* p) noexcept
+	{
+		T value;
+		std::memcpy(&value, p, sizeof(T));
+		return value;
+	}
+
+	f32 ReadComponent(const GltfAccessor& accessor, const unsigned char* element, ui32 component) noexcept
+	{
+		switch (accessor.componentType)
+		{
+		case GltfUnsignedByte: return element[component] / 255.0f;
+		case GltfUnsignedShort: return Read<ui16>(element + component * 2) / 65535.0f;
+		default: return Read<f32>(element + component * 4);
+		}
+	}
+
+	void DecodeVertices(const GltfPrimitive& primitive, ui32 begin, ui32 end, bool convertToLeftHanded, Vertex* out) noexcept
+	{
+		for (ui32 i = begin; i < end; i++)
+		{
+			const auto p = primitive.world.transformPoint(Read<Vec3>(primitive.positions.data + static_cast<size_t>(i) * primitive.positions.stride));
+			auto color = primitive.baseColor;
+			if (primitive.colors.count)
+			{
+				const auto element = primitive.colors.data + static_cast<size_t>(i) * primitive.colors.stride;
+				color.x *= ReadComponent(primitive.colors, element, 0);
+				color.y *= ReadComponent(primitive.colors, element, 1);
+				color.z *= ReadComponent(primitive.colors, element, 2);
+				if (primitive.colors.components == 4) color.w *= ReadComponent(primitive.colors, element, 3);
+			}
+			out[primitive.firstVertex + i] = { p.x, p.y, convertToLeftHanded ? -p.z : p.z, color.x, color.y, color.z, color.w };
+		}
+	}
+
+	void DecodeIndices(const GltfPrimitive& primitive, ui32 begin, ui32 end, ui32* out)
+	{
+		const auto vertexCount = primitive.positions.count;
+		for (ui32 i = begin; i < end; i++)
+		{
+			ui32 index = i;
+			if (primitive.indices.count)
+			{
+				const auto element = primitive.indices.data + static_cast<size_t>(i) * primitive.indices.stride;
+				switch (primitive.indices.componentType)
+				{
+				case GltfUnsignedByte: index = *element; break;
+				case GltfUnsignedShort: index = Read<ui16>(element); break;
+				default: index = Read<ui32>(element); break;
+				}
+			}
+			if (index >= vertexCount) throw ImportError("glTF: an index references a vertex that does not exist.");
+
+			// begin is a multiple of three, so the swap of each triangle's last two corners stays inside the range
+			auto slot = i;
+			if (primitive.flipWinding && i % 3) slot = i % 3 == 1 ? i + 1 : i - 1;
+			out[primitive.firstIndex + slot] = primitive.firstVertex + index;
+		}
+	}
+
+	void ImportGlbData(const unsigned char* data, size_t size, ImportedMesh& outMesh, const MeshImportOptions& options)
+	{
+		DX3DProfileZone("MeshImporter::ImportGlb");
+
+		if (size < 20 || Read<ui32>(data) != GlbMagic) throw ImportError("Not a binary glTF file.");
+		if (Read<ui32>(data + 4) != 2) throw ImportError("glTF: only version 2 is supported.");
+		const size_t length = std::min<size_t>(Read<ui32>(data + 8), size);
+
+		const size_t jsonLength = Read<ui32>(data + 12);
+		if (Read<ui32>(data + 16) != GlbChunkJson || 20 + jsonLength > length) throw ImportError("glTF: missing JSON chunk.");
+		const auto jsonText = reinterpret_cast<const char*>(data + 20);
+
+		const unsigned char* bin = nullptr;
+		size_t binSize = 0;
+		const size_t binHeader = 20 + ((jsonLength + 3) & ~size_t(3));
+		if (binHeader + 8 <= length && Read<ui32>(data + binHeader + 4) == GlbChunkBin)
+		{
+			binSize = Read<ui32>(data + binHeader);
+			bin = data + binHeader + 8;
+			if (binHeader + 8 + binSize > length) throw ImportError("glTF: the BIN chunk is truncated.");
+		}
+
+		const auto json = JsonParser(jsonText, jsonText + jsonLength).parseDocument();
+		auto primitives = GlbReader(json, bin, binSize, options).collectPrimitives();
+
+		// every primitive gets its own range of the output, then they are cut into work items
+		ui64 vertexCount = 0;
+		ui64 indexCount = 0;
+		std::vector<GltfRange> ranges;
+		for (ui32 i = 0; i < primitives.size(); i++)
+		{
+			auto& primitive = primitives[i];
+			primitive.firstVertex = static_cast<ui32>(vertexCount);
+			primitive.firstIndex = static_cast<ui32>(indexCount);
+			vertexCount += primitive.positions.count;
+			indexCount += primitive.indexCount;
+			if (vertexCount > 0xffffffffull || indexCount > 0xffffffffull) throw ImportError("glTF: too large for 32-bit indices.");
+
+			for (ui32 begin = 0; begin < primitive.positions.count; begin += GlbRangeSize)
+				ranges.push_back({ i, false, begin, std::min(primitive.positions.count, begin + GlbRangeSize) });
+			for (ui32 begin = 0; begin < primitive.indexCount; begin += GlbRangeSize * 3)
+				ranges.push_back({ i, true, begin, std::min(primitive.indexCount, begin + GlbRangeSize * 3) });
+		}
+
+		outMesh.vertices.resize(static_cast<size_t>(vertexCount));
+		outMesh.indices.resize(static_cast<size_t>(indexCount));
+		outMesh.stats.chunks = static_cast<ui32>(ranges.size());
+		RunParallel(options.threadPool, static_cast<ui32>(ranges.size()), [&](ui32 index)
+			{
+				const auto& range = ranges[index];
+				const auto& primitive = primitives[range.primitive];
+				if (range.indices) DecodeIndices(primitive, range.begin, range.end, outMesh.indices.data());
+				else DecodeVertices(primitive, range.begin, range.end, options.convertToLeftHanded, outMesh.vertices.data());
+			});
+	}
+}
+
+bool dx3d::MeshImporter::ParseFloat(const char*& text, const char* end, f32& outValue) noexcept
+{
+	// exact powers of ten: up to 1e10 in a float, up to 1e22 in a double
+	static constexpr d64 PowersOfTen[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	const char* p = text;
+	const bool negative = p < end && *p == '-';
+	if (p < end && (*p == '-' || *p == '+')) p++;
+
+	ui64 mantissa = 0;
+	i32 significantDigits = 0;
+	i32 exponent = 0;
+	bool anyDigits = false;
+	bool truncated = false;
+
+	auto addDigit = [&](char c, bool fraction)
+		{
+			anyDigits = true;
+			if (significantDigits < 19)
+			{
+				mantissa = mantissa * 10 + static_cast<ui64>(c - '0');
+				if (mantissa) significantDigits++;
+				if (fraction) exponent--;
+			}
+			else
+			{
+				truncated |= c != '0';
+				if (!fraction) exponent++;
+			}
+		};
+
+	while (p < end && IsDigit(*p)) addDigit(*p++, false);
+	if (p < end && *p == '.')
+	{
+		p++;
+		while (p < end && IsDigit(*p)) addDigit(*p++, true);
+	}
+
+	if (anyDigits && p < end && (*p == 'e' || *p == 'E'))
+	{
+		const char* q = p + 1;
+		bool negativeExponent = false;
+		if (q < end && (*q == '-' || *q == '+')) negativeExponent = *q++ == '-';
+		if (q < end && IsDigit(*q))
+		{
+			i32 value = 0;
+			while (q < end && IsDigit(*q))
+			{
+				if (value < 10000) value = value * 10 + (*q - '0');
+				q++;
+			}
+			exponent += negativeExponent ? -value : value;
+			p = q;
+		}
+	}
+
+	if (anyDigits && !truncated)
+	{
+		// a float mantissa times a float-exact power of ten is one correctly rounded operation
+		if (mantissa <= (1ull << 24) && exponent >= -10 && exponent <= 10)
+		{
+			auto value = static_cast<f32>(mantissa);
+			value = exponent < 0 ? value / static_cast<f32>(PowersOfTen[-exponent]) : value * static_cast<f32>(PowersOfTen[exponent]);
+			outValue = negative ? -value : value;
+			text = p;
+			return true;
+		}
+		// exact in a double, then rounded to float: can be off by one ulp for values right between two floats
+		if (mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22)
+		{
+			auto value = static_cast<d64>(mantissa);
+			value = exponent < 0 ? value / PowersOfTen[-exponent] : value * PowersOfTen[exponent];
+			outValue = static_cast<f32>(negative ? -value : value);
+			text = p;
+			return true;
+		}
+	}
+
+	// long mantissas, huge exponents, inf and nan
+	const char* start = text < end && *text == '+' ? text + 1 : text;
+	auto [next, error] = std::from_chars(start, end, outValue);
+	if (error == std::errc::result_out_of_range)
+	{
+		// from_chars leaves the value alone, flush to zero or saturate like a float conversion would
+		const auto magnitude = exponent < 0 ? 0.0f : std::numeric_limits<f32>::infinity();
+		outValue = negative ? -magnitude : magnitude;
+		text = next;
+		return true;
+	}
+	if (error != std::errc{}) return false;
+	text = next;
+	return true;
+}
+
+bool dx3d::MeshImporter::ImportObj(const void* data, size_t size, ImportedMesh& outMesh, const MeshImportOptions& options,
+	std::string* outError)
+{
+	return RunImport(data, size, outMesh, outError, [&](const unsigned char* bytes, size_t byteCount, ImportedMesh& mesh)
+		{
+			ImportObjData(bytes, byteCount, mesh, options);
+		});
+}
+
+bool dx3d::MeshImporter::ImportGlb(const void* data, size_t size, ImportedMesh& outMesh, const MeshImportOptions& options,
+	std::string* outError)
+{
+	return RunImport(data, size, outMesh, outError, [&](const unsigned char* bytes, size_t byteCount, ImportedMesh& mesh)
+		{
+			ImportGlbData(bytes, byteCount, mesh, options);
+		});
+}
+
+bool dx3d::MeshImporter::Import(const std::filesystem::path& path, ImportedMesh& outMesh, const MeshImportOptions& options,
+	std::string* outError)
+{
+	auto extension = path.extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+	if (extension != ".obj" && extension != ".glb") return Fail(outError, "Unsupported model format, only .obj and .glb are.");
+
+	// the parsers read straight out of the mapping, the file is never copied into memory first
+	MappedFile file(path);
+	if (!file.isOpen()) return Fail(outError, "Could not map the model file.");
+
+	if (extension == ".obj") return ImportObj(file.data(), file.size(), outMesh, options, outError);
+	return ImportGlb(file.data(), file.size(), outMesh, options, outError);
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <DX3D/Graphics/Mesh.h>
+#include <DX3D/Math/Vec4.h>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace dx3d
+{
+	struct MeshImportOptions
+	{
+		ThreadPool* threadPool{};                       // chunks are parsed on it, on the calling thread without one
+		Vec4 defaultColor{ 1.0f, 1.0f, 1.0f, 1.0f };    // for vertices the file gives no color
+		// both formats are right-handed with counter-clockwise front faces, the engine is left-handed with
+		// clockwise ones: z is negated and every triangle's winding flipped
+		bool convertToLeftHanded{ true };
+	};
+
+	struct MeshImportStats
+	{
+		ui64 bytes{};               // of the file
+		ui32 chunks{};              // parallel work items
+		d64 seconds{};
+		d64 megabytesPerSecond{};
+	};
+
+	// an indexed triangle list in the engine's vertex format, what Mesh::initializeBuffers takes
+	struct ImportedMesh
+	{
+		std::vector<Vertex> vertices{};
+		std::vector<ui32> indices{};
+		MeshImportStats stats{};
+	};
+
+	/*
+	* Loads models into ImportedMesh, straight out of the mapped file:
+	* - Wavefront OBJ: the file is cut into chunks at line boundaries, which are parsed in parallel
+	*   (v with the optional r g b extension and f, polygons are fanned, negative indices resolved per
+	*   chunk and fixed up once every chunk's vertex count is known) and then gathered in parallel.
+	*   Texture coordinates, normals, groups and materials are skipped, Vertex has no use for them.
+	* - glTF 2.0 binary (.glb): the JSON chunk is parsed up front, then the triangle primitives of the
+	*   default scene are decoded from the BIN chunk in parallel ranges, with their node transforms applied.
+	*   POSITION, COLOR_0 (float, unorm8 or unorm16) and the material's baseColorFactor are read.
+	* Numbers go through a hand-written float parser that only falls back to std::from_chars for input it
+	* cannot round exactly. Everything ends up in one mesh, the caller welds and optimizes it.
+	*/
+	namespace MeshImporter
+	{
+		// picks the format by extension (.obj, .glb), returns false and fills outError on failure
+		bool Import(const std::filesystem::path& path, ImportedMesh& outMesh, const MeshImportOptions& options = {},
+			std::string* outError = nullptr);
+
+		bool ImportObj(const void* data, size_t size, ImportedMesh& outMesh, const MeshImportOptions& options = {},
+			std::string* outError = nullptr);
+		bool ImportGlb(const void* data, size_t size, ImportedMesh& outMesh, const MeshImportOptions& options = {},
+			std::string* outError = nullptr);
+
+		// the number parser both formats use, advances text past the number and returns false when there is none
+		bool ParseFloat(const char*& text, const char* end, f32& outValue) noexcept;
+	}
+}
@@ -0,0 +1,387 @@
+#include <DX3D/Graphics/MeshOptimizer.h>
+#include <DX3D/Core/Hash.h>
+#include <DX3D/Math/Vec3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+namespace
+{
+	using namespace dx3d;
+
+	constexpr ui32 NoIndex = ~0u;
+
+	inline Vec3 GetPosition(const void* vertices, size_t vertexStride, ui32 index) noexcept
+	{
+		Vec3 p;
+		std::memcpy(&p, static_cast<const unsigned char*>(vertices) + index * vertexStride, sizeof(p));
+		return p;
+	}
+
+	inline Vec3 Cross(const Vec3& a, const Vec3& b) noexcept
+	{
+		return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+	}
+
+	inline f32 Dot(const Vec3& a, const Vec3& b) noexcept
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	// FIFO post-transform cache: a vertex is cached while fewer than size misses happened since its own
+	class FifoCache
+	{
+	public:
+		FifoCache(size_t vertexCount, ui32 size) : m_entryTime(vertexCount, 0), m_size(size), m_time(size + 1) {}
+
+		// returns the number of misses for the triangle
+		ui32 access(const ui32* triangle) noexcept
+		{
+			ui32 misses{};
+			for (ui32 i = 0; i < 3; i++)
+			{
+				const auto v = triangle[i];
+				if (m_time - m_entryTime[v] > m_size)
+				{
+					m_entryTime[v] = m_time++;
+					misses++;
+				}
+			}
+			return misses;
+		}
+
+		// everything cached so far falls out
+		void flush() noexcept { m_time += m_size + 1; }
+
+	private:
+		std::vector<ui64> m_entryTime;
+		ui64 m_size;
+		ui64 m_time;
+	};
+
+	// vertex -> triangles using it, as offsets into one flat list
+	struct Adjacency
+	{
+		std::vector<ui32> offsets{};
+		std::vector<ui32> triangles{};
+
+		Adjacency(const ui32* indices, size_t indexCount, size_t vertexCount) : offsets(vertexCount + 1, 0), triangles(indexCount)
+		{
+			for (size_t i = 0; i < indexCount; i++)
+				offsets[indices[i] + 1]++;
+			std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+			std::vector<ui32> fill(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < indexCount; i++)
+				triangles[fill[indices[i]]++] = static_cast<ui32>(i / 3);
+		}
+	};
+
+	// the passes after welding, shared by both Optimize overloads
+	void OptimizeWelded(MeshOptimizerStats& stats, size_t vertexStride, size_t vertexCount,
+		std::vector<unsigned char>& vertices, std::vector<ui32>& indices)
+	{
+		stats.triangles = static_cast<ui32>(indices.size() / 3);
+		stats.acmrBefore = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertexCount);
+
+		MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), vertexCount);
+		stats.clusters = MeshOptimizer::OptimizeOverdraw(indices.data(), indices.size(), vertices.data(), vertexStride, vertexCount);
+		vertexCount = MeshOptimizer::OptimizeVertexFetch(indices.data(), indices.size(), vertices.data(), vertexStride, vertexCount);
+		vertices.resize(vertexCount * vertexStride);
+
+		stats.uniqueVertices = static_cast<ui32>(vertexCount);
+		stats.acmrAfter = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertexCount);
+	}
+}
+
+size_t dx3d::MeshOptimizer::WeldVertices(const void* vertices, size_t vertexStride, size_t count,
+	std::vector<unsigned char>& outVertices, std::vector<ui32>& outIndices)
+{
+	const auto* bytes = static_cast<const unsigned char*>(vertices);
+
+	// open addressing, at most half full
+	size_t tableSize = 16;
+	while (tableSize < count * 2)
+		tableSize *= 2;
+	std::vector<ui32> table(tableSize, NoIndex);
+
+	outVertices.clear();
+	outVertices.reserve(count * vertexStride);
+	outIndices.resize(count);
+
+	ui32 uniqueCount{};
+	for (size_t i = 0; i < count; i++)
+	{
+		const auto* vertex = bytes + i * vertexStride;
+		auto slot = static_cast<size_t>(Hash::HashBytes(vertex, vertexStride)) & (tableSize - 1);
+		for (;;)
+		{
+			const auto candidate = table[slot];
+			if (candidate == NoIndex)
+			{
+				table[slot] = uniqueCount;
+				outVertices.insert(outVertices.end(), vertex, vertex + vertexStride);
+				outIndices[i] = uniqueCount++;
+				break;
+			}
+			if (std::memcmp(outVertices.data() + candidate * vertexStride, vertex, vertexStride) == 0)
+			{
+				outIndices[i] = candidate;
+				break;
+			}
+			slot = (slot + 1) & (tableSize - 1);
+		}
+	}
+	return uniqueCount;
+}
+
+void dx3d::MeshOptimizer::OptimizeVertexCache(ui32* indices, size_t indexCount, size_t vertexCount, ui32 cacheSize)
+{
+	const auto triangleCount = indexCount / 3;
+	if (!triangleCount)
+		return;
+
+	const Adjacency adjacency(indices, indexCount, vertexCount);
+	std::vector<ui32> liveTriangles(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+		liveTriangles[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+
+	std::vector<ui64> cacheTime(vertexCount, 0);
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<ui32> deadEnd{};
+	std::vector<ui32> candidates{};
+	std::vector<ui32> output{};
+	output.reserve(triangleCount * 3);
+
+	ui64 time = cacheSize + 1;
+	size_t cursor{};
+
+	// dead end: the most recently touched vertex with triangles left, else the next one in input order
+	auto skipDeadEnd = [&]() -> ui32
+		{
+			while (!deadEnd.empty())
+			{
+				const auto v = deadEnd.back();
+				deadEnd.pop_back();
+				if (liveTriangles[v]) return v;
+			}
+			for (; cursor < vertexCount; cursor++)
+			{
+				if (liveTriangles[cursor]) return static_cast<ui32>(cursor);
+			}
+			return NoIndex;
+		};
+
+	auto fanning = skipDeadEnd();
+	while (fanning != NoIndex)
+	{
+		// emit every triangle around the fanning vertex
+		candidates.clear();
+		for (auto i = adjacency.offsets[fanning]; i < adjacency.offsets[fanning + 1]; i++)
+		{
+			const auto triangle = adjacency.triangles[i];
+			if (emitted[triangle])
+				continue;
+			emitted[triangle] = true;
+
+			for (ui32 corner = 0; corner < 3; corner++)
+			{
+				const auto v = indices[triangle * 3 + corner];
+				output.push_back(v);
+				deadEnd.push_back(v);
+				candidates.push_back(v);
+				liveTriangles[v]--;
+				if (time - cacheTime[v] > cacheSize)
+					cacheTime[v] = time++;
+			}
+		}
+
+		// next fanning vertex: the oldest candidate that will still be cached after emitting its remaining fan
+		auto next = NoIndex;
+		ui64 bestPriority{};
+		for (const auto v : candidates)
+		{
+			if (!liveTriangles[v])
+				continue;
+			const auto age = time - cacheTime[v];
+			const auto priority = age + 2 * static_cast<ui64>(liveTriangles[v]) <= cacheSize ? age : 0;
+			if (next == NoIndex || priority > bestPriority)
+			{
+				bestPriority = priority;
+				next = v;
+			}
+		}
+		fanning = next != NoIndex ? next : skipDeadEnd();
+	}
+
+	std::copy(output.begin(), output.end(), indices);
+}
+
+dx3d::ui32 dx3d::MeshOptimizer::OptimizeOverdraw(ui32* indices, size_t indexCount, const void* vertices, size_t vertexStride,
+	size_t vertexCount, f32 threshold, ui32 cacheSize)
+{
+	const auto triangleCount = indexCount / 3;
+	if (!triangleCount)
+		return 0;
+
+	// hard boundaries: triangles the cache order could only start from scratch (all three corners missed)
+	std::vector<size_t> clusterStarts{};
+	{
+		FifoCache cache(vertexCount, cacheSize);
+		for (size_t t = 0; t < triangleCount; t++)
+		{
+			// the first one counts as a start even when it is degenerate and misses less
+			if (cache.access(indices + t * 3) == 3 || t == 0)
+				clusterStarts.push_back(t);
+		}
+	}
+	clusterStarts.push_back(triangleCount);
+
+	// soft boundaries: clusters are cut once their own ACMR got within threshold of the mesh's, with the cache
+	// flushed at every cut since after sorting the cluster before may be any other
+	const auto meshAcmr = AnalyzeVertexCache(indices, indexCount, vertexCount, cacheSize);
+	std::vector<size_t> clusters{};
+	{
+		FifoCache cache(vertexCount, cacheSize);
+		for (size_t hard = 0; hard + 1 < clusterStarts.size(); hard++)
+		{
+			const auto end = clusterStarts[hard + 1];
+			auto start = clusterStarts[hard];
+			ui32 misses{};
+			cache.flush();
+			clusters.push_back(start);
+			for (auto t = start; t < end; t++)
+			{
+				misses += cache.access(indices + t * 3);
+				const auto triangles = static_cast<f32>(t - start + 1);
+				if (t + 1 < end && static_cast<f32>(misses) <= threshold * meshAcmr * triangles)
+				{
+					start = t + 1;
+					misses = 0;
+					cache.flush();
+					clusters.push_back(start);
+				}
+			}
+		}
+	}
+	clusters.push_back(triangleCount);
+	const auto clusterCount = clusters.size() - 1;
+
+	// area weighted centroid and normal per cluster; D3D's clockwise front faces give outward normals for (b - a) x (c - a)
+	std::vector<Vec3> centroids(clusterCount), normals(clusterCount);
+	std::vector<f32> areas(clusterCount, 0.0f);
+	Vec3 meshCentroid{};
+	f32 meshArea{};
+	for (size_t c = 0; c < clusterCount; c++)
+	{
+		for (auto t = clusters[c]; t < clusters[c + 1]; t++)
+		{
+			const auto a = GetPosition(vertices, vertexStride, indices[t * 3]);
+			const auto b = GetPosition(vertices, vertexStride, indices[t * 3 + 1]);
+			const auto d = GetPosition(vertices, vertexStride, indices[t * 3 + 2]);
+			const auto normal = Cross(b - a, d - a);
+			const auto area = std::sqrt(Dot(normal, normal));
+			centroids[c] = centroids[c] + (a + b + d) * (area / 3.0f);
+			normals[c] = normals[c] + normal;
+			areas[c] += area;
+		}
+		meshCentroid = meshCentroid + centroids[c];
+		meshArea += areas[c];
+		if (areas[c] > 0.0f)
+			centroids[c] = centroids[c] * (1.0f / areas[c]);
+	}
+	if (meshArea > 0.0f)
+		meshCentroid = meshCentroid * (1.0f / meshArea);
+
+	// clusters far out along their own normal first (Sander et al.), they are the likeliest to cover the rest
+	std::vector<f32> sortKeys(clusterCount);
+	for (size_t c = 0; c < clusterCount; c++)
+	{
+		const auto length = std::sqrt(Dot(normals[c], normals[c]));
+		sortKeys[c] = length > 0.0f ? Dot(centroids[c] - meshCentroid, normals[c]) / length : 0.0f;
+	}
+	std::vector<ui32> order(clusterCount);
+	std::iota(order.begin(), order.end(), 0u);
+	std::stable_sort(order.begin(), order.end(), [&sortKeys](ui32 a, ui32 b) { return sortKeys[a] > sortKeys[b]; });
+
+	std::vector<ui32> sorted{};
+	sorted.reserve(triangleCount * 3);
+	for (const auto c : order)
+		sorted.insert(sorted.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+	std::copy(sorted.begin(), sorted.end(), indices);
+
+	return static_cast<ui32>(clusterCount);
+}
+
+size_t dx3d::MeshOptimizer::OptimizeVertexFetch(ui32* indices, size_t indexCount, void* vertices, size_t vertexStride, size_t vertexCount)
+{
+	std::vector<ui32> remap(vertexCount, NoIndex);
+	ui32 next{};
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		auto& target = remap[indices[i]];
+		if (target == NoIndex)
+			target = next++;
+		indices[i] = target;
+	}
+
+	auto* bytes = static_cast<unsigned char*>(vertices);
+	const std::vector<unsigned char> original(bytes, bytes + vertexCount * vertexStride);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		if (remap[v] != NoIndex)
+			std::memcpy(bytes + remap[v] * vertexStride, original.data() + v * vertexStride, vertexStride);
+	}
+	return next;
+}
+
+dx3d::f32 dx3d::MeshOptimizer::AnalyzeVertexCache(const ui32* indices, size_t indexCount, size_t vertexCount, ui32 cacheSize)
+{
+	const auto triangleCount = indexCount / 3;
+	if (!triangleCount)
+		return 0.0f;
+
+	FifoCache cache(vertexCount, cacheSize);
+	ui64 misses{};
+	for (size_t t = 0; t < triangleCount; t++)
+		misses += cache.access(indices + t * 3);
+	return static_cast<f32>(misses) / static_cast<f32>(triangleCount);
+}
+
+dx3d::MeshOptimizerStats dx3d::MeshOptimizer::Optimize(const void* vertices, size_t vertexStride, size_t count,
+	std::vector<unsigned char>& outVertices, std::vector<ui32>& outIndices)
+{
+	if (count % 3) throw std::invalid_argument("Triangle lists need a multiple of three vertices.");
+	if (vertexStride < sizeof(Vec3)) throw std::invalid_argument("Vertices need at least an x y z position.");
+
+	MeshOptimizerStats stats{};
+	stats.inputVertices = static_cast<ui32>(count);
+	auto vertexCount = WeldVertices(vertices, vertexStride, count, outVertices, outIndices);
+	OptimizeWelded(stats, vertexStride, vertexCount, outVertices, outIndices);
+	return stats;
+}
+
+dx3d::MeshOptimizerStats dx3d::MeshOptimizer::Optimize(const void* vertices, size_t vertexStride, size_t vertexCount,
+	const ui32* indices, size_t indexCount, std::vector<unsigned char>& outVertices, std::vector<ui32>& outIndices)
+{
+	if (indexCount % 3) throw std::invalid_argument("Triangle lists need a multiple of three indices.");
+	if (vertexStride < sizeof(Vec3)) throw std::invalid_argument("Vertices need at least an x y z position.");
+
+	MeshOptimizerStats stats{};
+	stats.inputVertices = static_cast<ui32>(vertexCount);
+
+	// welding the vertex array gives the old -> new remap, the triangles just go through it
+	std::vector<ui32> remap;
+	auto weldedCount = WeldVertices(vertices, vertexStride, vertexCount, outVertices, remap);
+	outIndices.resize(indexCount);
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		if (indices[i] >= vertexCount) throw std::invalid_argument("Index out of range of the vertices.");
+		outIndices[i] = remap[indices[i]];
+	}
+
+	OptimizeWelded(stats, vertexStride, weldedCount, outVertices, outIndices);
+	return stats;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <cstddef>
+#include <vector>
+
+namespace dx3d
+{
+	struct MeshOptimizerStats
+	{
+		ui32 inputVertices{};       // as authored, three per triangle for triangle lists
+		ui32 uniqueVertices{};      // after welding
+		ui32 triangles{};
+		ui32 clusters{};            // patches the overdraw pass sorted
+		f32 acmrBefore{};           // welded, still in the authored triangle order (unindexed it is 3)
+		f32 acmrAfter{};
+	};
+
+	/*
+	* Turns triangle soup into an indexed mesh that is cheap to draw, the passes in the order Optimize runs them:
+	* - weld: bitwise identical vertices are merged through a hash table and an index buffer is built,
+	* - vertex cache: Tipsify (Sander, Nehab, Barczak 2007) orders the triangles for a FIFO post-transform cache,
+	* - overdraw: the cache-ordered triangles are split into clusters where the cache misses allow it and the
+	*   clusters are sorted so outward facing ones come first, which tends to draw occluders before what they hide,
+	* - vertex fetch: vertices are renumbered in first-use order so the input assembler reads them front to back.
+	*
+	* Vertices are opaque blobs vertexStride bytes long with the x y z position as the first three floats,
+	* like Vertex. The ACMR (average cache miss ratio, vertices transformed per
+	* triangle) is measured with a FIFO cache of the given size; 3 is the worst case, 0.5 the best a grid can do.
+	*/
+	namespace MeshOptimizer
+	{
+		constexpr ui32 DefaultCacheSize = 16;
+		// clusters may end once their own ACMR is within this factor of the whole mesh's
+		constexpr f32 DefaultOverdrawThreshold = 1.05f;
+
+		// count unindexed vertices -> outVertices without duplicates + outIndices (count of them), returns the unique vertex count
+		size_t WeldVertices(const void* vertices, size_t vertexStride, size_t count,
+			std::vector<unsigned char>& outVertices, std::vector<ui32>& outIndices);
+
+		void OptimizeVertexCache(ui32* indices, size_t indexCount, size_t vertexCount, ui32 cacheSize = DefaultCacheSize);
+
+		// expects the output of OptimizeVertexCache, returns the number of clusters
+		ui32 OptimizeOverdraw(ui32* indices, size_t indexCount, const void* vertices, size_t vertexStride, size_t vertexCount,
+			f32 threshold = DefaultOverdrawThreshold, ui32 cacheSize = DefaultCacheSize);
+
+		// reorders vertices (in place) and rewrites indices to first-use order, returns the vertices still referenced
+		size_t OptimizeVertexFetch(ui32* indices, size_t indexCount, void* vertices, size_t vertexStride, size_t vertexCount);
+
+		f32 AnalyzeVertexCache(const ui32* indices, size_t indexCount, size_t vertexCount, ui32 cacheSize = DefaultCacheSize);
+
+		// every pass above on count unindexed vertices
+		MeshOptimizerStats Optimize(const void* vertices, size_t vertexStride, size_t count,
+			std::vector<unsigned char>& outVertices, std::vector<ui32>& outIndices);
+		// the same on an indexed triangle list, e.g. from an importer; unreferenced vertices are dropped
+		MeshOptimizerStats Optimize(const void* vertices, size_t vertexStride, size_t vertexCount,
+			const ui32* indices, size_t indexCount, std::vector<unsigned char>& outVertices, std::vector<ui32>& outIndices);
+	}
+}
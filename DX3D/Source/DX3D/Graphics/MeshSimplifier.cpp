@@ -0,0 +1,372 @@
+#include <DX3D/Graphics/MeshSimplifier.h>
+#include <DX3D/Graphics/MeshOptimizer.h>
+#include <DX3D/Math/Aabb.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace
+{
+	using namespace dx3d;
+
+	// planes standing on open borders weigh this much more than the triangles' own, so outlines stay put
+	constexpr d64 BorderWeight = 10.0;
+
+	inline Vec3 GetPosition(const void* vertices, size_t vertexStride, ui32 index) noexcept
+	{
+		Vec3 p;
+		std::memcpy(&p, static_cast<const unsigned char*>(vertices) + index * vertexStride, sizeof(p));
+		return p;
+	}
+
+	inline ui64 EdgeKey(ui32 from, ui32 to) noexcept
+	{
+		return (static_cast<ui64>(from) << 32) | to;
+	}
+
+	// sum of weight * (n.p + d)^2 over a set of planes, kept as the symmetric matrix it expands to;
+	// doubles because a vertex ends up summing the planes of everything collapsed into it
+	struct Quadric
+	{
+		d64 a00{}, a11{}, a22{}, a01{}, a02{}, a12{};
+		d64 b0{}, b1{}, b2{};
+		d64 c{};
+		d64 weight{};
+
+		static Quadric FromPlane(const Vec3& normal, f32 distance, d64 weight) noexcept
+		{
+			const d64 x = normal.x, y = normal.y, z = normal.z, d = distance;
+			Quadric q;
+			q.a00 = weight * x * x; q.a11 = weight * y * y; q.a22 = weight * z * z;
+			q.a01 = weight * x * y; q.a02 = weight * x * z; q.a12 = weight * y * z;
+			q.b0 = weight * x * d; q.b1 = weight * y * d; q.b2 = weight * z * d;
+			q.c = weight * d * d;
+			q.weight = weight;
+			return q;
+		}
+
+		Quadric& operator+=(const Quadric& q) noexcept
+		{
+			a00 += q.a00; a11 += q.a11; a22 += q.a22; a01 += q.a01; a02 += q.a02; a12 += q.a12;
+			b0 += q.b0; b1 += q.b1; b2 += q.b2;
+			c += q.c;
+			weight += q.weight;
+			return *this;
+		}
+
+		Quadric operator+(const Quadric& q) const noexcept
+		{
+			auto sum = *this;
+			return sum += q;
+		}
+
+		// the weighted mean squared distance from p to the planes
+		d64 evaluate(const Vec3& p) const noexcept
+		{
+			const d64 x = p.x, y = p.y, z = p.z;
+			const d64 e = x * (a00 * x + a01 * y + a02 * z) + y * (a01 * x + a11 * y + a12 * z) +
+				z * (a02 * x + a12 * y + a22 * z) + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+			return weight > 0.0 ? std::max(e, 0.0) / weight : 0.0;
+		}
+	};
+
+	enum class VertexKind : unsigned char
+	{
+		Manifold = 0,   // may collapse onto any neighbour
+		Border,         // on an open border, may only slide along it
+		Locked          // seams, corners of several borders, non-manifold edges
+	};
+
+	struct Collapse
+	{
+		ui32 from{};
+		ui32 to{};
+		f32 error{};
+	};
+
+	// vertex -> triangles using it, as offsets into one flat list
+	struct Adjacency
+	{
+		std::vector<ui32> offsets{};
+		std::vector<ui32> triangles{};
+
+		Adjacency(const std::vector<ui32>& indices, size_t vertexCount) : offsets(vertexCount + 1, 0), triangles(indices.size())
+		{
+			for (const auto index : indices)
+				offsets[index + 1]++;
+			std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+			std::vector<ui32> fill(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); i++)
+				triangles[fill[indices[i]]++] = static_cast<ui32>(i / 3);
+		}
+	};
+
+	std::unordered_set<ui64> GetDirectedEdges(const std::vector<ui32>& indices)
+	{
+		std::unordered_set<ui64> edges;
+		edges.reserve(indices.size());
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			for (ui32 e = 0; e < 3; e++)
+				edges.insert(EdgeKey(indices[i + e], indices[i + (e + 1) % 3]));
+		}
+		return edges;
+	}
+
+	std::vector<VertexKind> ClassifyVertices(const std::vector<ui32>& indices, const std::vector<Vec3>& positions)
+	{
+		const auto vertexCount = positions.size();
+		std::vector<VertexKind> kinds(vertexCount, VertexKind::Manifold);
+
+		// a seam: another vertex at exactly the same position, with other attributes (MeshOptimizer welded the equal ones)
+		std::vector<ui32> order(vertexCount);
+		std::iota(order.begin(), order.end(), 0u);
+		auto less = [&](ui32 a, ui32 b)
+			{
+				return std::memcmp(&positions[a], &positions[b], sizeof(Vec3)) < 0;
+			};
+		std::sort(order.begin(), order.end(), less);
+		for (size_t i = 1; i < vertexCount; i++)
+		{
+			if (!std::memcmp(&positions[order[i - 1]], &positions[order[i]], sizeof(Vec3)))
+				kinds[order[i - 1]] = kinds[order[i]] = VertexKind::Locked;
+		}
+
+		// an edge is open when no triangle runs it the other way round, and non-manifold when two run it the same way
+		std::unordered_set<ui64> edges;
+		edges.reserve(indices.size());
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			for (ui32 e = 0; e < 3; e++)
+			{
+				const auto a = indices[i + e], b = indices[i + (e + 1) % 3];
+				if (!edges.insert(EdgeKey(a, b)).second)
+					kinds[a] = kinds[b] = VertexKind::Locked;
+			}
+		}
+
+		std::vector<ui32> borderEdges(vertexCount, 0);
+		for (const auto edge : edges)
+		{
+			const auto a = static_cast<ui32>(edge >> 32), b = static_cast<ui32>(edge);
+			if (edges.count(EdgeKey(b, a))) continue;
+			borderEdges[a]++;
+			borderEdges[b]++;
+		}
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			if (kinds[v] == VertexKind::Locked || !borderEdges[v]) continue;
+			// more than one border through a vertex, it cannot slide along any of them
+			kinds[v] = borderEdges[v] > 2 ? VertexKind::Locked : VertexKind::Border;
+		}
+		return kinds;
+	}
+
+	std::vector<Quadric> ComputeQuadrics(const std::vector<ui32>& indices, const std::vector<Vec3>& positions)
+	{
+		std::vector<Quadric> quadrics(positions.size());
+		const auto edges = GetDirectedEdges(indices);
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			const ui32 corners[] = { indices[i], indices[i + 1], indices[i + 2] };
+			const auto& p0 = positions[corners[0]];
+			const auto cross = (positions[corners[1]] - p0).cross(positions[corners[2]] - p0);
+			const auto area = cross.length();
+			if (area <= 0.0f) continue;
+
+			const auto normal = cross / area;
+			const auto face = Quadric::FromPlane(normal, -normal.dot(p0), area * 0.5);
+			for (const auto corner : corners)
+				quadrics[corner] += face;
+
+			for (ui32 e = 0; e < 3; e++)
+			{
+				const auto a = corners[e], b = corners[(e + 1) % 3];
+				if (edges.count(EdgeKey(b, a))) continue;
+
+				// the plane through the border edge standing upright on the triangle
+				const auto edge = positions[b] - positions[a];
+				const auto length = edge.length();
+				if (length <= 0.0f) continue;
+				const auto borderNormal = edge.cross(normal).normalized();
+				const auto border = Quadric::FromPlane(borderNormal, -borderNormal.dot(positions[a]),
+					static_cast<d64>(length) * length * BorderWeight);
+				quadrics[a] += border;
+				quadrics[b] += border;
+			}
+		}
+		return quadrics;
+	}
+}
+
+dx3d::f32 dx3d::MeshSimplifier::Simplify(const ui32* indices, size_t indexCount, const void* vertices, size_t vertexStride,
+	size_t vertexCount, size_t targetIndexCount, f32 maxError, std::vector<ui32>& outIndices)
+{
+	if (indexCount % 3) throw std::invalid_argument("Triangle lists need a multiple of three indices.");
+	if (vertexStride < sizeof(Vec3)) throw std::invalid_argument("Vertices need at least an x y z position.");
+
+	outIndices.assign(indices, indices + indexCount);
+	for (const auto index : outIndices)
+	{
+		if (index >= vertexCount) throw std::invalid_argument("Index out of range of the vertices.");
+	}
+	if (indexCount <= targetIndexCount)
+		return 0.0f;
+
+	std::vector<Vec3> positions(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+		positions[v] = GetPosition(vertices, vertexStride, static_cast<ui32>(v));
+
+	const auto kinds = ClassifyVertices(outIndices, positions);
+	auto quadrics = ComputeQuadrics(outIndices, positions);
+
+	std::vector<ui32> collapsedTo(vertexCount);
+	std::vector<unsigned char> touched(vertexCount);
+	std::vector<Collapse> collapses;
+	f32 resultError = 0.0f;
+
+	while (outIndices.size() > targetIndexCount)
+	{
+		const Adjacency adjacency(outIndices, vertexCount);
+		const auto edges = GetDirectedEdges(outIndices);
+
+		// every edge once, in both directions where the kinds allow it
+		collapses.clear();
+		auto consider = [&](ui32 from, ui32 to, bool borderEdge)
+			{
+				if (kinds[from] == VertexKind::Locked) return;
+				if (kinds[from] == VertexKind::Border && !borderEdge) return;
+				const auto error = std::sqrt((quadrics[from] + quadrics[to]).evaluate(positions[to]));
+				if (error <= maxError)
+					collapses.push_back({ from, to, static_cast<f32>(error) });
+			};
+		for (size_t i = 0; i < outIndices.size(); i += 3)
+		{
+			for (ui32 e = 0; e < 3; e++)
+			{
+				const auto a = outIndices[i + e], b = outIndices[i + (e + 1) % 3];
+				const bool borderEdge = !edges.count(EdgeKey(b, a));
+				if (a > b && !borderEdge) continue;
+				consider(a, b, borderEdge);
+				consider(b, a, borderEdge);
+			}
+		}
+		if (collapses.empty())
+			break;
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+		// a vertex whose triangles changed in this pass has stale normals for the flip test, it waits for the next one
+		std::iota(collapsedTo.begin(), collapsedTo.end(), 0u);
+		std::fill(touched.begin(), touched.end(), 0);
+		const auto trianglesToRemove = (outIndices.size() - targetIndexCount + 2) / 3;
+		size_t removed = 0;
+		for (const auto& collapse : collapses)
+		{
+			if (removed >= trianglesToRemove) break;
+			if (touched[collapse.from] || touched[collapse.to]) continue;
+
+			bool allowed = true;
+			ui32 dropped = 0;
+			for (auto t = adjacency.offsets[collapse.from]; t < adjacency.offsets[collapse.from + 1] && allowed; t++)
+			{
+				const auto* triangle = &outIndices[static_cast<size_t>(adjacency.triangles[t]) * 3];
+				if (touched[triangle[0]] || touched[triangle[1]] || touched[triangle[2]])
+				{
+					allowed = false;
+					break;
+				}
+				if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+				{
+					dropped++;
+					continue;
+				}
+
+				// the triangle with `from` moved onto `to` has to keep facing the same way
+				Vec3 corners[3];
+				for (ui32 c = 0; c < 3; c++)
+					corners[c] = positions[triangle[c] == collapse.from ? collapse.to : triangle[c]];
+				const auto before = (positions[triangle[1]] - positions[triangle[0]]).cross(positions[triangle[2]] - positions[triangle[0]]);
+				const auto after = (corners[1] - corners[0]).cross(corners[2] - corners[0]);
+				if (before.dot(after) <= 0.0f)
+					allowed = false;
+			}
+			if (!allowed) continue;
+
+			collapsedTo[collapse.from] = collapse.to;
+			quadrics[collapse.to] += quadrics[collapse.from];
+			for (auto t = adjacency.offsets[collapse.from]; t < adjacency.offsets[collapse.from + 1]; t++)
+			{
+				const auto* triangle = &outIndices[static_cast<size_t>(adjacency.triangles[t]) * 3];
+				touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = 1;
+			}
+			removed += dropped;
+			resultError = std::max(resultError, collapse.error);
+		}
+		if (!removed)
+			break;
+
+		// re-point the triangles and drop the ones that lost a corner
+		size_t kept = 0;
+		for (size_t i = 0; i < outIndices.size(); i += 3)
+		{
+			const auto a = collapsedTo[outIndices[i]], b = collapsedTo[outIndices[i + 1]], c = collapsedTo[outIndices[i + 2]];
+			if (a == b || b == c || a == c) continue;
+			outIndices[kept++] = a;
+			outIndices[kept++] = b;
+			outIndices[kept++] = c;
+		}
+		outIndices.resize(kept);
+	}
+
+	return resultError;
+}
+
+std::vector<dx3d::MeshLodLevel> dx3d::MeshSimplifier::BuildLodChain(const ui32* indices, size_t indexCount, const void* vertices,
+	size_t vertexStride, size_t vertexCount, std::vector<ui32>& outIndices, const MeshLodOptions& options)
+{
+	if (indexCount % 3) throw std::invalid_argument("Triangle lists need a multiple of three indices.");
+	if (vertexStride < sizeof(Vec3)) throw std::invalid_argument("Vertices need at least an x y z position.");
+
+	outIndices.assign(indices, indices + indexCount);
+	std::vector<MeshLodLevel> levels{ { 0, static_cast<ui32>(indexCount), 0.0f } };
+	if (!indexCount)
+		return levels;
+
+	// the error budget scales with the mesh, a sphere around the box of what the triangles use
+	auto bounds = Aabb::empty();
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		if (indices[i] >= vertexCount) throw std::invalid_argument("Index out of range of the vertices.");
+		bounds.grow(GetPosition(vertices, vertexStride, indices[i]));
+	}
+	const auto errorBudget = options.maxError * bounds.extent().length();
+
+	std::vector<ui32> previous(indices, indices + indexCount);
+	std::vector<ui32> next;
+	f32 error = 0.0f;
+	const auto maxLevels = std::min(options.maxLevels, MaxMeshLodLevels);
+	while (levels.size() < maxLevels)
+	{
+		const auto previousTriangles = previous.size() / 3;
+		const auto targetTriangles = std::max(static_cast<size_t>(previousTriangles * options.reduction), static_cast<size_t>(options.minTriangles));
+		if (targetTriangles >= previousTriangles)
+			break;
+
+		// every level is simplified from the one before, so the errors add up
+		const auto levelError = Simplify(previous.data(), previous.size(), vertices, vertexStride, vertexCount,
+			targetTriangles * 3, errorBudget - error, next);
+		if (next.empty() || next.size() / 3 > previousTriangles * 9 / 10)
+			break;
+
+		error += levelError;
+		MeshOptimizer::OptimizeVertexCache(next.data(), next.size(), vertexCount);
+		levels.push_back({ static_cast<ui32>(outIndices.size()), static_cast<ui32>(next.size()), error });
+		outIndices.insert(outIndices.end(), next.begin(), next.end());
+		previous.swap(next);
+	}
+	return levels;
+}
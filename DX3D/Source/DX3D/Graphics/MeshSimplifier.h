@@ -0,0 +1,52 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <cstddef>
+#include <vector>
+
+namespace dx3d
+{
+	// levels BuildLodChain produces at most, the full mesh included
+	constexpr ui32 MaxMeshLodLevels = 8;
+
+	// one level of detail: a range of the shared index buffer over the shared vertices
+	struct MeshLodLevel
+	{
+		ui32 firstIndex{};
+		ui32 indexCount{};
+		f32 error{};                // how far the surface may be from the full mesh's, in object units
+	};
+
+	struct MeshLodOptions
+	{
+		ui32 maxLevels{ 5 };
+		f32 reduction{ 0.5f };      // each level aims for this fraction of the triangles of the one before
+		f32 maxError{ 0.1f };       // no level moves the surface further than this times the mesh's bounding radius
+		ui32 minTriangles{ 32 };    // no level is built below this
+	};
+
+	/*
+	* Quadric error simplification (Garland, Heckbert 1997), restricted to collapsing edges onto one of their
+	* endpoints: triangles are only dropped and re-pointed, the vertices stay untouched, so every level of
+	* detail is just another index list over the same vertex buffer.
+	* Every vertex carries the squared distances to the planes of its triangles (area weighted) as a quadric,
+	* a collapse costs the quadric of both ends evaluated at the end that stays. Collapses run cheapest first,
+	* in passes that each touch a vertex and its triangles at most once. A collapse is refused when it would
+	* flip a triangle, when it would move an open border inwards (border edges add quadrics of planes
+	* standing on them) or when it would pull apart a seam, vertices sharing a position with different
+	* attributes, which never move.
+	* Positions are read like MeshOptimizer reads them: the first three floats of every vertexStride bytes.
+	*/
+	namespace MeshSimplifier
+	{
+		// at most targetIndexCount indices (if the error allows it) into outIndices; returns the largest
+		// collapse error, a distance in the vertices' units
+		f32 Simplify(const ui32* indices, size_t indexCount, const void* vertices, size_t vertexStride, size_t vertexCount,
+			size_t targetIndexCount, f32 maxError, std::vector<ui32>& outIndices);
+
+		// level 0 is the input as it is, every further level is simplified from the one before and ordered for
+		// the vertex cache; the levels are appended to outIndices. Ends early once a level would not drop at
+		// least a tenth of the triangles left
+		std::vector<MeshLodLevel> BuildLodChain(const ui32* indices, size_t indexCount, const void* vertices,
+			size_t vertexStride, size_t vertexCount, std::vector<ui32>& outIndices, const MeshLodOptions& options = {});
+	}
+}
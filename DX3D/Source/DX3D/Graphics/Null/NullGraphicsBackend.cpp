@@ -0,0 +1,364 @@
+#include <DX3D/Graphics/Null/NullGraphicsBackend.h>
+#include <cstring>
+
+dx3d::NullCommandList::NullCommandList(NullGraphicsBackend& backend, bool recordCommands) :
+	m_backend(backend),
+	m_recordCommands(recordCommands)
+{
+}
+
+const std::vector<dx3d::RecordedCommand>& dx3d::NullCommandList::getCommands() const noexcept
+{
+	return m_commands;
+}
+
+void dx3d::NullCommandList::reset()
+{
+	m_commands.clear();
+	m_pipeline = {};
+	m_indexBuffer = {};
+	m_indexBufferOffset = 0;
+	resetStats();
+	invalidateState();
+}
+
+void dx3d::NullCommandList::onSetPipeline(PipelineHandle pipeline)
+{
+	m_topology = m_backend.getPipeline(pipeline).topology;
+	m_pipeline = pipeline;
+	if (m_recordCommands)
+		m_commands.push_back({ RecordedCommandType::SetPipeline, pipeline.id });
+}
+
+void dx3d::NullCommandList::onSetVertexBuffer(ui32 slot, BufferHandle buffer, ui32 stride, ui32 byteOffset)
+{
+	const auto& target = m_backend.getBuffer(buffer);
+	if (target.desc.type != BufferType::Vertex)
+		DX3DLogThrowInvalidArg("Buffer bound as vertex buffer was not created as one.");
+	if (target.mapped) DX3DLogThrowError("Buffer bound while it is still mapped.");
+	if (!stride) DX3DLogThrowInvalidArg("No vertex stride provided.");
+
+	if (m_recordCommands)
+		m_commands.push_back({ RecordedCommandType::SetVertexBuffer, buffer.id, slot, stride, byteOffset });
+}
+
+void dx3d::NullCommandList::onSetIndexBuffer(BufferHandle buffer, ui32 byteOffset)
+{
+	const auto& target = m_backend.getBuffer(buffer);
+	if (target.desc.type != BufferType::Index)
+		DX3DLogThrowInvalidArg("Buffer bound as index buffer was not created as one.");
+	if (target.mapped) DX3DLogThrowError("Buffer bound while it is still mapped.");
+
+	m_indexBuffer = buffer;
+	m_indexBufferOffset = byteOffset;
+	if (m_recordCommands)
+		m_commands.push_back({ RecordedCommandType::SetIndexBuffer, buffer.id, 0, sizeof(ui32), byteOffset });
+}
+
+void dx3d::NullCommandList::onSetConstantBuffer(ui32 slot, const ConstantBufferBinding& binding)
+{
+	const auto& target = m_backend.getBuffer(binding.buffer);
+	if (target.desc.type != BufferType::Constant)
+		DX3DLogThrowInvalidArg("Buffer bound as constant buffer was not created as one.");
+	if (target.mapped) DX3DLogThrowError("Buffer bound while it is still mapped.");
+	if (!binding.byteSize || binding.byteSize % ConstantBufferAlignment || binding.byteOffset % ConstantBufferAlignment)
+		DX3DLogThrowInvalidArg("Constant buffer ranges must be non-empty multiples of ConstantBufferAlignment.");
+	if (binding.byteSize > MaxConstantBufferBindingSize)
+		DX3DLogThrowInvalidArg("Constant buffer range is larger than a shader can address.");
+	if (static_cast<ui64>(binding.byteOffset) + binding.byteSize > target.desc.byteWidth)
+		DX3DLogThrowInvalidArg("Constant buffer range is out of bounds.");
+
+	if (m_recordCommands)
+	{
+		RecordedCommand command{ RecordedCommandType::SetConstantBuffer, binding.buffer.id, slot };
+		command.byteOffset = binding.byteOffset;
+		command.count = binding.byteSize;
+		m_commands.push_back(command);
+	}
+}
+
+void dx3d::NullCommandList::onDraw(ui32 vertexCount, ui32 startVertex)
+{
+	if (!m_pipeline) DX3DLogThrowError("Draw issued without a pipeline.");
+
+	if (m_recordCommands)
+	{
+		RecordedCommand command{ RecordedCommandType::Draw };
+		command.count = vertexCount;
+		command.start = startVertex;
+		m_commands.push_back(command);
+	}
+}
+
+void dx3d::NullCommandList::onDrawIndexed(ui32 indexCount, ui32 startIndex, i32 baseVertex)
+{
+	validateIndexRange(indexCount, startIndex);
+
+	if (m_recordCommands)
+	{
+		RecordedCommand command{ RecordedCommandType::DrawIndexed };
+		command.count = indexCount;
+		command.start = startIndex;
+		command.baseVertex = baseVertex;
+		m_commands.push_back(command);
+	}
+}
+
+void dx3d::NullCommandList::onDrawIndexedInstanced(ui32 indexCount, ui32 instanceCount, ui32 startIndex, i32 baseVertex, ui32 startInstance)
+{
+	validateIndexRange(indexCount, startIndex);
+
+	if (m_recordCommands)
+	{
+		RecordedCommand command{ RecordedCommandType::DrawIndexedInstanced };
+		command.count = indexCount;
+		command.instanceCount = instanceCount;
+		command.start = startIndex;
+		command.baseVertex = baseVertex;
+		command.startInstance = startInstance;
+		m_commands.push_back(command);
+	}
+}
+
+dx3d::Logger& dx3d::NullCommandList::getLogger() const noexcept
+{
+	return m_backend.getLogger();
+}
+
+void dx3d::NullCommandList::validateIndexRange(ui32 indexCount, ui32 startIndex) const
+{
+	if (!m_pipeline) DX3DLogThrowError("Draw issued without a pipeline.");
+	if (!m_indexBuffer) DX3DLogThrowError("Indexed draw issued without an index buffer.");
+
+	const auto& indexBuffer = m_backend.getBuffer(m_indexBuffer);
+	const auto end = m_indexBufferOffset + (static_cast<ui64>(startIndex) + indexCount) * sizeof(ui32);
+	if (end > indexBuffer.desc.byteWidth)
+		DX3DLogThrowInvalidArg("Indexed draw reads past the end of the index buffer.");
+}
+
+dx3d::NullGraphicsBackend::NullGraphicsBackend(const NullGraphicsBackendDesc& desc) :
+	GraphicsBackend(desc.base),
+	m_recordCommands(desc.recordCommands),
+	m_frameLatency(desc.frameLatency)
+{
+}
+
+dx3d::NullGraphicsBackend::~NullGraphicsBackend()
+{
+}
+
+dx3d::BufferHandle dx3d::NullGraphicsBackend::createBuffer(const BufferDesc& desc)
+{
+	if (!desc.byteWidth) DX3DLogThrowInvalidArg("No buffer size provided.");
+	if (desc.type == BufferType::Constant && desc.byteWidth % 16)
+		DX3DLogThrowInvalidArg("Constant buffer sizes must be multiples of 16 bytes.");
+	if (desc.usage == BufferUsage::Immutable && !desc.initialData)
+		DX3DLogThrowInvalidArg("Immutable buffers need their data at creation.");
+
+	ui32 index{};
+	if (m_freeBuffers.empty())
+	{
+		index = static_cast<ui32>(m_buffers.size());
+		m_buffers.emplace_back();
+	}
+	else
+	{
+		index = m_freeBuffers.back();
+		m_freeBuffers.pop_back();
+	}
+
+	auto& buffer = m_buffers[index];
+	buffer.desc = desc;
+	buffer.desc.initialData = nullptr;
+	buffer.contents.assign(desc.byteWidth, 0);
+	buffer.alive = true;
+	if (desc.initialData)
+	{
+		std::memcpy(buffer.contents.data(), desc.initialData, desc.byteWidth);
+		m_stats.bytesUploaded += desc.byteWidth;
+	}
+
+	m_stats.buffersCreated++;
+	return { index + 1 };
+}
+
+void dx3d::NullGraphicsBackend::updateBuffer(BufferHandle buffer, ui32 byteOffset, const void* data, ui32 byteSize)
+{
+	auto& target = getBuffer(buffer);
+	if (!data || !byteSize) DX3DLogThrowInvalidArg("No buffer data provided.");
+	if (target.desc.usage == BufferUsage::Immutable) DX3DLogThrowInvalidArg("Immutable buffers cannot be updated.");
+	if (target.desc.usage == BufferUsage::Dynamic && byteOffset)
+		DX3DLogThrowInvalidArg("Dynamic buffers are always rewritten from the start.");
+	if (target.mapped) DX3DLogThrowError("Buffer updated while it is mapped.");
+	if (static_cast<ui64>(byteOffset) + byteSize > target.desc.byteWidth)
+		DX3DLogThrowInvalidArg("Buffer update is out of bounds.");
+
+	std::memcpy(target.contents.data() + byteOffset, data, byteSize);
+	m_stats.bytesUploaded += byteSize;
+}
+
+void dx3d::NullGraphicsBackend::destroyBuffer(BufferHandle buffer)
+{
+	auto& target = getBuffer(buffer);
+	target.alive = false;
+	target.mapped = false;
+	target.contents = {};
+	m_freeBuffers.push_back(buffer.id - 1);
+	m_stats.buffersDestroyed++;
+}
+
+void* dx3d::NullGraphicsBackend::mapBuffer(BufferHandle buffer, MapMode)
+{
+	auto& target = getBuffer(buffer);
+	if (target.desc.usage != BufferUsage::Dynamic) DX3DLogThrowInvalidArg("Only dynamic buffers can be mapped.");
+	if (target.mapped) DX3DLogThrowError("Buffer is already mapped.");
+	if (m_inFrame) DX3DLogThrowError("Buffers cannot be mapped while the frame is being recorded.");
+
+	// system memory is never read behind our back, so discard and no-overwrite look the same here
+	target.mapped = true;
+	return target.contents.data();
+}
+
+void dx3d::NullGraphicsBackend::unmapBuffer(BufferHandle buffer)
+{
+	auto& target = getBuffer(buffer);
+	if (!target.mapped) DX3DLogThrowError("Buffer is not mapped.");
+	target.mapped = false;
+}
+
+dx3d::PipelineHandle dx3d::NullGraphicsBackend::createPipeline(const PipelineDesc& desc)
+{
+	if (!desc.vertexShaderPath) DX3DLogThrowInvalidArg("No vertex shader provided.");
+	if (!desc.pixelShaderPath) DX3DLogThrowInvalidArg("No pixel shader provided.");
+	if (desc.vertexLayout.empty()) DX3DLogThrowInvalidArg("No vertex layout provided.");
+
+	ui32 index{};
+	if (m_freePipelines.empty())
+	{
+		index = static_cast<ui32>(m_pipelines.size());
+		m_pipelines.emplace_back();
+	}
+	else
+	{
+		index = m_freePipelines.back();
+		m_freePipelines.pop_back();
+	}
+
+	auto& pipeline = m_pipelines[index];
+	pipeline.topology = desc.topology;
+	pipeline.vertexLayout = desc.vertexLayout;
+	pipeline.alive = true;
+
+	m_stats.pipelinesCreated++;
+	return { index + 1 };
+}
+
+void dx3d::NullGraphicsBackend::destroyPipeline(PipelineHandle pipeline)
+{
+	auto& target = getPipeline(pipeline);
+	target.alive = false;
+	target.vertexLayout = {};
+	m_freePipelines.push_back(pipeline.id - 1);
+}
+
+dx3d::GraphicsCommandList& dx3d::NullGraphicsBackend::beginFrame(const FrameDesc& desc)
+{
+	if (m_inFrame) DX3DLogThrowError("beginFrame called twice without endFrame.");
+	if (!desc.commandListCount) DX3DLogThrowInvalidArg("A frame needs at least one command list.");
+
+	while (m_commandLists.size() < desc.commandListCount)
+		m_commandLists.push_back(std::make_unique<NullCommandList>(*this, m_recordCommands));
+	for (ui32 i = 0; i < desc.commandListCount; i++)
+		m_commandLists[i]->reset();
+
+	m_commandListCount = desc.commandListCount;
+	m_inFrame = true;
+	return *m_commandLists.front();
+}
+
+dx3d::GraphicsCommandList& dx3d::NullGraphicsBackend::getCommandList(ui32 index)
+{
+	if (!m_inFrame || index >= m_commandListCount) DX3DLogThrowInvalidArg("Invalid command list index.");
+	return *m_commandLists[index];
+}
+
+dx3d::ui32 dx3d::NullGraphicsBackend::getCommandListCount() const noexcept
+{
+	return m_commandListCount;
+}
+
+void dx3d::NullGraphicsBackend::endFrame()
+{
+	if (!m_inFrame) DX3DLogThrowError("endFrame called without beginFrame.");
+	m_inFrame = false;
+
+	GraphicsCommandListStats frameStats{};
+	m_lastFrame.clear();
+	for (ui32 i = 0; i < m_commandListCount; i++)
+	{
+		const auto& commandList = *m_commandLists[i];
+		frameStats += commandList.getStats();
+		m_lastFrame.insert(m_lastFrame.end(), commandList.getCommands().begin(), commandList.getCommands().end());
+	}
+	addFrameStats(frameStats);
+}
+
+dx3d::ui64 dx3d::NullGraphicsBackend::getCompletedFrameCount()
+{
+	const auto submitted = getSubmittedFrameCount();
+	return submitted > m_frameLatency ? submitted - m_frameLatency : 0;
+}
+
+const dx3d::BufferDesc& dx3d::NullGraphicsBackend::getBufferDesc(BufferHandle buffer) const
+{
+	return getBuffer(buffer).desc;
+}
+
+const std::vector<unsigned char>& dx3d::NullGraphicsBackend::getBufferContents(BufferHandle buffer) const
+{
+	return getBuffer(buffer).contents;
+}
+
+dx3d::PrimitiveTopology dx3d::NullGraphicsBackend::getPipelineTopology(PipelineHandle pipeline) const
+{
+	return getPipeline(pipeline).topology;
+}
+
+const std::vector<dx3d::RecordedCommand>& dx3d::NullGraphicsBackend::getRecordedCommands() const noexcept
+{
+	return m_lastFrame;
+}
+
+size_t dx3d::NullGraphicsBackend::getLiveBufferCount() const noexcept
+{
+	return m_buffers.size() - m_freeBuffers.size();
+}
+
+size_t dx3d::NullGraphicsBackend::getLivePipelineCount() const noexcept
+{
+	return m_pipelines.size() - m_freePipelines.size();
+}
+
+dx3d::NullGraphicsBackend::Buffer& dx3d::NullGraphicsBackend::getBuffer(BufferHandle buffer)
+{
+	if (!buffer || buffer.id > m_buffers.size() || !m_buffers[buffer.id - 1].alive)
+		DX3DLogThrowInvalidArg("Invalid buffer handle.");
+	return m_buffers[buffer.id - 1];
+}
+
+const dx3d::NullGraphicsBackend::Buffer& dx3d::NullGraphicsBackend::getBuffer(BufferHandle buffer) const
+{
+	return const_cast<NullGraphicsBackend*>(this)->getBuffer(buffer);
+}
+
+dx3d::NullGraphicsBackend::Pipeline& dx3d::NullGraphicsBackend::getPipeline(PipelineHandle pipeline)
+{
+	if (!pipeline || pipeline.id > m_pipelines.size() || !m_pipelines[pipeline.id - 1].alive)
+		DX3DLogThrowInvalidArg("Invalid pipeline handle.");
+	return m_pipelines[pipeline.id - 1];
+}
+
+const dx3d::NullGraphicsBackend::Pipeline& dx3d::NullGraphicsBackend::getPipeline(PipelineHandle pipeline) const
+{
+	return const_cast<NullGraphicsBackend*>(this)->getPipeline(pipeline);
+}
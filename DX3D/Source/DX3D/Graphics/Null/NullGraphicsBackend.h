@@ -0,0 +1,144 @@
+#pragma once
+#include <DX3D/Graphics/GraphicsBackend.h>
+#include <memory>
+#include <vector>
+
+namespace dx3d
+{
+	class NullGraphicsBackend;
+
+	struct NullGraphicsBackendDesc
+	{
+		BaseDesc base;
+		bool recordCommands{ true };   // off = only count, for long benchmark runs
+		ui32 frameLatency{};           // frames the simulated GPU trails behind endFrame, exercises frame fences
+	};
+
+	enum class RecordedCommandType
+	{
+		SetPipeline = 0,
+		SetVertexBuffer,
+		SetIndexBuffer,
+		SetConstantBuffer,
+		Draw,
+		DrawIndexed,
+		DrawIndexedInstanced
+	};
+
+	struct RecordedCommand
+	{
+		RecordedCommandType type{};
+		ui32 handle{};          // pipeline or buffer id
+		ui32 slot{};
+		ui32 stride{};
+		ui32 byteOffset{};
+		ui32 count{};           // vertices or indices, bytes for constant buffers
+		ui32 instanceCount{};
+		ui32 start{};           // first vertex or index
+		i32 baseVertex{};
+		ui32 startInstance{};
+	};
+
+	class NullCommandList final : public GraphicsCommandList
+	{
+	public:
+		NullCommandList(NullGraphicsBackend& backend, bool recordCommands);
+
+		const std::vector<RecordedCommand>& getCommands() const noexcept;
+		void reset();
+
+	protected:
+		virtual void onSetPipeline(PipelineHandle pipeline) override;
+		virtual void onSetVertexBuffer(ui32 slot, BufferHandle buffer, ui32 stride, ui32 byteOffset) override;
+		virtual void onSetIndexBuffer(BufferHandle buffer, ui32 byteOffset) override;
+		virtual void onSetConstantBuffer(ui32 slot, const ConstantBufferBinding& binding) override;
+		virtual void onDraw(ui32 vertexCount, ui32 startVertex) override;
+		virtual void onDrawIndexed(ui32 indexCount, ui32 startIndex, i32 baseVertex) override;
+		virtual void onDrawIndexedInstanced(ui32 indexCount, ui32 instanceCount, ui32 startIndex, i32 baseVertex, ui32 startInstance) override;
+
+	private:
+		Logger& getLogger() const noexcept;
+		void validateIndexRange(ui32 indexCount, ui32 startIndex) const;
+
+	private:
+		NullGraphicsBackend& m_backend;
+		bool m_recordCommands{};
+		std::vector<RecordedCommand> m_commands{};
+		PipelineHandle m_pipeline{};
+		BufferHandle m_indexBuffer{};
+		ui32 m_indexBufferOffset{};
+	};
+
+	/*
+	* Graphics backend without a GPU, for running and profiling the CPU side of the engine headless.
+	* Buffers live in system memory (so uploads cost a real memcpy), every call is validated the way
+	* the debug layer would, and the commands of the last frame can be recorded for inspection.
+	* Counts buffers created, bytes uploaded, state changes and draw calls through GraphicsBackendStats.
+	*/
+	class NullGraphicsBackend final : public GraphicsBackend
+	{
+	public:
+		explicit NullGraphicsBackend(const NullGraphicsBackendDesc& desc);
+		virtual ~NullGraphicsBackend() override;
+
+		virtual BufferHandle createBuffer(const BufferDesc& desc) override;
+		virtual void updateBuffer(BufferHandle buffer, ui32 byteOffset, const void* data, ui32 byteSize) override;
+		virtual void destroyBuffer(BufferHandle buffer) override;
+		virtual void* mapBuffer(BufferHandle buffer, MapMode mode) override;
+		virtual void unmapBuffer(BufferHandle buffer) override;
+
+		virtual PipelineHandle createPipeline(const PipelineDesc& desc) override;
+		virtual void destroyPipeline(PipelineHandle pipeline) override;
+
+		virtual GraphicsCommandList& beginFrame(const FrameDesc& desc) override;
+		virtual GraphicsCommandList& getCommandList(ui32 index) override;
+		virtual ui32 getCommandListCount() const noexcept override;
+		virtual void endFrame() override;
+		virtual ui64 getCompletedFrameCount() override;
+
+		const BufferDesc& getBufferDesc(BufferHandle buffer) const;
+		const std::vector<unsigned char>& getBufferContents(BufferHandle buffer) const;
+		PrimitiveTopology getPipelineTopology(PipelineHandle pipeline) const;
+		// commands of the last finished frame in execution order, empty when recording is off
+		const std::vector<RecordedCommand>& getRecordedCommands() const noexcept;
+
+		size_t getLiveBufferCount() const noexcept;
+		size_t getLivePipelineCount() const noexcept;
+
+	private:
+		struct Buffer
+		{
+			BufferDesc desc{};
+			std::vector<unsigned char> contents{};
+			bool alive{};
+			bool mapped{};
+		};
+
+		struct Pipeline
+		{
+			PrimitiveTopology topology{};
+			std::vector<VertexAttribute> vertexLayout{};
+			bool alive{};
+		};
+
+		Buffer& getBuffer(BufferHandle buffer);
+		const Buffer& getBuffer(BufferHandle buffer) const;
+		Pipeline& getPipeline(PipelineHandle pipeline);
+		const Pipeline& getPipeline(PipelineHandle pipeline) const;
+
+	private:
+		std::vector<Buffer> m_buffers{};
+		std::vector<ui32> m_freeBuffers{};
+		std::vector<Pipeline> m_pipelines{};
+		std::vector<ui32> m_freePipelines{};
+
+		bool m_recordCommands{};
+		ui32 m_frameLatency{};
+		std::vector<std::unique_ptr<NullCommandList>> m_commandLists{};
+		ui32 m_commandListCount{};
+		std::vector<RecordedCommand> m_lastFrame{};
+		bool m_inFrame{};
+
+		friend class NullCommandList;
+	};
+}
@@ -0,0 +1,118 @@
+#include <DX3D/Graphics/PipelineCache.h>
+#include <DX3D/Graphics/GraphicsBackend.h>
+#include <DX3D/Core/Hash.h>
+
+namespace
+{
+	// strings end in a 0, so "ab" + "c" and "a" + "bc" cannot come out the same
+	void AppendString(std::string& out, const char* text)
+	{
+		if (text) out += text;
+		out += '\0';
+	}
+
+	void AppendString(std::string& out, const std::string& text)
+	{
+		out += text;
+		out += '\0';
+	}
+
+	template <typename T>
+	void AppendValue(std::string& out, const T& value)
+	{
+		out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	std::string SerializeDesc(const dx3d::PipelineDesc& desc)
+	{
+		std::string out;
+		AppendString(out, desc.vertexShaderPath);
+		AppendString(out, desc.pixelShaderPath);
+		AppendString(out, desc.vertexShaderEntryPoint);
+		AppendString(out, desc.pixelShaderEntryPoint);
+
+		AppendValue(out, desc.vertexLayout.size());
+		for (const auto& attribute : desc.vertexLayout)
+		{
+			AppendString(out, attribute.semanticName);
+			AppendValue(out, attribute.semanticIndex);
+			AppendValue(out, attribute.format);
+			AppendValue(out, attribute.slot);
+			AppendValue(out, attribute.offset);
+			AppendValue(out, attribute.inputRate);
+		}
+		AppendValue(out, desc.topology);
+
+		AppendValue(out, desc.vertexShaderDefines.size());
+		for (const auto& define : desc.vertexShaderDefines)
+		{
+			AppendString(out, define.name);
+			AppendString(out, define.definition);
+		}
+
+		// field by field, the padding of the state structs is not part of the description
+		AppendValue(out, desc.rasterizer.fillMode);
+		AppendValue(out, desc.rasterizer.cullMode);
+		AppendValue(out, desc.rasterizer.frontCounterClockwise);
+		AppendValue(out, desc.rasterizer.depthClip);
+		AppendValue(out, desc.blendMode);
+		AppendValue(out, desc.depth.depthTest);
+		AppendValue(out, desc.depth.depthWrite);
+		return out;
+	}
+}
+
+dx3d::PipelineCache::PipelineCache(const BaseDesc& desc, GraphicsBackend& backend) :
+	Base(desc),
+	m_backend(backend)
+{
+}
+
+dx3d::PipelineHandle dx3d::PipelineCache::acquire(const PipelineDesc& desc)
+{
+	auto description = SerializeDesc(desc);
+	const auto key = Hash::HashBytes(description.data(), description.size());
+
+	auto& bucket = m_entries[key];
+	for (auto& entry : bucket)
+	{
+		if (entry.description != description) continue;
+		entry.references++;
+		m_stats.hits++;
+		return entry.pipeline;
+	}
+
+	// the backend validates the description, nothing is cached when it throws
+	const auto pipeline = m_backend.createPipeline(desc);
+	bucket.push_back({ std::move(description), pipeline, 1 });
+	m_keys[pipeline.id] = key;
+
+	m_stats.misses++;
+	m_stats.pipelineCount++;
+	return pipeline;
+}
+
+void dx3d::PipelineCache::release(PipelineHandle pipeline)
+{
+	auto key = m_keys.find(pipeline.id);
+	if (key == m_keys.end()) DX3DLogThrowInvalidArg("Pipeline was not acquired from this cache.");
+
+	auto bucket = m_entries.find(key->second);
+	for (auto entry = bucket->second.begin(); entry != bucket->second.end(); ++entry)
+	{
+		if (entry->pipeline != pipeline) continue;
+		if (--entry->references) return;
+
+		m_backend.destroyPipeline(pipeline);
+		bucket->second.erase(entry);
+		if (bucket->second.empty()) m_entries.erase(bucket);
+		m_keys.erase(key);
+		m_stats.pipelineCount--;
+		return;
+	}
+}
+
+const dx3d::PipelineCacheStats& dx3d::PipelineCache::getStats() const noexcept
+{
+	return m_stats;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <DX3D/Core/Base.h>
+#include <DX3D/Graphics/GraphicsTypes.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dx3d
+{
+	struct PipelineCacheStats
+	{
+		ui64 hits{};
+		ui64 misses{};              // pipelines the backend had to create
+		size_t pipelineCount{};
+	};
+
+	/*
+	* Hands out one shared pipeline per unique PipelineDesc: shaders (path, entry point, defines), vertex layout,
+	* topology and the fixed-function states. Pipelines never change after creation, so every user asking for
+	* the same description draws with the same one, and the render queue's sort key keeps their draws together.
+	* Descriptions are compared in full, in serialized form; the hash only picks the bucket.
+	* Every acquire has to be paired with a release, the pipeline is destroyed with its last user.
+	*/
+	class PipelineCache final : public Base
+	{
+	public:
+		PipelineCache(const BaseDesc& desc, GraphicsBackend& backend);
+
+		PipelineHandle acquire(const PipelineDesc& desc);
+		void release(PipelineHandle pipeline);
+
+		const PipelineCacheStats& getStats() const noexcept;
+
+	private:
+		struct Entry
+		{
+			std::string description{};
+			PipelineHandle pipeline{};
+			ui32 references{};
+		};
+
+		GraphicsBackend& m_backend;
+		std::unordered_map<ui64, std::vector<Entry>> m_entries{};
+		std::unordered_map<ui32, ui64> m_keys{}; // pipeline id -> bucket, so release does not have to rehash
+		PipelineCacheStats m_stats{};
+	};
+}
@@ -0,0 +1,113 @@
+#include <DX3D/Graphics/RenderQueue.h>
+#include <DX3D/Graphics/GraphicsBackend.h>
+#include <algorithm>
+
+dx3d::ui64 dx3d::RenderQueue::MakeSortKey(PipelineHandle pipeline, BufferHandle vertexBuffer, BufferHandle indexBuffer, f32 depth) noexcept
+{
+	const auto quantizedDepth = static_cast<ui64>(std::clamp(depth, 0.0f, 1.0f) * 0xFFFFFF);
+	return (static_cast<ui64>(pipeline.id & 0xFFFF) << 48) |
+		(static_cast<ui64>(vertexBuffer.id & 0xFFFF) << 32) |
+		(static_cast<ui64>(indexBuffer.id & 0xFF) << 24) |
+		quantizedDepth;
+}
+
+void dx3d::RenderQueue::clear() noexcept
+{
+	m_items.clear();
+	m_order.clear();
+}
+
+void dx3d::RenderQueue::setFrameConstants(const ConstantBufferBinding& binding) noexcept
+{
+	m_frameConstants = binding;
+}
+
+void dx3d::RenderQueue::submit(const DrawItem& item)
+{
+	m_order.push_back({ item.sortKey, static_cast<ui32>(m_items.size()) });
+	m_items.push_back(item);
+}
+
+void dx3d::RenderQueue::sort()
+{
+	const auto count = m_order.size();
+	if (count < 2) return;
+	m_scratch.resize(count);
+
+	for (ui32 shift = 0; shift < 64; shift += 8)
+	{
+		size_t offsets[256]{};
+		for (const auto& entry : m_order)
+			offsets[(entry.key >> shift) & 0xFF]++;
+
+		// every key has the same byte here, the pass would not move anything
+		if (offsets[(m_order.front().key >> shift) & 0xFF] == count)
+			continue;
+
+		size_t offset = 0;
+		for (auto& bucket : offsets)
+		{
+			const auto bucketSize = bucket;
+			bucket = offset;
+			offset += bucketSize;
+		}
+
+		for (const auto& entry : m_order)
+			m_scratch[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+		m_order.swap(m_scratch);
+	}
+}
+
+dx3d::ui32 dx3d::RenderQueue::size() const noexcept
+{
+	return static_cast<ui32>(m_order.size());
+}
+
+bool dx3d::RenderQueue::empty() const noexcept
+{
+	return m_order.empty();
+}
+
+const dx3d::DrawItem& dx3d::RenderQueue::operator[](ui32 index) const noexcept
+{
+	return m_items[m_order[index].item];
+}
+
+void dx3d::RenderQueue::execute(GraphicsCommandList& commandList, ui32 first, ui32 last) const
+{
+	last = std::min(last, size());
+	if (m_frameConstants.buffer && first < last)
+		commandList.setConstantBuffer(FrameConstantsSlot, m_frameConstants);
+
+	for (auto i = first; i < last; i++)
+	{
+		const auto& item = (*this)[i];
+
+		commandList.setPipeline(item.pipeline);
+		for (ui32 slot = 0; slot < MaxDrawVertexBuffers; slot++)
+		{
+			const auto& binding = item.vertexBuffers[slot];
+			if (binding.buffer)
+				commandList.setVertexBuffer(slot, binding.buffer, binding.stride, binding.byteOffset);
+		}
+		if (item.objectConstants.buffer)
+			commandList.setConstantBuffer(ObjectConstantsSlot, item.objectConstants);
+
+		if (!item.indexBuffer)
+		{
+			commandList.draw(item.elementCount, item.startElement);
+			continue;
+		}
+
+		commandList.setIndexBuffer(item.indexBuffer, item.indexByteOffset);
+		if (item.instanceCount > 1 || item.startInstance)
+			commandList.drawIndexedInstanced(item.elementCount, item.instanceCount, item.startElement, item.baseVertex, item.startInstance);
+		else
+			commandList.drawIndexed(item.elementCount, item.startElement, item.baseVertex);
+	}
+}
+
+void dx3d::RenderQueue::execute(GraphicsCommandList& commandList) const
+{
+	execute(commandList, 0, size());
+}
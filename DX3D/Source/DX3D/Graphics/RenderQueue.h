@@ -0,0 +1,79 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <DX3D/Graphics/GraphicsTypes.h>
+#include <vector>
+
+namespace dx3d
+{
+	// vertex streams one draw can bind (slot = index into DrawItem::vertexBuffers)
+	constexpr ui32 MaxDrawVertexBuffers = 3;
+	// constant buffer slots of the engine's shaders: b0 is shared by every draw of the queue, b1 belongs to the draw
+	constexpr ui32 FrameConstantsSlot = 0;
+	constexpr ui32 ObjectConstantsSlot = 1;
+
+	/*
+	* Everything one draw needs, so it can be sorted before anything is recorded.
+	* Without an index buffer it is a Draw, with one a DrawIndexed (DrawIndexedInstanced for more than one instance).
+	*/
+	struct DrawItem
+	{
+		ui64 sortKey{};                                                 // see RenderQueue::MakeSortKey
+		PipelineHandle pipeline{};
+		VertexBufferBinding vertexBuffers[MaxDrawVertexBuffers]{};      // unset slots are not bound
+		BufferHandle indexBuffer{};
+		ui32 indexByteOffset{};
+		ConstantBufferBinding objectConstants{};                        // bound to ObjectConstantsSlot when set
+		ui32 elementCount{};                                            // vertices or indices
+		ui32 instanceCount{ 1 };
+		ui32 startElement{};                                            // first vertex or index
+		i32 baseVertex{};
+		ui32 startInstance{};
+	};
+
+	/*
+	* Collects the draws of a frame, sorts them by key (stable LSD radix sort, 8 bits per pass) and
+	* replays them into command lists. Sorted draws share their state with their neighbours, so the
+	* command list's state cache drops most of the pipeline and buffer bindings.
+	* Draws with equal keys keep their submission order. Submitting and sorting are single threaded,
+	* execute only reads the queue and may run on several lists at once.
+	*/
+	class RenderQueue final
+	{
+	public:
+		/*
+		* 64 bit key, most significant first:
+		*   16 bits pipeline (shaders + input layout + topology) | 16 bits vertex buffer of slot 0 |
+		*    8 bits index buffer | 24 bits depth in [0, 1] (front to back)
+		* Handle ids wrap in their fields, which only costs sorting quality, never correctness.
+		*/
+		static ui64 MakeSortKey(PipelineHandle pipeline, BufferHandle vertexBuffer, BufferHandle indexBuffer, f32 depth = 0.0f) noexcept;
+
+		void clear() noexcept;
+		// bound to FrameConstantsSlot once at the start of every execute, kept across clear()
+		void setFrameConstants(const ConstantBufferBinding& binding) noexcept;
+		void submit(const DrawItem& item);
+		void sort();
+
+		ui32 size() const noexcept;
+		bool empty() const noexcept;
+		// sorted position -> item, valid after sort()
+		const DrawItem& operator[](ui32 index) const noexcept;
+
+		// replays the sorted draws [first, last)
+		void execute(GraphicsCommandList& commandList, ui32 first, ui32 last) const;
+		void execute(GraphicsCommandList& commandList) const;
+
+	private:
+		struct SortEntry
+		{
+			ui64 key{};
+			ui32 item{};
+		};
+
+	private:
+		std::vector<DrawItem> m_items{};
+		std::vector<SortEntry> m_order{};
+		std::vector<SortEntry> m_scratch{};     // kept between frames, so sorting does not allocate
+		ConstantBufferBinding m_frameConstants{};
+	};
+}
@@ -0,0 +1,379 @@
+#include <DX3D/Graphics/SceneRenderer.h>
+#include <DX3D/Graphics/GraphicsBackend.h>
+#include <DX3D/Graphics/Mesh.h>
+#include <DX3D/Core/Profiler.h>
+#include <DX3D/Core/ThreadPool.h>
+#include <DX3D/Math/Vec4.h>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// unit shapes every added shape is an instance of, centered on the origin
+	constexpr dx3d::Vertex UnitTriangle[] = {
+		{  0.0f,  0.5f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f },  // Top: Red
+		{  0.5f, -0.5f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f },  // Bottom right: Green
+		{ -0.5f, -0.5f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f }   // Bottom left: Blue
+	};
+	constexpr dx3d::ui32 UnitTriangleIndices[] = { 0, 1, 2 };
+
+	constexpr dx3d::Vertex UnitRectangle[] = {
+		{ -0.5f,  0.5f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f },  // Top-left: Green
+		{  0.5f,  0.5f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f },  // Top-right: Yellow
+		{  0.5f, -0.5f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f },  // Bottom-right: Blue
+		{ -0.5f, -0.5f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f }   // Bottom-left: Red
+	};
+	// two triangles to form a rectangle
+	constexpr dx3d::ui32 UnitRectangleIndices[] = { 0, 1, 2, 0, 2, 3 };
+
+	constexpr dx3d::Vertex UnitCube[] = {
+		{ -0.5f,  0.5f,  0.5f, 1.0f, 0.0f, 0.0f, 1.0f },  // Red
+		{  0.5f,  0.5f,  0.5f, 0.0f, 1.0f, 0.0f, 1.0f },  // Green
+		{  0.5f, -0.5f,  0.5f, 0.0f, 0.0f, 1.0f, 1.0f },  // Blue
+		{ -0.5f, -0.5f,  0.5f, 1.0f, 1.0f, 0.0f, 1.0f },  // Yellow
+
+		{ -0.5f,  0.5f, -0.5f, 1.0f, 0.0f, 1.0f, 1.0f },  // Magenta
+		{  0.5f,  0.5f, -0.5f, 0.0f, 1.0f, 1.0f, 1.0f },  // Cyan
+		{  0.5f, -0.5f, -0.5f, 1.0f, 1.0f, 1.0f, 1.0f },  // White
+		{ -0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f, 1.0f }   // Gray
+	};
+	// 6 faces, 2 triangles per face
+	constexpr dx3d::ui32 UnitCubeIndices[] = {
+		0, 1, 2, 0, 2, 3,   // Front face
+		4, 6, 5, 4, 7, 6,   // Back face
+		4, 5, 1, 4, 1, 0,   // Top face
+		3, 2, 6, 3, 6, 7,   // Bottom face
+		1, 5, 6, 1, 6, 2,   // Right face
+		4, 0, 3, 4, 3, 7    // Left face
+	};
+
+	// bulk adds below this many shapes are not worth waking the workers for
+	constexpr size_t ParallelAddThreshold = 4096;
+
+	// Mat4::scale(scale) * Mat4::translation(position), written straight into the rows
+	dx3d::Mat4 PlaceShape(dx3d::f32 scaleX, dx3d::f32 scaleY, dx3d::f32 scaleZ,
+		dx3d::f32 posX, dx3d::f32 posY, dx3d::f32 posZ) noexcept
+	{
+		return {
+			scaleX, 0.0f, 0.0f, 0.0f,
+			0.0f, scaleY, 0.0f, 0.0f,
+			0.0f, 0.0f, scaleZ, 0.0f,
+			posX, posY, posZ, 1.0f
+		};
+	}
+
+	// no color given, keep the vertex colors of the unit shape
+	dx3d::Vec4 ShapeColor(dx3d::f32 r, dx3d::f32 g, dx3d::f32 b, dx3d::f32 a) noexcept
+	{
+		const bool keepColors = r < 0 || g < 0 || b < 0;
+		return keepColors ? dx3d::Vec4{ -1.0f, -1.0f, -1.0f, a } : dx3d::Vec4{ r, g, b, a };
+	}
+}
+
+dx3d::SceneRenderer::SceneRenderer(const SceneRendererDesc& desc) : Base(desc.base), m_backend(desc.backend),
+	m_threadPool(desc.threadPool), m_minDrawsPerCommandList(desc.minDrawsPerCommandList)
+{
+	if (!m_minDrawsPerCommandList) DX3DLogThrowInvalidArg("A command list needs at least one draw.");
+	// every shape mesh shares one vertex layout, so they share one arena as well
+	m_geometryArena = std::make_unique<GeometryArena>(GeometryArenaDesc{ desc.base, m_backend, sizeof(Vertex), desc.vertexEncoding });
+	m_uploadRing = std::make_unique<DynamicUploadRing>(DynamicUploadRingDesc{ desc.base, m_backend });
+	m_constantRing = std::make_unique<ConstantBufferRing>(ConstantBufferRingDesc{ desc.base, m_backend });
+	m_cameraBlock = m_constantRing->createBlock();
+	m_constantRing->updateBlock(m_cameraBlock, FrameConstants{ Mat4::identity() });
+	m_shapeSystem = std::make_unique<ShapeSystem>(ShapeSystemDesc{ desc.base, m_backend, *m_geometryArena, m_uploadRing.get() });
+
+	// in ShapeMesh order
+	m_shapeSystem->addMesh(UnitTriangle, UnitTriangleIndices);
+	m_shapeSystem->addMesh(UnitRectangle, UnitRectangleIndices);
+	m_shapeSystem->addMesh(UnitCube, UnitCubeIndices);
+}
+
+dx3d::SceneRenderer::~SceneRenderer()
+{
+}
+
+dx3d::Entity dx3d::SceneRenderer::addTriangle(float posX, float posY, float size, float r, float g, float b, float a)
+{
+	const TriangleDesc desc{ posX, posY, size, r, g, b, a };
+	return addTriangles({ &desc, 1 }).front();
+}
+
+std::vector<dx3d::Entity> dx3d::SceneRenderer::addTriangles(std::span<const TriangleDesc> triangles)
+{
+	DX3DProfileZone("SceneRenderer::addTriangles");
+	return addShapes(static_cast<ui32>(ShapeMesh::Triangle), triangles.size(), [&](size_t i, Mat4& transform, Vec4& color)
+		{
+			const auto& desc = triangles[i];
+			transform = PlaceShape(desc.size, desc.size, 1.0f, desc.posX, desc.posY, 0.0f);
+			color = ShapeColor(desc.r, desc.g, desc.b, desc.a);
+		});
+}
+
+dx3d::Entity dx3d::SceneRenderer::addRectangle(float posX, float posY, float width, float height, float r, float g, float b, float a)
+{
+	const RectangleDesc desc{ posX, posY, width, height, r, g, b, a };
+	return addRectangles({ &desc, 1 }).front();
+}
+
+std::vector<dx3d::Entity> dx3d::SceneRenderer::addRectangles(std::span<const RectangleDesc> rectangles)
+{
+	DX3DProfileZone("SceneRenderer::addRectangles");
+	return addShapes(static_cast<ui32>(ShapeMesh::Rectangle), rectangles.size(), [&](size_t i, Mat4& transform, Vec4& color)
+		{
+			const auto& desc = rectangles[i];
+			transform = PlaceShape(desc.width, desc.height, 1.0f, desc.posX, desc.posY, 0.0f);
+			color = ShapeColor(desc.r, desc.g, desc.b, desc.a);
+		});
+}
+
+dx3d::Entity dx3d::SceneRenderer::addCube(float posX, float posY, float posZ, float size, float r, float g, float b, float a)
+{
+	const CubeDesc desc{ posX, posY, posZ, size, r, g, b, a };
+	return addCubes({ &desc, 1 }).front();
+}
+
+std::vector<dx3d::Entity> dx3d::SceneRenderer::addCubes(std::span<const CubeDesc> cubes)
+{
+	DX3DProfileZone("SceneRenderer::addCubes");
+	return addShapes(static_cast<ui32>(ShapeMesh::Cube), cubes.size(), [&](size_t i, Mat4& transform, Vec4& color)
+		{
+			const auto& desc = cubes[i];
+			transform = PlaceShape(desc.size, desc.size, desc.size, desc.posX, desc.posY, desc.posZ);
+			color = ShapeColor(desc.r, desc.g, desc.b, desc.a);
+		});
+}
+
+dx3d::Entity dx3d::SceneRenderer::addShape(ui32 mesh, const Mat4& transform, const Vec4& color)
+{
+	// throws for meshes that do not exist
+	m_shapeSystem->getMeshBounds(mesh);
+	return addShapes(mesh, 1, [&](size_t, Mat4& shapeTransform, Vec4& shapeColor)
+		{
+			shapeTransform = transform;
+			shapeColor = color;
+		}).front();
+}
+
+dx3d::ui32 dx3d::SceneRenderer::addShapeMesh(std::span<const Vertex> vertices, std::span<const ui32> indices)
+{
+	return m_shapeSystem->addMesh(vertices, indices);
+}
+
+template <typename Place>
+std::vector<dx3d::Entity> dx3d::SceneRenderer::addShapes(ui32 mesh, size_t count, const Place& place)
+{
+	// the new rows are filled where they landed, chunk by chunk; bounds and culling catch up in update()
+	std::vector<Entity> shapes(count);
+	m_entityStore.create(ShapeSystem::getComponentMask(), mesh, count, shapes.data(),
+		[&](EntityChunk& chunk, ui32 firstRow, ui32 rowCount, size_t firstIndex)
+		{
+			auto* transforms = chunk.write<TransformComponent>();
+			auto* colors = chunk.write<ColorComponent>();
+			for (ui32 row = firstRow; row < firstRow + rowCount; row++)
+				place(firstIndex + row - firstRow, transforms[row].world, colors[row].color);
+		}, count >= ParallelAddThreshold ? m_threadPool : nullptr);
+	return shapes;
+}
+
+void dx3d::SceneRenderer::moveShape(Entity shape, float posX, float posY, float posZ, float size)
+{
+	setShapeTransform(shape, PlaceShape(size, size, size, posX, posY, posZ));
+}
+
+void dx3d::SceneRenderer::setShapeTransform(Entity shape, const Mat4& transform)
+{
+	requireShape(shape);
+	m_entityStore.get<TransformComponent>(shape)->world = transform;
+}
+
+void dx3d::SceneRenderer::setShapeColor(Entity shape, const Vec4& color)
+{
+	requireShape(shape);
+	m_entityStore.get<ColorComponent>(shape)->color = color;
+}
+
+void dx3d::SceneRenderer::removeShape(Entity shape)
+{
+	requireShape(shape);
+	m_entityStore.destroy(shape);
+}
+
+void dx3d::SceneRenderer::requireShape(Entity shape) const
+{
+	if (!m_entityStore.contains(shape) || (m_entityStore.getComponents(shape) & ShapeSystem::getComponentMask()) != ShapeSystem::getComponentMask())
+		throw std::invalid_argument("Shape handle is stale or null");
+}
+
+dx3d::EntityStore& dx3d::SceneRenderer::getEntityStore() noexcept
+{
+	return m_entityStore;
+}
+
+dx3d::SceneNode dx3d::SceneRenderer::attachShape(Entity shape, SceneNode parent)
+{
+	requireShape(shape);
+	return m_sceneGraph.createNode(parent, std::as_const(m_entityStore).get<TransformComponent>(shape)->world, shape);
+}
+
+dx3d::SceneGraph& dx3d::SceneRenderer::getSceneGraph() noexcept
+{
+	return m_sceneGraph;
+}
+
+void dx3d::SceneRenderer::setCamera(const Mat4& viewProjection)
+{
+	// a camera that did not move leaves the block as it is, nothing is sent
+	m_constantRing->updateBlock(m_cameraBlock, FrameConstants{ viewProjection });
+	m_frustum = Frustum::fromMatrix(viewProjection);
+	m_meshLod.viewProjection = viewProjection;
+}
+
+void dx3d::SceneRenderer::setFrustum(const Frustum& frustum) noexcept
+{
+	m_frustum = frustum;
+}
+
+void dx3d::SceneRenderer::setMeshLod(f32 viewportHeight, f32 pixelError, f32 hysteresis) noexcept
+{
+	m_meshLod.viewportHeight = viewportHeight;
+	m_meshLod.pixelError = pixelError;
+	m_meshLod.hysteresis = hysteresis;
+}
+
+void dx3d::SceneRenderer::update()
+{
+	DX3DProfileZone("SceneRenderer::update");
+	if (m_frameOpen)
+		m_constantRing->end();
+	m_frameOpen = m_framePrepared = false;
+
+	m_geometryArena->flush();
+
+	// only the nodes below a change are recomputed, and only their shapes get written
+	m_sceneGraph.update(m_threadPool);
+	m_sceneGraph.forEachRecomputed([&](Entity shape, const Mat4& world)
+		{
+			if (auto* transform = m_entityStore.get<TransformComponent>(shape))
+				transform->world = world;
+		});
+
+	m_shapeSystem->update(m_entityStore, m_frustum);
+	m_cullingStats = m_shapeSystem->getCullingStats();
+
+	m_uploadRing->begin();
+	m_shapeSystem->flush(m_entityStore);
+	m_uploadRing->end();
+
+	// the meshes' object constants go into the ring until prepare(), the camera is sent with them if it changed
+	m_constantRing->begin();
+	m_frameOpen = true;
+	m_meshLod.stats = {};
+
+	DX3DProfileZone("SceneRenderer::submit");
+	m_renderQueue.clear();
+	m_renderQueue.setFrameConstants(m_constantRing->getBinding(m_cameraBlock));
+	m_shapeSystem->submit(m_renderQueue);
+}
+
+void dx3d::SceneRenderer::submitMesh(const Mesh& mesh, const Mat4& world, ui32* lodLevel)
+{
+	if (!m_frameOpen) DX3DLogThrowError("Meshes can only be submitted between update and prepare.");
+	mesh.submit(m_renderQueue, *m_constantRing, world, lodLevel ? &m_meshLod : nullptr, lodLevel);
+}
+
+void dx3d::SceneRenderer::prepare()
+{
+	if (!m_frameOpen) DX3DLogThrowError("prepare called without update.");
+
+	// unmaps the per-frame constants, nothing of the frame may be recorded before
+	m_constantRing->end();
+	m_frameOpen = false;
+	m_meshLodStats = m_meshLod.stats;
+	{
+		DX3DProfileZone("RenderQueue::sort");
+		m_renderQueue.sort();
+	}
+
+	// splitting only pays when every list gets enough draws to outweigh its own setup and execute
+	const auto threadCount = m_threadPool ? m_threadPool->getThreadCount() : 1;
+	const auto drawCount = m_renderQueue.size();
+	m_commandListCount = static_cast<ui32>(std::clamp<size_t>(drawCount / m_minDrawsPerCommandList, 1, threadCount));
+	m_framePrepared = true;
+}
+
+void dx3d::SceneRenderer::render()
+{
+	DX3DProfileZone("SceneRenderer::render");
+	if (!m_framePrepared)
+		prepare();
+	m_framePrepared = false;
+
+	const auto drawCount = m_renderQueue.size();
+	const auto listCount = m_backend.getCommandListCount();
+
+	// contiguous runs of the sorted queue per list, so executing the lists in order replays the sorted order
+	auto recordList = [&](ui32 list)
+		{
+			DX3DProfileZone("RenderQueue::execute");
+			m_renderQueue.execute(m_backend.getCommandList(list), list * drawCount / listCount, (list + 1) * drawCount / listCount);
+		};
+
+	if (m_threadPool && listCount > 1)
+	{
+		m_threadPool->parallelFor(listCount, recordList);
+	}
+	else
+	{
+		for (ui32 list = 0; list < listCount; list++)
+			recordList(list);
+	}
+}
+
+dx3d::ui32 dx3d::SceneRenderer::getCommandListCount() const noexcept
+{
+	return m_commandListCount;
+}
+
+void dx3d::SceneRenderer::renderFrame(const FrameDesc& desc)
+{
+	update();
+	prepare();
+
+	auto frameDesc = desc;
+	frameDesc.commandListCount = getCommandListCount();
+	m_backend.beginFrame(frameDesc);
+	render();
+	m_backend.endFrame();
+}
+
+dx3d::GraphicsBackend& dx3d::SceneRenderer::getBackend() noexcept
+{
+	return m_backend;
+}
+
+const dx3d::DynamicUploadRing& dx3d::SceneRenderer::getUploadRing() const noexcept
+{
+	return *m_uploadRing;
+}
+
+const dx3d::ConstantBufferRing& dx3d::SceneRenderer::getConstantRing() const noexcept
+{
+	return *m_constantRing;
+}
+
+const dx3d::CullingStats& dx3d::SceneRenderer::getCullingStats() const noexcept
+{
+	return m_cullingStats;
+}
+
+const dx3d::MeshLodStats& dx3d::SceneRenderer::getMeshLodStats() const noexcept
+{
+	return m_meshLodStats;
+}
+
+const dx3d::SceneGraphStats& dx3d::SceneRenderer::getSceneGraphStats() const noexcept
+{
+	return m_sceneGraph.getStats();
+}
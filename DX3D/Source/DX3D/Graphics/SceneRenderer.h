@@ -0,0 +1,139 @@
+#pragma once
+#include <DX3D/Core/Base.h>
+#include <DX3D/Graphics/GraphicsTypes.h>
+#include <DX3D/Graphics/GeometryArena.h>
+#include <DX3D/Graphics/DynamicUploadRing.h>
+#include <DX3D/Graphics/ConstantBufferRing.h>
+#include <DX3D/Graphics/ShapeSystem.h>
+#include <DX3D/Graphics/RenderQueue.h>
+#include <DX3D/Core/EntityStore.h>
+#include <DX3D/Core/SceneGraph.h>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace dx3d
+{
+	/*
+	* The API independent part of the engine: owns the geometry arena, the entity store the shapes live in
+	* and the shape system, and records them into whatever GraphicsBackend it was given.
+	* Shapes are entities (ShapeComponents.h) grouped by mesh in the store's chunks; code that moves many of
+	* them at once can write the components through getEntityStore() directly, the next update() notices.
+	* Shapes can also hang in the scene graph: attachShape gives one a node, and from then on update() writes
+	* the node's world matrix into the shape whenever it or a node above it changed.
+	* Every update() culls them against the frustum, only the visible shapes are uploaded and drawn.
+	* The camera is a retained constant block, bound once per command list; it is only sent again when it changes.
+	* Meshes are drawn immediate mode: submitMesh between update() and prepare() puts their world matrices into the
+	* constant ring's per-frame blocks, which prepare() closes before anything is recorded.
+	* The draws go through a RenderQueue, which is sorted by state and replayed into the command lists;
+	* with a thread pool the sorted queue is split over several lists recorded in parallel.
+	* GraphicsEngine drives it with the D3D11 backend; headless runs pair it with NullGraphicsBackend,
+	* or with SoftwareGraphicsBackend when the rendered pixels matter.
+	*/
+	class SceneRenderer final : public Base
+	{
+	public:
+		explicit SceneRenderer(const SceneRendererDesc& desc);
+		virtual ~SceneRenderer() override;
+
+		// add a triangle at specified position with specified color
+		Entity addTriangle(float posX, float posY, float size = 1.0f,
+			float r = -1.0f, float g = -1.0f, float b = -1.0f, float a = 1.0f);
+		// the entities are filled chunk by chunk on the thread pool
+		std::vector<Entity> addTriangles(std::span<const TriangleDesc> triangles);
+
+		// add a rectangle at specified position with specified size and color
+		Entity addRectangle(float posX, float posY, float width = 1.0f, float height = 1.0f,
+			float r = -1.0f, float g = -1.0f, float b = -1.0f, float a = 1.0f);
+		std::vector<Entity> addRectangles(std::span<const RectangleDesc> rectangles);
+
+		// add a cube at specified position with specified size and color
+		Entity addCube(float posX, float posY, float posZ, float size = 1.0f,
+			float r = -1.0f, float g = -1.0f, float b = -1.0f, float a = 1.0f);
+		std::vector<Entity> addCubes(std::span<const CubeDesc> cubes);
+
+		// any registered mesh (ShapeMesh or addShapeMesh) with any transform, color r < 0 keeps the mesh colors
+		Entity addShape(ui32 mesh, const Mat4& transform, const Vec4& color = { -1.0f, -1.0f, -1.0f, 1.0f });
+		ui32 addShapeMesh(std::span<const Vertex> vertices, std::span<const ui32> indices);
+
+		// places a shape added before at a position and uniform size, the color stays;
+		// it is streamed through the upload ring for as long as it keeps moving
+		void moveShape(Entity shape, float posX, float posY, float posZ, float size = 1.0f);
+		void setShapeTransform(Entity shape, const Mat4& transform);
+		void setShapeColor(Entity shape, const Vec4& color);
+		// handles go stale on removal, using one afterwards throws
+		void removeShape(Entity shape);
+
+		EntityStore& getEntityStore() noexcept;
+
+		// a node for the shape, its current transform becomes the local one relative to the parent;
+		// moving the shape directly afterwards only lasts until the node or one above it changes
+		SceneNode attachShape(Entity shape, SceneNode parent = {});
+		SceneGraph& getSceneGraph() noexcept;
+
+		// what the shaders transform world positions by, identity by default (the positions are clip space);
+		// the frustum follows it
+		void setCamera(const Mat4& viewProjection);
+		// what update() culls against, for culling with a different volume than the camera's
+		void setFrustum(const Frustum& frustum) noexcept;
+		// the screen the mesh levels of detail are picked for (MeshLodContext), the camera comes from setCamera
+		void setMeshLod(f32 viewportHeight, f32 pixelError = 1.0f, f32 hysteresis = 0.25f) noexcept;
+		// picks up changed shapes, culls them and pushes pending geometry and instance writes, then opens the frame's
+		// per-frame constants and queues the visible shapes; a frame updated again before it was rendered is dropped
+		void update();
+		// between update() and prepare(): draws the mesh in this frame, world becomes its object constants;
+		// with lodLevel the level of detail is picked by screen size and written back, keep one per drawn instance
+		// across frames so the hysteresis holds, without one the full mesh is drawn
+		void submitMesh(const Mesh& mesh, const Mat4& world = Mat4::identity(), ui32* lodLevel = nullptr);
+		// closes the frame's per-frame constants and sorts the queue, after the last submitMesh and before beginFrame
+		void prepare();
+		// records the sorted draws into the lists of the current frame (between beginFrame and endFrame),
+		// prepares the frame first if that was not done
+		void render();
+		// command lists the prepared frame's draws are worth splitting over, pass it to beginFrame after prepare():
+		// one below twice minDrawsPerCommandList, then up to one per thread
+		ui32 getCommandListCount() const noexcept;
+
+		// update + prepare + beginFrame + render + endFrame, the whole CPU side of a frame without meshes
+		void renderFrame(const FrameDesc& desc);
+
+		GraphicsBackend& getBackend() noexcept;
+		const DynamicUploadRing& getUploadRing() const noexcept;
+		const ConstantBufferRing& getConstantRing() const noexcept;
+		// for the last update()
+		const CullingStats& getCullingStats() const noexcept;
+		// for the last prepared frame
+		const MeshLodStats& getMeshLodStats() const noexcept;
+		const SceneGraphStats& getSceneGraphStats() const noexcept;
+
+	private:
+		// count shapes of one mesh, place(index, transform, color) fills each of them
+		template <typename Place>
+		std::vector<Entity> addShapes(ui32 mesh, size_t count, const Place& place);
+		void requireShape(Entity shape) const;
+
+	private:
+		GraphicsBackend& m_backend;
+		ThreadPool* m_threadPool{};
+		ui32 m_minDrawsPerCommandList{};
+		ui32 m_commandListCount{ 1 };   // for the prepared frame
+
+		std::unique_ptr<GeometryArena> m_geometryArena{};
+		std::unique_ptr<DynamicUploadRing> m_uploadRing{};
+		std::unique_ptr<ConstantBufferRing> m_constantRing{};
+		ConstantBlockHandle m_cameraBlock{};
+
+		EntityStore m_entityStore{};
+		SceneGraph m_sceneGraph{};
+		std::unique_ptr<ShapeSystem> m_shapeSystem{};
+
+		RenderQueue m_renderQueue{};
+
+		Frustum m_frustum{ Frustum::clipVolume() };
+		CullingStats m_cullingStats{};
+		MeshLodContext m_meshLod{};             // its stats count the frame being submitted
+		MeshLodStats m_meshLodStats{};
+		bool m_frameOpen{};             // update() ran, the per-frame constants take uploads until prepare()
+		bool m_framePrepared{};         // prepare() ran, the sorted queue waits for render()
+	};
+}
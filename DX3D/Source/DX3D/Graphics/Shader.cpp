@@ -1,7 +1,8 @@
 #include <DX3D/Graphics/Shader.h>
 #include <DX3D/Graphics/GraphicsLogUtils.h>
+#include <DX3D/Graphics/GraphicsDevice.h>
+#include <DX3D/Core/MappedFile.h>
 #include <d3dcompiler.h>
-#include <fstream>
 
 #pragma comment(lib, "d3dcompiler.lib")
 
@@ -15,7 +16,12 @@ namespace dx3d
     {
     }
 
-    bool Shader::compile(const std::string& source)
+    bool Shader::compile(const std::string& source, const char* sourceName)
+    {
+        return compile(source.c_str(), source.length(), sourceName);
+    }
+
+    bool Shader::compile(const char* source, size_t sourceSize, const char* sourceName)
     {
         UINT flags = D3DCOMPILE_ENABLE_STRICTNESS;
 #ifdef _DEBUG
@@ -23,40 +29,28 @@ namespace dx3d
         flags |= D3DCOMPILE_SKIP_OPTIMIZATION;
 #endif
 
-        Microsoft::WRL::ComPtr<ID3DBlob> errorBlob;
-        Microsoft::WRL::ComPtr<ID3DBlob> shaderBlob;
-
-        HRESULT hr = D3DCompile(
-            source.c_str(),
-            source.length(),
-            nullptr,
-            nullptr,
-            nullptr,
+        // identical sources (same entry point, target, flags and defines) are compiled once and then come from the cache
+        m_byteCode = m_desc.graphicsDesc.graphicsDevice->getShaderCache().getOrCompile({
+            source,
+            sourceSize,
+            sourceName,
             m_desc.entryPoint.c_str(),
             m_desc.target.c_str(),
             flags,
-            0,
-            &shaderBlob,
-            &errorBlob
-        );
+            m_desc.defines
+        });
 
-        if (FAILED(hr))
+        if (!m_byteCode)
         {
-            if (errorBlob)
-            {
-                //DX3DLogError(static_cast<char*>(errorBlob->GetBufferPointer()));
-            }
             return false;
         }
 
-        m_byteCode.resize(shaderBlob->GetBufferSize());
-        memcpy(m_byteCode.data(), shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize());
-
+        HRESULT hr{};
         if (m_desc.type == Type::Vertex)
         {
             hr = m_desc.graphicsDesc.device.CreateVertexShader(
-                m_byteCode.data(),
-                m_byteCode.size(),
+                m_byteCode->data(),
+                m_byteCode->size(),
                 nullptr,
                 &m_vertexShader
             );
@@ -64,8 +58,8 @@ namespace dx3d
         else
         {
             hr = m_desc.graphicsDesc.device.CreatePixelShader(
-                m_byteCode.data(),
-                m_byteCode.size(),
+                m_byteCode->data(),
+                m_byteCode->size(),
                 nullptr,
                 &m_pixelShader
             );
@@ -85,20 +79,19 @@ namespace dx3d
 
     bool Shader::loadFromFile(const std::string& filename)
     {
-        std::ifstream file(filename, std::ios::binary);
-        if (!file)
+        MappedFile file(filename);
+        if (!file.isOpen())
         {
             // DX3DLogError("Failed to open shader file");
             return false;
         }
 
-        file.seekg(0, std::ios::end);
-        size_t size = file.tellg();
-        file.seekg(0, std::ios::beg);
-
-        std::vector<char> buffer(size);
-        file.read(buffer.data(), size);
+        return compile(reinterpret_cast<const char*>(file.data()), file.size(), filename.c_str());
+    }
 
-        return compile(std::string(buffer.data(), size));
+    const ShaderBytecode& Shader::getByteCode() const
+    {
+        static const ShaderBytecode empty{};
+        return m_byteCode ? *m_byteCode : empty;
     }
 } 
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <DX3D/Graphics/ShaderBinary.h>
 #include <DX3D/Graphics/GraphicsUtils.h>
+#include <DX3D/Graphics/GraphicsDevice.h>
 #include <d3dcompiler.h>
 
 dx3d::ShaderBinary::ShaderBinary(const ShaderCompileDesc& desc, const GraphicsResourceDesc& gDesc) :
@@ -16,33 +17,26 @@ dx3d::ShaderBinary::ShaderBinary(const ShaderCompileDesc& desc, const GraphicsRe
 	compileFlags |= D3DCOMPILE_DEBUG;
 #endif
 
-	Microsoft::WRL::ComPtr<ID3DBlob> errorBlob{};
-	DX3DGraphicsCheckShaderCompile(
-		D3DCompile(
-			desc.shaderSourceCode,
-			desc.shaderSourceCodeSize,
-			desc.shaderSourceName,
-			nullptr,
-			nullptr,
-			desc.shaderEntryPoint,
-			dx3d::GraphicsUtils::GetShaderModelTarget(desc.shaderType),
-			compileFlags,
-			0,
-			&m_blob,
-			&errorBlob
-		),
-		errorBlob.Get()
-	);
-
-
+	std::string errors{};
+	m_byteCode = m_graphicsDevice->getShaderCache().getOrCompile({
+		desc.shaderSourceCode,
+		desc.shaderSourceCodeSize,
+		desc.shaderSourceName,
+		desc.shaderEntryPoint,
+		dx3d::GraphicsUtils::GetShaderModelTarget(desc.shaderType),
+		compileFlags
+	}, &errors);
+
+	if (!m_byteCode)
+		DX3DLogThrowError(errors.c_str());
 }
 
 dx3d::ShaderBinaryData dx3d::ShaderBinary::getData() const noexcept
 {
 	return
 	{
-		m_blob->GetBufferPointer(),
-		m_blob->GetBufferSize()
+		m_byteCode->data(),
+		m_byteCode->size()
 	};
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 #include <DX3D/Graphics/GraphicsResource.h>
+#include <DX3D/Graphics/ShaderCache.h>
 
 namespace dx3d
 {
@@ -10,7 +11,7 @@ namespace dx3d
 		ShaderBinaryData getData() const noexcept;
 		ShaderType getType() const noexcept;
 	private:
-		Microsoft::WRL::ComPtr<ID3DBlob> m_blob{};
+		ShaderBytecodePtr m_byteCode{};
 		ShaderType m_type{};
 	};
 }
\ No newline at end of file
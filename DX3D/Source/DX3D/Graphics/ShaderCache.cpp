@@ -0,0 +1,168 @@
+#include <DX3D/Graphics/ShaderCache.h>
+#include <DX3D/Core/Hash.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	constexpr char CacheFileMagic[4] = { 'D', 'X', 'S', 'C' };
+	constexpr dx3d::ui32 CacheFileVersion = 1;
+
+	struct CacheFileHeader
+	{
+		char magic[4]{};
+		dx3d::ui32 version{};
+		dx3d::ui64 key{};
+		dx3d::ui64 size{};
+		dx3d::ui64 checksum{};
+	};
+
+	dx3d::ui64 HashString(const char* text, dx3d::ui64 seed)
+	{
+		// the terminator is hashed too so "ab"+"c" and "a"+"bc" end up with different keys
+		return text ? dx3d::Hash::HashBytes(text, std::strlen(text) + 1, seed) : dx3d::Hash::HashValue('\0', seed);
+	}
+}
+
+dx3d::ShaderCache::ShaderCache(const ShaderCacheDesc& desc) :
+	Base(desc.base),
+	m_directory(desc.directory),
+	m_compilerId(desc.compilerId),
+	m_compiler(desc.compiler)
+{
+	if (!m_compiler) DX3DLogThrowInvalidArg("No shader compile function provided.");
+}
+
+dx3d::ShaderBytecodePtr dx3d::ShaderCache::getOrCompile(const ShaderCompileRequest& request, std::string* outErrors)
+{
+	if (!request.sourceCode) DX3DLogThrowInvalidArg("No shader source code provided.");
+	if (!request.sourceCodeSize) DX3DLogThrowInvalidArg("No shader source code size provided.");
+	if (!request.entryPoint) DX3DLogThrowInvalidArg("No shader entry point provided.");
+	if (!request.target) DX3DLogThrowInvalidArg("No shader target provided.");
+
+	const auto key = computeKey(request);
+	std::lock_guard lock(m_mutex);
+
+	if (auto it = m_registry.find(key); it != m_registry.end())
+	{
+		m_stats.memoryHits++;
+		return it->second;
+	}
+
+	if (auto bytecode = loadFromDisk(key))
+	{
+		m_stats.diskHits++;
+		m_registry.emplace(key, bytecode);
+		return bytecode;
+	}
+
+	auto bytecode = std::make_shared<ShaderBytecode>();
+	std::string errors{};
+	if (!m_compiler(request, *bytecode, errors))
+	{
+		if (outErrors) *outErrors = errors;
+		return nullptr;
+	}
+
+	m_stats.compiles++;
+	saveToDisk(key, *bytecode);
+	m_registry.emplace(key, bytecode);
+	return bytecode;
+}
+
+dx3d::ui64 dx3d::ShaderCache::computeKey(const ShaderCompileRequest& request) const noexcept
+{
+	auto key = Hash::HashBytes(request.sourceCode, request.sourceCodeSize);
+	key = HashString(request.entryPoint, key);
+	key = HashString(request.target, key);
+	key = Hash::HashValue(request.flags, key);
+	for (const auto& define : request.defines)
+	{
+		key = HashString(define.name.c_str(), key);
+		key = HashString(define.definition.c_str(), key);
+	}
+	key = HashString(m_compilerId.c_str(), key);
+	return key;
+}
+
+dx3d::ShaderCacheStats dx3d::ShaderCache::getStats() const
+{
+	std::lock_guard lock(m_mutex);
+	return m_stats;
+}
+
+std::filesystem::path dx3d::ShaderCache::getCacheFilePath(ui64 key) const
+{
+	char name[32]{};
+	std::snprintf(name, sizeof(name), "%016llx.cso", key);
+	return m_directory / name;
+}
+
+dx3d::ShaderBytecodePtr dx3d::ShaderCache::loadFromDisk(ui64 key) const
+{
+	if (m_directory.empty()) return nullptr;
+
+	std::ifstream file(getCacheFilePath(key), std::ios::binary);
+	if (!file) return nullptr;
+
+	CacheFileHeader header{};
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return nullptr;
+	if (std::memcmp(header.magic, CacheFileMagic, sizeof(CacheFileMagic)) != 0 ||
+		header.version != CacheFileVersion || header.key != key || !header.size)
+		return nullptr;
+
+	auto bytecode = std::make_shared<ShaderBytecode>(static_cast<size_t>(header.size));
+	if (!file.read(reinterpret_cast<char*>(bytecode->data()), static_cast<std::streamsize>(header.size)))
+		return nullptr;
+
+	// a truncated or half-written entry is treated as a miss and simply gets recompiled
+	if (Hash::HashBytes(bytecode->data(), bytecode->size()) != header.checksum)
+		return nullptr;
+
+	return bytecode;
+}
+
+void dx3d::ShaderCache::saveToDisk(ui64 key, const ShaderBytecode& bytecode)
+{
+	if (m_directory.empty()) return;
+
+	std::error_code error{};
+	std::filesystem::create_directories(m_directory, error);
+	if (error)
+	{
+		DX3DLogWarning("Could not create the shader cache directory, bytecode will not be persisted.");
+		return;
+	}
+
+	CacheFileHeader header{};
+	std::memcpy(header.magic, CacheFileMagic, sizeof(CacheFileMagic));
+	header.version = CacheFileVersion;
+	header.key = key;
+	header.size = bytecode.size();
+	header.checksum = Hash::HashBytes(bytecode.data(), bytecode.size());
+
+	// written next to the final name first, so a crash never leaves a valid-looking partial file
+	const auto path = getCacheFilePath(key);
+	auto tempPath = path;
+	tempPath += ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(bytecode.data()), static_cast<std::streamsize>(bytecode.size()));
+		if (!file)
+		{
+			DX3DLogWarning("Could not write a shader cache entry.");
+			return;
+		}
+	}
+
+	std::filesystem::rename(tempPath, path, error);
+	if (error)
+	{
+		std::filesystem::remove(tempPath, error);
+		DX3DLogWarning("Could not write a shader cache entry.");
+		return;
+	}
+	m_stats.diskWrites++;
+}
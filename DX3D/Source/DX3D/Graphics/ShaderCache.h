@@ -0,0 +1,79 @@
+#pragma once
+#include <DX3D/Core/Base.h>
+#include <DX3D/Graphics/GraphicsTypes.h>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dx3d
+{
+	using ShaderBytecode = std::vector<unsigned char>;
+	using ShaderBytecodePtr = std::shared_ptr<const ShaderBytecode>;
+
+	struct ShaderCompileRequest
+	{
+		const void* sourceCode{};
+		size_t sourceCodeSize{};
+		const char* sourceName{};   // only used for diagnostics, the key is content based
+		const char* entryPoint{};
+		const char* target{};
+		ui32 flags{};
+		std::vector<ShaderMacro> defines{};
+	};
+
+	// fills the bytecode or the error text, returns false when compilation failed
+	using ShaderCompileFunction = std::function<bool(const ShaderCompileRequest& request,
+		ShaderBytecode& outBytecode, std::string& outErrors)>;
+
+	struct ShaderCacheDesc
+	{
+		BaseDesc base;
+		std::filesystem::path directory{};   // empty = in-process registry only
+		std::string compilerId{};            // part of the key, so a compiler upgrade invalidates old entries
+		ShaderCompileFunction compiler{};
+	};
+
+	struct ShaderCacheStats
+	{
+		ui64 memoryHits{};
+		ui64 diskHits{};
+		ui64 compiles{};
+		ui64 diskWrites{};
+	};
+
+	/*
+	* Content-addressed shader bytecode cache.
+	* Key = source bytes + entry point + target + compile flags + defines + compiler id.
+	* Lookups go in-process registry -> disk -> compiler, so every unique shader is compiled
+	* once and then reused across runs. #include is not followed, sources must be self-contained.
+	*/
+	class ShaderCache final : public Base
+	{
+	public:
+		explicit ShaderCache(const ShaderCacheDesc& desc);
+
+		// returns nullptr and fills outErrors when the shader does not compile
+		ShaderBytecodePtr getOrCompile(const ShaderCompileRequest& request, std::string* outErrors = nullptr);
+
+		ui64 computeKey(const ShaderCompileRequest& request) const noexcept;
+		ShaderCacheStats getStats() const;
+
+	private:
+		std::filesystem::path getCacheFilePath(ui64 key) const;
+		ShaderBytecodePtr loadFromDisk(ui64 key) const;
+		void saveToDisk(ui64 key, const ShaderBytecode& bytecode);
+
+	private:
+		std::filesystem::path m_directory{};
+		std::string m_compilerId{};
+		ShaderCompileFunction m_compiler{};
+
+		mutable std::mutex m_mutex{};
+		std::unordered_map<ui64, ShaderBytecodePtr> m_registry{};
+		ShaderCacheStats m_stats{};
+	};
+}
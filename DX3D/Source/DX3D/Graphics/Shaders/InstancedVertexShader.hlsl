@@ -0,0 +1,38 @@
+struct VSInput {
+    float3 position : POSITION;
+    float4 color : COLOR;
+    float4 transform0 : INSTANCE_TRANSFORM0;
+    float4 transform1 : INSTANCE_TRANSFORM1;
+    float4 transform2 : INSTANCE_TRANSFORM2;
+    float4 transform3 : INSTANCE_TRANSFORM3;
+    float4 instanceColor : INSTANCE_COLOR;
+};
+
+struct PSInput {
+    float4 position : SV_POSITION;
+    float4 color : COLOR;
+};
+
+// the camera, shared by every draw of the frame (FrameConstants in ConstantBufferRing.h)
+cbuffer FrameConstants : register(b0) {
+    row_major float4x4 viewProjection;
+};
+
+// Snorm16x4 positions come in normalized to the mesh bounds (see VertexEncoder::GetShaderDefines),
+// every other encoding is already expanded to float by the input assembler
+float3 DecodePosition(float3 position) {
+#ifdef DX3D_POSITION_SNORM
+    return position * DX3D_POSITION_EXTENT + DX3D_POSITION_CENTER;
+#else
+    return position;
+#endif
+}
+
+PSInput main(VSInput input) {
+    PSInput output;
+    float4x4 world = float4x4(input.transform0, input.transform1, input.transform2, input.transform3);
+    output.position = mul(mul(float4(DecodePosition(input.position), 1.0f), world), viewProjection);
+    // a negative red channel means "no color given", keep the mesh colors and only take the alpha
+    output.color = input.instanceColor.r < 0.0f ? float4(input.color.rgb, input.instanceColor.a) : input.instanceColor;
+    return output;
+}
\ No newline at end of file
@@ -8,9 +8,29 @@ struct PSInput {
     float4 color : COLOR;
 };
 
+// the camera, shared by every draw of the frame (FrameConstants in ConstantBufferRing.h)
+cbuffer FrameConstants : register(b0) {
+    row_major float4x4 viewProjection;
+};
+
+// the mesh's own transform (ObjectConstants in ConstantBufferRing.h)
+cbuffer ObjectConstants : register(b1) {
+    row_major float4x4 world;
+};
+
+// Snorm16x4 positions come in normalized to the mesh bounds (see VertexEncoder::GetShaderDefines),
+// every other encoding is already expanded to float by the input assembler
+float3 DecodePosition(float3 position) {
+#ifdef DX3D_POSITION_SNORM
+    return position * DX3D_POSITION_EXTENT + DX3D_POSITION_CENTER;
+#else
+    return position;
+#endif
+}
+
 PSInput main(VSInput input) {
     PSInput output;
-    output.position = float4(input.position, 1.0f);
+    output.position = mul(mul(float4(DecodePosition(input.position), 1.0f), world), viewProjection);
     output.color = input.color;
     return output;
 } 
\ No newline at end of file
@@ -0,0 +1,290 @@
+#include <DX3D/Graphics/ShapeSystem.h>
+#include <DX3D/Graphics/GraphicsBackend.h>
+#include <DX3D/Graphics/DynamicUploadRing.h>
+#include <DX3D/Graphics/PipelineCache.h>
+#include <DX3D/Graphics/RenderQueue.h>
+#include <DX3D/Core/Profiler.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+static_assert(sizeof(dx3d::TransformComponent) == 64 && sizeof(dx3d::ColorComponent) == 16,
+	"The shape components are copied straight into the instance streams");
+
+dx3d::ShapeSystem::ShapeSystem(const ShapeSystemDesc& desc) : Base(desc.base), m_backend(desc.backend), m_arena(desc.arena),
+	m_uploadRing(desc.uploadRing)
+{
+	if (m_arena.getInputStride() != sizeof(Vertex))
+		DX3DLogThrowInvalidArg("Geometry arena stride does not match Vertex");
+
+	// slot 0 = the meshes in the arena, slot 1 = one transform per instance, slot 2 = one color per instance
+	PipelineDesc pipelineDesc = {};
+	pipelineDesc.vertexShaderPath = "DX3D/Source/DX3D/Graphics/Shaders/InstancedVertexShader.hlsl";
+	pipelineDesc.pixelShaderPath = "DX3D/Source/DX3D/Graphics/Shaders/PixelShader.hlsl";
+	pipelineDesc.vertexLayout = VertexEncoder::GetVertexLayout(m_arena.getEncoding());
+	pipelineDesc.vertexLayout.insert(pipelineDesc.vertexLayout.end(), {
+		{ "INSTANCE_TRANSFORM", 0, VertexFormat::Float4, 1, 0, VertexInputRate::PerInstance },
+		{ "INSTANCE_TRANSFORM", 1, VertexFormat::Float4, 1, 16, VertexInputRate::PerInstance },
+		{ "INSTANCE_TRANSFORM", 2, VertexFormat::Float4, 1, 32, VertexInputRate::PerInstance },
+		{ "INSTANCE_TRANSFORM", 3, VertexFormat::Float4, 1, 48, VertexInputRate::PerInstance },
+		{ "INSTANCE_COLOR", 0, VertexFormat::Float4, 2, 0, VertexInputRate::PerInstance }
+	});
+	pipelineDesc.vertexShaderDefines = VertexEncoder::GetShaderDefines(m_arena.getEncoding(), m_arena.getBounds());
+	m_pipeline = m_backend.getPipelineCache().acquire(pipelineDesc);
+}
+
+dx3d::ShapeSystem::~ShapeSystem()
+{
+	if (m_transformBuffer)
+		m_backend.destroyBuffer(m_transformBuffer);
+	if (m_colorBuffer)
+		m_backend.destroyBuffer(m_colorBuffer);
+	if (m_pipeline)
+		m_backend.getPipelineCache().release(m_pipeline);
+}
+
+dx3d::ComponentMask dx3d::ShapeSystem::getComponentMask()
+{
+	return EntityStore::getMask<TransformComponent, ColorComponent, BoundsComponent>();
+}
+
+dx3d::ui32 dx3d::ShapeSystem::addMesh(std::span<const Vertex> vertices, std::span<const ui32> indices)
+{
+	if (vertices.empty() || indices.empty() || indices.size() % 3)
+		DX3DLogThrowInvalidArg("Shape meshes must be non-empty indexed triangle lists");
+
+	ShapeMeshEntry mesh{};
+	mesh.geometry = m_arena.allocate(vertices.data(), static_cast<ui32>(vertices.size()),
+		indices.data(), static_cast<ui32>(indices.size()));
+	mesh.bounds = Aabb::fromPoints(vertices.data(), sizeof(Vertex), vertices.size());
+	m_meshes.push_back(mesh);
+	return static_cast<ui32>(m_meshes.size() - 1);
+}
+
+const dx3d::Aabb& dx3d::ShapeSystem::getMeshBounds(ui32 mesh) const
+{
+	if (mesh >= m_meshes.size())
+		throw std::invalid_argument("No shape mesh with this id");
+	return m_meshes[mesh].bounds;
+}
+
+void dx3d::ShapeSystem::update(EntityStore& store, const Frustum& frustum)
+{
+	DX3DProfileZone("ShapeSystem::update");
+
+	if (store.getStructureVersion() != m_structureVersion)
+		dropDestroyed(store);
+	if (store.getVersion() != m_boundsVersion)
+		updateBounds(store);
+
+	// a still camera over shapes that did not move sees what it saw last frame
+	if (!m_cullStale && std::equal(std::begin(frustum.planes), std::end(frustum.planes), std::begin(m_culledFrustum.planes)))
+		return;
+
+	m_visible.clear();
+	m_cullingStats = {};
+	m_bvh.cull(frustum, m_visible, m_cullingStats);
+	m_culledFrustum = frustum;
+	m_cullStale = false;
+}
+
+const dx3d::CullingStats& dx3d::ShapeSystem::getCullingStats() const noexcept
+{
+	return m_cullingStats;
+}
+
+void dx3d::ShapeSystem::dropDestroyed(const EntityStore& store)
+{
+	// entities that are gone, lost a component or moved to a group without a mesh leave the BVH
+	const auto mask = getComponentMask();
+	for (ui32 slot = 0; slot < m_tracked.size(); slot++)
+	{
+		const auto entity = m_tracked[slot];
+		if (!entity)
+			continue;
+		if (store.contains(entity) && (store.getComponents(entity) & mask) == mask && store.getGroup(entity) < m_meshes.size())
+			continue;
+
+		m_bvh.remove(slot);
+		m_tracked[slot] = {};
+		m_shapeCount--;
+		m_instancesChanged = true;
+		m_cullStale = true;
+	}
+	m_structureVersion = store.getStructureVersion();
+}
+
+void dx3d::ShapeSystem::updateBounds(EntityStore& store)
+{
+	const auto lastVersion = m_boundsVersion;
+	m_tracked.resize(std::max<size_t>(m_tracked.size(), store.getSlotCapacity()));
+
+	// only the chunks written since the last update, new entities go into the BVH and moved boxes are refitted
+	store.forEachChunk(getComponentMask(), [&](EntityChunk& chunk)
+		{
+			if (chunk.getVersion() <= lastVersion || chunk.getGroup() >= m_meshes.size())
+				return;
+
+			const auto& meshBounds = m_meshes[chunk.getGroup()].bounds;
+			const auto* entities = chunk.getEntities();
+			const auto* transforms = chunk.read<TransformComponent>();
+			auto* bounds = chunk.write<BoundsComponent>();
+			for (ui32 row = 0; row < chunk.size(); row++)
+			{
+				const auto box = meshBounds.transformed(transforms[row].world);
+				const auto slot = EntityStore::getSlot(entities[row]);
+				if (m_tracked[slot] != entities[row])
+				{
+					m_bvh.insert(slot, box);
+					m_tracked[slot] = entities[row];
+					m_shapeCount++;
+					m_cullStale = true;
+				}
+				else if (!(box.min == bounds[row].world.min && box.max == bounds[row].world.max))
+				{
+					m_bvh.update(slot, box);
+					m_cullStale = true;
+				}
+				bounds[row].world = box;
+			}
+			m_instancesChanged = true;
+		});
+
+	m_boundsVersion = store.getVersion();
+}
+
+void dx3d::ShapeSystem::flush(EntityStore& store)
+{
+	DX3DProfileZone("ShapeSystem::flush");
+
+	// part of the shapes is off-screen: only the visible ones are gathered into the ring, whatever they did;
+	// changing shapes are streamed through the ring as a whole, one memcpy per chunk and stream
+	const bool visibleOnly = m_cullingStats.culled != 0;
+	if (m_uploadRing && (visibleOnly || m_instancesChanged))
+	{
+		const auto capacity = static_cast<ui32>(visibleOnly ? m_visible.size() : m_shapeCount);
+		m_ownBuffersStale |= m_instancesChanged;
+		m_instancesChanged = false;
+		m_instancesInRing = true;
+		if (!capacity)
+		{
+			for (auto& mesh : m_meshes)
+				mesh.instanceCount = 0;
+			return;
+		}
+
+		// one allocation for both streams, a second one could grow the ring and unmap the first
+		const auto colorsOffset = capacity * static_cast<ui32>(sizeof(TransformComponent));
+		const auto allocation = m_uploadRing->allocate(colorsOffset + capacity * static_cast<ui32>(sizeof(ColorComponent)));
+		auto* data = static_cast<unsigned char*>(allocation.data);
+		gatherInstances(store, visibleOnly, capacity, reinterpret_cast<TransformComponent*>(data),
+			reinterpret_cast<ColorComponent*>(data + colorsOffset));
+
+		m_transformBinding = { allocation.buffer, sizeof(TransformComponent), allocation.byteOffset };
+		m_colorBinding = { allocation.buffer, sizeof(ColorComponent), allocation.byteOffset + colorsOffset };
+		return;
+	}
+
+	// a ring range is only good for the frame it was written in, shapes that stopped changing get copied once
+	if (!m_instancesChanged && !m_ownBuffersStale && !m_instancesInRing)
+		return;
+
+	const auto capacity = static_cast<ui32>(m_shapeCount);
+	if (capacity > m_instanceCapacity)
+	{
+		m_instanceCapacity = std::max(capacity, m_instanceCapacity * 2);
+
+		if (m_transformBuffer)
+			m_backend.destroyBuffer(m_transformBuffer);
+		if (m_colorBuffer)
+			m_backend.destroyBuffer(m_colorBuffer);
+		m_transformBuffer = m_backend.createBuffer({ BufferType::Vertex, BufferUsage::Dynamic,
+			static_cast<ui32>(sizeof(TransformComponent) * m_instanceCapacity) });
+		m_colorBuffer = m_backend.createBuffer({ BufferType::Vertex, BufferUsage::Dynamic,
+			static_cast<ui32>(sizeof(ColorComponent) * m_instanceCapacity) });
+	}
+
+	// the whole streams are rewritten in one go, so the old contents can be discarded
+	m_transformStaging.resize(capacity);
+	m_colorStaging.resize(capacity);
+	const auto count = gatherInstances(store, false, capacity, m_transformStaging.data(), m_colorStaging.data());
+	if (count)
+	{
+		m_backend.updateBuffer(m_transformBuffer, 0, m_transformStaging.data(), static_cast<ui32>(sizeof(TransformComponent) * count));
+		m_backend.updateBuffer(m_colorBuffer, 0, m_colorStaging.data(), static_cast<ui32>(sizeof(ColorComponent) * count));
+	}
+
+	m_transformBinding = { m_transformBuffer, sizeof(TransformComponent) };
+	m_colorBinding = { m_colorBuffer, sizeof(ColorComponent) };
+	m_instancesChanged = false;
+	m_ownBuffersStale = false;
+	m_instancesInRing = false;
+}
+
+dx3d::ui32 dx3d::ShapeSystem::gatherInstances(EntityStore& store, bool visibleOnly, ui32 capacity,
+	TransformComponent* transforms, ColorComponent* colors)
+{
+	if (visibleOnly)
+	{
+		m_visibleSlots.assign(m_tracked.size(), 0);
+		for (const auto slot : m_visible)
+			m_visibleSlots[slot] = 1;
+	}
+
+	// mesh by mesh, so every mesh's instances are one contiguous range of both streams
+	ui32 written = 0;
+	for (ui32 meshIndex = 0; meshIndex < m_meshes.size(); meshIndex++)
+	{
+		auto& mesh = m_meshes[meshIndex];
+		mesh.firstInstance = written;
+		store.forEachChunk(getComponentMask(), meshIndex, [&](EntityChunk& chunk)
+			{
+				const auto* chunkTransforms = chunk.read<TransformComponent>();
+				const auto* chunkColors = chunk.read<ColorComponent>();
+				if (!visibleOnly)
+				{
+					const auto rows = std::min(chunk.size(), capacity - written);
+					std::memcpy(transforms + written, chunkTransforms, sizeof(TransformComponent) * rows);
+					std::memcpy(colors + written, chunkColors, sizeof(ColorComponent) * rows);
+					written += rows;
+					return;
+				}
+
+				const auto* entities = chunk.getEntities();
+				for (ui32 row = 0; row < chunk.size() && written < capacity; row++)
+				{
+					if (!m_visibleSlots[EntityStore::getSlot(entities[row])])
+						continue;
+					transforms[written] = chunkTransforms[row];
+					colors[written] = chunkColors[row];
+					written++;
+				}
+			});
+		mesh.instanceCount = written - mesh.firstInstance;
+	}
+	return written;
+}
+
+void dx3d::ShapeSystem::submit(RenderQueue& queue)
+{
+	// one instanced draw per mesh, all of them reading the same two streams at their own first instance
+	DrawItem item = {};
+	item.pipeline = m_pipeline;
+	item.vertexBuffers[0] = m_arena.getVertexBufferBinding();
+	item.vertexBuffers[1] = m_transformBinding;
+	item.vertexBuffers[2] = m_colorBinding;
+	item.indexBuffer = m_arena.getIndexBuffer();
+	item.sortKey = RenderQueue::MakeSortKey(item.pipeline, item.vertexBuffers[0].buffer, item.indexBuffer);
+
+	for (const auto& mesh : m_meshes)
+	{
+		if (!mesh.instanceCount)
+			continue;
+
+		item.elementCount = mesh.geometry.indices.size;
+		item.startElement = mesh.geometry.indices.offset;
+		item.instanceCount = mesh.instanceCount;
+		item.startInstance = mesh.firstInstance;
+		queue.submit(item);
+	}
+}
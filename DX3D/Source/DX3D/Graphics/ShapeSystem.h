@@ -0,0 +1,91 @@
+#pragma once
+#include <DX3D/Core/Base.h>
+#include <DX3D/Core/EntityStore.h>
+#include <DX3D/Graphics/GraphicsTypes.h>
+#include <DX3D/Graphics/GeometryArena.h>
+#include <DX3D/Graphics/BoundingVolumeHierarchy.h>
+#include <DX3D/Graphics/Mesh.h>
+#include <DX3D/Graphics/ShapeComponents.h>
+#include <span>
+#include <vector>
+
+namespace dx3d
+{
+	/*
+	* Draws the shape entities of an EntityStore (TransformComponent + ColorComponent + BoundsComponent),
+	* one instanced draw per mesh. The group of a chunk is its mesh, so everything is gathered chunk by chunk:
+	* - update() recomputes the bounds of the chunks written since the last update and feeds the changed
+	*   boxes to the BVH, keyed by entity slot; entities destroyed in the store are dropped from it.
+	* - flush() writes the instances: with everything visible a chunk's transforms and colors are two
+	*   memcpys, with part of it culled only the visible rows are copied. Changing instances go through the
+	*   upload ring; once they stop changing they are copied once into the system's own buffers and drawn
+	*   from there until something changes again.
+	* - submit() queues a DrawIndexedInstanced per mesh with visible instances.
+	*/
+	class ShapeSystem final : public Base
+	{
+	public:
+		explicit ShapeSystem(const ShapeSystemDesc& desc);
+		virtual ~ShapeSystem() override;
+
+		// the components an entity needs to be drawn
+		static ComponentMask getComponentMask();
+
+		// x y z r g b a vertices and a triangle list, returns the id entities use as their group to be drawn as it
+		ui32 addMesh(std::span<const Vertex> vertices, std::span<const ui32> indices);
+		// the mesh's own box, BoundsComponent is this through the transform
+		const Aabb& getMeshBounds(ui32 mesh) const;
+
+		// picks up what changed in the store since the last update, then culls
+		void update(EntityStore& store, const Frustum& frustum);
+		// visible / culled in the last update
+		const CullingStats& getCullingStats() const noexcept;
+		// writes the visible instances, between the upload ring's begin and end
+		void flush(EntityStore& store);
+		void submit(RenderQueue& queue);
+
+	private:
+		struct ShapeMeshEntry
+		{
+			GeometryAllocation geometry{};
+			Aabb bounds{};
+			ui32 firstInstance{};       // where flush() put the mesh's instances this frame
+			ui32 instanceCount{};
+		};
+
+		void dropDestroyed(const EntityStore& store);
+		void updateBounds(EntityStore& store);
+		// copies every chunk or only the visible rows into the two streams, at most capacity, returns the instance count
+		ui32 gatherInstances(EntityStore& store, bool visibleOnly, ui32 capacity, TransformComponent* transforms,
+			ColorComponent* colors);
+
+	private:
+		GraphicsBackend& m_backend;
+		GeometryArena& m_arena;
+		DynamicUploadRing* m_uploadRing{};
+		PipelineHandle m_pipeline{};
+		std::vector<ShapeMeshEntry> m_meshes{};
+
+		BoundingVolumeHierarchy m_bvh{};                // one box per shape entity, keyed by its slot
+		std::vector<Entity> m_tracked{};                // by slot, the entity the BVH holds the box of
+		std::vector<ui32> m_visible{};                  // slots the last cull found visible
+		std::vector<unsigned char> m_visibleSlots{};    // the same as flags by slot, for the chunk pass
+		CullingStats m_cullingStats{};
+		Frustum m_culledFrustum{};                      // what m_visible was culled against
+		bool m_cullStale{ true };                       // the BVH changed since
+		ui64 m_boundsVersion{};                         // store version the bounds were last brought up to date at
+		ui64 m_structureVersion{};                      // store structure version dropDestroyed last ran at
+		size_t m_shapeCount{};
+
+		BufferHandle m_transformBuffer{};               // dynamic, the instances once they stop changing
+		BufferHandle m_colorBuffer{};
+		ui32 m_instanceCapacity{};
+		std::vector<TransformComponent> m_transformStaging{};
+		std::vector<ColorComponent> m_colorStaging{};
+		VertexBufferBinding m_transformBinding{};       // where this frame's instances are, own buffers or ring
+		VertexBufferBinding m_colorBinding{};
+		bool m_instancesChanged{};                      // since the last flush
+		bool m_ownBuffersStale{};                       // changed since the own buffers were filled
+		bool m_instancesInRing{};                       // the bindings point at ranges that expire with the frame
+	};
+}
@@ -0,0 +1,281 @@
+#include <DX3D/Graphics/Software/Image.h>
+#include <DX3D/Math/Simd.h>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace
+{
+	using namespace dx3d;
+
+	constexpr std::array<ui32, 256> MakeCrcTable() noexcept
+	{
+		std::array<ui32, 256> table{};
+		for (ui32 n = 0; n < 256; n++)
+		{
+			auto c = n;
+			for (ui32 k = 0; k < 8; k++)
+				c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+			table[n] = c;
+		}
+		return table;
+	}
+
+	constexpr auto CrcTable = MakeCrcTable();
+
+	void PutBigEndian(std::vector<unsigned char>& out, ui32 value)
+	{
+		out.push_back(static_cast<unsigned char>(value >> 24));
+		out.push_back(static_cast<unsigned char>(value >> 16));
+		out.push_back(static_cast<unsigned char>(value >> 8));
+		out.push_back(static_cast<unsigned char>(value));
+	}
+
+	void PutChunk(std::vector<unsigned char>& out, const char type[4], const std::vector<unsigned char>& data)
+	{
+		PutBigEndian(out, static_cast<ui32>(data.size()));
+		const auto typeBegin = out.size();
+		out.insert(out.end(), type, type + 4);
+		out.insert(out.end(), data.begin(), data.end());
+		// the chunk CRC covers the type and the data, not the length
+		PutBigEndian(out, ImageIO::Crc32(out.data() + typeBegin, out.size() - typeBegin));
+	}
+
+	bool WriteFile(const std::filesystem::path& path, const void* data, size_t size)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+		return static_cast<bool>(file);
+	}
+
+	// skips whitespace and # comments between the fields of a PPM header
+	bool ReadPpmField(std::istream& in, ui32& value)
+	{
+		for (;;)
+		{
+			const auto c = in.peek();
+			if (c == '#')
+			{
+				std::string comment;
+				std::getline(in, comment);
+			}
+			else if (c == ' ' || c == '\t' || c == '\r' || c == '\n') in.get();
+			else break;
+		}
+		return static_cast<bool>(in >> value);
+	}
+
+	struct DiffTotals
+	{
+		ui64 differingPixels{};
+		ui64 channelSum{};
+		ui32 maxChannelDifference{};
+	};
+
+	// |a - b| per channel into diff, alpha cleared first when ignored
+	void DiffPixels(const ui32* a, const ui32* b, ui32* diff, size_t count,
+		ui32 channelTolerance, bool ignoreAlpha, DiffTotals& totals) noexcept
+	{
+		const ui32 channelMask = ignoreAlpha ? 0x00ffffffu : 0xffffffffu;
+		const auto tolerance = static_cast<unsigned char>(std::min<ui32>(channelTolerance, 255));
+
+		size_t i = 0;
+#if DX3D_SIMD_SSE
+		const __m128i mask = _mm_set1_epi32(static_cast<int>(channelMask));
+		const __m128i opaque = _mm_set1_epi32(static_cast<int>(0xff000000u));
+		const __m128i toleranceBytes = _mm_set1_epi8(static_cast<char>(tolerance));
+		const __m128i zero = _mm_setzero_si128();
+		__m128i maxBytes = zero;
+		__m128i sums = zero;
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+			const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+			// unsigned saturation makes one of the two differences zero, or-ing them is |a - b|
+			const __m128i d = _mm_and_si128(_mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va)), mask);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(diff + i), _mm_or_si128(d, opaque));
+
+			maxBytes = _mm_max_epu8(maxBytes, d);
+			sums = _mm_add_epi64(sums, _mm_sad_epu8(d, zero));
+			// a pixel differs when any byte is still nonzero after taking the tolerance off
+			const __m128i over = _mm_cmpeq_epi32(_mm_subs_epu8(d, toleranceBytes), zero);
+			const auto sameMask = static_cast<ui32>(_mm_movemask_ps(_mm_castsi128_ps(over)));
+			totals.differingPixels += 4 - ((sameMask & 1) + ((sameMask >> 1) & 1) + ((sameMask >> 2) & 1) + (sameMask >> 3));
+		}
+
+		alignas(16) unsigned char maxLanes[16];
+		_mm_store_si128(reinterpret_cast<__m128i*>(maxLanes), maxBytes);
+		for (const auto m : maxLanes)
+			totals.maxChannelDifference = std::max<ui32>(totals.maxChannelDifference, m);
+		alignas(16) ui64 sumLanes[2];
+		_mm_store_si128(reinterpret_cast<__m128i*>(sumLanes), sums);
+		totals.channelSum += sumLanes[0] + sumLanes[1];
+#endif
+		for (; i < count; i++)
+		{
+			const auto pa = a[i] & channelMask, pb = b[i] & channelMask;
+			ui32 d{};
+			bool differs = false;
+			for (ui32 shift = 0; shift < 32; shift += 8)
+			{
+				const auto ca = (pa >> shift) & 0xff, cb = (pb >> shift) & 0xff;
+				const auto channel = ca > cb ? ca - cb : cb - ca;
+				d |= channel << shift;
+				totals.channelSum += channel;
+				totals.maxChannelDifference = std::max(totals.maxChannelDifference, channel);
+				differs |= channel > tolerance;
+			}
+			diff[i] = d | 0xff000000u;
+			totals.differingPixels += differs;
+		}
+	}
+}
+
+bool dx3d::ImageIO::WritePpm(const Image& image, const std::filesystem::path& path)
+{
+	if (image.pixels.size() != static_cast<size_t>(image.width) * image.height)
+		return false;
+
+	char header[64]{};
+	const auto headerSize = std::snprintf(header, sizeof(header), "P6\n%u %u\n255\n", image.width, image.height);
+
+	std::vector<unsigned char> data(header, header + headerSize);
+	data.reserve(data.size() + image.pixels.size() * 3);
+	for (const auto pixel : image.pixels)
+	{
+		data.push_back(static_cast<unsigned char>(pixel));
+		data.push_back(static_cast<unsigned char>(pixel >> 8));
+		data.push_back(static_cast<unsigned char>(pixel >> 16));
+	}
+	return WriteFile(path, data.data(), data.size());
+}
+
+bool dx3d::ImageIO::WritePng(const Image& image, const std::filesystem::path& path)
+{
+	if (!image.width || !image.height || image.pixels.size() != static_cast<size_t>(image.width) * image.height)
+		return false;
+
+	// raw scanlines, each behind filter type 0 (none)
+	const size_t rowSize = static_cast<size_t>(image.width) * 4 + 1;
+	std::vector<unsigned char> raw(rowSize * image.height);
+	for (ui32 y = 0; y < image.height; y++)
+	{
+		raw[y * rowSize] = 0;
+		std::memcpy(&raw[y * rowSize + 1], &image.pixels[static_cast<size_t>(y) * image.width], rowSize - 1);
+	}
+
+	// zlib stream of stored deflate blocks: header, up to 65535 bytes per block, Adler-32 of the raw data
+	constexpr size_t MaxStoredBlock = 65535;
+	std::vector<unsigned char> zlib{ 0x78, 0x01 };
+	zlib.reserve(raw.size() + raw.size() / MaxStoredBlock * 5 + 16);
+	for (size_t offset = 0; offset < raw.size(); offset += MaxStoredBlock)
+	{
+		const auto length = static_cast<ui32>(std::min(MaxStoredBlock, raw.size() - offset));
+		const bool last = offset + length == raw.size();
+		zlib.push_back(last ? 1 : 0);
+		zlib.push_back(static_cast<unsigned char>(length));
+		zlib.push_back(static_cast<unsigned char>(length >> 8));
+		zlib.push_back(static_cast<unsigned char>(~length));
+		zlib.push_back(static_cast<unsigned char>(~length >> 8));
+		zlib.insert(zlib.end(), raw.begin() + static_cast<std::ptrdiff_t>(offset), raw.begin() + static_cast<std::ptrdiff_t>(offset + length));
+	}
+	PutBigEndian(zlib, Adler32(raw.data(), raw.size()));
+
+	std::vector<unsigned char> header{};
+	PutBigEndian(header, image.width);
+	PutBigEndian(header, image.height);
+	header.insert(header.end(), { 8, 6, 0, 0, 0 });    // 8 bit RGBA, deflate, no filtering beyond the per-row byte, no interlace
+
+	std::vector<unsigned char> file{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+	PutChunk(file, "IHDR", header);
+	PutChunk(file, "IDAT", zlib);
+	PutChunk(file, "IEND", {});
+	return WriteFile(path, file.data(), file.size());
+}
+
+bool dx3d::ImageIO::ReadPpm(const std::filesystem::path& path, Image& outImage)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file) return false;
+
+	char magic[2]{};
+	if (!file.read(magic, 2) || magic[0] != 'P' || magic[1] != '6') return false;
+
+	ui32 width{}, height{}, maxValue{};
+	if (!ReadPpmField(file, width) || !ReadPpmField(file, height) || !ReadPpmField(file, maxValue))
+		return false;
+	if (!width || !height || maxValue != 255) return false;
+	file.get();     // the single whitespace between the header and the samples
+
+	std::vector<unsigned char> data(static_cast<size_t>(width) * height * 3);
+	if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())))
+		return false;
+
+	outImage.width = width;
+	outImage.height = height;
+	outImage.pixels.resize(static_cast<size_t>(width) * height);
+	for (size_t i = 0; i < outImage.pixels.size(); i++)
+	{
+		outImage.pixels[i] = data[i * 3] | (static_cast<ui32>(data[i * 3 + 1]) << 8) |
+			(static_cast<ui32>(data[i * 3 + 2]) << 16) | 0xff000000u;
+	}
+	return true;
+}
+
+dx3d::ImageDiff dx3d::ImageIO::Compare(const Image& actual, const Image& expected, ui32 channelTolerance, bool ignoreAlpha)
+{
+	ImageDiff result{};
+	if (actual.width != expected.width || actual.height != expected.height ||
+		actual.pixels.size() != expected.pixels.size())
+	{
+		result.sizeMismatch = true;
+		return result;
+	}
+
+	result.differenceImage.width = actual.width;
+	result.differenceImage.height = actual.height;
+	result.differenceImage.pixels.resize(actual.pixels.size());
+
+	DiffTotals totals{};
+	DiffPixels(actual.pixels.data(), expected.pixels.data(), result.differenceImage.pixels.data(),
+		actual.pixels.size(), channelTolerance, ignoreAlpha, totals);
+
+	result.differingPixels = totals.differingPixels;
+	result.maxChannelDifference = totals.maxChannelDifference;
+	const auto channels = actual.pixels.size() * (ignoreAlpha ? 3 : 4);
+	result.meanChannelDifference = channels ? static_cast<d64>(totals.channelSum) / static_cast<d64>(channels) : 0.0;
+	return result;
+}
+
+dx3d::ui32 dx3d::ImageIO::Crc32(const void* data, size_t size, ui32 crc) noexcept
+{
+	const auto* bytes = static_cast<const unsigned char*>(data);
+	crc = ~crc;
+	for (size_t i = 0; i < size; i++)
+		crc = CrcTable[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+	return ~crc;
+}
+
+dx3d::ui32 dx3d::ImageIO::Adler32(const void* data, size_t size, ui32 adler) noexcept
+{
+	// 5552 bytes is the most that can be summed before the 32 bit sums may overflow
+	const auto* bytes = static_cast<const unsigned char*>(data);
+	ui32 a = adler & 0xffff, b = adler >> 16;
+	while (size)
+	{
+		const auto block = std::min<size_t>(size, 5552);
+		for (size_t i = 0; i < block; i++)
+		{
+			a += bytes[i];
+			b += a;
+		}
+		a %= 65521;
+		b %= 65521;
+		bytes += block;
+		size -= block;
+	}
+	return (b << 16) | a;
+}
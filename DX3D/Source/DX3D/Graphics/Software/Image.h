@@ -0,0 +1,48 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <filesystem>
+#include <vector>
+
+namespace dx3d
+{
+	// 8 bit RGBA pixels, rows top to bottom, each ui32 holds r in its lowest byte (R8G8B8A8_UNORM in memory)
+	struct Image
+	{
+		ui32 width{};
+		ui32 height{};
+		std::vector<ui32> pixels{};
+
+		ui32 getPixel(ui32 x, ui32 y) const noexcept { return pixels[static_cast<size_t>(y) * width + x]; }
+	};
+
+	struct ImageDiff
+	{
+		ui64 differingPixels{};         // pixels with any channel off by more than the tolerance
+		ui32 maxChannelDifference{};
+		d64 meanChannelDifference{};    // over every channel of every pixel
+		bool sizeMismatch{};
+		Image differenceImage{};        // |a - b| per channel with alpha forced to 255, empty on a size mismatch
+
+		bool matches() const noexcept { return !sizeMismatch && !differingPixels; }
+	};
+
+	/*
+	* Dumping and comparing rendered frames, for golden-image tests of the software backend.
+	* PNGs are written with stored (uncompressed) deflate blocks, larger than needed but readable by anything;
+	* PPM is the format goldens are read back from since it needs no decoder.
+	* The writers and readers return false instead of throwing, a missing golden is a test failure, not a crash.
+	*/
+	namespace ImageIO
+	{
+		bool WritePpm(const Image& image, const std::filesystem::path& path);
+		bool WritePng(const Image& image, const std::filesystem::path& path);
+		// binary P6 with a max value of 255, alpha comes back as 255
+		bool ReadPpm(const std::filesystem::path& path, Image& outImage);
+
+		// alpha is compared too, so a golden read from a PPM should be compared with ignoreAlpha
+		ImageDiff Compare(const Image& actual, const Image& expected, ui32 channelTolerance = 0, bool ignoreAlpha = false);
+
+		ui32 Crc32(const void* data, size_t size, ui32 crc = 0) noexcept;
+		ui32 Adler32(const void* data, size_t size, ui32 adler = 1) noexcept;
+	}
+}
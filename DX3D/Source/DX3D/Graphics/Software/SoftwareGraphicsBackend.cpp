@@ -0,0 +1,626 @@
+#include <DX3D/Graphics/Software/SoftwareGraphicsBackend.h>
+#include <DX3D/Graphics/VertexEncoding.h>
+#include <DX3D/Graphics/RenderQueue.h>
+#include <DX3D/Core/Profiler.h>
+#include <DX3D/Core/ThreadPool.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+
+namespace
+{
+	using namespace dx3d;
+
+	struct ShaderInput
+	{
+		const char* semanticName;
+		ui32 semanticIndex;
+	};
+
+	// the semantics the emulated shaders read, in AttributeInput order
+	constexpr ShaderInput ShaderInputs[] = {
+		{ "POSITION", 0 },
+		{ "COLOR", 0 },
+		{ "INSTANCE_TRANSFORM", 0 },
+		{ "INSTANCE_TRANSFORM", 1 },
+		{ "INSTANCE_TRANSFORM", 2 },
+		{ "INSTANCE_TRANSFORM", 3 },
+		{ "INSTANCE_COLOR", 0 },
+	};
+
+	bool IsShader(const char* path, const char* fileName)
+	{
+		return std::filesystem::path(path).filename() == fileName;
+	}
+
+	const ShaderMacro* FindDefine(const std::vector<ShaderMacro>& defines, const char* name)
+	{
+		const auto found = std::find_if(defines.begin(), defines.end(),
+			[name](const ShaderMacro& macro) { return macro.name == name; });
+		return found != defines.end() ? &*found : nullptr;
+	}
+
+	// reads the "float3(x, y, z)" VertexEncoder::GetShaderDefines writes
+	bool ParseFloat3(const ShaderMacro* macro, Vec3& out)
+	{
+		return macro && std::sscanf(macro->definition.c_str(), " float3 ( %f , %f , %f )", &out.x, &out.y, &out.z) == 3;
+	}
+
+	// what the input assembler hands the shader: missing components are 0, 0, 0, 1 like on the GPU
+	Vec4 DecodeVertexFormat(VertexFormat format, const unsigned char* data) noexcept
+	{
+		switch (format)
+		{
+		case VertexFormat::Float2:
+		{
+			f32 v[2];
+			std::memcpy(v, data, sizeof(v));
+			return { v[0], v[1], 0.0f, 1.0f };
+		}
+		case VertexFormat::Float3:
+		{
+			f32 v[3];
+			std::memcpy(v, data, sizeof(v));
+			return { v[0], v[1], v[2], 1.0f };
+		}
+		case VertexFormat::Float4:
+		{
+			Vec4 v;
+			std::memcpy(&v, data, sizeof(v));
+			return v;
+		}
+		case VertexFormat::Half4:
+		{
+			ui16 v[4];
+			std::memcpy(v, data, sizeof(v));
+			return { VertexEncoder::HalfToFloat(v[0]), VertexEncoder::HalfToFloat(v[1]),
+				VertexEncoder::HalfToFloat(v[2]), VertexEncoder::HalfToFloat(v[3]) };
+		}
+		case VertexFormat::Short4Norm:
+		{
+			// -32768 and -32767 both are -1
+			short v[4];
+			std::memcpy(v, data, sizeof(v));
+			auto decode = [](short s) { return std::max(static_cast<f32>(s) / 32767.0f, -1.0f); };
+			return { decode(v[0]), decode(v[1]), decode(v[2]), decode(v[3]) };
+		}
+		case VertexFormat::UByte4Norm:
+			return { data[0] / 255.0f, data[1] / 255.0f, data[2] / 255.0f, data[3] / 255.0f };
+		default:
+			return { 0.0f, 0.0f, 0.0f, 1.0f };
+		}
+	}
+}
+
+dx3d::SoftwareCommandList::SoftwareCommandList(SoftwareGraphicsBackend& backend) :
+	m_backend(backend)
+{
+}
+
+const std::vector<dx3d::RecordedCommand>& dx3d::SoftwareCommandList::getCommands() const noexcept
+{
+	return m_commands;
+}
+
+void dx3d::SoftwareCommandList::reset()
+{
+	m_commands.clear();
+	m_hasPipeline = false;
+	m_hasIndexBuffer = false;
+	resetStats();
+	invalidateState();
+}
+
+void dx3d::SoftwareCommandList::onSetPipeline(PipelineHandle pipeline)
+{
+	m_topology = m_backend.getPipeline(pipeline).topology;
+	m_hasPipeline = true;
+	m_commands.push_back({ RecordedCommandType::SetPipeline, pipeline.id });
+}
+
+void dx3d::SoftwareCommandList::onSetVertexBuffer(ui32 slot, BufferHandle buffer, ui32 stride, ui32 byteOffset)
+{
+	const auto& target = m_backend.getBuffer(buffer);
+	if (target.desc.type != BufferType::Vertex)
+		DX3DLogThrowInvalidArg("Buffer bound as vertex buffer was not created as one.");
+	if (target.mapped) DX3DLogThrowError("Buffer bound while it is still mapped.");
+	if (!stride) DX3DLogThrowInvalidArg("No vertex stride provided.");
+	if (slot >= MaxCachedVertexBuffers) DX3DLogThrowInvalidArg("The software backend has no such vertex buffer slot.");
+
+	m_commands.push_back({ RecordedCommandType::SetVertexBuffer, buffer.id, slot, stride, byteOffset });
+}
+
+void dx3d::SoftwareCommandList::onSetIndexBuffer(BufferHandle buffer, ui32 byteOffset)
+{
+	const auto& target = m_backend.getBuffer(buffer);
+	if (target.desc.type != BufferType::Index)
+		DX3DLogThrowInvalidArg("Buffer bound as index buffer was not created as one.");
+	if (target.mapped) DX3DLogThrowError("Buffer bound while it is still mapped.");
+
+	m_hasIndexBuffer = true;
+	m_commands.push_back({ RecordedCommandType::SetIndexBuffer, buffer.id, 0, sizeof(ui32), byteOffset });
+}
+
+void dx3d::SoftwareCommandList::onSetConstantBuffer(ui32 slot, const ConstantBufferBinding& binding)
+{
+	const auto& target = m_backend.getBuffer(binding.buffer);
+	if (target.desc.type != BufferType::Constant)
+		DX3DLogThrowInvalidArg("Buffer bound as constant buffer was not created as one.");
+	if (target.mapped) DX3DLogThrowError("Buffer bound while it is still mapped.");
+	if (!binding.byteSize || binding.byteSize % ConstantBufferAlignment || binding.byteOffset % ConstantBufferAlignment)
+		DX3DLogThrowInvalidArg("Constant buffer ranges must be non-empty multiples of ConstantBufferAlignment.");
+	if (binding.byteSize > MaxConstantBufferBindingSize)
+		DX3DLogThrowInvalidArg("Constant buffer range is larger than a shader can address.");
+	if (static_cast<ui64>(binding.byteOffset) + binding.byteSize > target.desc.byteWidth)
+		DX3DLogThrowInvalidArg("Constant buffer range is out of bounds.");
+	if (slot >= MaxCachedConstantBuffers) DX3DLogThrowInvalidArg("The software backend has no such constant buffer slot.");
+
+	RecordedCommand command{ RecordedCommandType::SetConstantBuffer, binding.buffer.id, slot };
+	command.byteOffset = binding.byteOffset;
+	command.count = binding.byteSize;
+	m_commands.push_back(command);
+}
+
+void dx3d::SoftwareCommandList::onDraw(ui32 vertexCount, ui32 startVertex)
+{
+	if (!m_hasPipeline) DX3DLogThrowError("Draw issued without a pipeline.");
+
+	RecordedCommand command{ RecordedCommandType::Draw };
+	command.count = vertexCount;
+	command.start = startVertex;
+	m_commands.push_back(command);
+}
+
+void dx3d::SoftwareCommandList::onDrawIndexed(ui32 indexCount, ui32 startIndex, i32 baseVertex)
+{
+	onDrawIndexedInstanced(indexCount, 1, startIndex, baseVertex, 0);
+	m_commands.back().type = RecordedCommandType::DrawIndexed;
+}
+
+void dx3d::SoftwareCommandList::onDrawIndexedInstanced(ui32 indexCount, ui32 instanceCount, ui32 startIndex, i32 baseVertex, ui32 startInstance)
+{
+	if (!m_hasPipeline) DX3DLogThrowError("Draw issued without a pipeline.");
+	if (!m_hasIndexBuffer) DX3DLogThrowError("Indexed draw issued without an index buffer.");
+
+	RecordedCommand command{ RecordedCommandType::DrawIndexedInstanced };
+	command.count = indexCount;
+	command.instanceCount = instanceCount;
+	command.start = startIndex;
+	command.baseVertex = baseVertex;
+	command.startInstance = startInstance;
+	m_commands.push_back(command);
+}
+
+dx3d::Logger& dx3d::SoftwareCommandList::getLogger() const noexcept
+{
+	return m_backend.getLogger();
+}
+
+dx3d::SoftwareGraphicsBackend::SoftwareGraphicsBackend(const SoftwareGraphicsBackendDesc& desc) :
+	GraphicsBackend(desc.base),
+	m_threadPool(desc.threadPool),
+	m_rasterizer(desc.width, desc.height, desc.tileSize)
+{
+	m_rasterizer.resolve(m_frame);
+}
+
+dx3d::SoftwareGraphicsBackend::~SoftwareGraphicsBackend()
+{
+}
+
+dx3d::BufferHandle dx3d::SoftwareGraphicsBackend::createBuffer(const BufferDesc& desc)
+{
+	if (!desc.byteWidth) DX3DLogThrowInvalidArg("No buffer size provided.");
+	if (desc.usage == BufferUsage::Immutable && !desc.initialData)
+		DX3DLogThrowInvalidArg("Immutable buffers need their data at creation.");
+
+	ui32 index{};
+	if (m_freeBuffers.empty())
+	{
+		index = static_cast<ui32>(m_buffers.size());
+		m_buffers.emplace_back();
+	}
+	else
+	{
+		index = m_freeBuffers.back();
+		m_freeBuffers.pop_back();
+	}
+
+	auto& buffer = m_buffers[index];
+	buffer.desc = desc;
+	buffer.desc.initialData = nullptr;
+	buffer.contents.assign(desc.byteWidth, 0);
+	buffer.alive = true;
+	if (desc.initialData)
+	{
+		std::memcpy(buffer.contents.data(), desc.initialData, desc.byteWidth);
+		m_stats.bytesUploaded += desc.byteWidth;
+	}
+
+	m_stats.buffersCreated++;
+	return { index + 1 };
+}
+
+void dx3d::SoftwareGraphicsBackend::updateBuffer(BufferHandle buffer, ui32 byteOffset, const void* data, ui32 byteSize)
+{
+	auto& target = getBuffer(buffer);
+	if (!data || !byteSize) DX3DLogThrowInvalidArg("No buffer data provided.");
+	if (target.desc.usage == BufferUsage::Immutable) DX3DLogThrowInvalidArg("Immutable buffers cannot be updated.");
+	if (target.desc.usage == BufferUsage::Dynamic && byteOffset)
+		DX3DLogThrowInvalidArg("Dynamic buffers are always rewritten from the start.");
+	if (target.mapped) DX3DLogThrowError("Buffer updated while it is mapped.");
+	if (static_cast<ui64>(byteOffset) + byteSize > target.desc.byteWidth)
+		DX3DLogThrowInvalidArg("Buffer update is out of bounds.");
+
+	std::memcpy(target.contents.data() + byteOffset, data, byteSize);
+	m_stats.bytesUploaded += byteSize;
+}
+
+void dx3d::SoftwareGraphicsBackend::destroyBuffer(BufferHandle buffer)
+{
+	auto& target = getBuffer(buffer);
+	target.alive = false;
+	target.mapped = false;
+	target.contents = {};
+	m_freeBuffers.push_back(buffer.id - 1);
+	m_stats.buffersDestroyed++;
+}
+
+void* dx3d::SoftwareGraphicsBackend::mapBuffer(BufferHandle buffer, MapMode)
+{
+	auto& target = getBuffer(buffer);
+	if (target.desc.usage != BufferUsage::Dynamic) DX3DLogThrowInvalidArg("Only dynamic buffers can be mapped.");
+	if (target.mapped) DX3DLogThrowError("Buffer is already mapped.");
+	if (m_inFrame) DX3DLogThrowError("Buffers cannot be mapped while the frame is being recorded.");
+
+	// frames are rendered inside endFrame, nothing reads the buffer later, so both modes are the same here
+	target.mapped = true;
+	return target.contents.data();
+}
+
+void dx3d::SoftwareGraphicsBackend::unmapBuffer(BufferHandle buffer)
+{
+	auto& target = getBuffer(buffer);
+	if (!target.mapped) DX3DLogThrowError("Buffer is not mapped.");
+	target.mapped = false;
+}
+
+dx3d::PipelineHandle dx3d::SoftwareGraphicsBackend::createPipeline(const PipelineDesc& desc)
+{
+	if (!desc.vertexShaderPath) DX3DLogThrowInvalidArg("No vertex shader provided.");
+	if (!desc.pixelShaderPath) DX3DLogThrowInvalidArg("No pixel shader provided.");
+	if (desc.vertexLayout.empty()) DX3DLogThrowInvalidArg("No vertex layout provided.");
+
+	Pipeline pipeline{};
+	if (IsShader(desc.vertexShaderPath, "VertexShader.hlsl")) pipeline.program = VertexProgram::Default;
+	else if (IsShader(desc.vertexShaderPath, "InstancedVertexShader.hlsl")) pipeline.program = VertexProgram::Instanced;
+	else DX3DLogThrowInvalidArg("The software backend cannot run this vertex shader.");
+	if (!IsShader(desc.pixelShaderPath, "PixelShader.hlsl"))
+		DX3DLogThrowInvalidArg("The software backend cannot run this pixel shader.");
+	// the rasterizer has Direct3D's default state built in, and depth states do nothing without a depth buffer
+	if (!(desc.rasterizer == RasterizerState{}) || desc.blendMode != BlendMode::Opaque)
+		DX3DLogThrowInvalidArg("The software backend only runs the default rasterizer state without blending.");
+
+	// like input layout creation on the GPU: every input the shader reads has to be in the layout
+	const ui32 inputCount = pipeline.program == VertexProgram::Instanced ? InputCount : InputTransform0;
+	for (ui32 input = 0; input < inputCount; input++)
+	{
+		const auto found = std::find_if(desc.vertexLayout.begin(), desc.vertexLayout.end(), [input](const VertexAttribute& attribute)
+			{
+				return attribute.semanticName && std::strcmp(attribute.semanticName, ShaderInputs[input].semanticName) == 0 &&
+					attribute.semanticIndex == ShaderInputs[input].semanticIndex;
+			});
+		if (found == desc.vertexLayout.end())
+			DX3DLogThrowInvalidArg("The vertex layout is missing an input the vertex shader reads.");
+		if (found->slot >= GraphicsCommandList::MaxCachedVertexBuffers)
+			DX3DLogThrowInvalidArg("The software backend has no such vertex buffer slot.");
+		pipeline.inputs[input] = static_cast<ui32>(found - desc.vertexLayout.begin());
+	}
+
+	if (FindDefine(desc.vertexShaderDefines, "DX3D_POSITION_SNORM"))
+	{
+		pipeline.snormPositions = true;
+		if (!ParseFloat3(FindDefine(desc.vertexShaderDefines, "DX3D_POSITION_CENTER"), pipeline.positionCenter) ||
+			!ParseFloat3(FindDefine(desc.vertexShaderDefines, "DX3D_POSITION_EXTENT"), pipeline.positionExtent))
+			DX3DLogThrowInvalidArg("DX3D_POSITION_SNORM needs DX3D_POSITION_CENTER and DX3D_POSITION_EXTENT as float3(x, y, z).");
+	}
+
+	pipeline.topology = desc.topology;
+	pipeline.vertexLayout = desc.vertexLayout;
+	pipeline.alive = true;
+
+	ui32 index{};
+	if (m_freePipelines.empty())
+	{
+		index = static_cast<ui32>(m_pipelines.size());
+		m_pipelines.push_back(std::move(pipeline));
+	}
+	else
+	{
+		index = m_freePipelines.back();
+		m_freePipelines.pop_back();
+		m_pipelines[index] = std::move(pipeline);
+	}
+
+	m_stats.pipelinesCreated++;
+	return { index + 1 };
+}
+
+void dx3d::SoftwareGraphicsBackend::destroyPipeline(PipelineHandle pipeline)
+{
+	auto& target = getPipeline(pipeline);
+	target.alive = false;
+	target.vertexLayout = {};
+	m_freePipelines.push_back(pipeline.id - 1);
+}
+
+dx3d::GraphicsCommandList& dx3d::SoftwareGraphicsBackend::beginFrame(const FrameDesc& desc)
+{
+	if (m_inFrame) DX3DLogThrowError("beginFrame called twice without endFrame.");
+	if (!desc.commandListCount) DX3DLogThrowInvalidArg("A frame needs at least one command list.");
+
+	while (m_commandLists.size() < desc.commandListCount)
+		m_commandLists.push_back(std::make_unique<SoftwareCommandList>(*this));
+	for (ui32 i = 0; i < desc.commandListCount; i++)
+		m_commandLists[i]->reset();
+
+	m_rasterizer.clear(desc.clearColor);
+	m_rasterizer.resetStats();
+	m_commandListCount = desc.commandListCount;
+	m_inFrame = true;
+	return *m_commandLists.front();
+}
+
+dx3d::GraphicsCommandList& dx3d::SoftwareGraphicsBackend::getCommandList(ui32 index)
+{
+	if (!m_inFrame || index >= m_commandListCount) DX3DLogThrowInvalidArg("Invalid command list index.");
+	return *m_commandLists[index];
+}
+
+dx3d::ui32 dx3d::SoftwareGraphicsBackend::getCommandListCount() const noexcept
+{
+	return m_commandListCount;
+}
+
+void dx3d::SoftwareGraphicsBackend::endFrame()
+{
+	if (!m_inFrame) DX3DLogThrowError("endFrame called without beginFrame.");
+	m_inFrame = false;
+
+	GraphicsCommandListStats frameStats{};
+	{
+		DX3DProfileZone("Software::render");
+		for (ui32 i = 0; i < m_commandListCount; i++)
+		{
+			const auto& commandList = *m_commandLists[i];
+			frameStats += commandList.getStats();
+			execute(commandList.getCommands());
+		}
+		m_rasterizer.flush(m_threadPool);
+		m_rasterizer.resolve(m_frame);
+	}
+
+	m_lastFrameStats = m_rasterizer.getStats();
+	addFrameStats(frameStats);
+}
+
+dx3d::ui64 dx3d::SoftwareGraphicsBackend::getCompletedFrameCount()
+{
+	return getSubmittedFrameCount();
+}
+
+const dx3d::Image& dx3d::SoftwareGraphicsBackend::getFrame() const noexcept
+{
+	return m_frame;
+}
+
+const dx3d::RasterizerStats& dx3d::SoftwareGraphicsBackend::getRasterizerStats() const noexcept
+{
+	return m_lastFrameStats;
+}
+
+dx3d::SoftwareGraphicsBackend::Buffer& dx3d::SoftwareGraphicsBackend::getBuffer(BufferHandle buffer)
+{
+	if (!buffer || buffer.id > m_buffers.size() || !m_buffers[buffer.id - 1].alive)
+		DX3DLogThrowInvalidArg("Invalid buffer handle.");
+	return m_buffers[buffer.id - 1];
+}
+
+const dx3d::SoftwareGraphicsBackend::Buffer& dx3d::SoftwareGraphicsBackend::getBuffer(BufferHandle buffer) const
+{
+	return const_cast<SoftwareGraphicsBackend*>(this)->getBuffer(buffer);
+}
+
+dx3d::SoftwareGraphicsBackend::Pipeline& dx3d::SoftwareGraphicsBackend::getPipeline(PipelineHandle pipeline)
+{
+	if (!pipeline || pipeline.id > m_pipelines.size() || !m_pipelines[pipeline.id - 1].alive)
+		DX3DLogThrowInvalidArg("Invalid pipeline handle.");
+	return m_pipelines[pipeline.id - 1];
+}
+
+const dx3d::SoftwareGraphicsBackend::Pipeline& dx3d::SoftwareGraphicsBackend::getPipeline(PipelineHandle pipeline) const
+{
+	return const_cast<SoftwareGraphicsBackend*>(this)->getPipeline(pipeline);
+}
+
+void dx3d::SoftwareGraphicsBackend::execute(const std::vector<RecordedCommand>& commands)
+{
+	// every command list starts from the default state, like a deferred context
+	DrawState state{};
+	for (const auto& command : commands)
+	{
+		switch (command.type)
+		{
+		case RecordedCommandType::SetPipeline:
+			state.pipeline = &getPipeline({ command.handle });
+			break;
+		case RecordedCommandType::SetVertexBuffer:
+			state.vertexBuffers[command.slot] = { { command.handle }, command.stride, command.byteOffset };
+			break;
+		case RecordedCommandType::SetIndexBuffer:
+			state.indexBuffer = { command.handle };
+			state.indexByteOffset = command.byteOffset;
+			break;
+		case RecordedCommandType::SetConstantBuffer:
+			state.constantBuffers[command.slot] = { { command.handle }, command.byteOffset, command.count };
+			break;
+		case RecordedCommandType::Draw:
+		{
+			readConstants(state);
+			if (m_sequentialIndices.size() < static_cast<size_t>(command.start) + command.count)
+			{
+				m_sequentialIndices.resize(static_cast<size_t>(command.start) + command.count);
+				std::iota(m_sequentialIndices.begin(), m_sequentialIndices.end(), 0u);
+			}
+			drawPrimitives(state, m_sequentialIndices.data() + command.start, command.count, 0, 1, 0);
+			break;
+		}
+		case RecordedCommandType::DrawIndexed:
+		case RecordedCommandType::DrawIndexedInstanced:
+		{
+			const auto& indexBuffer = getBuffer(state.indexBuffer);
+			const auto end = state.indexByteOffset + (static_cast<ui64>(command.start) + command.count) * sizeof(ui32);
+			if (end > indexBuffer.desc.byteWidth)
+				DX3DLogThrowInvalidArg("Indexed draw reads past the end of the index buffer.");
+
+			readConstants(state);
+			const auto* indices = reinterpret_cast<const ui32*>(indexBuffer.contents.data() + state.indexByteOffset) + command.start;
+			const auto instanceCount = command.type == RecordedCommandType::DrawIndexed ? 1 : command.instanceCount;
+			drawPrimitives(state, indices, command.count, command.baseVertex, instanceCount, command.startInstance);
+			break;
+		}
+		}
+	}
+}
+
+void dx3d::SoftwareGraphicsBackend::readConstants(DrawState& state)
+{
+	state.viewProjection = readConstantMatrix(state, FrameConstantsSlot);
+	if (state.pipeline->program == VertexProgram::Default)
+		state.world = readConstantMatrix(state, ObjectConstantsSlot);
+}
+
+dx3d::Mat4 dx3d::SoftwareGraphicsBackend::readConstantMatrix(const DrawState& state, ui32 slot)
+{
+	// both cbuffers start with a row_major float4x4, laid out like Mat4
+	const auto& binding = state.constantBuffers[slot];
+	if (!binding.buffer) DX3DLogThrowError("Draw reads a constant buffer slot nothing is bound to.");
+	if (binding.byteSize < sizeof(Mat4)) DX3DLogThrowInvalidArg("Constant buffer range is smaller than the shader reads.");
+
+	Mat4 matrix{};
+	std::memcpy(&matrix, getBuffer(binding.buffer).contents.data() + binding.byteOffset, sizeof(Mat4));
+	return matrix;
+}
+
+void dx3d::SoftwareGraphicsBackend::drawPrimitives(const DrawState& state, const ui32* indices, ui32 count, i32 baseVertex,
+	ui32 instanceCount, ui32 startInstance)
+{
+	const auto topology = state.pipeline->topology;
+	if (topology == PrimitiveTopology::LineList)
+		return;
+
+	// shade the index range once per instance (like a post-transform cache would) unless the indices
+	// are spread so thin that shading every index is less work
+	const auto [lowest, highest] = std::minmax_element(indices, indices + count);
+	const ui32 first = count ? *lowest : 0;
+	const ui32 rangeSize = count ? *highest - first + 1 : 0;
+	const bool shadeRange = rangeSize <= count;
+	m_shadedVertices.resize(shadeRange ? rangeSize : count);
+	m_assembledVertices.resize(count);
+
+	for (ui32 instance = startInstance; instance < startInstance + instanceCount; instance++)
+	{
+		if (shadeRange)
+		{
+			for (ui32 i = 0; i < rangeSize; i++)
+				m_shadedVertices[i] = shadeVertex(state, static_cast<ui32>(static_cast<i32>(first + i) + baseVertex), instance);
+			for (ui32 i = 0; i < count; i++)
+				m_assembledVertices[i] = &m_shadedVertices[indices[i] - first];
+		}
+		else
+		{
+			for (ui32 i = 0; i < count; i++)
+			{
+				m_shadedVertices[i] = shadeVertex(state, static_cast<ui32>(static_cast<i32>(indices[i]) + baseVertex), instance);
+				m_assembledVertices[i] = &m_shadedVertices[i];
+			}
+		}
+
+		const auto& v = m_assembledVertices;
+		if (topology == PrimitiveTopology::TriangleList)
+		{
+			for (ui32 i = 0; i + 2 < count; i += 3)
+				m_rasterizer.addTriangle(*v[i], *v[i + 1], *v[i + 2]);
+		}
+		else
+		{
+			// every other strip triangle runs the other way round, swapping its first two corners keeps the winding
+			for (ui32 i = 0; i + 2 < count; i++)
+			{
+				if (i & 1) m_rasterizer.addTriangle(*v[i + 1], *v[i], *v[i + 2]);
+				else m_rasterizer.addTriangle(*v[i], *v[i + 1], *v[i + 2]);
+			}
+		}
+	}
+}
+
+dx3d::Vec4 dx3d::SoftwareGraphicsBackend::fetchAttribute(const DrawState& state, ui32 input, ui32 vertex, ui32 instance)
+{
+	const auto& attribute = state.pipeline->vertexLayout[state.pipeline->inputs[input]];
+	const auto& binding = state.vertexBuffers[attribute.slot];
+	if (!binding.buffer) DX3DLogThrowError("Draw reads a vertex buffer slot nothing is bound to.");
+
+	const auto& buffer = getBuffer(binding.buffer);
+	const auto element = attribute.inputRate == VertexInputRate::PerInstance ? instance : vertex;
+	const auto offset = binding.byteOffset + static_cast<ui64>(element) * binding.stride + attribute.offset;
+	if (offset + GetVertexFormatSize(attribute.format) > buffer.contents.size())
+		DX3DLogThrowInvalidArg("Draw reads past the end of a vertex buffer.");
+
+	return DecodeVertexFormat(attribute.format, buffer.contents.data() + offset);
+}
+
+dx3d::RasterVertex dx3d::SoftwareGraphicsBackend::shadeVertex(const DrawState& state, ui32 vertex, ui32 instance)
+{
+	const auto& pipeline = *state.pipeline;
+
+	// DecodePosition() of the shaders
+	const auto input = fetchAttribute(state, InputPosition, vertex, instance);
+	Vec3 position{ input.x, input.y, input.z };
+	if (pipeline.snormPositions)
+	{
+		position = {
+			position.x * pipeline.positionExtent.x + pipeline.positionCenter.x,
+			position.y * pipeline.positionExtent.y + pipeline.positionCenter.y,
+			position.z * pipeline.positionExtent.z + pipeline.positionCenter.z
+		};
+	}
+
+	RasterVertex output{};
+	output.color = fetchAttribute(state, InputColor, vertex, instance);
+	// mul(float4(position, 1), m): the rows of m weighted by the components
+	auto transform = [](const Vec4& p, const Mat4& m)
+		{
+			return Vec4{ m.m[0][0], m.m[0][1], m.m[0][2], m.m[0][3] } * p.x + Vec4{ m.m[1][0], m.m[1][1], m.m[1][2], m.m[1][3] } * p.y +
+				Vec4{ m.m[2][0], m.m[2][1], m.m[2][2], m.m[2][3] } * p.z + Vec4{ m.m[3][0], m.m[3][1], m.m[3][2], m.m[3][3] } * p.w;
+		};
+
+	if (pipeline.program == VertexProgram::Default)
+	{
+		output.position = transform(transform({ position, 1.0f }, state.world), state.viewProjection);
+		return output;
+	}
+
+	// the instance's world matrix comes in as four rows
+	const auto row0 = fetchAttribute(state, InputTransform0, vertex, instance);
+	const auto row1 = fetchAttribute(state, InputTransform1, vertex, instance);
+	const auto row2 = fetchAttribute(state, InputTransform2, vertex, instance);
+	const auto row3 = fetchAttribute(state, InputTransform3, vertex, instance);
+	output.position = transform(row0 * position.x + row1 * position.y + row2 * position.z + row3, state.viewProjection);
+
+	// a negative red channel means "no color given", keep the mesh colors and only take the alpha
+	const auto instanceColor = fetchAttribute(state, InputInstanceColor, vertex, instance);
+	output.color = instanceColor.x < 0.0f ? Vec4{ output.color.x, output.color.y, output.color.z, instanceColor.w } : instanceColor;
+	return output;
+}
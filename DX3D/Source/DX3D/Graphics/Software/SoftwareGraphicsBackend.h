@@ -0,0 +1,177 @@
+#pragma once
+#include <DX3D/Graphics/GraphicsBackend.h>
+#include <DX3D/Graphics/Null/NullGraphicsBackend.h>
+#include <DX3D/Graphics/Software/Image.h>
+#include <DX3D/Graphics/Software/SoftwareRasterizer.h>
+#include <DX3D/Math/Mat4.h>
+#include <memory>
+#include <vector>
+
+namespace dx3d
+{
+	class SoftwareGraphicsBackend;
+	class ThreadPool;
+
+	struct SoftwareGraphicsBackendDesc
+	{
+		BaseDesc base;
+		ui32 width{ 1280 };
+		ui32 height{ 720 };
+		ui32 tileSize{ 64 };            // pixels per tile side, rounded up to a multiple of 4
+		ThreadPool* threadPool{};       // tiles are rasterized on it, on the thread calling endFrame without one
+	};
+
+	class SoftwareCommandList final : public GraphicsCommandList
+	{
+	public:
+		explicit SoftwareCommandList(SoftwareGraphicsBackend& backend);
+
+		const std::vector<RecordedCommand>& getCommands() const noexcept;
+		void reset();
+
+	protected:
+		virtual void onSetPipeline(PipelineHandle pipeline) override;
+		virtual void onSetVertexBuffer(ui32 slot, BufferHandle buffer, ui32 stride, ui32 byteOffset) override;
+		virtual void onSetIndexBuffer(BufferHandle buffer, ui32 byteOffset) override;
+		virtual void onSetConstantBuffer(ui32 slot, const ConstantBufferBinding& binding) override;
+		virtual void onDraw(ui32 vertexCount, ui32 startVertex) override;
+		virtual void onDrawIndexed(ui32 indexCount, ui32 startIndex, i32 baseVertex) override;
+		virtual void onDrawIndexedInstanced(ui32 indexCount, ui32 instanceCount, ui32 startIndex, i32 baseVertex, ui32 startInstance) override;
+
+	private:
+		Logger& getLogger() const noexcept;
+
+	private:
+		SoftwareGraphicsBackend& m_backend;
+		std::vector<RecordedCommand> m_commands{};
+		bool m_hasPipeline{};
+		bool m_hasIndexBuffer{};
+	};
+
+	/*
+	* Graphics backend that renders on the CPU into an in-memory RGBA8 frame, for headless runs that need
+	* actual pixels: golden-image tests and checking what the GPU path should show.
+	*
+	* Buffers and pipelines behave like in NullGraphicsBackend. The command lists only record; endFrame
+	* replays them in index order through an input assembler that decodes every VertexFormat, an emulation
+	* of the engine's vertex shaders (VertexShader.hlsl and InstancedVertexShader.hlsl, including the
+	* DX3D_POSITION_SNORM decode selected through the pipeline's defines and the matrices they read from their
+	* constant buffers) and SoftwareRasterizer, which
+	* writes the interpolated color the way PixelShader.hlsl does. Other shaders are rejected when the
+	* pipeline is created, line lists are accepted and not drawn.
+	*/
+	class SoftwareGraphicsBackend final : public GraphicsBackend
+	{
+	public:
+		explicit SoftwareGraphicsBackend(const SoftwareGraphicsBackendDesc& desc);
+		virtual ~SoftwareGraphicsBackend() override;
+
+		virtual BufferHandle createBuffer(const BufferDesc& desc) override;
+		virtual void updateBuffer(BufferHandle buffer, ui32 byteOffset, const void* data, ui32 byteSize) override;
+		virtual void destroyBuffer(BufferHandle buffer) override;
+		virtual void* mapBuffer(BufferHandle buffer, MapMode mode) override;
+		virtual void unmapBuffer(BufferHandle buffer) override;
+
+		virtual PipelineHandle createPipeline(const PipelineDesc& desc) override;
+		virtual void destroyPipeline(PipelineHandle pipeline) override;
+
+		virtual GraphicsCommandList& beginFrame(const FrameDesc& desc) override;
+		virtual GraphicsCommandList& getCommandList(ui32 index) override;
+		virtual ui32 getCommandListCount() const noexcept override;
+		// renders the frame before returning, so every submitted frame is also completed
+		virtual void endFrame() override;
+		virtual ui64 getCompletedFrameCount() override;
+
+		// the last finished frame
+		const Image& getFrame() const noexcept;
+		// of the last finished frame
+		const RasterizerStats& getRasterizerStats() const noexcept;
+
+	private:
+		struct Buffer
+		{
+			BufferDesc desc{};
+			std::vector<unsigned char> contents{};
+			bool alive{};
+			bool mapped{};
+		};
+
+		enum class VertexProgram
+		{
+			Default = 0,    // VertexShader.hlsl
+			Instanced       // InstancedVertexShader.hlsl
+		};
+
+		// the attributes the vertex shader reads, resolved against the layout once at creation
+		enum AttributeInput : ui32
+		{
+			InputPosition = 0,
+			InputColor,
+			InputTransform0,
+			InputTransform1,
+			InputTransform2,
+			InputTransform3,
+			InputInstanceColor,
+			InputCount
+		};
+
+		struct Pipeline
+		{
+			PrimitiveTopology topology{};
+			std::vector<VertexAttribute> vertexLayout{};
+			VertexProgram program{};
+			ui32 inputs[InputCount]{};          // index into vertexLayout
+			bool snormPositions{};
+			Vec3 positionCenter{};
+			Vec3 positionExtent{ 1.0f, 1.0f, 1.0f };
+			bool alive{};
+		};
+
+		// what the replay has bound while walking the recorded commands
+		struct DrawState
+		{
+			const Pipeline* pipeline{};
+			VertexBufferBinding vertexBuffers[GraphicsCommandList::MaxCachedVertexBuffers]{};
+			BufferHandle indexBuffer{};
+			ui32 indexByteOffset{};
+			ConstantBufferBinding constantBuffers[GraphicsCommandList::MaxCachedConstantBuffers]{};
+			// read from the constant buffers once per draw, for the vertex program
+			Mat4 viewProjection{};
+			Mat4 world{};
+		};
+
+		Buffer& getBuffer(BufferHandle buffer);
+		const Buffer& getBuffer(BufferHandle buffer) const;
+		Pipeline& getPipeline(PipelineHandle pipeline);
+		const Pipeline& getPipeline(PipelineHandle pipeline) const;
+
+		void execute(const std::vector<RecordedCommand>& commands);
+		// the cbuffers of the vertex program into state.viewProjection and state.world
+		void readConstants(DrawState& state);
+		Mat4 readConstantMatrix(const DrawState& state, ui32 slot);
+		void drawPrimitives(const DrawState& state, const ui32* indices, ui32 count, i32 baseVertex,
+			ui32 instanceCount, ui32 startInstance);
+		Vec4 fetchAttribute(const DrawState& state, ui32 input, ui32 vertex, ui32 instance);
+		RasterVertex shadeVertex(const DrawState& state, ui32 vertex, ui32 instance);
+
+	private:
+		std::vector<Buffer> m_buffers{};
+		std::vector<ui32> m_freeBuffers{};
+		std::vector<Pipeline> m_pipelines{};
+		std::vector<ui32> m_freePipelines{};
+
+		ThreadPool* m_threadPool{};
+		SoftwareRasterizer m_rasterizer;
+		Image m_frame{};
+		RasterizerStats m_lastFrameStats{};
+
+		std::vector<std::unique_ptr<SoftwareCommandList>> m_commandLists{};
+		ui32 m_commandListCount{};
+		std::vector<ui32> m_sequentialIndices{};    // 0, 1, 2, ... for the non-indexed draws
+		std::vector<RasterVertex> m_shadedVertices{};
+		std::vector<const RasterVertex*> m_assembledVertices{};     // per index of the draw, into m_shadedVertices
+		bool m_inFrame{};
+
+		friend class SoftwareCommandList;
+	};
+}
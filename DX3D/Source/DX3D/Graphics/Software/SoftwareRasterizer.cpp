@@ -0,0 +1,435 @@
+#include <DX3D/Graphics/Software/SoftwareRasterizer.h>
+#include <DX3D/Core/ThreadPool.h>
+#include <DX3D/Math/Simd.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+	using namespace dx3d;
+
+	// clip space planes as (x, y, z, w) weights, a vertex is inside when the dot product is >= 0.
+	// x and y only clip against a guard band 4 times the viewport, which keeps the screen space
+	// coordinates small enough for the edge functions while sparing most triangles the clipper
+	constexpr f32 GuardBand = 4.0f;
+	constexpr ui32 ClipPlaneCount = 6;
+	constexpr f32 ClipPlanes[ClipPlaneCount][4] = {
+		{ 0.0f, 0.0f, 1.0f, 0.0f },         // z >= 0
+		{ 0.0f, 0.0f, -1.0f, 1.0f },        // z <= w
+		{ 1.0f, 0.0f, 0.0f, GuardBand },
+		{ -1.0f, 0.0f, 0.0f, GuardBand },
+		{ 0.0f, 1.0f, 0.0f, GuardBand },
+		{ 0.0f, -1.0f, 0.0f, GuardBand },
+	};
+
+	// a triangle clipped by six planes has at most nine corners
+	constexpr ui32 MaxClippedVertices = 9;
+
+	// vertices are snapped to 1/256 pixel like the D3D rasterizer does, so tiny moves do not flicker the edges
+	constexpr f32 SubpixelSteps = 256.0f;
+
+	inline f32 PlaneDistance(const f32 plane[4], const Vec4& p) noexcept
+	{
+		return plane[0] * p.x + plane[1] * p.y + plane[2] * p.z + plane[3] * p.w;
+	}
+
+	inline ui32 GetOutcode(const Vec4& p) noexcept
+	{
+		ui32 code{};
+		for (ui32 plane = 0; plane < ClipPlaneCount; plane++)
+			code |= (PlaneDistance(ClipPlanes[plane], p) < 0.0f) << plane;
+		return code;
+	}
+
+	inline RasterVertex Lerp(const RasterVertex& a, const RasterVertex& b, f32 t) noexcept
+	{
+		return { a.position + (b.position - a.position) * t, a.color + (b.color - a.color) * t };
+	}
+
+	// Sutherland-Hodgman against the planes in clipMask, returns the corner count of the remaining polygon
+	ui32 ClipPolygon(RasterVertex* polygon, ui32 count, ui32 clipMask) noexcept
+	{
+		RasterVertex scratch[MaxClippedVertices];
+		for (ui32 plane = 0; plane < ClipPlaneCount && count; plane++)
+		{
+			if (!(clipMask & (1u << plane)))
+				continue;
+
+			ui32 outCount{};
+			for (ui32 i = 0; i < count; i++)
+			{
+				const auto& current = polygon[i];
+				const auto& next = polygon[(i + 1) % count];
+				const auto dCurrent = PlaneDistance(ClipPlanes[plane], current.position);
+				const auto dNext = PlaneDistance(ClipPlanes[plane], next.position);
+
+				if (dCurrent >= 0.0f)
+					scratch[outCount++] = current;
+				// always measured from the inside corner, so a neighbor clipping the same edge gets the same point
+				if (dCurrent >= 0.0f && dNext < 0.0f)
+					scratch[outCount++] = Lerp(current, next, dCurrent / (dCurrent - dNext));
+				else if (dCurrent < 0.0f && dNext >= 0.0f)
+					scratch[outCount++] = Lerp(next, current, dNext / (dNext - dCurrent));
+			}
+			std::copy(scratch, scratch + outCount, polygon);
+			count = outCount;
+		}
+		return count;
+	}
+
+	inline f32 Snap(f32 value) noexcept
+	{
+		return std::nearbyint(value * SubpixelSteps) * (1.0f / SubpixelSteps);
+	}
+
+	// canonical order of an edge's end points, so both triangles sharing it set it up from the same one
+	inline bool IsCanonical(f32 ax, f32 ay, f32 bx, f32 by) noexcept
+	{
+		return ay < by || (ay == by && ax < bx);
+	}
+
+	// float -> R8G8B8A8_UNORM: saturate (NaN becomes 0), scale, round to nearest even
+	inline ui32 PackUnorm(f32 value) noexcept
+	{
+		value = value > 0.0f ? value : 0.0f;
+		value = value < 1.0f ? value : 1.0f;
+		return static_cast<ui32>(std::nearbyint(value * 255.0f));
+	}
+
+	inline ui32 PackColor(const Vec4& color) noexcept
+	{
+		return PackUnorm(color.x) | (PackUnorm(color.y) << 8) | (PackUnorm(color.z) << 16) | (PackUnorm(color.w) << 24);
+	}
+}
+
+dx3d::SoftwareRasterizer::SoftwareRasterizer(ui32 width, ui32 height, ui32 tileSize) :
+	m_width(width),
+	m_height(height),
+	m_stride((width + 3) & ~3u),
+	m_tileSize((std::max(tileSize, 4u) + 3) & ~3u)
+{
+	if (!width || !height) throw std::invalid_argument("The software render target needs a size.");
+	// keeps every coordinate inside the guard band small enough for float edge functions to stay exact near the edges
+	if (width > 8192 || height > 8192) throw std::invalid_argument("The software render target is limited to 8192 x 8192.");
+
+	m_tilesX = (m_width + m_tileSize - 1) / m_tileSize;
+	m_tilesY = (m_height + m_tileSize - 1) / m_tileSize;
+	m_color.assign(static_cast<size_t>(m_stride) * m_height, 0);
+	m_bins.resize(static_cast<size_t>(m_tilesX) * m_tilesY);
+	m_tileStats.resize(m_bins.size());
+}
+
+void dx3d::SoftwareRasterizer::clear(const Vec4& color)
+{
+	std::fill(m_color.begin(), m_color.end(), PackColor(color));
+}
+
+void dx3d::SoftwareRasterizer::addTriangle(const RasterVertex& a, const RasterVertex& b, const RasterVertex& c)
+{
+	m_stats.trianglesSubmitted++;
+
+	const auto codeA = GetOutcode(a.position), codeB = GetOutcode(b.position), codeC = GetOutcode(c.position);
+	if (codeA & codeB & codeC)
+	{
+		// all three corners behind the same plane
+		m_stats.trianglesCulled++;
+		return;
+	}
+
+	RasterVertex polygon[MaxClippedVertices] = { a, b, c };
+	if (!(codeA | codeB | codeC))
+	{
+		setupTriangle(polygon);
+		return;
+	}
+
+	m_stats.trianglesClipped++;
+	const auto count = ClipPolygon(polygon, 3, codeA | codeB | codeC);
+	if (count < 3)
+	{
+		m_stats.trianglesCulled++;
+		return;
+	}
+
+	// the clipped polygon is convex and keeps the winding, fan it out from the first corner
+	for (ui32 i = 1; i + 1 < count; i++)
+	{
+		const RasterVertex fan[3] = { polygon[0], polygon[i], polygon[i + 1] };
+		setupTriangle(fan);
+	}
+}
+
+void dx3d::SoftwareRasterizer::flush(ThreadPool* threadPool)
+{
+	const auto tileCount = static_cast<ui32>(m_bins.size());
+	auto rasterize = [this](ui32 tile)
+		{
+			m_tileStats[tile] = {};
+			rasterizeTile(tile, m_tileStats[tile]);
+		};
+
+	// every tile owns its pixels, so the tiles need no synchronization between them
+	if (threadPool && tileCount > 1) threadPool->parallelFor(tileCount, rasterize);
+	else for (ui32 tile = 0; tile < tileCount; tile++) rasterize(tile);
+
+	for (ui32 tile = 0; tile < tileCount; tile++)
+	{
+		m_stats += m_tileStats[tile];
+		m_bins[tile].clear();
+	}
+	m_triangles.clear();
+}
+
+void dx3d::SoftwareRasterizer::resolve(Image& image) const
+{
+	image.width = m_width;
+	image.height = m_height;
+	image.pixels.resize(static_cast<size_t>(m_width) * m_height);
+	for (ui32 y = 0; y < m_height; y++)
+	{
+		std::copy_n(m_color.begin() + static_cast<std::ptrdiff_t>(y) * m_stride, m_width,
+			image.pixels.begin() + static_cast<std::ptrdiff_t>(y) * m_width);
+	}
+}
+
+dx3d::ui32 dx3d::SoftwareRasterizer::getWidth() const noexcept
+{
+	return m_width;
+}
+
+dx3d::ui32 dx3d::SoftwareRasterizer::getHeight() const noexcept
+{
+	return m_height;
+}
+
+const dx3d::RasterizerStats& dx3d::SoftwareRasterizer::getStats() const noexcept
+{
+	return m_stats;
+}
+
+void dx3d::SoftwareRasterizer::resetStats() noexcept
+{
+	m_stats = {};
+}
+
+void dx3d::SoftwareRasterizer::setupTriangle(const RasterVertex* vertices)
+{
+	SetupTriangle triangle{};
+	f32 x[3], y[3];
+	for (ui32 i = 0; i < 3; i++)
+	{
+		const auto& p = vertices[i].position;
+		if (!(p.w > 0.0f))
+		{
+			// only possible for a corner sitting exactly on the eye after clipping, it has no area on screen
+			m_stats.trianglesCulled++;
+			return;
+		}
+		// viewport transform: x -1..1 -> 0..width, y 1..-1 -> 0..height
+		const auto invW = 1.0f / p.w;
+		x[i] = Snap((p.x * invW + 1.0f) * 0.5f * static_cast<f32>(m_width));
+		y[i] = Snap((1.0f - p.y * invW) * 0.5f * static_cast<f32>(m_height));
+		triangle.invW[i] = invW;
+		triangle.colorOverW[i] = vertices[i].color * invW;
+	}
+
+	// positive for triangles that run clockwise on screen, the front faces of the default rasterizer state
+	const auto area = (x[2] - x[1]) * (y[0] - y[1]) - (y[2] - y[1]) * (x[0] - x[1]);
+	if (!(area > 0.0f))
+	{
+		m_stats.trianglesCulled++;
+		return;
+	}
+	triangle.invArea = 1.0f / area;
+
+	for (ui32 edge = 0; edge < 3; edge++)
+	{
+		// edge i runs from vertex i + 1 to vertex i + 2, opposite vertex i
+		auto from = (edge + 1) % 3, to = (edge + 2) % 3;
+		triangle.edgeSign[edge] = 1.0f;
+		if (!IsCanonical(x[from], y[from], x[to], y[to]))
+		{
+			std::swap(from, to);
+			triangle.edgeSign[edge] = -1.0f;
+		}
+		triangle.edgeA[edge] = y[from] - y[to];
+		triangle.edgeB[edge] = x[to] - x[from];
+		triangle.originX[edge] = x[from];
+		triangle.originY[edge] = y[from];
+
+		// the gradient points inside: a left edge has the triangle to its right, a top edge has it below
+		const auto gradientX = triangle.edgeSign[edge] * triangle.edgeA[edge];
+		const auto gradientY = triangle.edgeSign[edge] * triangle.edgeB[edge];
+		triangle.edgeTopLeft[edge] = gradientX > 0.0f || (gradientX == 0.0f && gradientY > 0.0f);
+	}
+
+	// pixels whose centers (x + .5) can be inside
+	const auto minX = std::min({ x[0], x[1], x[2] }), maxX = std::max({ x[0], x[1], x[2] });
+	const auto minY = std::min({ y[0], y[1], y[2] }), maxY = std::max({ y[0], y[1], y[2] });
+	triangle.minX = std::max(static_cast<i32>(std::ceil(minX - 0.5f)), 0);
+	triangle.minY = std::max(static_cast<i32>(std::ceil(minY - 0.5f)), 0);
+	triangle.maxX = std::min(static_cast<i32>(std::floor(maxX - 0.5f)), static_cast<i32>(m_width) - 1);
+	triangle.maxY = std::min(static_cast<i32>(std::floor(maxY - 0.5f)), static_cast<i32>(m_height) - 1);
+	if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+	{
+		m_stats.trianglesCulled++;
+		return;
+	}
+
+	const auto index = static_cast<ui32>(m_triangles.size());
+	m_triangles.push_back(triangle);
+	m_stats.trianglesRasterized++;
+
+	const auto tileSize = static_cast<i32>(m_tileSize);
+	for (auto tileY = triangle.minY / tileSize; tileY <= triangle.maxY / tileSize; tileY++)
+	{
+		for (auto tileX = triangle.minX / tileSize; tileX <= triangle.maxX / tileSize; tileX++)
+		{
+			// skip tiles that lie completely outside one edge: test the pixel center of the tile rectangle
+			// farthest along the edge's inside direction, with some slack so rounding never drops a pixel
+			const auto left = static_cast<f32>(std::max(tileX * tileSize, triangle.minX)) + 0.5f;
+			const auto top = static_cast<f32>(std::max(tileY * tileSize, triangle.minY)) + 0.5f;
+			const auto right = static_cast<f32>(std::min(tileX * tileSize + tileSize - 1, triangle.maxX)) + 0.5f;
+			const auto bottom = static_cast<f32>(std::min(tileY * tileSize + tileSize - 1, triangle.maxY)) + 0.5f;
+
+			bool outside = false;
+			for (ui32 edge = 0; edge < 3 && !outside; edge++)
+			{
+				const auto a = triangle.edgeSign[edge] * triangle.edgeA[edge];
+				const auto b = triangle.edgeSign[edge] * triangle.edgeB[edge];
+				const auto px = a > 0.0f ? right : left;
+				const auto py = b > 0.0f ? bottom : top;
+				const auto e = a * (px - triangle.originX[edge]) + b * (py - triangle.originY[edge]);
+				outside = e < -1e-3f * (std::fabs(a) + std::fabs(b));
+			}
+			if (outside)
+				continue;
+
+			m_bins[static_cast<size_t>(tileY) * m_tilesX + tileX].push_back(index);
+			m_stats.tileBins++;
+		}
+	}
+}
+
+void dx3d::SoftwareRasterizer::rasterizeTile(ui32 tileIndex, RasterizerStats& stats)
+{
+	const auto tileX = static_cast<i32>(tileIndex % m_tilesX), tileY = static_cast<i32>(tileIndex / m_tilesX);
+	const auto size = static_cast<i32>(m_tileSize);
+	const auto x0 = tileX * size, y0 = tileY * size;
+	const auto x1 = std::min(x0 + size, static_cast<i32>(m_width)) - 1;
+	const auto y1 = std::min(y0 + size, static_cast<i32>(m_height)) - 1;
+
+	for (const auto triangle : m_bins[tileIndex])
+		rasterizeTriangle(m_triangles[triangle], x0, y0, x1, y1, stats);
+}
+
+void dx3d::SoftwareRasterizer::rasterizeTriangle(const SetupTriangle& t, i32 x0, i32 y0, i32 x1, i32 y1, RasterizerStats& stats)
+{
+	const auto startX = std::max(x0, t.minX) & ~3;      // whole 4-pixel steps, the tile starts on one
+	const auto endX = std::min(x1, t.maxX);
+	const auto startY = std::max(y0, t.minY);
+	const auto endY = std::min(y1, t.maxY);
+
+#if DX3D_SIMD_SSE
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(255.0f);
+	const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 limitX = _mm_set1_ps(static_cast<f32>(endX) + 1.0f);
+	const __m128 invArea = _mm_set1_ps(t.invArea);
+
+	__m128 edgeA[3], originX[3], edgeSign[3], topLeft[3], invW[3], color[3][4];
+	for (ui32 i = 0; i < 3; i++)
+	{
+		edgeA[i] = _mm_set1_ps(t.edgeA[i]);
+		originX[i] = _mm_set1_ps(t.originX[i]);
+		edgeSign[i] = _mm_set1_ps(t.edgeSign[i]);
+		topLeft[i] = _mm_castsi128_ps(_mm_set1_epi32(t.edgeTopLeft[i] ? -1 : 0));
+		invW[i] = _mm_set1_ps(t.invW[i]);
+		color[i][0] = _mm_set1_ps(t.colorOverW[i].x);
+		color[i][1] = _mm_set1_ps(t.colorOverW[i].y);
+		color[i][2] = _mm_set1_ps(t.colorOverW[i].z);
+		color[i][3] = _mm_set1_ps(t.colorOverW[i].w);
+	}
+
+	for (auto y = startY; y <= endY; y++)
+	{
+		const auto py = static_cast<f32>(y) + 0.5f;
+		__m128 rowTerm[3];
+		for (ui32 i = 0; i < 3; i++)
+			rowTerm[i] = _mm_set1_ps(t.edgeB[i] * (py - t.originY[i]));
+
+		auto* row = m_color.data() + static_cast<size_t>(y) * m_stride;
+		for (auto x = startX; x <= endX; x += 4)
+		{
+			const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<f32>(x)), laneOffsets);
+
+			// exactly the operations and operands the neighbor across each edge uses, then the sign
+			__m128 e[3];
+			__m128 inside = _mm_cmplt_ps(px, limitX);
+			for (ui32 i = 0; i < 3; i++)
+			{
+				e[i] = _mm_mul_ps(edgeSign[i], _mm_add_ps(_mm_mul_ps(edgeA[i], _mm_sub_ps(px, originX[i])), rowTerm[i]));
+				const __m128 onEdge = _mm_and_ps(_mm_cmpeq_ps(e[i], zero), topLeft[i]);
+				inside = _mm_and_ps(inside, _mm_or_ps(_mm_cmpgt_ps(e[i], zero), onEdge));
+			}
+
+			const auto mask = _mm_movemask_ps(inside);
+			if (!mask)
+				continue;
+
+			// perspective-correct: interpolate color / w and 1 / w with the screen space barycentrics, then divide
+			const __m128 b0 = _mm_mul_ps(e[0], invArea), b1 = _mm_mul_ps(e[1], invArea), b2 = _mm_mul_ps(e[2], invArea);
+			const __m128 w = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b0, invW[0]), _mm_mul_ps(b1, invW[1])), _mm_mul_ps(b2, invW[2]));
+
+			__m128i packed = _mm_setzero_si128();
+			for (ui32 channel = 0; channel < 4; channel++)
+			{
+				const __m128 value = _mm_div_ps(_mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(b0, color[0][channel]), _mm_mul_ps(b1, color[1][channel])), _mm_mul_ps(b2, color[2][channel])), w);
+				// max first so NaN turns into 0, like the scalar path
+				const __m128 saturated = _mm_min_ps(_mm_max_ps(value, zero), one);
+				const __m128i unorm = _mm_cvtps_epi32(_mm_mul_ps(saturated, scale));
+				packed = _mm_or_si128(packed, _mm_slli_epi32(unorm, static_cast<int>(channel * 8)));
+			}
+
+			auto* target = reinterpret_cast<__m128i*>(row + x);
+			const __m128i keep = _mm_castps_si128(inside);
+			_mm_storeu_si128(target, _mm_or_si128(_mm_and_si128(keep, packed), _mm_andnot_si128(keep, _mm_loadu_si128(target))));
+			stats.pixelsWritten += static_cast<ui64>(((mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + (mask >> 3)));
+		}
+	}
+#else
+	for (auto y = startY; y <= endY; y++)
+	{
+		const auto py = static_cast<f32>(y) + 0.5f;
+		auto* row = m_color.data() + static_cast<size_t>(y) * m_stride;
+		for (auto x = startX; x <= endX; x++)
+		{
+			const auto px = static_cast<f32>(x) + 0.5f;
+
+			f32 e[3];
+			bool inside = true;
+			for (ui32 i = 0; i < 3; i++)
+			{
+				e[i] = t.edgeSign[i] * (t.edgeA[i] * (px - t.originX[i]) + t.edgeB[i] * (py - t.originY[i]));
+				inside &= e[i] > 0.0f || (e[i] == 0.0f && t.edgeTopLeft[i]);
+			}
+			if (!inside)
+				continue;
+
+			const auto b0 = e[0] * t.invArea, b1 = e[1] * t.invArea, b2 = e[2] * t.invArea;
+			const auto w = b0 * t.invW[0] + b1 * t.invW[1] + b2 * t.invW[2];
+			const Vec4 color{
+				(b0 * t.colorOverW[0].x + b1 * t.colorOverW[1].x + b2 * t.colorOverW[2].x) / w,
+				(b0 * t.colorOverW[0].y + b1 * t.colorOverW[1].y + b2 * t.colorOverW[2].y) / w,
+				(b0 * t.colorOverW[0].z + b1 * t.colorOverW[1].z + b2 * t.colorOverW[2].z) / w,
+				(b0 * t.colorOverW[0].w + b1 * t.colorOverW[1].w + b2 * t.colorOverW[2].w) / w
+			};
+			row[x] = PackColor(color);
+			stats.pixelsWritten++;
+		}
+	}
+#endif
+}
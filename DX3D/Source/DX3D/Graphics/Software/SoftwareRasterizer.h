@@ -0,0 +1,101 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <DX3D/Graphics/Software/Image.h>
+#include <DX3D/Math/Vec4.h>
+#include <vector>
+
+namespace dx3d
+{
+	class ThreadPool;
+
+	// what the vertex stage hands to the rasterizer: clip space position and the color the pixel shader returns
+	struct RasterVertex
+	{
+		Vec4 position{};
+		Vec4 color{};
+	};
+
+	struct RasterizerStats
+	{
+		ui64 trianglesSubmitted{};
+		ui64 trianglesCulled{};         // back facing, degenerate, or entirely outside after clipping
+		ui64 trianglesClipped{};        // crossed a clip or guard band plane and were split
+		ui64 trianglesRasterized{};
+		ui64 tileBins{};                // triangle x tile pairs the binner emitted
+		ui64 pixelsWritten{};
+
+		RasterizerStats& operator+=(const RasterizerStats& other) noexcept
+		{
+			trianglesSubmitted += other.trianglesSubmitted;
+			trianglesCulled += other.trianglesCulled;
+			trianglesClipped += other.trianglesClipped;
+			trianglesRasterized += other.trianglesRasterized;
+			tileBins += other.tileBins;
+			pixelsWritten += other.pixelsWritten;
+			return *this;
+		}
+	};
+
+	/*
+	* Tile-based triangle rasterizer with the fixed function state of a default PipelineDesc:
+	* back faces (counter-clockwise on screen) culled, no depth buffer, no blending, the viewport covering the target,
+	* clipping to 0 <= z <= w, pixel centers at .5 and the top-left fill rule.
+	*
+	* addTriangle clips, projects and bins; flush rasterizes all binned triangles tile by tile, the tiles in
+	* parallel on a ThreadPool, the triangles of one tile in submission order so the result matches the GPU.
+	* Edge functions and the perspective-correct color interpolation run on 4 pixels at a time (SSE2).
+	* Every edge is evaluated in one canonical direction and negated for the other, so two triangles sharing
+	* an edge compute bit-identical values along it and the fill rule hands each pixel to exactly one of them.
+	*/
+	class SoftwareRasterizer final
+	{
+	public:
+		// tileSize is rounded up to a multiple of 4 pixels
+		SoftwareRasterizer(ui32 width, ui32 height, ui32 tileSize);
+
+		void clear(const Vec4& color);
+		void addTriangle(const RasterVertex& a, const RasterVertex& b, const RasterVertex& c);
+		// threadPool may be null, then the tiles are rasterized on the calling thread
+		void flush(ThreadPool* threadPool);
+		// copies the target into image, call after flush
+		void resolve(Image& image) const;
+
+		ui32 getWidth() const noexcept;
+		ui32 getHeight() const noexcept;
+		const RasterizerStats& getStats() const noexcept;
+		void resetStats() noexcept;
+
+	private:
+		// screen space triangle ready to rasterize, edge i is opposite vertex i
+		struct SetupTriangle
+		{
+			// E(x, y) = sign (A (x - originX) + B (y - originY)), from the canonical start point of the edge
+			f32 edgeA[3], edgeB[3];
+			f32 originX[3], originY[3];
+			f32 edgeSign[3];                    // -1 where the triangle runs the edge against its canonical direction
+			bool edgeTopLeft[3];                // pixels exactly on the edge belong to this triangle
+			f32 invArea;
+			f32 invW[3];
+			Vec4 colorOverW[3];
+			i32 minX, minY, maxX, maxY;         // inclusive pixel bounds, clamped to the target
+		};
+
+		void setupTriangle(const RasterVertex* vertices);
+		void rasterizeTile(ui32 tileIndex, RasterizerStats& stats);
+		void rasterizeTriangle(const SetupTriangle& triangle, i32 x0, i32 y0, i32 x1, i32 y1, RasterizerStats& stats);
+
+	private:
+		ui32 m_width{};
+		ui32 m_height{};
+		ui32 m_stride{};                        // pixels per row, the width rounded up to 4 so every row is whole 4-pixel steps
+		ui32 m_tileSize{};
+		ui32 m_tilesX{};
+		ui32 m_tilesY{};
+
+		std::vector<ui32> m_color{};
+		std::vector<SetupTriangle> m_triangles{};
+		std::vector<std::vector<ui32>> m_bins{};    // per tile, triangle indices in submission order
+		std::vector<RasterizerStats> m_tileStats{};
+		RasterizerStats m_stats{};
+	};
+}
@@ -0,0 +1,363 @@
+#include <DX3D/Graphics/VertexEncoding.h>
+#include <DX3D/Math/Simd.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	using namespace dx3d;
+
+	constexpr size_t ColorOffset = 3 * sizeof(f32);
+
+	inline const unsigned char* VertexAt(const void* vertices, size_t vertexStride, size_t i) noexcept
+	{
+		return static_cast<const unsigned char*>(vertices) + i * vertexStride;
+	}
+
+	// NaN ends up at low, like _mm_max_ps(value, low) followed by _mm_min_ps(.., high)
+	inline f32 Clamp(f32 value, f32 low, f32 high) noexcept
+	{
+		value = value > low ? value : low;
+		return value < high ? value : high;
+	}
+
+	inline f32 InverseExtent(f32 extent) noexcept
+	{
+		// a flat axis decodes to the center no matter what is stored
+		return extent > 0.0f ? 1.0f / extent : 0.0f;
+	}
+
+	inline ui32 FloatBits(f32 value) noexcept
+	{
+		ui32 bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	inline f32 BitsFloat(ui32 bits) noexcept
+	{
+		f32 value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	// scaled by 32767 and rounded to nearest even, which is what cvtps2dq does in the default rounding mode
+	inline ui16 FloatToSnorm16(f32 value) noexcept
+	{
+		return static_cast<ui16>(static_cast<short>(std::nearbyint(Clamp(value, -1.0f, 1.0f) * 32767.0f)));
+	}
+
+	inline unsigned char FloatToUnorm8(f32 value) noexcept
+	{
+		return static_cast<unsigned char>(std::nearbyint(Clamp(value, 0.0f, 1.0f) * 255.0f));
+	}
+
+	void EncodePositionsScalar(PositionEncoding encoding, const PositionBounds& bounds, const void* vertices,
+		size_t vertexStride, size_t count, unsigned char* out, size_t outStride) noexcept
+	{
+		const f32 center[3] = { bounds.center.x, bounds.center.y, bounds.center.z };
+		const f32 inverseExtent[3] = { InverseExtent(bounds.extent.x), InverseExtent(bounds.extent.y), InverseExtent(bounds.extent.z) };
+
+		for (size_t i = 0; i < count; i++, out += outStride)
+		{
+			f32 position[3];
+			std::memcpy(position, VertexAt(vertices, vertexStride, i), sizeof(position));
+
+			ui16 packed[4];
+			switch (encoding)
+			{
+			case PositionEncoding::Half4:
+				for (ui32 axis = 0; axis < 3; axis++)
+					packed[axis] = VertexEncoder::FloatToHalf(position[axis]);
+				packed[3] = VertexEncoder::FloatToHalf(1.0f);
+				std::memcpy(out, packed, sizeof(packed));
+				break;
+			case PositionEncoding::Snorm16x4:
+				for (ui32 axis = 0; axis < 3; axis++)
+					packed[axis] = FloatToSnorm16((position[axis] - center[axis]) * inverseExtent[axis]);
+				packed[3] = FloatToSnorm16(1.0f);
+				std::memcpy(out, packed, sizeof(packed));
+				break;
+			default:
+				std::memcpy(out, position, sizeof(position));
+				break;
+			}
+		}
+	}
+
+	void EncodeColorsScalar(ColorEncoding encoding, const void* vertices, size_t vertexStride, size_t count,
+		unsigned char* out, size_t outStride) noexcept
+	{
+		for (size_t i = 0; i < count; i++, out += outStride)
+		{
+			f32 color[4];
+			std::memcpy(color, VertexAt(vertices, vertexStride, i) + ColorOffset, sizeof(color));
+
+			if (encoding == ColorEncoding::Unorm8x4)
+			{
+				for (ui32 channel = 0; channel < 4; channel++)
+					out[channel] = FloatToUnorm8(color[channel]);
+			}
+			else
+			{
+				std::memcpy(out, color, sizeof(color));
+			}
+		}
+	}
+
+#if DX3D_SIMD_SSE
+	/*
+	* float -> half for four lanes at once, round to nearest even; the same steps as FloatToHalf below,
+	* with the branches turned into masks. Each 32 bit lane holds its half sign extended, so
+	* _mm_packs_epi32 narrows it without saturating.
+	*/
+	inline __m128i FloatToHalf4(__m128 value) noexcept
+	{
+		const __m128i infinity32 = _mm_set1_epi32(255 << 23);
+		const __m128i halfMax = _mm_set1_epi32((127 + 16) << 23);      // everything from here up is inf in fp16
+		const __m128i minNormal = _mm_set1_epi32((127 - 14) << 23);    // smaller values become fp16 subnormals
+		const __m128i subnormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+		const __m128i normalBias = _mm_set1_epi32(0xfff - ((127 - 15) << 23));
+
+		const __m128 sign = _mm_and_ps(value, _mm_set1_ps(-0.0f));
+		const __m128 absolute = _mm_xor_ps(value, sign);
+		const __m128i bits = _mm_castps_si128(absolute);
+
+		const __m128i isNan = _mm_cmpgt_epi32(bits, infinity32);
+		const __m128i isFinite = _mm_cmpgt_epi32(halfMax, bits);
+		const __m128i isSubnormal = _mm_cmpgt_epi32(minNormal, bits);
+		const __m128i special = _mm_or_si128(_mm_and_si128(isNan, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7c00));
+
+		// the float add does the subnormal rounding
+		const __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absolute, _mm_castsi128_ps(subnormalMagic))), subnormalMagic);
+
+		// -1 when the kept mantissa is odd, so ties round up to even
+		const __m128i mantissaOdd = _mm_srai_epi32(_mm_slli_epi32(bits, 31 - 13), 31);
+		const __m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(bits, normalBias), mantissaOdd), 13);
+
+		const __m128i finite = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+		const __m128i half = _mm_or_si128(_mm_and_si128(isFinite, finite), _mm_andnot_si128(isFinite, special));
+		return _mm_or_si128(half, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+	}
+
+	// x y z from the vertex, w = 1; the load reads the red channel behind z, which is always there
+	inline __m128 LoadPosition(const unsigned char* vertex) noexcept
+	{
+		const __m128 xyzMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+		const __m128 w = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+		return _mm_or_ps(_mm_and_ps(_mm_loadu_ps(reinterpret_cast<const f32*>(vertex)), xyzMask), w);
+	}
+
+	void EncodePositionsSse(PositionEncoding encoding, const PositionBounds& bounds, const void* vertices,
+		size_t vertexStride, size_t count, unsigned char* out, size_t outStride) noexcept
+	{
+		if (encoding == PositionEncoding::Float3)
+		{
+			EncodePositionsScalar(encoding, bounds, vertices, vertexStride, count, out, outStride);
+			return;
+		}
+
+		// w stays 1 through the normalization: center 0, inverse extent 1
+		const __m128 center = _mm_set_ps(0.0f, bounds.center.z, bounds.center.y, bounds.center.x);
+		const __m128 inverseExtent = _mm_set_ps(1.0f, InverseExtent(bounds.extent.z), InverseExtent(bounds.extent.y),
+			InverseExtent(bounds.extent.x));
+		const __m128 minusOne = _mm_set1_ps(-1.0f);
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 snormScale = _mm_set1_ps(32767.0f);
+
+		for (size_t i = 0; i < count; i++, out += outStride)
+		{
+			const __m128 position = LoadPosition(VertexAt(vertices, vertexStride, i));
+
+			__m128i packed;
+			if (encoding == PositionEncoding::Half4)
+			{
+				packed = FloatToHalf4(position);
+			}
+			else
+			{
+				const __m128 normalized = _mm_mul_ps(_mm_sub_ps(position, center), inverseExtent);
+				packed = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(normalized, minusOne), one), snormScale));
+			}
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packs_epi32(packed, packed));
+		}
+	}
+
+	void EncodeColorsSse(ColorEncoding encoding, const void* vertices, size_t vertexStride, size_t count,
+		unsigned char* out, size_t outStride) noexcept
+	{
+		if (encoding == ColorEncoding::Float4)
+		{
+			EncodeColorsScalar(encoding, vertices, vertexStride, count, out, outStride);
+			return;
+		}
+
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 unormScale = _mm_set1_ps(255.0f);
+
+		for (size_t i = 0; i < count; i++, out += outStride)
+		{
+			const __m128 color = _mm_loadu_ps(reinterpret_cast<const f32*>(VertexAt(vertices, vertexStride, i) + ColorOffset));
+			const __m128i scaled = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(color, zero), one), unormScale));
+			const __m128i words = _mm_packs_epi32(scaled, scaled);
+			const int rgba = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+			std::memcpy(out, &rgba, sizeof(rgba));
+		}
+	}
+#endif
+}
+
+dx3d::ui32 dx3d::VertexEncoding::getPositionSize() const noexcept
+{
+	return position == PositionEncoding::Float3 ? 12 : 8;
+}
+
+dx3d::ui32 dx3d::VertexEncoding::getStride() const noexcept
+{
+	return getPositionSize() + (color == ColorEncoding::Float4 ? 16 : 4);
+}
+
+dx3d::PositionBounds dx3d::PositionBounds::FromVertices(const void* vertices, size_t vertexStride, size_t count) noexcept
+{
+	if (!vertices || !count)
+		return {};
+
+	f32 low[4], high[4];
+#if DX3D_SIMD_SSE
+	// the fourth lane picks up the red channel and is ignored
+	__m128 minimum = _mm_loadu_ps(reinterpret_cast<const f32*>(VertexAt(vertices, vertexStride, 0)));
+	__m128 maximum = minimum;
+	for (size_t i = 1; i < count; i++)
+	{
+		const __m128 position = _mm_loadu_ps(reinterpret_cast<const f32*>(VertexAt(vertices, vertexStride, i)));
+		minimum = _mm_min_ps(minimum, position);
+		maximum = _mm_max_ps(maximum, position);
+	}
+	_mm_storeu_ps(low, minimum);
+	_mm_storeu_ps(high, maximum);
+#else
+	std::memcpy(low, VertexAt(vertices, vertexStride, 0), 3 * sizeof(f32));
+	std::memcpy(high, low, 3 * sizeof(f32));
+	for (size_t i = 1; i < count; i++)
+	{
+		f32 position[3];
+		std::memcpy(position, VertexAt(vertices, vertexStride, i), sizeof(position));
+		for (ui32 axis = 0; axis < 3; axis++)
+		{
+			low[axis] = std::min(low[axis], position[axis]);
+			high[axis] = std::max(high[axis], position[axis]);
+		}
+	}
+#endif
+
+	PositionBounds bounds{};
+	bounds.center = Vec3{ low[0] + high[0], low[1] + high[1], low[2] + high[2] } * 0.5f;
+	bounds.extent = Vec3{ high[0] - low[0], high[1] - low[1], high[2] - low[2] } * 0.5f;
+	return bounds;
+}
+
+void dx3d::VertexEncoder::Encode(const VertexEncoding& encoding, const PositionBounds& bounds,
+	const void* vertices, size_t vertexStride, size_t count, void* out) noexcept
+{
+#if DX3D_SIMD_SSE
+	// position and color are written in two passes, so neither inner loop has to switch on the format
+	auto* bytes = static_cast<unsigned char*>(out);
+	const auto stride = encoding.getStride();
+	EncodePositionsSse(encoding.position, bounds, vertices, vertexStride, count, bytes, stride);
+	EncodeColorsSse(encoding.color, vertices, vertexStride, count, bytes + encoding.getPositionSize(), stride);
+#else
+	Scalar::Encode(encoding, bounds, vertices, vertexStride, count, out);
+#endif
+}
+
+void dx3d::VertexEncoder::Scalar::Encode(const VertexEncoding& encoding, const PositionBounds& bounds,
+	const void* vertices, size_t vertexStride, size_t count, void* out) noexcept
+{
+	auto* bytes = static_cast<unsigned char*>(out);
+	const auto stride = encoding.getStride();
+	EncodePositionsScalar(encoding.position, bounds, vertices, vertexStride, count, bytes, stride);
+	EncodeColorsScalar(encoding.color, vertices, vertexStride, count, bytes + encoding.getPositionSize(), stride);
+}
+
+std::vector<dx3d::VertexAttribute> dx3d::VertexEncoder::GetVertexLayout(const VertexEncoding& encoding)
+{
+	VertexFormat positionFormat = VertexFormat::Float3;
+	if (encoding.position == PositionEncoding::Half4) positionFormat = VertexFormat::Half4;
+	else if (encoding.position == PositionEncoding::Snorm16x4) positionFormat = VertexFormat::Short4Norm;
+
+	const auto colorFormat = encoding.color == ColorEncoding::Unorm8x4 ? VertexFormat::UByte4Norm : VertexFormat::Float4;
+
+	return {
+		{ "POSITION", 0, positionFormat, 0, 0 },
+		{ "COLOR", 0, colorFormat, 0, encoding.getPositionSize() }
+	};
+}
+
+std::vector<dx3d::ShaderMacro> dx3d::VertexEncoder::GetShaderDefines(const VertexEncoding& encoding, const PositionBounds& bounds)
+{
+	if (encoding.position != PositionEncoding::Snorm16x4)
+		return {};
+
+	// 9 significant digits round trip a float exactly
+	auto toFloat3 = [](const Vec3& v)
+		{
+			char text[96];
+			std::snprintf(text, sizeof(text), "float3(%.9g, %.9g, %.9g)", v.x, v.y, v.z);
+			return std::string(text);
+		};
+
+	return {
+		{ "DX3D_POSITION_SNORM", "1" },
+		{ "DX3D_POSITION_CENTER", toFloat3(bounds.center) },
+		{ "DX3D_POSITION_EXTENT", toFloat3(bounds.extent) }
+	};
+}
+
+dx3d::ui16 dx3d::VertexEncoder::FloatToHalf(f32 value) noexcept
+{
+	auto bits = FloatBits(value);
+	const auto sign = bits & 0x80000000u;
+	bits ^= sign;
+
+	ui32 half{};
+	if (bits >= ((127 + 16) << 23))
+	{
+		// too large for fp16 (inf), or inf / NaN to begin with; NaN stays quiet
+		half = bits > (255u << 23) ? 0x7e00 : 0x7c00;
+	}
+	else if (bits < ((127 - 14) << 23))
+	{
+		// fp16 subnormal or zero, the float add rounds the mantissa into place
+		const auto magic = static_cast<ui32>(((127 - 15) + (23 - 10) + 1) << 23);
+		half = FloatBits(BitsFloat(bits) + BitsFloat(magic)) - magic;
+	}
+	else
+	{
+		// rebias the exponent, round to nearest even by adding just under half an ulp plus the odd bit
+		const auto mantissaOdd = (bits >> 13) & 1;
+		bits += (static_cast<ui32>(15 - 127) << 23) + 0xfff + mantissaOdd;
+		half = bits >> 13;
+	}
+
+	return static_cast<ui16>(half | (sign >> 16));
+}
+
+dx3d::f32 dx3d::VertexEncoder::HalfToFloat(ui16 value) noexcept
+{
+	const auto sign = static_cast<ui32>(value & 0x8000) << 16;
+	const auto exponent = static_cast<ui32>(value >> 10) & 0x1f;
+	const auto mantissa = static_cast<ui32>(value) & 0x3ff;
+
+	if (exponent == 0)
+	{
+		// zero or subnormal: mantissa * 2^-24
+		const auto magnitude = static_cast<f32>(mantissa) * (1.0f / 16777216.0f);
+		return sign ? -magnitude : magnitude;
+	}
+	if (exponent == 31)
+		return BitsFloat(sign | 0x7f800000u | (mantissa << 13));
+	return BitsFloat(sign | ((exponent + 127 - 15) << 23) | (mantissa << 13));
+}
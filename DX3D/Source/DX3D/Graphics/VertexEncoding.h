@@ -0,0 +1,37 @@
+#pragma once
+#include <DX3D/Core/Core.h>
+#include <DX3D/Graphics/GraphicsTypes.h>
+#include <DX3D/Graphics/VertexEncodingTypes.h>
+#include <cstddef>
+#include <vector>
+
+namespace dx3d
+{
+	/*
+	* Packs float vertices into a VertexEncoding (SSE2: one vertex per step, scalar otherwise).
+	* Half positions round to nearest even, normalized values are clamped and rounded to nearest.
+	* Everything besides the encoders themselves only needs what the pipeline has to know about the encoding:
+	* the input layout to bind it with and the defines that select the matching decode in the vertex shaders.
+	*/
+	namespace VertexEncoder
+	{
+		// vertices are x y z r g b a floats vertexStride bytes apart, out receives count * encoding.getStride() bytes
+		void Encode(const VertexEncoding& encoding, const PositionBounds& bounds,
+			const void* vertices, size_t vertexStride, size_t count, void* out) noexcept;
+
+		// POSITION at 0 and COLOR right behind it, in input slot 0
+		std::vector<VertexAttribute> GetVertexLayout(const VertexEncoding& encoding);
+		// DX3D_POSITION_SNORM + the bounds for Snorm16x4 positions, nothing for the formats the input assembler decodes
+		std::vector<ShaderMacro> GetShaderDefines(const VertexEncoding& encoding, const PositionBounds& bounds);
+
+		ui16 FloatToHalf(f32 value) noexcept;
+		f32 HalfToFloat(ui16 value) noexcept;
+
+		// the same conversions one value at a time, the reference the SIMD path is checked against
+		namespace Scalar
+		{
+			void Encode(const VertexEncoding& encoding, const PositionBounds& bounds,
+				const void* vertices, size_t vertexStride, size_t count, void* out) noexcept;
+		}
+	}
+}
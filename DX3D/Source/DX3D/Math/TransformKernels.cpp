@@ -0,0 +1,277 @@
+#include <DX3D/Math/TransformKernels.h>
+#include <DX3D/Math/Simd.h>
+
+namespace
+{
+	using namespace dx3d;
+
+	inline void transformPointScalar(const Mat4& matrix, const f32* p, f32 w, f32* result) noexcept
+	{
+		const auto& m = matrix.m;
+		const f32 x = p[0], y = p[1], z = p[2];
+		result[0] = x * m[0][0] + y * m[1][0] + z * m[2][0] + w * m[3][0];
+		result[1] = x * m[0][1] + y * m[1][1] + z * m[2][1] + w * m[3][1];
+		result[2] = x * m[0][2] + y * m[1][2] + z * m[2][2] + w * m[3][2];
+	}
+
+	inline void transformFloat4Scalar(const Mat4& matrix, const f32* v, f32* result) noexcept
+	{
+		const auto& m = matrix.m;
+		const f32 x = v[0], y = v[1], z = v[2], w = v[3];
+		for (ui32 column = 0; column < 4; column++)
+			result[column] = x * m[0][column] + y * m[1][column] + z * m[2][column] + w * m[3][column];
+	}
+
+	void transformPointsScalar(const Mat4& matrix, const f32* points, f32* results, size_t count, f32 w) noexcept
+	{
+		for (size_t i = 0; i < count; i++)
+			transformPointScalar(matrix, points + i * 3, w, results + i * 3);
+	}
+
+	void transformFloat4sScalar(const Mat4& matrix, const f32* vectors, f32* results, size_t count) noexcept
+	{
+		for (size_t i = 0; i < count; i++)
+			transformFloat4Scalar(matrix, vectors + i * 4, results + i * 4);
+	}
+
+#if DX3D_SIMD_SSE
+	/*
+	* Packed xyz arrays are transformed in blocks of 4 points = 12 floats = 3 registers (a, b, c):
+	*   a = x0 y0 z0 x1   b = y1 z1 x2 y2   c = z2 x3 y3 z3
+	* shuffled into x0..x3, y0..y3, z0..z3, transformed as structure of arrays and shuffled back.
+	* _mm256_shuffle_ps shuffles within each 128 bit lane, so the AVX path runs the same shuffles on two
+	* blocks at once (points 0-3 in the low lanes, 4-7 in the high ones).
+	*/
+	template<typename V, typename Ops>
+	inline void transformBlock(const V (&m)[3][3], const V (&t)[3], V a, V b, V c, V& outA, V& outB, V& outC) noexcept
+	{
+		const auto x = Ops::template shuffle<_MM_SHUFFLE(3, 0, 3, 0)>(a, Ops::template shuffle<_MM_SHUFFLE(1, 0, 3, 2)>(b, c));
+		const auto y = Ops::template shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(
+			Ops::template shuffle<_MM_SHUFFLE(0, 0, 1, 1)>(a, b), Ops::template shuffle<_MM_SHUFFLE(2, 2, 3, 3)>(b, c));
+		const auto z = Ops::template shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(
+			Ops::template shuffle<_MM_SHUFFLE(1, 1, 2, 2)>(a, b), Ops::template shuffle<_MM_SHUFFLE(3, 3, 0, 0)>(c, c));
+
+		V r[3];
+		for (ui32 column = 0; column < 3; column++)
+			r[column] = Ops::add(Ops::add(Ops::mul(x, m[0][column]), Ops::mul(y, m[1][column])),
+				Ops::add(Ops::mul(z, m[2][column]), t[column]));
+
+		outA = Ops::template shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(
+			Ops::template shuffle<_MM_SHUFFLE(0, 0, 0, 0)>(r[0], r[1]), Ops::template shuffle<_MM_SHUFFLE(1, 1, 0, 0)>(r[2], r[0]));
+		outB = Ops::template shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(
+			Ops::template shuffle<_MM_SHUFFLE(1, 1, 1, 1)>(r[1], r[2]), Ops::template shuffle<_MM_SHUFFLE(2, 2, 2, 2)>(r[0], r[1]));
+		outC = Ops::template shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(
+			Ops::template shuffle<_MM_SHUFFLE(3, 3, 2, 2)>(r[2], r[0]), Ops::template shuffle<_MM_SHUFFLE(3, 3, 3, 3)>(r[1], r[2]));
+	}
+
+	struct SseOps
+	{
+		template<int Imm> static __m128 shuffle(__m128 a, __m128 b) noexcept { return _mm_shuffle_ps(a, b, Imm); }
+		static __m128 add(__m128 a, __m128 b) noexcept { return _mm_add_ps(a, b); }
+		static __m128 mul(__m128 a, __m128 b) noexcept { return _mm_mul_ps(a, b); }
+		static __m128 set1(f32 v) noexcept { return _mm_set1_ps(v); }
+	};
+
+#if DX3D_SIMD_AVX
+	struct AvxOps
+	{
+		template<int Imm> static __m256 shuffle(__m256 a, __m256 b) noexcept { return _mm256_shuffle_ps(a, b, Imm); }
+		static __m256 add(__m256 a, __m256 b) noexcept { return _mm256_add_ps(a, b); }
+		static __m256 mul(__m256 a, __m256 b) noexcept { return _mm256_mul_ps(a, b); }
+		static __m256 set1(f32 v) noexcept { return _mm256_set1_ps(v); }
+
+		// 4 floats at low into the low lane, 4 floats at high into the high lane
+		static __m256 load2(const f32* low, const f32* high) noexcept
+		{
+			return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+		}
+
+		static void store2(f32* low, f32* high, __m256 v) noexcept
+		{
+			_mm_storeu_ps(low, _mm256_castps256_ps128(v));
+			_mm_storeu_ps(high, _mm256_extractf128_ps(v, 1));
+		}
+	};
+#endif
+
+	template<typename V, typename Ops>
+	inline void broadcastMatrix(const Mat4& matrix, f32 w, V (&m)[3][3], V (&t)[3]) noexcept
+	{
+		for (ui32 row = 0; row < 3; row++)
+			for (ui32 column = 0; column < 3; column++)
+				m[row][column] = Ops::set1(matrix.m[row][column]);
+		for (ui32 column = 0; column < 3; column++)
+			t[column] = Ops::set1(matrix.m[3][column] * w);
+	}
+
+	// one point, xyz written with a 8 + 4 byte store so nothing past the position is touched
+	inline void transformPointSse(const __m128 (&rows)[4], const f32* p, f32* result) noexcept
+	{
+		const auto r = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p[0]), rows[0]), _mm_mul_ps(_mm_set1_ps(p[1]), rows[1])),
+			_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p[2]), rows[2]), rows[3]));
+		_mm_storel_pi(reinterpret_cast<__m64*>(result), r);
+		_mm_store_ss(result + 2, _mm_movehl_ps(r, r));
+	}
+
+	inline void loadRows(const Mat4& matrix, f32 w, __m128 (&rows)[4]) noexcept
+	{
+		for (ui32 row = 0; row < 4; row++)
+			rows[row] = _mm_loadu_ps(matrix.m[row]);
+		rows[3] = _mm_mul_ps(rows[3], _mm_set1_ps(w));
+	}
+#endif
+
+	void transformPoints(const Mat4& matrix, const f32* points, f32* results, size_t count, f32 w) noexcept
+	{
+#if DX3D_SIMD_SSE
+		size_t i = 0;
+#if DX3D_SIMD_AVX
+		{
+			__m256 m[3][3], t[3];
+			broadcastMatrix<__m256, AvxOps>(matrix, w, m, t);
+			for (; i + 8 <= count; i += 8)
+			{
+				const auto* p = points + i * 3;
+				auto* out = results + i * 3;
+				__m256 a, b, c;
+				transformBlock<__m256, AvxOps>(m, t, AvxOps::load2(p, p + 12), AvxOps::load2(p + 4, p + 16),
+					AvxOps::load2(p + 8, p + 20), a, b, c);
+				AvxOps::store2(out, out + 12, a);
+				AvxOps::store2(out + 4, out + 16, b);
+				AvxOps::store2(out + 8, out + 20, c);
+			}
+		}
+#endif
+		{
+			__m128 m[3][3], t[3];
+			broadcastMatrix<__m128, SseOps>(matrix, w, m, t);
+			for (; i + 4 <= count; i += 4)
+			{
+				const auto* p = points + i * 3;
+				auto* out = results + i * 3;
+				__m128 a, b, c;
+				transformBlock<__m128, SseOps>(m, t, _mm_loadu_ps(p), _mm_loadu_ps(p + 4), _mm_loadu_ps(p + 8), a, b, c);
+				_mm_storeu_ps(out, a);
+				_mm_storeu_ps(out + 4, b);
+				_mm_storeu_ps(out + 8, c);
+			}
+		}
+
+		__m128 rows[4];
+		loadRows(matrix, w, rows);
+		for (; i < count; i++)
+			transformPointSse(rows, points + i * 3, results + i * 3);
+#else
+		transformPointsScalar(matrix, points, results, count, w);
+#endif
+	}
+
+	void transformFloat4s(const Mat4& matrix, const f32* vectors, f32* results, size_t count) noexcept
+	{
+#if DX3D_SIMD_SSE
+		size_t i = 0;
+#if DX3D_SIMD_AVX
+		{
+			// two vectors per register, each lane broadcasts its own x, y, z, w
+			__m256 rows[4];
+			for (ui32 row = 0; row < 4; row++)
+				rows[row] = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix.m[row]));
+			for (; i + 2 <= count; i += 2)
+			{
+				const auto v = _mm256_loadu_ps(vectors + i * 4);
+				const auto r = _mm256_add_ps(
+					_mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(v, 0x00), rows[0]), _mm256_mul_ps(_mm256_permute_ps(v, 0x55), rows[1])),
+					_mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(v, 0xAA), rows[2]), _mm256_mul_ps(_mm256_permute_ps(v, 0xFF), rows[3])));
+				_mm256_storeu_ps(results + i * 4, r);
+			}
+		}
+#endif
+		__m128 rows[4];
+		loadRows(matrix, 1.0f, rows);
+		for (; i < count; i++)
+		{
+			const auto v = _mm_loadu_ps(vectors + i * 4);
+			const auto r = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(v, v, 0x00), rows[0]), _mm_mul_ps(_mm_shuffle_ps(v, v, 0x55), rows[1])),
+				_mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(v, v, 0xAA), rows[2]), _mm_mul_ps(_mm_shuffle_ps(v, v, 0xFF), rows[3])));
+			_mm_storeu_ps(results + i * 4, r);
+		}
+#else
+		transformFloat4sScalar(matrix, vectors, results, count);
+#endif
+	}
+}
+
+void dx3d::TransformKernels::TransformPoints(const Mat4& matrix, const Vec3* points, Vec3* results, size_t count) noexcept
+{
+	transformPoints(matrix, reinterpret_cast<const f32*>(points), reinterpret_cast<f32*>(results), count, 1.0f);
+}
+
+void dx3d::TransformKernels::TransformPoints(const Mat4& matrix, const void* points, size_t pointStride,
+	void* results, size_t resultStride, size_t count) noexcept
+{
+	if (pointStride == sizeof(Vec3) && resultStride == sizeof(Vec3))
+		return transformPoints(matrix, static_cast<const f32*>(points), static_cast<f32*>(results), count, 1.0f);
+
+	// vertex structs interleave other attributes, so every position is loaded and stored on its own
+	const auto* source = static_cast<const unsigned char*>(points);
+	auto* destination = static_cast<unsigned char*>(results);
+#if DX3D_SIMD_SSE
+	__m128 rows[4];
+	loadRows(matrix, 1.0f, rows);
+	for (size_t i = 0; i < count; i++)
+		transformPointSse(rows, reinterpret_cast<const f32*>(source + i * pointStride),
+			reinterpret_cast<f32*>(destination + i * resultStride));
+#else
+	for (size_t i = 0; i < count; i++)
+		transformPointScalar(matrix, reinterpret_cast<const f32*>(source + i * pointStride), 1.0f,
+			reinterpret_cast<f32*>(destination + i * resultStride));
+#endif
+}
+
+void dx3d::TransformKernels::TransformDirections(const Mat4& matrix, const Vec3* directions, Vec3* results, size_t count) noexcept
+{
+	transformPoints(matrix, reinterpret_cast<const f32*>(directions), reinterpret_cast<f32*>(results), count, 0.0f);
+}
+
+void dx3d::TransformKernels::TransformVectors(const Mat4& matrix, const Vec4* vectors, Vec4* results, size_t count) noexcept
+{
+	transformFloat4s(matrix, reinterpret_cast<const f32*>(vectors), reinterpret_cast<f32*>(results), count);
+}
+
+void dx3d::TransformKernels::MultiplyMatrices(const Mat4* matrices, const Mat4& matrix, Mat4* results, size_t count) noexcept
+{
+	// every row of matrices[i] is a vector transformed by matrix
+	transformFloat4s(matrix, reinterpret_cast<const f32*>(matrices), reinterpret_cast<f32*>(results), count * 4);
+}
+
+void dx3d::TransformKernels::Scalar::TransformPoints(const Mat4& matrix, const Vec3* points, Vec3* results, size_t count) noexcept
+{
+	transformPointsScalar(matrix, reinterpret_cast<const f32*>(points), reinterpret_cast<f32*>(results), count, 1.0f);
+}
+
+void dx3d::TransformKernels::Scalar::TransformPoints(const Mat4& matrix, const void* points, size_t pointStride,
+	void* results, size_t resultStride, size_t count) noexcept
+{
+	const auto* source = static_cast<const unsigned char*>(points);
+	auto* destination = static_cast<unsigned char*>(results);
+	for (size_t i = 0; i < count; i++)
+		transformPointScalar(matrix, reinterpret_cast<const f32*>(source + i * pointStride), 1.0f,
+			reinterpret_cast<f32*>(destination + i * resultStride));
+}
+
+void dx3d::TransformKernels::Scalar::TransformDirections(const Mat4& matrix, const Vec3* directions, Vec3* results, size_t count) noexcept
+{
+	transformPointsScalar(matrix, reinterpret_cast<const f32*>(directions), reinterpret_cast<f32*>(results), count, 0.0f);
+}
+
+void dx3d::TransformKernels::Scalar::TransformVectors(const Mat4& matrix, const Vec4* vectors, Vec4* results, size_t count) noexcept
+{
+	transformFloat4sScalar(matrix, reinterpret_cast<const f32*>(vectors), reinterpret_cast<f32*>(results), count);
+}
+
+void dx3d::TransformKernels::Scalar::MultiplyMatrices(const Mat4* matrices, const Mat4& matrix, Mat4* results, size_t count) noexcept
+{
+	transformFloat4sScalar(matrix, reinterpret_cast<const f32*>(matrices), reinterpret_cast<f32*>(results), count * 4);
+}
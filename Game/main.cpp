@@ -2,7 +2,12 @@
 
 int main() {
 	try {
-		dx3d::Game game({ {640,480},dx3d::Logger::LogLevel::Info });
+		dx3d::GameDesc desc{ {640,480},dx3d::Logger::LogLevel::Info };
+		// the sample logs at Info, its log writes stay off the frame
+		desc.asyncLogging = true;
+		// and reports what the caches, rings and scheduler did on shutdown
+		desc.logStatistics = true;
+		dx3d::Game game(desc);
 		game.run();
 	}
 	catch (const std::runtime_error&)
@@ -0,0 +1,112 @@
+// Times the SIMD transform kernels against their Scalar:: reference on the same data.
+// Usage: DX3DBenchmarks [--quick]
+// --quick runs a small batch once, enough for ctest to check that the kernels still agree.
+#include <DX3D/Math/TransformKernels.h>
+#include <DX3D/Math/Simd.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using namespace dx3d;
+	using Clock = std::chrono::steady_clock;
+
+	struct BenchmarkResult
+	{
+		double scalarNanoseconds{};
+		double simdNanoseconds{};
+		bool matches{};
+	};
+
+	// fastest of the repeats in nanoseconds per element, the minimum is the least disturbed by the rest of the machine
+	template <typename Kernel>
+	double TimeKernel(Kernel&& kernel, size_t count, int repeats)
+	{
+		auto best = Clock::duration::max();
+		for (int i = 0; i < repeats; i++)
+		{
+			const auto start = Clock::now();
+			kernel();
+			best = std::min(best, Clock::now() - start);
+		}
+		return std::chrono::duration<double, std::nano>(best).count() / static_cast<double>(std::max<size_t>(count, 1));
+	}
+
+	bool NearlyEqual(const f32* a, const f32* b, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			if (std::fabs(a[i] - b[i]) > 1.0e-4f * std::max(1.0f, std::fabs(b[i]))) return false;
+		}
+		return true;
+	}
+
+	template <typename T, typename ScalarKernel, typename SimdKernel>
+	BenchmarkResult Compare(const std::vector<T>& input, ScalarKernel&& scalar, SimdKernel&& simd, int repeats)
+	{
+		std::vector<T> expected(input.size()), actual(input.size());
+		BenchmarkResult result{};
+		result.scalarNanoseconds = TimeKernel([&]() { scalar(input.data(), expected.data(), input.size()); }, input.size(), repeats);
+		result.simdNanoseconds = TimeKernel([&]() { simd(input.data(), actual.data(), input.size()); }, input.size(), repeats);
+		result.matches = NearlyEqual(reinterpret_cast<const f32*>(actual.data()), reinterpret_cast<const f32*>(expected.data()),
+			input.size() * sizeof(T) / sizeof(f32));
+		return result;
+	}
+
+	bool Report(const char* name, const BenchmarkResult& result)
+	{
+		std::printf("%-20s scalar %7.3f ns  simd %7.3f ns  speedup %5.2fx%s\n", name, result.scalarNanoseconds,
+			result.simdNanoseconds, result.scalarNanoseconds / std::max(result.simdNanoseconds, 1.0e-9),
+			result.matches ? "" : "  MISMATCH");
+		return result.matches;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+	const size_t count = quick ? 4099 : (1u << 20) + 3;
+	const int repeats = quick ? 1 : 20;
+
+#if defined(DX3D_SIMD_AVX)
+	std::printf("SIMD path: AVX, %zu elements, best of %d\n", count, repeats);
+#elif defined(DX3D_SIMD_SSE)
+	std::printf("SIMD path: SSE, %zu elements, best of %d\n", count, repeats);
+#else
+	std::printf("SIMD path: none (scalar fallback), %zu elements, best of %d\n", count, repeats);
+#endif
+
+	std::mt19937 random(42);
+	std::uniform_real_distribution<f32> distribution(-100.0f, 100.0f);
+	std::vector<Vec3> points(count);
+	for (auto& point : points)
+		point = { distribution(random), distribution(random), distribution(random) };
+	std::vector<Vec4> vectors(count);
+	for (size_t i = 0; i < count; i++)
+		vectors[i] = { points[i].x, points[i].y, points[i].z, 1.0f };
+	std::vector<Mat4> matrices(count / 16);
+	for (size_t i = 0; i < matrices.size(); i++)
+		matrices[i] = Mat4::rotationY(0.001f * static_cast<f32>(i)) * Mat4::translation(points[i]);
+
+	const auto matrix = Mat4::scale({ 2.0f, 2.0f, 2.0f }) * Mat4::rotationX(0.4f) * Mat4::translation({ 1.0f, 2.0f, 3.0f });
+
+	bool ok = true;
+	ok &= Report("TransformPoints", Compare(points,
+		[&](const Vec3* in, Vec3* out, size_t n) { TransformKernels::Scalar::TransformPoints(matrix, in, out, n); },
+		[&](const Vec3* in, Vec3* out, size_t n) { TransformKernels::TransformPoints(matrix, in, out, n); }, repeats));
+	ok &= Report("TransformDirections", Compare(points,
+		[&](const Vec3* in, Vec3* out, size_t n) { TransformKernels::Scalar::TransformDirections(matrix, in, out, n); },
+		[&](const Vec3* in, Vec3* out, size_t n) { TransformKernels::TransformDirections(matrix, in, out, n); }, repeats));
+	ok &= Report("TransformVectors", Compare(vectors,
+		[&](const Vec4* in, Vec4* out, size_t n) { TransformKernels::Scalar::TransformVectors(matrix, in, out, n); },
+		[&](const Vec4* in, Vec4* out, size_t n) { TransformKernels::TransformVectors(matrix, in, out, n); }, repeats));
+	ok &= Report("MultiplyMatrices", Compare(matrices,
+		[&](const Mat4* in, Mat4* out, size_t n) { TransformKernels::Scalar::MultiplyMatrices(in, matrix, out, n); },
+		[&](const Mat4* in, Mat4* out, size_t n) { TransformKernels::MultiplyMatrices(in, matrix, out, n); }, repeats));
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include "TestFramework.h"
+#include <DX3D/Graphics/BufferAllocator.h>
+
+using dx3d::BufferAllocator;
+
+DX3DTest(BufferAllocator, AllocatesFirstFit)
+{
+	BufferAllocator allocator(100);
+	BufferAllocator::Allocation a{}, b{}, c{};
+	DX3DRequire(allocator.allocate(30, a));
+	DX3DRequire(allocator.allocate(30, b));
+	DX3DCheck(a.offset == 0 && a.size == 30);
+	DX3DCheck(b.offset == 30 && b.size == 30);
+	DX3DCheck(allocator.getUsedSize() == 60);
+
+	// the hole at the front is the first one large enough
+	allocator.free(a);
+	DX3DRequire(allocator.allocate(20, c));
+	DX3DCheck(c.offset == 0);
+	DX3DCheck(allocator.getUsedSize() == 50);
+	DX3DCheck(allocator.getFreeBlockCount() == 2);
+}
+
+DX3DTest(BufferAllocator, FailsWhenNothingFits)
+{
+	BufferAllocator allocator(64);
+	BufferAllocator::Allocation a{}, b{};
+	DX3DRequire(allocator.allocate(40, a));
+	DX3DCheck(!allocator.allocate(40, b));
+	DX3DCheck(allocator.getUsedSize() == 40);
+	DX3DCheck(allocator.getLargestFreeBlock() == 24);
+	DX3DCheckThrows(allocator.allocate(0, b), std::invalid_argument);
+}
+
+DX3DTest(BufferAllocator, FreeMergesNeighbours)
+{
+	BufferAllocator allocator(30);
+	BufferAllocator::Allocation a{}, b{}, c{};
+	DX3DRequire(allocator.allocate(10, a));
+	DX3DRequire(allocator.allocate(10, b));
+	DX3DRequire(allocator.allocate(10, c));
+
+	allocator.free(a);
+	allocator.free(c);
+	DX3DCheck(allocator.getFreeBlockCount() == 2);
+
+	// touches both free blocks, all three become one
+	allocator.free(b);
+	DX3DCheck(allocator.getFreeBlockCount() == 1);
+	DX3DCheck(allocator.getLargestFreeBlock() == 30);
+	DX3DCheck(allocator.getUsedSize() == 0);
+}
+
+DX3DTest(BufferAllocator, RejectsDoubleFree)
+{
+	BufferAllocator allocator(32);
+	BufferAllocator::Allocation a{};
+	DX3DRequire(allocator.allocate(8, a));
+	allocator.free(a);
+	DX3DCheckThrows(allocator.free(a), std::invalid_argument);
+	DX3DCheckThrows(allocator.free({ 30, 8 }), std::invalid_argument);
+}
+
+DX3DTest(BufferAllocator, GrowKeepsOffsets)
+{
+	BufferAllocator allocator(16);
+	BufferAllocator::Allocation a{}, b{};
+	DX3DRequire(allocator.allocate(12, a));
+	DX3DCheck(!allocator.allocate(8, b));
+
+	// the free tail and the new space join into one block
+	allocator.grow(32);
+	DX3DCheck(allocator.getCapacity() == 32);
+	DX3DCheck(allocator.getFreeBlockCount() == 1);
+	DX3DRequire(allocator.allocate(8, b));
+	DX3DCheck(a.offset == 0);
+	DX3DCheck(b.offset == 12);
+
+	allocator.grow(8);
+	DX3DCheck(allocator.getCapacity() == 32);
+}
+
+DX3DTest(BufferAllocator, ResetFreesEverything)
+{
+	BufferAllocator allocator(20);
+	BufferAllocator::Allocation a{};
+	DX3DRequire(allocator.allocate(5, a));
+	DX3DRequire(allocator.allocate(5, a));
+	allocator.reset();
+	DX3DCheck(allocator.getUsedSize() == 0);
+	DX3DCheck(allocator.getFreeBlockCount() == 1);
+	DX3DCheck(allocator.getLargestFreeBlock() == 20);
+}
+
+DX3DTest(BufferAllocator, MergeRangesJoinsTouchingRanges)
+{
+	const auto merged = BufferAllocator::mergeRanges({ { 20, 5 }, { 0, 10 }, { 10, 4 }, { 14, 0 }, { 25, 5 } });
+	DX3DRequire(merged.size() == 2);
+	DX3DCheck(merged[0].offset == 0 && merged[0].size == 14);
+	DX3DCheck(merged[1].offset == 20 && merged[1].size == 10);
+}
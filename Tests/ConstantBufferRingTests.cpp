@@ -0,0 +1,146 @@
+#include "TestFramework.h"
+#include <DX3D/Graphics/ConstantBufferRing.h>
+#include <DX3D/Graphics/Null/NullGraphicsBackend.h>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+	using namespace dx3d;
+
+	// the ring holds four 256-byte blocks, so two frames of two blocks fill it
+	ConstantBufferRingDesc MakeRingDesc(GraphicsBackend& backend)
+	{
+		return { { Test::GetLogger() }, backend, 4 * ConstantBufferAlignment };
+	}
+
+	ObjectConstants MakeConstants(f32 x)
+	{
+		return { Mat4::translation({ x, 0.0f, 0.0f }) };
+	}
+
+	bool Holds(const NullGraphicsBackend& backend, const ConstantBufferBinding& binding, const ObjectConstants& constants)
+	{
+		const auto& contents = backend.getBufferContents(binding.buffer);
+		return binding.byteOffset + sizeof(constants) <= contents.size() &&
+			!std::memcmp(contents.data() + binding.byteOffset, &constants, sizeof(constants));
+	}
+
+	void SubmitFrame(GraphicsBackend& backend)
+	{
+		backend.beginFrame({});
+		backend.endFrame();
+	}
+}
+
+DX3DTest(ConstantBufferRing, UploadsLandAlignedInTheRing)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() } });
+	ConstantBufferRing ring(MakeRingDesc(backend));
+
+	ring.begin();
+	const auto a = ring.upload(MakeConstants(1.0f));
+	const auto b = ring.upload(MakeConstants(2.0f));
+	ring.end();
+
+	DX3DCheck(a.buffer == b.buffer);
+	DX3DCheck(a.byteOffset % ConstantBufferAlignment == 0 && b.byteOffset % ConstantBufferAlignment == 0);
+	DX3DCheck(a.byteSize == ConstantBufferAlignment);
+	DX3DCheck(a.byteOffset != b.byteOffset);
+	DX3DCheck(Holds(backend, a, MakeConstants(1.0f)));
+	DX3DCheck(Holds(backend, b, MakeConstants(2.0f)));
+	DX3DCheck(ring.getStats().blocksUploaded == 2);
+}
+
+DX3DTest(ConstantBufferRing, EqualBlocksInAFrameShareOneBinding)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() }, true, 1 });
+	ConstantBufferRing ring(MakeRingDesc(backend));
+
+	ring.begin();
+	const auto a = ring.upload(MakeConstants(1.0f));
+	const auto b = ring.upload(MakeConstants(1.0f));
+	ring.end();
+	SubmitFrame(backend);
+
+	// not across frames, the GPU may still read the earlier frame's block while this one is written
+	ring.begin();
+	const auto c = ring.upload(MakeConstants(1.0f));
+	ring.end();
+
+	DX3DCheck(a == b);
+	DX3DCheck(!(a == c));
+	DX3DCheck(ring.getStats().blocksDeduplicated == 1);
+	DX3DCheck(ring.getStats().blocksUploaded == 2);
+}
+
+DX3DTest(ConstantBufferRing, UploadsOnlyBetweenBeginAndEnd)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() } });
+	ConstantBufferRing ring(MakeRingDesc(backend));
+
+	DX3DCheckThrows(ring.upload(MakeConstants(1.0f)), std::runtime_error);
+	DX3DCheckThrows(ring.end(), std::runtime_error);
+	ring.begin();
+	DX3DCheckThrows(ring.begin(), std::runtime_error);
+	ring.end();
+	DX3DCheckThrows(ring.upload(MakeConstants(1.0f)), std::runtime_error);
+}
+
+DX3DTest(ConstantBufferRing, ReusesSpaceOnceTheFrameCompleted)
+{
+	// the simulated GPU finishes a frame one frame after it was submitted
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() }, true, 1 });
+	ConstantBufferRing ring(MakeRingDesc(backend));
+
+	ConstantBufferBinding frames[3][2]{};
+	for (auto& frame : frames)
+	{
+		ring.begin();
+		frame[0] = ring.upload(MakeConstants(1.0f));
+		frame[1] = ring.upload(MakeConstants(2.0f));
+		ring.end();
+		SubmitFrame(backend);
+	}
+
+	// frame 1 could not touch frame 0's blocks, frame 2 went back to them once frame 0 was done
+	DX3DCheck(frames[1][0].byteOffset >= frames[0][1].byteOffset + ConstantBufferAlignment);
+	DX3DCheck(frames[2][0].buffer == frames[0][0].buffer);
+	DX3DCheck(frames[2][0].byteOffset == frames[0][0].byteOffset);
+	DX3DCheck(ring.getUploadRing().getStats().wraps == 1);
+	DX3DCheck(ring.getUploadRing().getStats().grows == 0);
+}
+
+DX3DTest(ConstantBufferRing, GrowsWhileEveryFrameIsInFlight)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() }, true, 3 });
+	ConstantBufferRing ring(MakeRingDesc(backend));
+
+	ConstantBufferBinding last{};
+	for (int frame = 0; frame < 3; frame++)
+	{
+		ring.begin();
+		ring.upload(MakeConstants(1.0f));
+		last = ring.upload(MakeConstants(2.0f));
+		ring.end();
+		SubmitFrame(backend);
+	}
+
+	DX3DCheck(ring.getUploadRing().getStats().grows == 1);
+	DX3DCheck(Holds(backend, last, MakeConstants(2.0f)));
+}
+
+DX3DTest(ConstantBufferRing, RetainedBlocksOnlySendChanges)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() } });
+	ConstantBufferRing ring(MakeRingDesc(backend));
+
+	const auto block = ring.createBlock();
+	DX3DCheck(ring.updateBlock(block, MakeConstants(1.0f)));
+	DX3DCheck(!ring.updateBlock(block, MakeConstants(1.0f)));
+	ring.flush();
+	ring.flush();
+
+	DX3DCheck(ring.getStats().flushes == 1);
+	DX3DCheck(Holds(backend, ring.getBinding(block), MakeConstants(1.0f)));
+}
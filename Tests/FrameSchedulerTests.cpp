@@ -0,0 +1,187 @@
+#include "TestFramework.h"
+#include <DX3D/Core/FrameScheduler.h>
+#include <DX3D/Core/TripleBuffer.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+	using namespace dx3d;
+
+	// quarter second steps and eighth second advances, all exact in binary so the step counts are too
+	constexpr d64 Step = 0.25;
+
+	FrameSchedulerDesc MakeDesc(const d64& clock, ui32 maxSteps = 8)
+	{
+		FrameSchedulerDesc desc{ { Test::GetLogger() }, Step, maxSteps, 0.0, FramePacing::Spin };
+		desc.clock = [&clock] { return clock; };
+		return desc;
+	}
+
+	// the writer's values carry a second copy, a torn read shows up as the two disagreeing
+	struct Sample
+	{
+		ui64 value{};
+		ui64 check{};
+	};
+}
+
+DX3DTest(FrameScheduler, StepsFollowTheElapsedTime)
+{
+	d64 clock = 10.0;
+	FrameScheduler scheduler(MakeDesc(clock));
+
+	clock += 0.625;
+	auto timing = scheduler.beginFrame();
+	DX3DCheck(timing.frameIndex == 0);
+	DX3DCheck(timing.frameSeconds == 0.625);
+	DX3DCheck(timing.simulationSteps == 2);
+	DX3DCheck(timing.interpolation == 0.5f);
+	// the two steps were due at 10.25 and 10.5, an eighth is left over towards the next one
+	DX3DCheck(timing.firstStepTime == 10.25);
+
+	clock += 0.125;
+	timing = scheduler.beginFrame();
+	DX3DCheck(timing.frameIndex == 1);
+	DX3DCheck(timing.simulationSteps == 1);
+	DX3DCheck(timing.interpolation == 0.0f);
+	DX3DCheck(timing.firstStepTime == 10.75);
+
+	// frames faster than the step run none and only move the interpolation
+	for (int frame = 0; frame < 3; frame++)
+	{
+		clock += 0.0625;
+		timing = scheduler.beginFrame();
+		DX3DCheck(timing.simulationSteps == 0);
+		DX3DCheck(timing.interpolation == 0.25f * static_cast<f32>(frame + 1));
+	}
+	clock += 0.0625;
+	DX3DCheck(scheduler.beginFrame().simulationSteps == 1);
+
+	const auto stats = scheduler.getStats();
+	DX3DCheck(stats.frames == 6);
+	DX3DCheck(stats.simulationSteps == 4);
+	DX3DCheck(stats.droppedSteps == 0);
+	DX3DCheck(stats.idleSeconds == 0.0);
+}
+
+DX3DTest(FrameScheduler, StallsAreClampedToMaxSteps)
+{
+	d64 clock = 0.0;
+	FrameScheduler scheduler(MakeDesc(clock, 4));
+
+	// ten seconds in a debugger: four steps are run, the other thirty-six are given up
+	clock += 10.125;
+	auto timing = scheduler.beginFrame();
+	DX3DCheck(timing.simulationSteps == 4);
+	DX3DCheck(timing.interpolation == 0.5f);
+	DX3DCheck(timing.firstStepTime == 9.25);
+	DX3DCheck(scheduler.getStats().droppedSteps == 36);
+
+	// the simulation carries on from the present, not from before the stall
+	clock += 0.125;
+	timing = scheduler.beginFrame();
+	DX3DCheck(timing.simulationSteps == 1);
+	DX3DCheck(timing.firstStepTime == 10.25);
+
+	const auto stats = scheduler.getStats();
+	DX3DCheck(stats.simulationSteps == 5);
+	DX3DCheck(stats.droppedSteps == 36);
+}
+
+DX3DTest(FrameScheduler, FrameCapSpacesTheFrames)
+{
+	// every read of the clock moves it on, so the wait for the cap ends
+	d64 clock = 0.0;
+	FrameSchedulerDesc desc{ { Test::GetLogger() }, Step, 8, 4.0, FramePacing::Spin };
+	desc.clock = [&clock] { return clock += 1.0 / 64.0; };
+	FrameScheduler scheduler(desc);
+
+	// the frames keep the phase of the cap being set, the first one comes early
+	scheduler.beginFrame();
+	d64 previous = scheduler.beginFrame().time;
+	for (int frame = 0; frame < 4; frame++)
+	{
+		const auto time = scheduler.beginFrame().time;
+		DX3DCheck(time - previous >= 0.25);
+		DX3DCheck(time - previous < 0.25 + 4.0 / 64.0);
+		previous = time;
+	}
+	DX3DCheck(scheduler.getStats().idleSeconds > 4 * 0.125);
+}
+
+DX3DTest(FrameScheduler, InterpolationIsClamped)
+{
+	d64 clock = 5.0;
+	FrameScheduler scheduler(MakeDesc(clock));
+	DX3DCheck(scheduler.getInterpolation(4.875) == 0.5f);
+	DX3DCheck(scheduler.getInterpolation(4.0) == 1.0f);
+	DX3DCheck(scheduler.getInterpolation(5.5) == 0.0f);
+	DX3DCheck(scheduler.getSimulationStep() == Step);
+
+	DX3DCheckThrows(FrameScheduler(FrameSchedulerDesc{ { Test::GetLogger() }, 0.0 }), std::invalid_argument);
+	DX3DCheckThrows(FrameScheduler(FrameSchedulerDesc{ { Test::GetLogger() }, Step, 0 }), std::invalid_argument);
+}
+
+DX3DTest(TripleBuffer, ReaderTakesTheNewestValue)
+{
+	TripleBuffer<ui64> buffer;
+	DX3DCheck(!buffer.update());
+
+	buffer.getWriteBuffer() = 1;
+	buffer.publish();
+	DX3DCheck(buffer.update());
+	DX3DCheck(buffer.read() == 1);
+	DX3DCheck(!buffer.update());
+	DX3DCheck(buffer.read() == 1);
+
+	// a slow reader skips the values it missed
+	for (ui64 value = 2; value <= 4; value++)
+	{
+		buffer.getWriteBuffer() = value;
+		buffer.publish();
+	}
+	DX3DCheck(buffer.update());
+	DX3DCheck(buffer.read() == 4);
+	DX3DCheck(!buffer.update());
+}
+
+DX3DTest(TripleBuffer, ProducerAndConsumerNeverTear)
+{
+	constexpr ui64 Count = 200000;
+	TripleBuffer<Sample> buffer;
+	std::atomic<bool> done{};
+
+	std::thread producer([&]
+		{
+			for (ui64 value = 1; value <= Count; value++)
+			{
+				auto& sample = buffer.getWriteBuffer();
+				sample.value = value;
+				sample.check = ~value;
+				buffer.publish();
+			}
+			done = true;
+		});
+
+	// what the reader sees only ever moves forward and is always a whole value
+	ui64 last = 0, taken = 0, torn = 0, backwards = 0;
+	bool finished = false;
+	while (!finished)
+	{
+		finished = done.load();
+		if (!buffer.update()) continue;
+		const auto& sample = buffer.read();
+		if (sample.check != ~sample.value) torn++;
+		if (sample.value <= last) backwards++;
+		last = sample.value;
+		taken++;
+	}
+	producer.join();
+
+	DX3DCheck(torn == 0);
+	DX3DCheck(backwards == 0);
+	DX3DCheck(last == Count);
+	DX3DCheck(taken >= 1 && taken <= Count);
+}
@@ -0,0 +1,105 @@
+#include "TestFramework.h"
+#include <DX3D/Graphics/GeometryArena.h>
+#include <DX3D/Graphics/Null/NullGraphicsBackend.h>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	using namespace dx3d;
+
+	struct ColoredVertex
+	{
+		f32 x{}, y{}, z{};
+		f32 r{}, g{}, b{}, a{};
+	};
+
+	std::vector<ColoredVertex> MakeVertices(ui32 count, f32 base)
+	{
+		std::vector<ColoredVertex> vertices(count);
+		for (ui32 i = 0; i < count; i++)
+			vertices[i] = { base + static_cast<f32>(i), 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+		return vertices;
+	}
+
+	GeometryArenaDesc MakeArenaDesc(GraphicsBackend& backend)
+	{
+		return { { Test::GetLogger() }, backend, sizeof(ColoredVertex), {}, {}, 8, 8 };
+	}
+}
+
+DX3DTest(GeometryArena, RebasesIndicesOntoTheAllocation)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() } });
+	GeometryArena arena(MakeArenaDesc(backend));
+
+	const ui32 indices[] = { 0, 1, 2 };
+	const auto first = MakeVertices(3, 0.0f);
+	const auto second = MakeVertices(3, 10.0f);
+	const auto a = arena.allocate(first.data(), 3, indices, 3);
+	const auto b = arena.allocate(second.data(), 3, indices, 3);
+	DX3DCheck(a.vertices.offset == 0 && b.vertices.offset == 3);
+	DX3DCheck(b.indices.offset == 3);
+
+	arena.flush();
+	const auto& indexData = backend.getBufferContents(arena.getIndexBuffer());
+	ui32 written[6]{};
+	std::memcpy(written, indexData.data(), sizeof(written));
+	DX3DCheck(written[0] == 0 && written[2] == 2);
+	DX3DCheck(written[3] == 3 && written[5] == 5);
+}
+
+DX3DTest(GeometryArena, GrowsAndKeepsTheContents)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() } });
+	GeometryArena arena(MakeArenaDesc(backend));
+
+	const auto first = MakeVertices(6, 0.0f);
+	const auto a = arena.allocate(first.data(), 6);
+	arena.flush();
+	const auto buffersBefore = backend.getStats().buffersCreated;
+	const auto liveBuffersBefore = backend.getLiveBufferCount();
+
+	// does not fit next to the first one, the arena grows and the buffer is recreated on the next flush
+	const auto second = MakeVertices(6, 100.0f);
+	const auto b = arena.allocate(second.data(), 6);
+	DX3DCheck(arena.getVertexCapacity() >= 12);
+	DX3DCheck(a.vertices.offset == 0 && b.vertices.offset == 6);
+
+	arena.flush();
+	DX3DCheck(backend.getStats().buffersCreated == buffersBefore + 1);
+	DX3DCheck(backend.getLiveBufferCount() == liveBuffersBefore);
+
+	// the default encoding stores the float vertices as they are
+	const auto& vertexData = backend.getBufferContents(arena.getVertexBufferBinding().buffer);
+	ColoredVertex stored[12]{};
+	std::memcpy(stored, vertexData.data(), sizeof(stored));
+	DX3DCheck(stored[5].x == 5.0f);
+	DX3DCheck(stored[6].x == 100.0f);
+	DX3DCheck(stored[11].x == 105.0f);
+}
+
+DX3DTest(GeometryArena, ReusesFreedRanges)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() } });
+	GeometryArena arena(MakeArenaDesc(backend));
+
+	const auto vertices = MakeVertices(4, 0.0f);
+	const auto a = arena.allocate(vertices.data(), 4);
+	arena.allocate(vertices.data(), 4);
+	arena.free(a);
+
+	const auto c = arena.allocate(vertices.data(), 4);
+	DX3DCheck(c.vertices.offset == 0);
+	DX3DCheck(arena.getVertexCapacity() == 8);
+}
+
+DX3DTest(GeometryArena, RejectsIndicesOutsideTheShape)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() } });
+	GeometryArena arena(MakeArenaDesc(backend));
+
+	const auto vertices = MakeVertices(3, 0.0f);
+	const ui32 indices[] = { 0, 1, 3 };
+	DX3DCheckThrows(arena.allocate(vertices.data(), 3, indices, 3), std::invalid_argument);
+}
@@ -0,0 +1,146 @@
+#include "TestFramework.h"
+#include <DX3D/Core/ThreadPool.h>
+#include <DX3D/Graphics/SceneRenderer.h>
+#include <DX3D/Graphics/Software/Image.h>
+#include <DX3D/Graphics/Software/SoftwareGraphicsBackend.h>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace
+{
+	using namespace dx3d;
+
+	constexpr ui32 FrameWidth = 160;
+	constexpr ui32 FrameHeight = 120;
+	constexpr f32 Pi = 3.14159265f;
+
+	struct SceneSetup
+	{
+		ui32 tileSize{ 64 };
+		ThreadPool* threadPool{};
+		VertexEncoding vertexEncoding{ PositionEncoding::Half4, ColorEncoding::Unorm8x4 };
+	};
+
+	using BuildScene = std::function<void(SceneRenderer& renderer)>;
+
+	Image RenderScene(const BuildScene& build, const SceneSetup& setup = {})
+	{
+		SoftwareGraphicsBackend backend(SoftwareGraphicsBackendDesc{ { Test::GetLogger() }, FrameWidth, FrameHeight,
+			setup.tileSize, setup.threadPool });
+		// with a thread pool even these few draws are split over several lists, the seams between them must not show
+		SceneRenderer renderer(SceneRendererDesc{ { Test::GetLogger() }, backend, setup.threadPool, setup.vertexEncoding, 1 });
+		build(renderer);
+		renderer.renderFrame({ { 0.1f, 0.1f, 0.2f, 1.0f }, renderer.getCommandListCount() });
+		return backend.getFrame();
+	}
+
+	/*
+	* Compares a frame with Golden/<name>.ppm. With --update-goldens the frame replaces the golden instead.
+	* A mismatch writes <name>_actual.png and <name>_diff.png next to the test binary to look at.
+	* Goldens are allowed a small error so a different libm or fp16 conversion on another platform does not fail them:
+	* 2 levels per channel, and one pixel in a thousand off by more (a triangle edge landing on the other side of a pixel center).
+	*/
+	void CheckGolden(const char* name, const Image& frame)
+	{
+		const auto golden = std::filesystem::path(DX3D_GOLDEN_DIR) / (std::string(name) + ".ppm");
+		if (Test::HasOption("--update-goldens"))
+		{
+			DX3DRequire(ImageIO::WritePpm(frame, golden));
+			std::printf("Updated %s\n", golden.string().c_str());
+			return;
+		}
+
+		Image expected{};
+		DX3DRequire(ImageIO::ReadPpm(golden, expected));
+		const auto diff = ImageIO::Compare(frame, expected, 2, true);
+		const bool matches = !diff.sizeMismatch && diff.differingPixels <= static_cast<ui64>(FrameWidth) * FrameHeight / 1000;
+		if (!matches)
+		{
+			const auto output = std::filesystem::path(DX3D_GOLDEN_OUTPUT_DIR);
+			std::filesystem::create_directories(output);
+			ImageIO::WritePng(frame, output / (std::string(name) + "_actual.png"));
+			if (!diff.sizeMismatch) ImageIO::WritePng(diff.differenceImage, output / (std::string(name) + "_diff.png"));
+			std::printf("%s: %llu pixels differ, max channel difference %u, written to %s\n", name,
+				static_cast<unsigned long long>(diff.differingPixels), diff.maxChannelDifference, output.string().c_str());
+		}
+		DX3DCheck(matches);
+	}
+
+	// clip space shapes, the camera stays identity
+	void BuildShapes(SceneRenderer& renderer)
+	{
+		renderer.addRectangle(-0.45f, 0.4f, 0.8f, 0.6f, 0.2f, 0.8f, 0.3f);
+		renderer.addRectangle(0.4f, -0.45f, 0.9f, 0.5f);
+		renderer.addTriangle(0.45f, 0.45f, 0.7f, 0.9f, 0.2f, 0.1f);
+		renderer.addTriangle(-0.5f, -0.4f, 0.9f);
+	}
+
+	// a grid of cubes seen in perspective, some turned so three faces show
+	void BuildCubes(SceneRenderer& renderer)
+	{
+		for (int y = 0; y < 3; y++)
+		{
+			for (int x = 0; x < 5; x++)
+			{
+				const auto cube = renderer.addCube(static_cast<f32>(x - 2) * 1.6f, static_cast<f32>(y - 1) * 1.6f, 0.0f, 0.9f);
+				if ((x + y) % 2)
+				{
+					renderer.setShapeTransform(cube, Mat4::scale(0.9f) * Mat4::rotationY(0.6f) * Mat4::rotationX(0.4f) *
+						Mat4::translation({ static_cast<f32>(x - 2) * 1.6f, static_cast<f32>(y - 1) * 1.6f, 0.0f }));
+				}
+				if (x == 2) renderer.setShapeColor(cube, { 0.9f, 0.8f, 0.2f, 1.0f });
+			}
+		}
+		renderer.setCamera(Mat4::lookAtLH({ 1.0f, 2.0f, -9.0f }, {}, { 0.0f, 1.0f, 0.0f }) *
+			Mat4::perspectiveFovLH(0.9f, static_cast<f32>(FrameWidth) / FrameHeight, 0.1f, 100.0f));
+	}
+
+	// a disk of thin triangles around one vertex, a crack or a double-drawn pixel along the shared edges shows up in it
+	void BuildFan(SceneRenderer& renderer)
+	{
+		constexpr ui32 Segments = 96;
+		std::vector<Vertex> vertices{ { 0.0f, 0.0f, 0.5f, 1.0f, 1.0f, 1.0f, 1.0f } };
+		std::vector<ui32> indices{};
+		for (ui32 i = 0; i < Segments; i++)
+		{
+			const f32 angle = 2.0f * Pi * static_cast<f32>(i) / Segments;
+			const f32 shade = static_cast<f32>(i % 2);
+			vertices.push_back({ 0.9f * std::cos(angle) * FrameHeight / FrameWidth, 0.9f * std::sin(angle), 0.5f,
+				shade, 0.5f, 1.0f - shade, 1.0f });
+			// clockwise on screen, the front face
+			indices.insert(indices.end(), { 0, 1 + (i + 1) % Segments, 1 + i });
+		}
+		renderer.addShape(renderer.addShapeMesh(vertices, indices), Mat4::identity());
+	}
+}
+
+DX3DTest(GoldenImage, Shapes)
+{
+	CheckGolden("Shapes", RenderScene(BuildShapes));
+}
+
+DX3DTest(GoldenImage, Cubes)
+{
+	CheckGolden("Cubes", RenderScene(BuildCubes));
+}
+
+DX3DTest(GoldenImage, Fan)
+{
+	CheckGolden("Fan", RenderScene(BuildFan));
+}
+
+// the tile size, the thread count and the vertex encoding must not change a pixel beyond the fp16 rounding
+DX3DTest(GoldenImage, SetupsMatchGolden)
+{
+	ThreadPool threadPool(ThreadPoolDesc{ { Test::GetLogger() }, 3 });
+	if (Test::HasOption("--update-goldens")) return;
+
+	CheckGolden("Cubes", RenderScene(BuildCubes, { 16, &threadPool }));
+	CheckGolden("Cubes", RenderScene(BuildCubes, { 24, nullptr, { PositionEncoding::Float3, ColorEncoding::Float4 } }));
+	CheckGolden("Shapes", RenderScene(BuildShapes, { 32, &threadPool, { PositionEncoding::Snorm16x4, ColorEncoding::Unorm8x4 } }));
+	CheckGolden("Fan", RenderScene(BuildFan, { 8, &threadPool }));
+}
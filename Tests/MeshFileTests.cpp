@@ -0,0 +1,233 @@
+#include "TestMeshes.h"
+#include <DX3D/Core/Hash.h>
+#include <DX3D/Graphics/ImmutableBufferCache.h>
+#include <DX3D/Graphics/MeshFile.h>
+#include <DX3D/Graphics/Null/NullGraphicsBackend.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	using namespace dx3d;
+
+	// offsets into the version 1 header, the corruption tests patch single fields
+	constexpr std::streamoff VersionOffset = 4;
+	constexpr std::streamoff VertexCountOffset = 28;
+	constexpr std::streamoff VertexSizeOffset = 120;
+
+	// a file in the temp directory that is removed again when the test case ends
+	struct TempFile
+	{
+		explicit TempFile(const char* name) : path(std::filesystem::temp_directory_path() / (std::string("DX3DTests_") + name)) {}
+		~TempFile()
+		{
+			std::error_code error{};
+			std::filesystem::remove(path, error);
+		}
+
+		std::filesystem::path path;
+	};
+
+	// the grid as the triangle list MeshFile::Write welds
+	std::vector<Vertex> MakeGridTriangles(ui32 cells)
+	{
+		const auto vertices = Test::MakeGridVertices(cells, 0.1f);
+		std::vector<Vertex> triangles;
+		for (const auto index : Test::MakeGridIndices(cells))
+			triangles.push_back(vertices[index]);
+		return triangles;
+	}
+
+	void WriteGrid(const std::filesystem::path& path, const VertexEncoding& encoding = {})
+	{
+		const auto triangles = MakeGridTriangles(8);
+		DX3DRequire(MeshFile::Write(path, triangles.data(), sizeof(Vertex), triangles.size(), encoding));
+	}
+
+	template <typename T>
+	void Patch(const std::filesystem::path& path, std::streamoff offset, const T& value)
+	{
+		std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+		file.seekp(offset);
+		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		DX3DRequire(file.good());
+	}
+
+	std::string OpenError(const std::filesystem::path& path)
+	{
+		MeshFile file;
+		std::string error;
+		DX3DCheck(!file.open(path, &error));
+		DX3DCheck(!file.isOpen());
+		return error;
+	}
+}
+
+DX3DTest(MeshFile, RoundTripKeepsTheData)
+{
+	const TempFile temp("RoundTrip.dxmf");
+	const std::vector<ui32> indices{ 0, 1, 2, 2, 1, 3 };
+	const std::vector<unsigned char> vertices(4 * VertexEncoding{}.getStride(), 0x5a);
+
+	MeshFileData data{};
+	data.bounds = { { -1.0f, -2.0f, -3.0f }, { 1.0f, 2.0f, 3.0f } };
+	data.vertices = vertices.data();
+	data.vertexCount = 4;
+	data.indices = indices.data();
+	data.indexCount = static_cast<ui32>(indices.size());
+	data.optimizerStats.inputVertices = 6;
+	data.optimizerStats.acmrAfter = 0.75f;
+	std::string error;
+	DX3DRequire(MeshFile::Write(temp.path, data, &error));
+
+	MeshFile file;
+	DX3DRequire(file.open(temp.path, &error));
+	const auto& loaded = file.getData();
+	DX3DCheck(loaded.encoding.position == data.encoding.position && loaded.encoding.color == data.encoding.color);
+	DX3DCheck(loaded.vertexCount == 4 && loaded.indexCount == 6);
+	DX3DCheck(file.getVertexDataSize() == vertices.size());
+	DX3DCheck(!std::memcmp(loaded.vertices, vertices.data(), vertices.size()));
+	DX3DCheck(!std::memcmp(loaded.indices, indices.data(), indices.size() * sizeof(ui32)));
+	DX3DCheck(loaded.bounds.min.y == -2.0f && loaded.bounds.max.z == 3.0f);
+	DX3DCheck(loaded.optimizerStats.inputVertices == 6 && loaded.optimizerStats.acmrAfter == 0.75f);
+	DX3DCheck(loaded.optimizerStats.triangles == 2);
+	DX3DCheck(file.getVertexHash() == Hash::HashBytes(vertices.data(), vertices.size()));
+	DX3DCheck(file.getIndexHash() == Hash::HashBytes(indices.data(), indices.size() * sizeof(ui32)));
+
+	// the stored layout is exactly what the vertex shaders read
+	const auto expectedLayout = VertexEncoder::GetVertexLayout(data.encoding);
+	const auto& layout = file.getVertexLayout();
+	DX3DRequire(layout.size() == expectedLayout.size());
+	for (size_t i = 0; i < layout.size(); i++)
+	{
+		DX3DCheck(std::strcmp(layout[i].semanticName, expectedLayout[i].semanticName) == 0);
+		DX3DCheck(layout[i].format == expectedLayout[i].format && layout[i].offset == expectedLayout[i].offset);
+	}
+	DX3DCheck(reinterpret_cast<uintptr_t>(loaded.vertices) % MeshFile::BlobAlignment == 0);
+	DX3DCheck(reinterpret_cast<uintptr_t>(loaded.indices) % MeshFile::BlobAlignment == 0);
+
+	file.close();
+	DX3DCheck(!file.isOpen() && !file.getData().vertices);
+}
+
+DX3DTest(MeshFile, WriteWeldsAndEncodesTriangles)
+{
+	const TempFile temp("Weld.dxmf");
+	const VertexEncoding encoding{ PositionEncoding::Snorm16x4, ColorEncoding::Unorm8x4 };
+	WriteGrid(temp.path, encoding);
+
+	MeshFile file;
+	DX3DRequire(file.open(temp.path));
+	const auto& data = file.getData();
+	DX3DCheck(data.encoding.position == PositionEncoding::Snorm16x4);
+	DX3DCheck(data.vertexCount == 9 * 9);
+	DX3DCheck(data.indexCount == 8 * 8 * 6);
+	DX3DCheck(data.optimizerStats.inputVertices == 8 * 8 * 6);
+	DX3DCheck(file.getVertexDataSize() == data.vertexCount * encoding.getStride());
+	// Snorm16x4 positions only decode with the box they were normalized into
+	DX3DCheck(data.positionBounds.extent.x > 0.0f && data.positionBounds.extent.z > 0.0f);
+	for (ui32 i = 0; i < data.indexCount; i++)
+		DX3DCheck(data.indices[i] < data.vertexCount);
+}
+
+DX3DTest(MeshFile, CorruptedHeadersAreRejected)
+{
+	const TempFile temp("Corrupted.dxmf");
+
+	DX3DCheck(OpenError(temp.path) == "Could not map the mesh file.");
+
+	WriteGrid(temp.path);
+	Patch(temp.path, 0, 'X');
+	DX3DCheck(OpenError(temp.path) == "Not a mesh file.");
+
+	WriteGrid(temp.path);
+	Patch(temp.path, VersionOffset, MeshFile::Version + 1);
+	DX3DCheck(OpenError(temp.path) == "Unsupported mesh file version.");
+
+	WriteGrid(temp.path);
+	Patch(temp.path, VertexCountOffset, ui32{ 1000 });
+	DX3DCheck(OpenError(temp.path) == "The blob sizes do not match the counts.");
+
+	// a size that would wrap when handed to a 32-bit buffer description
+	WriteGrid(temp.path);
+	Patch(temp.path, VertexSizeOffset, ui64{ 1 } << 32);
+	DX3DCheck(OpenError(temp.path) == "The mesh is too large for a single buffer.");
+
+	WriteGrid(temp.path);
+	std::filesystem::resize_file(temp.path, std::filesystem::file_size(temp.path) - 4);
+	DX3DCheck(OpenError(temp.path) == "The mesh file is truncated.");
+
+	WriteGrid(temp.path);
+	std::filesystem::resize_file(temp.path, 100);
+	DX3DCheck(OpenError(temp.path) == "The mesh file is truncated.");
+}
+
+DX3DTest(MeshFile, LoadedMeshesShareBuffers)
+{
+	const TempFile temp("Shared.dxmf");
+	WriteGrid(temp.path);
+
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() } });
+	const auto& stats = backend.getImmutableBufferCache().getStats();
+	Mesh first({ Test::GetLogger() }, backend);
+	first.loadFromFile(temp.path);
+	const auto misses = stats.misses;
+	Mesh second({ Test::GetLogger() }, backend);
+	second.loadFromFile(temp.path);
+	DX3DCheck(stats.misses == misses);
+	DX3DCheck(stats.hits >= 2);
+	DX3DCheck(first.getLodLevels().size() == 1 && first.getLodLevels()[0].indexCount == 8 * 8 * 6);
+
+	const TempFile missing("Missing.dxmf");
+	Mesh third({ Test::GetLogger() }, backend);
+	DX3DCheckThrows(third.loadFromFile(missing.path), std::runtime_error);
+}
+
+// the stored hash only picks the bucket, a file whose hash lies must not get another file's buffer
+DX3DTest(ImmutableBufferCache, PrecomputedHashStillComparesBytes)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() } });
+	auto& cache = backend.getImmutableBufferCache();
+	const std::vector<ui32> a{ 1, 2, 3 };
+	const std::vector<ui32> b{ 4, 5, 6 };
+	constexpr ui64 hash = 0x1234;
+
+	const auto first = cache.acquire({ a.data(), 12, BufferType::Index, BufferUsage::Immutable, hash });
+	const auto other = cache.acquire({ b.data(), 12, BufferType::Index, BufferUsage::Immutable, hash });
+	const auto same = cache.acquire({ a.data(), 12, BufferType::Index, BufferUsage::Immutable, hash });
+	DX3DCheck(!(first == other));
+	DX3DCheck(first == same);
+	DX3DCheck(backend.getBufferContents(other) == std::vector<unsigned char>(reinterpret_cast<const unsigned char*>(b.data()),
+		reinterpret_cast<const unsigned char*>(b.data()) + 12));
+	DX3DCheck(cache.getStats().hits == 1 && cache.getStats().misses == 2);
+
+	cache.release(first);
+	cache.release(other);
+	cache.release(same);
+	DX3DCheck(cache.getStats().bufferCount == 0);
+}
+
+DX3DTest(ImmutableBufferCache, EqualContentsShareOneBuffer)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() } });
+	auto& cache = backend.getImmutableBufferCache();
+	const std::vector<ui32> a{ 7, 8, 9 };
+	const auto copy = a;
+
+	const auto first = cache.acquire({ a.data(), 12, BufferType::Index });
+	const auto second = cache.acquire({ copy.data(), 12, BufferType::Index });
+	// the type is part of the key; a correct precomputed hash finds the buffer hashed on acquire
+	const auto vertex = cache.acquire({ a.data(), 12, BufferType::Vertex });
+	const auto hashed = cache.acquire({ a.data(), 12, BufferType::Index, BufferUsage::Immutable, Hash::HashBytes(a.data(), 12) });
+	DX3DCheck(first == second);
+	DX3DCheck(!(first == vertex));
+	DX3DCheck(first == hashed);
+	DX3DCheck(cache.getStats().bytesSaved == 24);
+
+	for (const auto buffer : { first, second, vertex, hashed })
+		cache.release(buffer);
+	DX3DCheck(cache.getStats().bufferCount == 0);
+}
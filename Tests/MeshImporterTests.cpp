@@ -0,0 +1,274 @@
+#include "TestFramework.h"
+#include <DX3D/Core/ThreadPool.h>
+#include <DX3D/Graphics/MeshImporter.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+	using namespace dx3d;
+
+	MeshImportOptions RightHanded(ThreadPool* threadPool = nullptr)
+	{
+		MeshImportOptions options{};
+		options.threadPool = threadPool;
+		options.convertToLeftHanded = false;
+		return options;
+	}
+
+	bool ImportObj(const std::string& text, ImportedMesh& mesh, const MeshImportOptions& options = RightHanded(),
+		std::string* error = nullptr)
+	{
+		return MeshImporter::ImportObj(text.data(), text.size(), mesh, options, error);
+	}
+
+	std::string ObjError(const std::string& text)
+	{
+		ImportedMesh mesh{};
+		std::string error;
+		DX3DCheck(!ImportObj(text, mesh, RightHanded(), &error));
+		DX3DCheck(mesh.vertices.empty() && mesh.indices.empty());
+		return error;
+	}
+
+	bool Contains(const std::string& text, const char* part)
+	{
+		return text.find(part) != std::string::npos;
+	}
+
+	// a triangle of three float VEC3 positions and three unsigned short indices, the bin chunk both accessors read
+	constexpr f32 TrianglePositions[9] = { 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 2.0f, 0.0f, 1.0f, 3.0f };
+	constexpr ui16 TriangleIndices[3] = { 0, 1, 2 };
+	const std::string TriangleViews =
+		R"([{"buffer":0,"byteOffset":0,"byteLength":36},{"buffer":0,"byteOffset":36,"byteLength":6}])";
+	const std::string TriangleAccessors =
+		R"([{"bufferView":0,"componentType":5126,"count":3,"type":"VEC3"},)"
+		R"({"bufferView":1,"componentType":5123,"count":3,"type":"SCALAR"}])";
+
+	std::vector<unsigned char> MakeTriangleBin()
+	{
+		std::vector<unsigned char> bin(44);
+		std::memcpy(bin.data(), TrianglePositions, sizeof(TrianglePositions));
+		std::memcpy(bin.data() + 36, TriangleIndices, sizeof(TriangleIndices));
+		return bin;
+	}
+
+	std::string MakeTriangleJson(const std::string& accessors = TriangleAccessors, const std::string& views = TriangleViews,
+		const std::string& node = R"({"mesh":0})")
+	{
+		return R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":44}],"bufferViews":)" + views +
+			R"(,"accessors":)" + accessors +
+			R"(,"meshes":[{"primitives":[{"attributes":{"POSITION":0},"indices":1}]}],"nodes":[)" + node +
+			R"(],"scenes":[{"nodes":[0]}],"scene":0})";
+	}
+
+	// header, JSON chunk padded with spaces, BIN chunk padded with zeros; binLength overrides the BIN chunk's stated size
+	std::vector<unsigned char> MakeGlb(std::string json, std::vector<unsigned char> bin, ui32 binLength = ~0u)
+	{
+		while (json.size() % 4) json += ' ';
+		while (bin.size() % 4) bin.push_back(0);
+
+		std::vector<unsigned char> glb(12 + 8 + json.size() + 8 + bin.size());
+		size_t offset = 0;
+		auto write = [&](const void* data, size_t size)
+			{
+				std::memcpy(glb.data() + offset, data, size);
+				offset += size;
+			};
+		const ui32 header[5] = { 0x46546C67, 2, static_cast<ui32>(glb.size()), static_cast<ui32>(json.size()), 0x4E4F534A };
+		write(header, sizeof(header));
+		write(json.data(), json.size());
+		const ui32 binHeader[2] = { binLength != ~0u ? binLength : static_cast<ui32>(bin.size()), 0x004E4942 };
+		write(binHeader, sizeof(binHeader));
+		write(bin.data(), bin.size());
+		return glb;
+	}
+
+	std::string GlbError(const std::vector<unsigned char>& glb)
+	{
+		ImportedMesh mesh{};
+		std::string error;
+		DX3DCheck(!MeshImporter::ImportGlb(glb.data(), glb.size(), mesh, RightHanded(), &error));
+		DX3DCheck(mesh.vertices.empty() && mesh.indices.empty());
+		return error;
+	}
+
+	std::string GlbErrorFor(const std::string& accessors, const std::string& views = TriangleViews)
+	{
+		return GlbError(MakeGlb(MakeTriangleJson(accessors, views), MakeTriangleBin()));
+	}
+}
+
+DX3DTest(MeshImporter, ObjIndicesAndColors)
+{
+	ImportedMesh mesh{};
+	DX3DRequire(ImportObj(
+		"# a quad, fanned into two triangles\n"
+		"v 0 0 0\n"
+		"v 1 0 0 1 0 0\n"
+		"v 1 1 0 0 1 0 0.5\n"
+		"v 0 1 0.5\r\n"
+		"vt 0 0\n"
+		"f 1/1 2/2/2 3//3 4\n", mesh));
+
+	DX3DRequire(mesh.vertices.size() == 4);
+	DX3DCheck(mesh.indices == std::vector<ui32>({ 0, 1, 2, 0, 2, 3 }));
+	// without r g b the default color, with them their own, a fourth one is alpha
+	DX3DCheck(mesh.vertices[0].r == 1.0f && mesh.vertices[0].a == 1.0f);
+	DX3DCheck(mesh.vertices[1].r == 1.0f && mesh.vertices[1].g == 0.0f);
+	DX3DCheck(mesh.vertices[2].g == 1.0f && mesh.vertices[2].a == 0.5f);
+	DX3DCheck(mesh.vertices[3].z == 0.5f);
+}
+
+DX3DTest(MeshImporter, ObjRelativeIndices)
+{
+	ImportedMesh relative{};
+	DX3DRequire(ImportObj(
+		"v 0 0 0\nv 1 0 0\nv 0 1 0\n"
+		"f -3 -2 -1\n"
+		"v 2 0 0\nv 2 1 0\n"
+		// relative and absolute in one face, -1 is the vertex right above
+		"f -4 -2 -1\n"
+		"f 2 -2 5\n", relative));
+	DX3DCheck(relative.indices == std::vector<ui32>({ 0, 1, 2, 1, 3, 4, 1, 3, 4 }));
+
+	// the engine's handedness: z mirrored and each triangle turned around
+	ImportedMesh leftHanded{};
+	DX3DRequire(ImportObj("v 0 0 1\nv 1 0 1\nv 0 1 1\nf -3 -2 -1\n", leftHanded, MeshImportOptions{}));
+	DX3DCheck(leftHanded.indices == std::vector<ui32>({ 0, 2, 1 }));
+	DX3DCheck(leftHanded.vertices[0].z == -1.0f);
+}
+
+DX3DTest(MeshImporter, ObjChunkBoundaries)
+{
+	// well over the 1 MiB chunks; the faces after the first vertex block reach back across chunk boundaries with
+	// relative indices, and more vertices between the face blocks shift what -1 means
+	constexpr ui32 BlockVertices = 60000;
+	std::string text;
+	std::vector<ui32> expected;
+	ui32 vertexCount = 0;
+	for (ui32 block = 0; block < 2; block++)
+	{
+		for (ui32 i = 0; i < BlockVertices; i++, vertexCount++)
+			text += "v " + std::to_string(vertexCount) + ".5 " + std::to_string(block) + " -0.25 # padding for longer lines\n";
+		for (ui32 i = 0; i + 2 < vertexCount; i += 997)
+		{
+			const auto back = static_cast<i32>(vertexCount - i);
+			text += "f -" + std::to_string(back) + " " + std::to_string(i + 2) + " -" + std::to_string(back - 2) + "\n";
+			expected.insert(expected.end(), { i, i + 1, i + 2 });
+		}
+	}
+	// the last line without a newline
+	text += "f 1 2 3";
+	expected.insert(expected.end(), { 0, 1, 2 });
+
+	ThreadPool threadPool(ThreadPoolDesc{ { Test::GetLogger() }, 3 });
+	for (auto* pool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+	{
+		ImportedMesh mesh{};
+		std::string error;
+		DX3DRequire(ImportObj(text, mesh, RightHanded(pool), &error));
+		DX3DCheck(mesh.stats.chunks >= 3);
+		DX3DCheck(mesh.stats.bytes == text.size());
+		DX3DRequire(mesh.vertices.size() == vertexCount);
+		DX3DCheck(mesh.indices == expected);
+		bool inPlace = true;
+		for (ui32 i = 0; i < vertexCount; i++)
+			inPlace &= mesh.vertices[i].x == static_cast<f32>(i) + 0.5f && mesh.vertices[i].y == static_cast<f32>(i / BlockVertices);
+		DX3DCheck(inPlace);
+	}
+}
+
+DX3DTest(MeshImporter, MalformedObj)
+{
+	DX3DCheck(Contains(ObjError("v 0 0\n"), "a vertex needs x y z."));
+	DX3DCheck(Contains(ObjError("v 0 0 0\nv 1 0 0\nf 1 2\n"), "at least three corners"));
+	DX3DCheck(Contains(ObjError("v 0 0 0\nf 1 x 2\n"), "malformed face"));
+	// index 0 does not exist in OBJ, they count from 1
+	DX3DCheck(Contains(ObjError("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 0 1 2\n"), "malformed face"));
+	DX3DCheck(Contains(ObjError("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n"), "does not exist"));
+	DX3DCheck(Contains(ObjError("v 0 0 0\nv 1 0 0\nf -3 -2 -1\n"), "does not exist"));
+	// the position of the bad line is reported in bytes
+	DX3DCheck(Contains(ObjError("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2\n"), "OBJ at byte 24"));
+}
+
+DX3DTest(MeshImporter, GlbTriangle)
+{
+	const auto glb = MakeGlb(MakeTriangleJson(), MakeTriangleBin());
+	ImportedMesh mesh{};
+	std::string error;
+	DX3DRequire(MeshImporter::ImportGlb(glb.data(), glb.size(), mesh, RightHanded(), &error));
+	DX3DRequire(mesh.vertices.size() == 3);
+	DX3DCheck(mesh.indices == std::vector<ui32>({ 0, 1, 2 }));
+	DX3DCheck(mesh.vertices[1].x == 1.0f && mesh.vertices[2].z == 3.0f);
+
+	// the node's translation is applied, and left-handed conversion mirrors z and flips the triangle
+	const auto moved = MakeGlb(MakeTriangleJson(TriangleAccessors, TriangleViews, R"({"mesh":0,"translation":[1,0,0]})"),
+		MakeTriangleBin());
+	DX3DRequire(MeshImporter::ImportGlb(moved.data(), moved.size(), mesh, MeshImportOptions{}, &error));
+	DX3DCheck(mesh.indices == std::vector<ui32>({ 0, 2, 1 }));
+	DX3DCheck(mesh.vertices[1].x == 2.0f && mesh.vertices[2].z == -3.0f);
+}
+
+DX3DTest(MeshImporter, MalformedGlbAccessors)
+{
+	const std::string positions = R"({"bufferView":0,"componentType":5126,"count":3,"type":"VEC3"})";
+	const std::string indices = R"({"bufferView":1,"componentType":5123,"count":3,"type":"SCALAR"})";
+	auto accessors = [](const std::string& first, const std::string& second) { return "[" + first + "," + second + "]"; };
+
+	// counts and offsets past the view or the view past the BIN chunk
+	DX3DCheck(Contains(GlbErrorFor(accessors(R"({"bufferView":0,"componentType":5126,"count":4,"type":"VEC3"})", indices)),
+		"reaches past its buffer"));
+	DX3DCheck(Contains(GlbErrorFor(accessors(positions,
+		R"({"bufferView":1,"byteOffset":2,"componentType":5123,"count":3,"type":"SCALAR"})")), "reaches past its buffer"));
+	DX3DCheck(Contains(GlbErrorFor(TriangleAccessors,
+		R"([{"buffer":0,"byteOffset":0,"byteLength":36},{"buffer":0,"byteOffset":40,"byteLength":6}])"), "reaches past its buffer"));
+	DX3DCheck(Contains(GlbErrorFor(TriangleAccessors,
+		R"([{"buffer":0,"byteOffset":0,"byteLength":36,"byteStride":16},{"buffer":0,"byteOffset":36,"byteLength":6}])"),
+		"reaches past its buffer"));
+
+	// types the decoder cannot read
+	DX3DCheck(Contains(GlbErrorFor(accessors(R"({"bufferView":0,"componentType":5126,"count":4,"type":"VEC2"})", indices)),
+		"POSITION has to be float VEC3"));
+	DX3DCheck(Contains(GlbErrorFor(accessors(positions, R"({"bufferView":1,"componentType":5126,"count":1,"type":"SCALAR"})")),
+		"unsupported index accessor"));
+	DX3DCheck(Contains(GlbErrorFor(accessors(positions, R"({"bufferView":1,"componentType":5120,"count":3,"type":"SCALAR"})")),
+		"unsupported component type"));
+	DX3DCheck(Contains(GlbErrorFor(accessors(positions, R"({"bufferView":1,"componentType":5123,"count":3,"type":"MAT2"})")),
+		"unsupported accessor type"));
+	DX3DCheck(Contains(GlbErrorFor(accessors(positions,
+		R"({"bufferView":1,"componentType":5123,"count":3,"type":"SCALAR","sparse":{}})")), "sparse accessors"));
+	DX3DCheck(Contains(GlbErrorFor(accessors(positions, R"({"componentType":5123,"count":3,"type":"SCALAR"})")),
+		"without a buffer view"));
+
+	// indices that are not indices
+	DX3DCheck(Contains(GlbErrorFor(accessors(positions, R"({"bufferView":1,"componentType":5123,"count":2,"type":"SCALAR"})")),
+		"multiple of three"));
+	DX3DCheck(Contains(GlbErrorFor(accessors(positions, R"({"bufferView":-1,"componentType":5123,"count":3,"type":"SCALAR"})")),
+		"not a valid index"));
+	DX3DCheck(Contains(GlbErrorFor(accessors(positions, R"({"bufferView":7,"componentType":5123,"count":3,"type":"SCALAR"})")),
+		"missing bufferViews entry 7"));
+	DX3DCheck(Contains(GlbErrorFor("[" + positions + "]"), "missing accessors entry 1"));
+
+	auto bin = MakeTriangleBin();
+	const ui16 outOfRange = 3;
+	std::memcpy(bin.data() + 40, &outOfRange, sizeof(outOfRange));
+	DX3DCheck(Contains(GlbError(MakeGlb(MakeTriangleJson(), bin)), "references a vertex that does not exist"));
+}
+
+DX3DTest(MeshImporter, MalformedGlbContainer)
+{
+	auto glb = MakeGlb(MakeTriangleJson(), MakeTriangleBin());
+	DX3DCheck(Contains(GlbError({ glb.begin(), glb.begin() + 16 }), "Not a binary glTF file"));
+
+	auto version = glb;
+	version[4] = 1;
+	DX3DCheck(Contains(GlbError(version), "only version 2"));
+
+	DX3DCheck(Contains(GlbError(MakeGlb(MakeTriangleJson(), MakeTriangleBin(), 4096)), "BIN chunk is truncated"));
+	DX3DCheck(Contains(GlbError(MakeGlb(R"({"meshes":[)", MakeTriangleBin())), "malformed JSON"));
+
+	// cut off inside the BIN chunk, the header's length is not trusted over the real size
+	DX3DCheck(!GlbError({ glb.begin(), glb.end() - 8 }).empty());
+}
@@ -0,0 +1,157 @@
+#include "TestMeshes.h"
+#include <DX3D/Graphics/MeshOptimizer.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	using namespace dx3d;
+
+	constexpr ui32 Cells = 24;
+
+	// a triangle as the bytes of its three vertices, turned to start at the smallest so the winding is kept
+	using Triangle = std::array<std::string, 3>;
+
+	// the mesh as a sorted list of triangles, independent of triangle order, vertex order and which corner comes first
+	std::vector<Triangle> GetTriangles(const ui32* indices, size_t indexCount, const void* vertices, size_t vertexStride)
+	{
+		const auto* bytes = static_cast<const unsigned char*>(vertices);
+		std::vector<Triangle> triangles;
+		for (size_t i = 0; i + 2 < indexCount; i += 3)
+		{
+			Triangle triangle{};
+			for (size_t corner = 0; corner < 3; corner++)
+				triangle[corner].assign(reinterpret_cast<const char*>(bytes + indices[i + corner] * vertexStride), vertexStride);
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+			triangles.push_back(std::move(triangle));
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	std::vector<Triangle> GetTriangles(const std::vector<ui32>& indices, const std::vector<Vertex>& vertices)
+	{
+		return GetTriangles(indices.data(), indices.size(), vertices.data(), sizeof(Vertex));
+	}
+
+	// the grid's triangles in a fixed random order, about the worst a post-transform cache can get
+	std::vector<ui32> ShuffleTriangles(std::vector<ui32> indices)
+	{
+		std::vector<std::array<ui32, 3>> triangles(indices.size() / 3);
+		std::memcpy(triangles.data(), indices.data(), indices.size() * sizeof(ui32));
+		std::mt19937 random(1234);
+		for (size_t i = triangles.size() - 1; i > 0; i--)
+			std::swap(triangles[i], triangles[random() % (i + 1)]);
+		std::memcpy(indices.data(), triangles.data(), indices.size() * sizeof(ui32));
+		return indices;
+	}
+}
+
+DX3DTest(MeshOptimizer, WeldKeepsEveryTriangle)
+{
+	const auto vertices = Test::MakeGridVertices(Cells, 0.1f);
+	const auto indices = Test::MakeGridIndices(Cells);
+	std::vector<Vertex> soup;
+	for (const auto index : indices)
+		soup.push_back(vertices[index]);
+
+	std::vector<unsigned char> welded;
+	std::vector<ui32> weldedIndices;
+	const auto unique = MeshOptimizer::WeldVertices(soup.data(), sizeof(Vertex), soup.size(), welded, weldedIndices);
+	DX3DCheck(unique == vertices.size());
+	DX3DCheck(welded.size() == unique * sizeof(Vertex));
+	DX3DRequire(weldedIndices.size() == soup.size());
+	// every corner reads back the very vertex it was before
+	for (size_t i = 0; i < soup.size(); i++)
+		DX3DCheck(!std::memcmp(welded.data() + weldedIndices[i] * sizeof(Vertex), &soup[i], sizeof(Vertex)));
+	DX3DCheck(GetTriangles(weldedIndices.data(), weldedIndices.size(), welded.data(), sizeof(Vertex)) ==
+		GetTriangles(indices, vertices));
+}
+
+DX3DTest(MeshOptimizer, CachePassKeepsTheTrianglesAndLowersAcmr)
+{
+	const auto vertices = Test::MakeGridVertices(Cells, 0.1f);
+	const auto before = GetTriangles(Test::MakeGridIndices(Cells), vertices);
+
+	// the rows as authored and shuffled, neither may get worse
+	for (auto indices : { Test::MakeGridIndices(Cells), ShuffleTriangles(Test::MakeGridIndices(Cells)) })
+	{
+		const auto acmrBefore = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+		MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), vertices.size());
+		const auto acmrAfter = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+		DX3DCheck(GetTriangles(indices, vertices) == before);
+		DX3DCheck(acmrAfter <= acmrBefore);
+		// a grid can get close to its ideal 0.5, a FIFO cache of 16 is well under 1
+		DX3DCheck(acmrAfter < 0.9f);
+	}
+
+	const auto shuffled = ShuffleTriangles(Test::MakeGridIndices(Cells));
+	DX3DCheck(MeshOptimizer::AnalyzeVertexCache(shuffled.data(), shuffled.size(), vertices.size()) > 1.5f);
+}
+
+DX3DTest(MeshOptimizer, OverdrawPassKeepsTheTriangles)
+{
+	const auto vertices = Test::MakeGridVertices(Cells, 0.3f);
+	auto indices = ShuffleTriangles(Test::MakeGridIndices(Cells));
+	const auto before = GetTriangles(indices, vertices);
+
+	MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), vertices.size());
+	const auto acmrCache = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+	const auto clusters = MeshOptimizer::OptimizeOverdraw(indices.data(), indices.size(), vertices.data(), sizeof(Vertex),
+		vertices.size());
+	const auto acmrOverdraw = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+	DX3DCheck(clusters >= 1);
+	DX3DCheck(clusters <= indices.size() / 3);
+	DX3DCheck(GetTriangles(indices, vertices) == before);
+	// the clusters only end where the cache allowed it, sorting them costs the misses at their seams
+	DX3DCheck(acmrOverdraw <= acmrCache * MeshOptimizer::DefaultOverdrawThreshold + 0.05f);
+}
+
+DX3DTest(MeshOptimizer, FetchPassRenumbersConsistently)
+{
+	auto vertices = Test::MakeGridVertices(Cells, 0.1f);
+	// a vertex no triangle uses, it is dropped
+	vertices.push_back({ 9.0f, 9.0f, 9.0f, 1.0f, 1.0f, 1.0f, 1.0f });
+	auto indices = ShuffleTriangles(Test::MakeGridIndices(Cells));
+	MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), vertices.size());
+	const auto before = GetTriangles(indices, vertices);
+	const auto acmrBefore = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+	const auto used = MeshOptimizer::OptimizeVertexFetch(indices.data(), indices.size(), vertices.data(), sizeof(Vertex),
+		vertices.size());
+	DX3DCheck(used == vertices.size() - 1);
+	// every triangle still reads the same vertices, and the indices count up in the order they are first used
+	DX3DCheck(GetTriangles(indices.data(), indices.size(), vertices.data(), sizeof(Vertex)) == before);
+	ui32 next = 0;
+	for (const auto index : indices)
+	{
+		DX3DCheck(index <= next);
+		if (index == next) next++;
+	}
+	DX3DCheck(next == used);
+	// renumbering does not change which vertices are in the cache
+	DX3DCheck(MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), used) == acmrBefore);
+}
+
+DX3DTest(MeshOptimizer, OptimizeNeverWorsensAGrid)
+{
+	const auto vertices = Test::MakeGridVertices(Cells, 0.1f);
+	const auto indices = Test::MakeGridIndices(Cells);
+	std::vector<unsigned char> optimized;
+	std::vector<ui32> optimizedIndices;
+	const auto stats = MeshOptimizer::Optimize(vertices.data(), sizeof(Vertex), vertices.size(), indices.data(), indices.size(),
+		optimized, optimizedIndices);
+
+	DX3DCheck(stats.uniqueVertices == vertices.size());
+	DX3DCheck(stats.triangles == Cells * Cells * 2);
+	DX3DCheck(stats.acmrAfter <= stats.acmrBefore);
+	DX3DCheck(stats.acmrAfter == MeshOptimizer::AnalyzeVertexCache(optimizedIndices.data(), optimizedIndices.size(),
+		stats.uniqueVertices));
+	DX3DCheck(GetTriangles(optimizedIndices.data(), optimizedIndices.size(), optimized.data(), sizeof(Vertex)) ==
+		GetTriangles(indices, vertices));
+}
@@ -0,0 +1,100 @@
+#include "TestMeshes.h"
+#include <DX3D/Graphics/MeshSimplifier.h>
+#include <algorithm>
+#include <array>
+#include <set>
+#include <vector>
+
+namespace
+{
+	using namespace dx3d;
+
+	constexpr ui32 GridCells = 40;
+
+	// (a, b, c) with c the smallest index, so the same triangle compares equal however it was rotated
+	std::set<std::array<ui32, 3>> GetTriangles(const ui32* indices, size_t count)
+	{
+		std::set<std::array<ui32, 3>> triangles;
+		for (size_t i = 0; i + 2 < count; i += 3)
+		{
+			std::array<ui32, 3> triangle{ indices[i], indices[i + 1], indices[i + 2] };
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+			triangles.insert(triangle);
+		}
+		return triangles;
+	}
+}
+
+DX3DTest(MeshSimplifier, ChainStartsWithTheInputAndShrinks)
+{
+	const auto vertices = Test::MakeGridVertices(GridCells, 0.1f);
+	const auto indices = Test::MakeGridIndices(GridCells);
+	std::vector<ui32> lodIndices;
+	const auto levels = MeshSimplifier::BuildLodChain(indices.data(), indices.size(), vertices.data(), sizeof(Vertex),
+		vertices.size(), lodIndices);
+
+	DX3DRequire(levels.size() >= 3);
+	DX3DCheck(levels.size() <= MeshLodOptions{}.maxLevels);
+	DX3DCheck(levels[0].firstIndex == 0 && levels[0].indexCount == indices.size() && levels[0].error == 0.0f);
+	DX3DCheck(GetTriangles(lodIndices.data(), levels[0].indexCount) == GetTriangles(indices.data(), indices.size()));
+
+	bool shrinks = true, errorsGrow = true, packed = true, valid = true, minimumKept = true;
+	for (size_t i = 1; i < levels.size(); i++)
+	{
+		shrinks &= levels[i].indexCount < levels[i - 1].indexCount && levels[i].indexCount % 3 == 0;
+		errorsGrow &= levels[i].error >= levels[i - 1].error;
+		packed &= levels[i].firstIndex == levels[i - 1].firstIndex + levels[i - 1].indexCount;
+		minimumKept &= levels[i].indexCount / 3 >= MeshLodOptions{}.minTriangles;
+	}
+	for (const auto index : lodIndices)
+		valid &= index < vertices.size();
+	DX3DCheck(shrinks);
+	DX3DCheck(errorsGrow);
+	DX3DCheck(packed);
+	DX3DCheck(minimumKept);
+	DX3DCheck(valid);
+	DX3DCheck(levels.back().firstIndex + levels.back().indexCount == lodIndices.size());
+}
+
+DX3DTest(MeshSimplifier, ErrorStaysWithinTheLimit)
+{
+	const auto vertices = Test::MakeGridVertices(GridCells, 0.3f);
+	const auto indices = Test::MakeGridIndices(GridCells);
+	MeshLodOptions options{};
+	options.maxError = 0.02f;
+	std::vector<ui32> lodIndices;
+	const auto levels = MeshSimplifier::BuildLodChain(indices.data(), indices.size(), vertices.data(), sizeof(Vertex),
+		vertices.size(), lodIndices, options);
+
+	// the bounding radius of the grid is about sqrt(2)
+	for (const auto& level : levels)
+		DX3DCheck(level.error <= options.maxError * 1.5f);
+}
+
+DX3DTest(MeshSimplifier, FlatGridCollapsesWithoutError)
+{
+	const auto vertices = Test::MakeGridVertices(GridCells);
+	const auto indices = Test::MakeGridIndices(GridCells);
+	std::vector<ui32> simplified;
+	const auto error = MeshSimplifier::Simplify(indices.data(), indices.size(), vertices.data(), sizeof(Vertex),
+		vertices.size(), indices.size() / 4, 0.01f, simplified);
+
+	DX3DCheck(simplified.size() <= indices.size() / 2);
+	DX3DCheck(simplified.size() % 3 == 0);
+	DX3DCheck(error < 1.0e-4f);
+}
+
+DX3DTest(MeshSimplifier, BorderStaysInPlace)
+{
+	const auto vertices = Test::MakeGridVertices(GridCells);
+	const auto indices = Test::MakeGridIndices(GridCells);
+	std::vector<ui32> simplified;
+	MeshSimplifier::Simplify(indices.data(), indices.size(), vertices.data(), sizeof(Vertex), vertices.size(),
+		indices.size() / 8, 0.01f, simplified);
+
+	// the four corners span the grid; taking one away moves the border by a whole cell (0.05), past the error limit
+	const ui32 row = GridCells + 1;
+	const ui32 corners[] = { 0, GridCells, GridCells * row, GridCells * row + GridCells };
+	for (const auto corner : corners)
+		DX3DCheck(std::find(simplified.begin(), simplified.end(), corner) != simplified.end());
+}
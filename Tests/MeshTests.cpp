@@ -0,0 +1,85 @@
+#include "TestMeshes.h"
+#include <DX3D/Graphics/Null/NullGraphicsBackend.h>
+#include <vector>
+
+namespace
+{
+	using namespace dx3d;
+
+	// the camera at the origin looking down +z, the mesh centred distance units in front of it
+	MeshLodContext MakeLodContext()
+	{
+		MeshLodContext lod{};
+		lod.viewProjection = Mat4::perspectiveFovLH(1.0f, 1.0f, 0.1f, 10000.0f);
+		lod.viewportHeight = 720.0f;
+		return lod;
+	}
+
+	Mat4 At(f32 distance)
+	{
+		return Mat4::translation({ 0.0f, 0.0f, distance });
+	}
+
+	Test::TestMesh MakeWavyGrid(GraphicsBackend& backend)
+	{
+		return Test::TestMesh(backend, Test::MakeGridVertices(40, 0.1f), Test::MakeGridIndices(40));
+	}
+}
+
+DX3DTest(Mesh, LevelsCoarsenWithDistance)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() } });
+	const auto mesh = MakeWavyGrid(backend);
+	const auto lod = MakeLodContext();
+	const auto levelCount = static_cast<ui32>(mesh.getLodLevels().size());
+	DX3DRequire(levelCount >= 3);
+
+	DX3DCheck(mesh.selectLod(At(0.5f), lod, 0) == 0);
+	DX3DCheck(mesh.selectLod(At(5000.0f), lod, 0) == levelCount - 1);
+	// behind the camera it is drawn at full detail
+	DX3DCheck(mesh.selectLod(At(-10.0f), lod, 0) == 0);
+
+	bool monotonic = true;
+	ui32 previous = 0;
+	for (f32 distance = 0.5f; distance < 5000.0f; distance *= 1.1f)
+	{
+		const auto level = mesh.selectLod(At(distance), lod, 0);
+		monotonic &= level >= previous;
+		previous = level;
+	}
+	DX3DCheck(monotonic);
+}
+
+DX3DTest(Mesh, HysteresisKeepsTheCurrentLevel)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() } });
+	const auto mesh = MakeWavyGrid(backend);
+	const auto lod = MakeLodContext();
+	const auto coarsest = static_cast<ui32>(mesh.getLodLevels().size()) - 1;
+
+	// coming from a coarser level never picks a finer one than coming from the full mesh, and somewhere
+	// inside the hysteresis band it keeps the coarser one where a fresh pick would not
+	bool neverFiner = true;
+	f32 bandDistance = 0.0f;
+	for (f32 distance = 0.5f; distance < 5000.0f; distance *= 1.02f)
+	{
+		const auto fresh = mesh.selectLod(At(distance), lod, 0);
+		const auto kept = mesh.selectLod(At(distance), lod, coarsest);
+		neverFiner &= kept >= fresh;
+		if (!bandDistance && kept > fresh) bandDistance = distance;
+	}
+	DX3DCheck(neverFiner);
+	DX3DRequire(bandDistance > 0.0f);
+
+	// moving back and forth across the threshold switches the level once, not every frame
+	ui32 level = mesh.selectLod(At(bandDistance), lod, 0);
+	ui32 switches = 0;
+	for (int frame = 0; frame < 20; frame++)
+	{
+		const auto distance = frame % 2 ? bandDistance : bandDistance * 1.25f;
+		const auto next = mesh.selectLod(At(distance), lod, level);
+		switches += next != level;
+		level = next;
+	}
+	DX3DCheck(switches <= 1);
+}
@@ -0,0 +1,176 @@
+#include "TestMeshes.h"
+#include <DX3D/Core/ThreadPool.h>
+#include <DX3D/Graphics/SceneRenderer.h>
+#include <DX3D/Graphics/RenderQueue.h>
+#include <DX3D/Graphics/Null/NullGraphicsBackend.h>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	using namespace dx3d;
+
+	Test::TestMesh MakeQuad(GraphicsBackend& backend)
+	{
+		return Test::TestMesh(backend, {
+			{ -0.5f, 0.5f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f }, { 0.5f, 0.5f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f },
+			{ 0.5f, -0.5f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f }, { -0.5f, -0.5f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f } },
+			{ 0, 1, 2, 0, 2, 3 });
+	}
+
+	// the object constants of the recorded draws, in execution order
+	std::vector<Mat4> GetObjectConstants(const NullGraphicsBackend& backend)
+	{
+		std::vector<Mat4> worlds;
+		for (const auto& command : backend.getRecordedCommands())
+		{
+			if (command.type != RecordedCommandType::SetConstantBuffer || command.slot != ObjectConstantsSlot) continue;
+			Mat4 world{};
+			std::memcpy(&world, backend.getBufferContents({ command.handle }).data() + command.byteOffset, sizeof(world));
+			worlds.push_back(world);
+		}
+		return worlds;
+	}
+
+	void RenderFrame(SceneRenderer& renderer)
+	{
+		renderer.prepare();
+		renderer.getBackend().beginFrame({ {}, renderer.getCommandListCount() });
+		renderer.render();
+		renderer.getBackend().endFrame();
+	}
+}
+
+DX3DTest(SceneRenderer, SubmittedMeshesDrawWithTheirWorldMatrices)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() }, true, 2 });
+	SceneRenderer renderer(SceneRendererDesc{ { Test::GetLogger() }, backend });
+	auto mesh = MakeQuad(backend);
+
+	const auto a = Mat4::translation({ 1.0f, 2.0f, 3.0f });
+	const auto b = Mat4::translation({ 4.0f, 5.0f, 6.0f });
+	for (int frame = 0; frame < 4; frame++)
+	{
+		renderer.update();
+		renderer.submitMesh(mesh, a);
+		renderer.submitMesh(mesh, a);
+		renderer.submitMesh(mesh, b);
+		RenderFrame(renderer);
+	}
+
+	// both draws at a share one block, so its binding is skipped by the state cache for the second one
+	const auto worlds = GetObjectConstants(backend);
+	DX3DRequire(worlds.size() == 2);
+	DX3DCheck(!std::memcmp(&worlds[0], &a, sizeof(Mat4)));
+	DX3DCheck(!std::memcmp(&worlds[1], &b, sizeof(Mat4)));
+	DX3DCheck(backend.getStats().lastFrame.drawCalls == 3);
+	DX3DCheck(renderer.getConstantRing().getStats().blocksUploaded == 8);
+	DX3DCheck(renderer.getConstantRing().getStats().blocksDeduplicated == 4);
+	DX3DCheck(renderer.getConstantRing().getUploadRing().getStats().grows == 0);
+}
+
+DX3DTest(SceneRenderer, MeshesOnlyBetweenUpdateAndPrepare)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() } });
+	SceneRenderer renderer(SceneRendererDesc{ { Test::GetLogger() }, backend });
+	auto mesh = MakeQuad(backend);
+
+	DX3DCheckThrows(renderer.submitMesh(mesh), std::runtime_error);
+	DX3DCheckThrows(renderer.prepare(), std::runtime_error);
+	renderer.update();
+	renderer.prepare();
+	DX3DCheckThrows(renderer.submitMesh(mesh), std::runtime_error);
+
+	// an update without a render drops the frame and starts the next one
+	renderer.update();
+	renderer.update();
+	renderer.submitMesh(mesh);
+	RenderFrame(renderer);
+	DX3DCheck(backend.getStats().lastFrame.drawCalls == 1);
+}
+
+DX3DTest(SceneRenderer, MeshInstancesKeepTheirOwnLevelOfDetail)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() } });
+	SceneRenderer renderer(SceneRendererDesc{ { Test::GetLogger() }, backend });
+	const Test::TestMesh mesh(backend, Test::MakeGridVertices(40, 0.1f), Test::MakeGridIndices(40));
+	const auto& levels = mesh.getLodLevels();
+	const auto coarsest = static_cast<ui32>(levels.size()) - 1;
+	DX3DRequire(coarsest >= 2);
+
+	renderer.setCamera(Mat4::perspectiveFovLH(1.0f, 1.0f, 0.1f, 10000.0f));
+	renderer.setMeshLod(720.0f);
+
+	// a distance inside the hysteresis band, where the level depends on where the instance came from
+	MeshLodContext lod{};
+	lod.viewProjection = Mat4::perspectiveFovLH(1.0f, 1.0f, 0.1f, 10000.0f);
+	f32 bandDistance = 0.0f;
+	for (f32 distance = 0.5f; distance < 5000.0f && !bandDistance; distance *= 1.02f)
+	{
+		const auto world = Mat4::translation({ 0.0f, 0.0f, distance });
+		if (mesh.selectLod(world, lod, coarsest) > mesh.selectLod(world, lod, 0)) bandDistance = distance;
+	}
+	DX3DRequire(bandDistance > 0.0f);
+	const auto world = Mat4::translation({ 0.0f, 0.0f, bandDistance });
+	const auto expectedFine = mesh.selectLod(world, lod, 0);
+	const auto expectedCoarse = mesh.selectLod(world, lod, coarsest);
+
+	// two instances at the same place, one arriving from full detail and one from the coarsest level
+	ui32 fine = 0, coarse = coarsest;
+	for (int frame = 0; frame < 4; frame++)
+	{
+		renderer.update();
+		renderer.submitMesh(mesh, world, &fine);
+		renderer.submitMesh(mesh, world, &coarse);
+		RenderFrame(renderer);
+		DX3DCheck(fine == expectedFine);
+		DX3DCheck(coarse == expectedCoarse);
+	}
+
+	const auto& stats = renderer.getMeshLodStats();
+	const ui64 full = levels[0].indexCount / 3;
+	DX3DCheck(stats.levelDraws[expectedFine] + stats.levelDraws[expectedCoarse] == 2);
+	DX3DCheck(stats.trianglesDrawn == (levels[expectedFine].indexCount + levels[expectedCoarse].indexCount) / 3);
+	DX3DCheck(stats.trianglesSaved == 2 * full - stats.trianglesDrawn);
+
+	// the stats are per frame, and draws without a level are full detail and not counted
+	renderer.update();
+	renderer.submitMesh(mesh, world);
+	RenderFrame(renderer);
+	DX3DCheck(renderer.getMeshLodStats().trianglesDrawn == 0);
+	DX3DCheck(backend.getStats().lastFrame.primitives == full);
+}
+
+DX3DTest(SceneRenderer, CommandListsFollowTheDrawCount)
+{
+	NullGraphicsBackend backend(NullGraphicsBackendDesc{ { Test::GetLogger() } });
+	ThreadPool threadPool(ThreadPoolDesc{ { Test::GetLogger() }, 3 });
+	SceneRenderer renderer(SceneRendererDesc{ { Test::GetLogger() }, backend, &threadPool, {}, 8 });
+	auto mesh = MakeQuad(backend);
+
+	// every submit is its own draw, the lists get at least eight of them and there are no more lists than threads
+	auto listsFor = [&](ui32 draws)
+		{
+			renderer.update();
+			for (ui32 i = 0; i < draws; i++)
+				renderer.submitMesh(mesh, Mat4::translation({ static_cast<f32>(i), 0.0f, 0.0f }));
+			RenderFrame(renderer);
+			DX3DCheck(backend.getStats().lastFrame.drawCalls == draws);
+			return renderer.getCommandListCount();
+		};
+	DX3DCheck(listsFor(0) == 1);
+	DX3DCheck(listsFor(15) == 1);
+	DX3DCheck(listsFor(16) == 2);
+	DX3DCheck(listsFor(31) == 3);
+	DX3DCheck(listsFor(200) == threadPool.getThreadCount());
+
+	SceneRenderer serial(SceneRendererDesc{ { Test::GetLogger() }, backend, nullptr, {}, 8 });
+	serial.update();
+	for (ui32 i = 0; i < 200; i++)
+		serial.submitMesh(mesh, Mat4::translation({ static_cast<f32>(i), 0.0f, 0.0f }));
+	serial.prepare();
+	DX3DCheck(serial.getCommandListCount() == 1);
+
+	DX3DCheckThrows(SceneRenderer(SceneRendererDesc{ { Test::GetLogger() }, backend, nullptr, {}, 0 }), std::invalid_argument);
+}
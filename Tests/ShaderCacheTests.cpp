@@ -0,0 +1,194 @@
+#include "TestFramework.h"
+#include <DX3D/Graphics/ShaderCache.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace
+{
+	using namespace dx3d;
+
+	// stands in for D3DCompile: the "bytecode" is the entry point followed by the source, fails on "error"
+	struct StubCompiler
+	{
+		int calls{};
+
+		ShaderCompileFunction getFunction()
+		{
+			return [this](const ShaderCompileRequest& request, ShaderBytecode& outBytecode, std::string& outErrors)
+			{
+				calls++;
+				const std::string source(static_cast<const char*>(request.sourceCode), request.sourceCodeSize);
+				if (source.find("error") != std::string::npos)
+				{
+					outErrors = "stub: syntax error";
+					return false;
+				}
+
+				const auto text = std::string(request.entryPoint) + ":" + source;
+				outBytecode.assign(text.begin(), text.end());
+				return true;
+			};
+		}
+	};
+
+	// an empty cache directory for one test case, removed again afterwards
+	struct TemporaryDirectory
+	{
+		std::filesystem::path path{};
+
+		explicit TemporaryDirectory(const char* name) : path(std::filesystem::temp_directory_path() / name)
+		{
+			std::filesystem::remove_all(path);
+		}
+
+		~TemporaryDirectory()
+		{
+			std::error_code error{};
+			std::filesystem::remove_all(path, error);
+		}
+	};
+
+	constexpr char VertexSource[] = "float4 vsmain(float4 p : POSITION) : SV_POSITION { return p; }";
+
+	ShaderCompileRequest MakeRequest(const char* source = VertexSource)
+	{
+		return { source, std::char_traits<char>::length(source), "VertexShader.hlsl", "vsmain", "vs_5_0" };
+	}
+
+	ShaderCacheDesc MakeCacheDesc(StubCompiler& compiler, const std::filesystem::path& directory = {},
+		const char* compilerId = "stub 1")
+	{
+		return { { Test::GetLogger() }, directory, compilerId, compiler.getFunction() };
+	}
+}
+
+DX3DTest(ShaderCache, CompilesOnceInProcess)
+{
+	StubCompiler compiler{};
+	ShaderCache cache(MakeCacheDesc(compiler));
+
+	const auto first = cache.getOrCompile(MakeRequest());
+	const auto second = cache.getOrCompile(MakeRequest());
+	DX3DRequire(first && second);
+	DX3DCheck(first == second);
+	DX3DCheck(compiler.calls == 1);
+
+	const auto stats = cache.getStats();
+	DX3DCheck(stats.compiles == 1);
+	DX3DCheck(stats.memoryHits == 1);
+	DX3DCheck(stats.diskWrites == 0);
+}
+
+DX3DTest(ShaderCache, KeyCoversEveryInput)
+{
+	StubCompiler compiler{}, otherCompiler{};
+	ShaderCache cache(MakeCacheDesc(compiler));
+	ShaderCache otherCache(MakeCacheDesc(otherCompiler, {}, "stub 2"));
+
+	const auto request = MakeRequest();
+	const auto key = cache.computeKey(request);
+	DX3DCheck(cache.computeKey(MakeRequest()) == key);
+	DX3DCheck(otherCache.computeKey(request) != key);
+
+	auto changed = request;
+	changed.sourceCodeSize--;
+	DX3DCheck(cache.computeKey(changed) != key);
+
+	changed = request;
+	changed.entryPoint = "psmain";
+	DX3DCheck(cache.computeKey(changed) != key);
+
+	changed = request;
+	changed.target = "vs_4_0";
+	DX3DCheck(cache.computeKey(changed) != key);
+
+	changed = request;
+	changed.flags = 1;
+	DX3DCheck(cache.computeKey(changed) != key);
+
+	changed = request;
+	changed.defines = { { "DX3D_POSITION_SNORM", "1" } };
+	const auto definedKey = cache.computeKey(changed);
+	DX3DCheck(definedKey != key);
+	changed.defines = { { "DX3D_POSITION_SNORM", "0" } };
+	DX3DCheck(cache.computeKey(changed) != definedKey);
+
+	// the source name is only for diagnostics
+	changed = request;
+	changed.sourceName = "Elsewhere.hlsl";
+	DX3DCheck(cache.computeKey(changed) == key);
+}
+
+DX3DTest(ShaderCache, ReusesDiskEntriesAcrossRuns)
+{
+	TemporaryDirectory directory("DX3DTests-ShaderCache-Disk");
+	StubCompiler firstRun{}, secondRun{};
+
+	ShaderBytecodePtr compiled{};
+	{
+		ShaderCache cache(MakeCacheDesc(firstRun, directory.path));
+		compiled = cache.getOrCompile(MakeRequest());
+		DX3DCheck(cache.getStats().diskWrites == 1);
+	}
+
+	ShaderCache cache(MakeCacheDesc(secondRun, directory.path));
+	const auto loaded = cache.getOrCompile(MakeRequest());
+	DX3DRequire(compiled && loaded);
+	DX3DCheck(*loaded == *compiled);
+	DX3DCheck(secondRun.calls == 0);
+	DX3DCheck(cache.getStats().diskHits == 1);
+}
+
+DX3DTest(ShaderCache, RecompilesCorruptEntries)
+{
+	TemporaryDirectory directory("DX3DTests-ShaderCache-Corrupt");
+	StubCompiler compiler{};
+	{
+		ShaderCache cache(MakeCacheDesc(compiler, directory.path));
+		cache.getOrCompile(MakeRequest());
+	}
+
+	// flip the last byte of the bytecode, the checksum no longer matches
+	DX3DRequire(std::distance(std::filesystem::directory_iterator(directory.path), std::filesystem::directory_iterator()) == 1);
+	const auto entry = std::filesystem::directory_iterator(directory.path)->path();
+	{
+		std::fstream file(entry, std::ios::binary | std::ios::in | std::ios::out);
+		file.seekg(-1, std::ios::end);
+		const auto last = static_cast<char>(file.get());
+		file.seekp(-1, std::ios::end);
+		file.put(static_cast<char>(last ^ 0x5a));
+	}
+
+	ShaderCache cache(MakeCacheDesc(compiler, directory.path));
+	DX3DCheck(cache.getOrCompile(MakeRequest()) != nullptr);
+	DX3DCheck(compiler.calls == 2);
+	DX3DCheck(cache.getStats().diskHits == 0);
+}
+
+DX3DTest(ShaderCache, CompilerIdInvalidatesDiskEntries)
+{
+	TemporaryDirectory directory("DX3DTests-ShaderCache-CompilerId");
+	StubCompiler oldCompiler{}, newCompiler{};
+	{
+		ShaderCache cache(MakeCacheDesc(oldCompiler, directory.path, "stub 1"));
+		cache.getOrCompile(MakeRequest());
+	}
+
+	ShaderCache cache(MakeCacheDesc(newCompiler, directory.path, "stub 2"));
+	cache.getOrCompile(MakeRequest());
+	DX3DCheck(newCompiler.calls == 1);
+}
+
+DX3DTest(ShaderCache, ReportsCompileErrorsWithoutCaching)
+{
+	StubCompiler compiler{};
+	ShaderCache cache(MakeCacheDesc(compiler));
+
+	std::string errors{};
+	DX3DCheck(cache.getOrCompile(MakeRequest("error here"), &errors) == nullptr);
+	DX3DCheck(errors == "stub: syntax error");
+	DX3DCheck(cache.getOrCompile(MakeRequest("error here")) == nullptr);
+	DX3DCheck(compiler.calls == 2);
+	DX3DCheck(cache.getStats().compiles == 0);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <DX3D/Core/Logger.h>
+#include <stdexcept>
+
+namespace dx3d
+{
+	/*
+	* Just enough of a test runner for the headless parts of the engine, no third-party framework.
+	* DX3DTest(Suite, Name) registers a test case, DX3DCheck records a failure and carries on,
+	* DX3DRequire records it and ends the test case. An exception leaving a test case fails it as well.
+	*/
+	namespace Test
+	{
+		using TestFunction = void (*)();
+
+		struct Registrar
+		{
+			Registrar(const char* suite, const char* name, TestFunction function);
+		};
+
+		// thrown by DX3DRequire to end the test case, counted once
+		struct RequireFailed final : std::runtime_error
+		{
+			using std::runtime_error::runtime_error;
+		};
+
+		void ReportFailure(const char* file, int line, const char* expression);
+		// errors only and written synchronously, for the Base-derived classes under test
+		Logger& GetLogger();
+		// whether the runner was started with the option, e.g. HasOption("--update-goldens")
+		bool HasOption(const char* option);
+	}
+}
+
+#define DX3DTest(suite, name)\
+	static void DX3DTest_##suite##_##name();\
+	static const dx3d::Test::Registrar DX3DTestRegistrar_##suite##_##name(#suite, #name, &DX3DTest_##suite##_##name);\
+	static void DX3DTest_##suite##_##name()
+
+#define DX3DCheck(condition)\
+	do { if (!(condition)) dx3d::Test::ReportFailure(__FILE__, __LINE__, #condition); } while (0)
+
+#define DX3DRequire(condition)\
+	do { if (!(condition)) { dx3d::Test::ReportFailure(__FILE__, __LINE__, #condition);\
+		throw dx3d::Test::RequireFailed(#condition); } } while (0)
+
+#define DX3DCheckThrows(expression, exception)\
+	do { bool dx3dThrown = false; try { (void)(expression); } catch (const exception&) { dx3dThrown = true; }\
+		if (!dx3dThrown) dx3d::Test::ReportFailure(__FILE__, __LINE__, #expression " throws " #exception); } while (0)
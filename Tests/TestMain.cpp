@@ -0,0 +1,97 @@
+#include "TestFramework.h"
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct TestCase
+	{
+		const char* suite{};
+		const char* name{};
+		dx3d::Test::TestFunction function{};
+	};
+
+	std::vector<TestCase>& GetTestCases()
+	{
+		static std::vector<TestCase> testCases{};
+		return testCases;
+	}
+
+	int g_failures{};
+	std::vector<std::string> g_options{};
+}
+
+dx3d::Test::Registrar::Registrar(const char* suite, const char* name, TestFunction function)
+{
+	GetTestCases().push_back({ suite, name, function });
+}
+
+void dx3d::Test::ReportFailure(const char* file, int line, const char* expression)
+{
+	std::printf("%s(%d): check failed: %s\n", file, line, expression);
+	g_failures++;
+}
+
+dx3d::Logger& dx3d::Test::GetLogger()
+{
+	static Logger logger(Logger::LoggerDesc{ Logger::LogLevel::Error, false });
+	return logger;
+}
+
+bool dx3d::Test::HasOption(const char* option)
+{
+	for (const auto& given : g_options)
+	{
+		if (given == option) return true;
+	}
+	return false;
+}
+
+// DX3DTests [--option]... [Suite | Suite.Name]... runs the matching test cases, all of them without filters
+int main(int argc, char** argv)
+{
+	std::vector<std::string> filters{};
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+		(argument.starts_with("--") ? g_options : filters).push_back(argument);
+	}
+	int run = 0, failed = 0;
+	for (const auto& testCase : GetTestCases())
+	{
+		const std::string fullName = std::string(testCase.suite) + "." + testCase.name;
+		bool selected = filters.empty();
+		for (const auto& filter : filters)
+			selected |= filter == testCase.suite || filter == fullName;
+		if (!selected) continue;
+
+		const auto failuresBefore = g_failures;
+		try
+		{
+			testCase.function();
+		}
+		catch (const dx3d::Test::RequireFailed&)
+		{
+		}
+		catch (const std::exception& e)
+		{
+			std::printf("%s: unexpected exception: %s\n", fullName.c_str(), e.what());
+			g_failures++;
+		}
+
+		run++;
+		const bool passed = g_failures == failuresBefore;
+		if (!passed) failed++;
+		std::printf("[%s] %s\n", passed ? "  OK  " : " FAIL ", fullName.c_str());
+	}
+
+	std::printf("%d test cases, %d failed\n", run, failed);
+	if (!run)
+	{
+		std::printf("No test case matched.\n");
+		return 1;
+	}
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "TestFramework.h"
+#include <DX3D/Graphics/Mesh.h>
+#include <cmath>
+#include <vector>
+
+namespace dx3d
+{
+	namespace Test
+	{
+		// Mesh only takes geometry from files, this hands it vertices directly
+		class TestMesh final : public Mesh
+		{
+		public:
+			TestMesh(GraphicsBackend& backend, const std::vector<Vertex>& vertices, const std::vector<ui32>& indices) :
+				Mesh({ GetLogger() }, backend)
+			{
+				initializeBuffers(vertices, indices);
+			}
+		};
+
+		// (cells + 1)^2 vertices over [-1, 1]^2 in x and y, z a gentle wave of the given height
+		inline std::vector<Vertex> MakeGridVertices(ui32 cells, f32 waveHeight = 0.0f)
+		{
+			std::vector<Vertex> vertices;
+			for (ui32 y = 0; y <= cells; y++)
+			{
+				for (ui32 x = 0; x <= cells; x++)
+				{
+					const f32 u = static_cast<f32>(x) / cells * 2.0f - 1.0f;
+					const f32 v = static_cast<f32>(y) / cells * 2.0f - 1.0f;
+					vertices.push_back({ u, v, waveHeight * std::sin(u * 3.0f) * std::cos(v * 2.0f), u * 0.5f + 0.5f, v * 0.5f + 0.5f, 0.5f, 1.0f });
+				}
+			}
+			return vertices;
+		}
+
+		// two clockwise triangles per cell, row by row
+		inline std::vector<ui32> MakeGridIndices(ui32 cells)
+		{
+			std::vector<ui32> indices;
+			const ui32 row = cells + 1;
+			for (ui32 y = 0; y < cells; y++)
+			{
+				for (ui32 x = 0; x < cells; x++)
+				{
+					const ui32 i = y * row + x;
+					indices.insert(indices.end(), { i, i + row, i + row + 1, i, i + row + 1, i + 1 });
+				}
+			}
+			return indices;
+		}
+	}
+}
@@ -0,0 +1,148 @@
+#include "TestFramework.h"
+#include <DX3D/Math/TransformKernels.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using namespace dx3d;
+
+	// the SIMD paths reorder the multiply-adds, so they may differ from the scalar reference in the last bits
+	bool NearlyEqual(f32 a, f32 b)
+	{
+		return std::fabs(a - b) <= 1.0e-5f * std::max(1.0f, std::max(std::fabs(a), std::fabs(b)));
+	}
+
+	Mat4 MakeTransform()
+	{
+		return Mat4::scale({ 1.5f, 0.5f, 2.0f }) * Mat4::rotationY(0.7f) * Mat4::rotationX(-0.3f) *
+			Mat4::translation({ 3.0f, -2.0f, 10.0f });
+	}
+
+	std::vector<Vec3> MakePoints(size_t count)
+	{
+		std::mt19937 random(1234);
+		std::uniform_real_distribution<f32> distribution(-100.0f, 100.0f);
+		std::vector<Vec3> points(count);
+		for (auto& point : points)
+			point = { distribution(random), distribution(random), distribution(random) };
+		return points;
+	}
+
+	bool Matches(const std::vector<Vec3>& a, const std::vector<Vec3>& b)
+	{
+		if (a.size() != b.size()) return false;
+		for (size_t i = 0; i < a.size(); i++)
+		{
+			if (!NearlyEqual(a[i].x, b[i].x) || !NearlyEqual(a[i].y, b[i].y) || !NearlyEqual(a[i].z, b[i].z))
+				return false;
+		}
+		return true;
+	}
+
+	// counts around the 4 and 8 wide blocks, so the remainder loops are covered too
+	constexpr size_t Counts[] = { 0, 1, 3, 4, 5, 7, 8, 9, 31, 1000 };
+}
+
+DX3DTest(TransformKernels, PointsMatchScalar)
+{
+	const auto matrix = MakeTransform();
+	for (const auto count : Counts)
+	{
+		const auto points = MakePoints(count);
+		std::vector<Vec3> expected(count), actual(count);
+		TransformKernels::Scalar::TransformPoints(matrix, points.data(), expected.data(), count);
+		TransformKernels::TransformPoints(matrix, points.data(), actual.data(), count);
+		DX3DCheck(Matches(actual, expected));
+
+		// in place
+		auto inPlace = points;
+		TransformKernels::TransformPoints(matrix, inPlace.data(), inPlace.data(), count);
+		DX3DCheck(Matches(inPlace, expected));
+	}
+}
+
+DX3DTest(TransformKernels, StridedPointsLeaveTheRestOfTheVertex)
+{
+	struct ColoredVertex
+	{
+		Vec3 position{};
+		f32 r{}, g{}, b{}, a{};
+	};
+
+	const auto matrix = MakeTransform();
+	const auto points = MakePoints(37);
+	std::vector<ColoredVertex> vertices(points.size());
+	for (size_t i = 0; i < points.size(); i++)
+		vertices[i] = { points[i], 0.25f, 0.5f, 0.75f, static_cast<f32>(i) };
+
+	std::vector<Vec3> expected(points.size());
+	TransformKernels::Scalar::TransformPoints(matrix, points.data(), expected.data(), points.size());
+	TransformKernels::TransformPoints(matrix, vertices.data(), sizeof(ColoredVertex), vertices.data(), sizeof(ColoredVertex),
+		vertices.size());
+
+	std::vector<Vec3> actual(points.size());
+	bool colorsKept = true;
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		actual[i] = vertices[i].position;
+		colorsKept &= vertices[i].r == 0.25f && vertices[i].b == 0.75f && vertices[i].a == static_cast<f32>(i);
+	}
+	DX3DCheck(Matches(actual, expected));
+	DX3DCheck(colorsKept);
+}
+
+DX3DTest(TransformKernels, DirectionsIgnoreTranslation)
+{
+	const auto matrix = MakeTransform();
+	const auto directions = MakePoints(19);
+	std::vector<Vec3> expected(directions.size()), actual(directions.size()), untranslated(directions.size());
+	TransformKernels::Scalar::TransformDirections(matrix, directions.data(), expected.data(), directions.size());
+	TransformKernels::TransformDirections(matrix, directions.data(), actual.data(), directions.size());
+	DX3DCheck(Matches(actual, expected));
+
+	auto withoutTranslation = matrix;
+	withoutTranslation.m[3][0] = withoutTranslation.m[3][1] = withoutTranslation.m[3][2] = 0.0f;
+	TransformKernels::TransformPoints(withoutTranslation, directions.data(), untranslated.data(), directions.size());
+	DX3DCheck(Matches(actual, untranslated));
+}
+
+DX3DTest(TransformKernels, VectorsMatchScalar)
+{
+	const auto matrix = MakeTransform() * Mat4::perspectiveFovLH(1.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+	const auto points = MakePoints(23);
+	std::vector<Vec4> vectors(points.size()), expected(points.size()), actual(points.size());
+	for (size_t i = 0; i < points.size(); i++)
+		vectors[i] = { points[i].x, points[i].y, points[i].z, (i % 2) ? 1.0f : 0.0f };
+
+	TransformKernels::Scalar::TransformVectors(matrix, vectors.data(), expected.data(), vectors.size());
+	TransformKernels::TransformVectors(matrix, vectors.data(), actual.data(), vectors.size());
+	bool matches = true;
+	for (size_t i = 0; i < vectors.size(); i++)
+	{
+		matches &= NearlyEqual(actual[i].x, expected[i].x) && NearlyEqual(actual[i].y, expected[i].y) &&
+			NearlyEqual(actual[i].z, expected[i].z) && NearlyEqual(actual[i].w, expected[i].w);
+	}
+	DX3DCheck(matches);
+}
+
+DX3DTest(TransformKernels, MatricesMatchScalar)
+{
+	const auto matrix = MakeTransform();
+	std::vector<Mat4> matrices(13), expected(13), actual(13);
+	for (size_t i = 0; i < matrices.size(); i++)
+		matrices[i] = Mat4::rotationZ(0.1f * static_cast<f32>(i)) * Mat4::translation({ static_cast<f32>(i), 1.0f, 2.0f });
+
+	TransformKernels::Scalar::MultiplyMatrices(matrices.data(), matrix, expected.data(), matrices.size());
+	TransformKernels::MultiplyMatrices(matrices.data(), matrix, actual.data(), matrices.size());
+	bool matches = true;
+	for (size_t i = 0; i < matrices.size(); i++)
+	{
+		for (int row = 0; row < 4; row++)
+			for (int column = 0; column < 4; column++)
+				matches &= NearlyEqual(actual[i].m[row][column], expected[i].m[row][column]);
+	}
+	DX3DCheck(matches);
+}